@@ -28,6 +28,7 @@
 #include <cstdint>
 #include <vector>
 #include <memory>
+#include <string>
 #include "tim/lite/handle.h"
 
 namespace tim {
@@ -37,6 +38,8 @@ class Execution {
  public:
   static std::shared_ptr<Execution> Create(const void* executable,
                                            size_t executable_size);
+  /* Map the executable file copy-on-write instead of reading it into memory */
+  static std::shared_ptr<Execution> CreateFromFile(const std::string& path);
   virtual std::shared_ptr<Handle> CreateInputHandle(uint32_t in_idx,
                                                     uint8_t* buffer,
                                                     size_t size) = 0;
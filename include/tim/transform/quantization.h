@@ -0,0 +1,183 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020-2023 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef TIM_TRANSFORM_QUANTIZATION_H_
+#define TIM_TRANSFORM_QUANTIZATION_H_
+
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "tim/vx/tensor.h"
+#include "tim/vx/types.h"
+
+namespace tim {
+
+namespace vx {
+    class Context;
+    class Graph;
+}
+
+namespace transform {
+
+enum class CalibrationMethod {
+  /// Observed minimum and maximum
+  MIN_MAX,
+  /// Drop the tails beyond `percentile` on both sides
+  PERCENTILE,
+  /// Clip |x| at the threshold whose quantized histogram has the smallest
+  /// KL divergence from the observed one
+  KL_DIVERGENCE,
+};
+
+struct QuantizationOptions {
+  CalibrationMethod method = CalibrationMethod::MIN_MAX;
+  /// Percentage of values kept inside the range by PERCENTILE
+  float percentile = 99.99f;
+  /// Histogram resolution of PERCENTILE and KL_DIVERGENCE
+  uint32_t histogram_bins = 2048;
+  /// UINT8 or INT8, activations are asymmetric
+  vx::DataType activation_type = vx::DataType::UINT8;
+  /// Weights of convolutions and fully connected ops become symmetric
+  /// `weight_type` with one scale per output channel, otherwise asymmetric
+  /// per tensor
+  bool per_channel_weights = false;
+  /// INT8 or INT4, the latter halves the weight memory again
+  vx::DataType weight_type = vx::DataType::INT8;
+};
+
+/// Values seen in one tensor over the calibration set
+class TensorStatistics {
+ public:
+  explicit TensorStatistics(uint32_t bins = 2048);
+
+  void Observe(const float* data, size_t count);
+
+  float Min() const { return min_; }
+  float Max() const { return max_; }
+  uint64_t Count() const { return count_; }
+  /// Range to quantize with `options.method`, it always holds 0
+  std::pair<float, float> Range(const QuantizationOptions& options) const;
+
+ private:
+  /// Histogram whose bin width doubles when a value falls outside of it,
+  /// so that counts are merged without resampling
+  struct Histogram {
+    float low{0};
+    float width{0};
+    std::vector<uint64_t> bins;
+
+    void Add(float value);
+    float Lower(uint64_t rank) const;
+    float Upper(uint64_t rank) const;
+  };
+
+  float KLThreshold(uint32_t levels) const;
+
+  uint32_t bins_;
+  float min_;
+  float max_;
+  uint64_t count_{0};
+  Histogram values_;
+  Histogram magnitudes_;
+};
+
+/// Scale and zero point mapping [min, max], widened to hold 0, to `type`
+vx::Quantization AsymmetricQuantization(float min, float max,
+                                        vx::DataType type);
+/// Symmetric `type` scales for each slice of `data` along `channel_dim`
+vx::Quantization PerChannelQuantization(
+    const std::vector<float>& data, const vx::ShapeType& shape,
+    int32_t channel_dim, vx::DataType type = vx::DataType::INT8);
+/// Converts `data` to the type and quantization of `spec`, rounding to
+/// nearest and saturating. Returns the raw tensor bytes, INT4 and UINT4 are
+/// packed as described in vx::DataType.
+std::vector<char> QuantizeData(const std::vector<float>& data,
+                               const vx::TensorSpec& spec);
+/// Inverse of QuantizeData(), also accepts FLOAT32 tensors
+std::vector<float> DequantizeData(const std::vector<char>& data,
+                                  const vx::TensorSpec& spec);
+
+/// Collects statistics of the FLOAT32 tensors of a float graph.
+///
+/// A copy of the graph is built in `ctx` with every such tensor turned
+/// into an output, so that Feed() can read them after each run.
+class Calibrator {
+ public:
+  Calibrator(const std::shared_ptr<vx::Graph>& graph,
+             std::shared_ptr<vx::Context>& ctx,
+             const QuantizationOptions& options = QuantizationOptions());
+  ~Calibrator();
+
+  /// Runs one sample, one buffer per graph input in graph order
+  bool Feed(const std::vector<std::vector<float>>& inputs);
+  /// Adds values of a tensor of the original graph observed elsewhere
+  void Observe(const std::shared_ptr<vx::Tensor>& tensor, const float* data,
+               size_t count);
+  /// Null if `tensor` was never observed
+  const TensorStatistics* Statistics(
+      const std::shared_ptr<vx::Tensor>& tensor) const;
+  const QuantizationOptions& Options() const { return options_; }
+
+ private:
+  struct Observer;
+
+  QuantizationOptions options_;
+  std::unique_ptr<Observer> observer_;
+  std::map<std::shared_ptr<vx::Tensor>, TensorStatistics> statistics_;
+};
+
+/// Quantized copy of the graph calibrated by `calibrator`. Like
+/// LayoutInference() it returns the new graph and the mapping from the
+/// tensors of `src_graph`, or a null graph if a float tensor was never
+/// observed. Biases of convolutions and fully connected ops become INT32
+/// with the scale of input * weights.
+std::pair<std::shared_ptr<vx::Graph>,
+          std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>>
+Quantize(const std::shared_ptr<vx::Graph>& src_graph,
+         std::shared_ptr<vx::Context>& ctx, const Calibrator& calibrator);
+
+struct LayerError {
+  /// Output of an op in the float graph
+  std::shared_ptr<vx::Tensor> tensor;
+  float max_abs_error{0};
+  /// Signal to quantization noise ratio in dB
+  double sqnr_db{0};
+};
+
+/// Runs the float graph and its quantized copy from Quantize() over
+/// `samples` and compares every op output, in the order of the ops of
+/// `src_graph`. Empty if either graph fails to run.
+std::vector<LayerError> CompareQuantization(
+    const std::shared_ptr<vx::Graph>& src_graph,
+    const std::pair<std::shared_ptr<vx::Graph>,
+                    std::map<std::shared_ptr<vx::Tensor>,
+                             std::shared_ptr<vx::Tensor>>>& quantized,
+    std::shared_ptr<vx::Context>& ctx,
+    const std::vector<std::vector<std::vector<float>>>& samples);
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
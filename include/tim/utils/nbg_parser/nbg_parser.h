@@ -168,6 +168,21 @@ nbg_status_e nbg_parser_init(
     nbg_parser_data *nbg
     );
 
+/*
+@brief, Initialize NBG parser in lazy mode. Only the fixed section is read and validated,
+        input/output properties are read in place from the NBG data on query, other
+        dynamic sections are never touched. The NBG data must stay valid until
+        nbg_parser_destroy(), a read-only memory mapping is fine.
+@param IN buffer, NBG data in memory.
+@param IN size, the size of NBG data.
+@param OUT nbg, the NBG parser object which created by nbg_parser_init_lazy().
+*/
+nbg_status_e nbg_parser_init_lazy(
+    void *buffer,
+    nbg_uint32_t size,
+    nbg_parser_data *nbg
+    );
+
 /*
 @brief, query the input info of network.
 @param IN nbg, the NBG parser object created by nbg_parser_init().
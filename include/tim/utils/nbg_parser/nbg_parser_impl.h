@@ -81,6 +81,9 @@ typedef struct _nbg_parser_data
     vip_uint32_t                    n_hw_init_ops;
     vip_uint32_t                    n_ICDT;
 
+    /* inputs/outputs point into the NBG buffer instead of owned copies */
+    vip_uint32_t                    in_place;
+
     nbg_reader_t                    reader;
 } nbg_parser_data_t;
 
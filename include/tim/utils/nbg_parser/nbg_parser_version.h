@@ -33,7 +33,7 @@ extern "C"{
 
 #define VERSION_MINOR           1
 
-#define VERSION_SUB_MINOR       2
+#define VERSION_SUB_MINOR       3
 
 #if defined(__cplusplus)
 }
@@ -26,6 +26,7 @@
 
 #include <map>
 #include <memory>
+#include <string>
 
 namespace tim {
 namespace vx {
@@ -38,6 +39,34 @@ class CompileOption {
   bool isRelaxMode() const;
   bool setRelaxMode(bool enable = false);
 
+  // Evaluate operations whose inputs are all constant on host at compile time
+  bool isConstFolding() const;
+  bool setConstFolding(bool enable = false);
+
+  // Remove operations whose outputs never reach a graph output, enabled by
+  // default
+  bool isDeadNodeElimination() const;
+  bool setDeadNodeElimination(bool enable = true);
+
+  // Merge duplicated operations applied to the same inputs, enabled by default
+  bool isCommonSubexpressionElimination() const;
+  bool setCommonSubexpressionElimination(bool enable = true);
+
+  // Directory where compiled graphs are stored keyed by graph fingerprint and
+  // loaded back on later compiles, empty string disables the cache
+  std::string getCompileCacheDir() const;
+  bool setCompileCacheDir(const std::string& dir = "");
+
+  // Time every kernel backend available for each node on the target and run
+  // the fastest one, results are kept in the kernel tuning database if set
+  bool isKernelTuning() const;
+  bool setKernelTuning(bool enable = false);
+
+  // File of kernel choices keyed by operation, tensor specs and target. Choices
+  // found in it are applied without measuring, empty string disables it
+  std::string getKernelTuningDB() const;
+  bool setKernelTuningDB(const std::string& path = "");
+
   static CompileOption DefaultOptions;
 
  private:
@@ -25,6 +25,8 @@
 #define TIM_VX_CONTEXT_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace tim {
 namespace vx {
@@ -36,10 +38,29 @@ class Context {
   virtual ~Context() {}
   virtual std::shared_ptr<Graph> CreateGraph() = 0;
   virtual std::shared_ptr<Graph> CreateGraph(const CompileOption& options) = 0;
+  /// Load a graph saved by Graph::Serialize, constant data is mapped from the
+  /// file instead of being read into memory. Returns nullptr on failure.
+  virtual std::shared_ptr<Graph> LoadGraph(const std::string& /*path*/) {
+    return nullptr;
+  }
+  virtual std::shared_ptr<Graph> LoadGraph(
+      const std::string& /*path*/, const CompileOption& /*options*/) {
+    return nullptr;
+  }
+
+  /// Compile independent graphs in parallel on up to `threads` threads, 0
+  /// picks the number of hardware threads. A graph must not appear twice.
+  /// Returns false if any graph failed to compile.
+  virtual bool CompileAll(const std::vector<std::shared_ptr<Graph>>& graphs,
+                          uint32_t threads = 0) = 0;
 
   virtual bool isClOnly() = 0;
 
   static std::shared_ptr<Context> Create();
+  /// Create a context sharing its low-level vx context with every other shared
+  /// context alive in this process, so hardware query and kernel compilation
+  /// are done once for all of them.
+  static std::shared_ptr<Context> CreateShared();
 };
 
 }  // namespace vx
@@ -0,0 +1,102 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_DETECTION_POST_PROCESS_H_
+#define TIM_VX_DETECTION_POST_PROCESS_H_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+struct _vsi_nn_detection_workspace_t;
+
+namespace tim {
+namespace vx {
+
+struct Detection {
+  // Index of the box in the input
+  uint32_t index;
+  uint32_t class_id;
+  float score;
+};
+
+struct NmsOptions {
+  float iou_threshold = 0.5f;
+  // Boxes scoring at or below the threshold are dropped before NMS
+  float score_threshold = 0.0f;
+  // Keep the best k candidates (per class) before NMS, 0 keeps all
+  uint32_t pre_nms_top_k = 0;
+  // Upper bound of returned detections
+  uint32_t max_detections = 100;
+  // Use width = x2 - x1 + 1 like caffe and faster-rcnn
+  bool pixel_inclusive = false;
+};
+
+/// Host side post processing for detection models.
+///
+/// Boxes are float[4] corners (x1, y1, x2, y2), so `boxes` holds 4 * count
+/// floats. Scratch memory is kept between calls, create one processor per
+/// thread and reuse it, and the result vector, across frames.
+class DetectionPostProcessor {
+ public:
+  /// `max_boxes` preallocates the workspace, it grows on demand otherwise
+  explicit DetectionPostProcessor(uint32_t max_boxes = 0);
+  ~DetectionPostProcessor();
+  DetectionPostProcessor(const DetectionPostProcessor&) = delete;
+  DetectionPostProcessor& operator=(const DetectionPostProcessor&) = delete;
+
+  /// Decode SSD style center-size regressions. `deltas` are
+  /// (dx, dy, dw, dh) and `anchors` (cx, cy, w, h), `variance` scales the
+  /// deltas. Writes 4 * count floats to `boxes`.
+  static bool DecodeBoxes(const float* deltas, const float* anchors,
+                          uint32_t count, const std::array<float, 4>& variance,
+                          float* boxes);
+
+  /// Class agnostic NMS, results sorted by descending score. `detections`
+  /// is resized to the kept boxes. Returns false on invalid arguments or if
+  /// scratch memory can not be allocated, an empty result is not a failure.
+  bool Nms(const float* boxes, const float* scores, uint32_t count,
+           const NmsOptions& options, std::vector<Detection>& detections);
+
+  /// NMS per class, `scores` is count x num_classes. Classes below
+  /// `first_class` are skipped, e.g. 1 for a background class.
+  bool MultiClassNms(const float* boxes, const float* scores, uint32_t count,
+                     uint32_t num_classes, uint32_t first_class,
+                     const NmsOptions& options,
+                     std::vector<Detection>& detections);
+
+  /// A single NMS pass over boxes that already carry a class, boxes only
+  /// suppress boxes of the same class
+  bool BatchedNms(const float* boxes, const float* scores,
+                  const uint32_t* class_ids, uint32_t count,
+                  const NmsOptions& options,
+                  std::vector<Detection>& detections);
+
+ private:
+  _vsi_nn_detection_workspace_t* workspace_;
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_DETECTION_POST_PROCESS_H_ */
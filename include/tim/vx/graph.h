@@ -32,6 +32,7 @@
 #include <string>
 #endif
 #include <memory>
+#include <string>
 #include <vector>
 namespace tim {
 namespace vx {
@@ -70,6 +71,13 @@ class Graph {
 
   virtual bool Run() = 0;
 
+  /// Save operations, tensor specs and constant data to `path`, it can be
+  /// loaded back with Context::LoadGraph. Only builtin operations are saved:
+  /// composed ops (e.g. RNNCell, MaxpoolGrad) are not lowered to the builtin
+  /// ops they expand to, so a graph holding one, or a custom op, fails to
+  /// serialize and has to be rebuilt from its source instead.
+  virtual bool Serialize(const std::string& /*path*/) { return false; }
+
   template <typename OpType, typename... Params>
   std::shared_ptr<OpType> CreateOperation(Params... parameters) {
     auto op = std::make_shared<OpType>(this, parameters...);
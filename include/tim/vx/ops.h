@@ -108,5 +108,7 @@
 #include "tim/vx/ops/max_pool3d.h"
 #include "tim/vx/ops/unidirectional_sequence_gru.h"
 #include "tim/vx/ops/grucell.h"
+#include "tim/vx/ops/scaled_dot_product_attention.h"
+#include "tim/vx/ops/slice_update.h"
 
 #endif /* TIM_VX_OPS_H_ */
@@ -25,8 +25,11 @@
 #define TIM_VX_OPS_CUSTOM_BASE_H_
 
 #include "tim/vx/builtin_op.h"
-#include <typeinfo>
+#include <initializer_list>
 #include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace tim {
 namespace vx {
@@ -45,44 +48,60 @@ struct Param {
   tim::vx::DataType type;
 };
 
-template <size_t I = 0, typename... Ts>
-typename std::enable_if<I == sizeof...(Ts), void>::type param_transform(
-    std::tuple<Ts...> tup, std::vector<Param>& param_list) {
-  auto size = std::tuple_size<decltype(tup)>::value;
-  if (size == I && param_list.size() != 0) {
-    //nothing to do
-  }
-  return;
+// Map a C++ type of kernel scalar parameter to tim::vx::DataType at compile
+// time, unsupported types fail to build instead of being dropped at runtime
+template <typename T>
+struct ParamTraits {
+  static_assert(sizeof(T) == 0, "unsupported custom op parameter type");
+};
+
+template <>
+struct ParamTraits<float> {
+  static constexpr tim::vx::DataType type = tim::vx::DataType::FLOAT32;
+  static void Pack(float value, Param& p) { p.data.f = value; }
+};
+
+template <>
+struct ParamTraits<uint32_t> {
+  static constexpr tim::vx::DataType type = tim::vx::DataType::UINT32;
+  static void Pack(uint32_t value, Param& p) { p.data.ui = value; }
+};
+
+template <>
+struct ParamTraits<int32_t> {
+  static constexpr tim::vx::DataType type = tim::vx::DataType::INT32;
+  static void Pack(int32_t value, Param& p) { p.data.i = value; }
+};
+
+template <>
+struct ParamTraits<bool> {
+  static constexpr tim::vx::DataType type = tim::vx::DataType::BOOL8;
+  static void Pack(bool value, Param& p) { p.data.b = value; }
+};
+
+template <typename T>
+inline Param make_param(const T& value) {
+  using Traits = ParamTraits<typename std::decay<T>::type>;
+  Param p;
+  p.type = Traits::type;
+  Traits::Pack(value, p);
+  return p;
+}
+
+template <typename Tuple, size_t... I>
+inline void param_transform_impl(const Tuple& tup,
+                                 std::vector<Param>& param_list,
+                                 std::index_sequence<I...>) {
+  (void)tup;
+  param_list.reserve(param_list.size() + sizeof...(I));
+  (void)std::initializer_list<int>{
+      (param_list.push_back(make_param(std::get<I>(tup))), 0)...};
 }
 
-template <size_t I = 0, typename... Ts>
-typename std::enable_if<(I < sizeof...(Ts)), void>::type param_transform(
-    std::tuple<Ts...> tup, std::vector<Param>& param_list) {
-  if (typeid(std::get<I>(tup)) == typeid(float)) {
-    Param p;
-    p.data.f = std::get<I>(tup);
-    p.type = tim::vx::DataType::FLOAT32;
-    param_list.push_back(p);
-  } else if (typeid(std::get<I>(tup)) == typeid(uint32_t)) {
-    Param p;
-    p.data.ui = std::get<I>(tup);
-    p.type = tim::vx::DataType::UINT32;
-    param_list.push_back(p);
-  } else if (typeid(std::get<I>(tup)) == typeid(int32_t)) {
-    Param p;
-    p.data.i = std::get<I>(tup);
-    p.type = tim::vx::DataType::INT32;
-    param_list.push_back(p);
-  } else if (typeid(std::get<I>(tup)) == typeid(bool)) {
-    Param p;
-    p.data.b = std::get<I>(tup);
-    p.type = tim::vx::DataType::BOOL8;
-    param_list.push_back(p);
-  } else {
-    std::cout << "need more else if type of param list " << std::endl;
-  }
-  // Go to next element
-  param_transform<I + 1>(tup, param_list);
+template <typename... Ts>
+inline void param_transform(const std::tuple<Ts...>& tup,
+                            std::vector<Param>& param_list) {
+  param_transform_impl(tup, param_list, std::index_sequence_for<Ts...>{});
 }
 
 class CustomOpBase : public Operation {
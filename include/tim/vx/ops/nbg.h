@@ -23,6 +23,9 @@
 *****************************************************************************/
 #ifndef TIM_VX_OPS_NBG_H_
 #define TIM_VX_OPS_NBG_H_
+#include <memory>
+#include <string>
+
 #include "tim/vx/builtin_op.h"
 
 namespace tim {
@@ -34,14 +37,29 @@ namespace ops {
  *
  * Network Binary Graph is a precompile technology, which can compile a fuse graph into
  * a bianry file.
+ *
+ * The binary passed by raw pointer must stay valid until the graph is
+ * compiled. Use the shared_ptr overload, or NBG::FromFile which maps the file
+ * copy-on-write instead of reading it into memory, to tie the binary
+ * lifetime to the op.
  */
 
 class NBG : public BuiltinOp {
  public:
   NBG(Graph* graph, const char* binary, size_t input_count, size_t output_count);
+  NBG(Graph* graph, const std::shared_ptr<const char>& binary,
+      size_t input_count, size_t output_count);
+
+  static std::shared_ptr<NBG> FromFile(Graph* graph, const std::string& path,
+                                       size_t input_count, size_t output_count);
+  /* Map a network binary file copy-on-write, returns nullptr on failure */
+  static std::shared_ptr<const char> MapFile(const std::string& path,
+                                             size_t* size = nullptr);
 
   std::shared_ptr<Operation> Clone(std::shared_ptr<Graph>& graph) const override;
 
+ protected:
+  std::shared_ptr<const char> binary_;
 };
 
 }  // namespace ops
@@ -29,6 +29,28 @@ namespace tim {
 namespace vx {
 namespace ops {
 
+/**
+ * ## RNNCell
+ *
+ * A basic recurrent cell, output = tanh(input * weights + bias +
+ * state_in * recurrent_weights), state_out is the output converted to its
+ * own type.
+ *
+ * Inputs are input [input_size, batch], weights [input_size, num_units],
+ * bias [num_units], state_in [num_units, batch] and recurrent_weights
+ * [num_units, num_units]. Outputs are output and state_out
+ * [num_units, batch].
+ *
+ * Float cells run as separate fully connected, add and tanh ops with
+ * float32 intermediates. Quantized cells run as one fused cell whose
+ * intermediates take internal_quant in the input type, or float16 when
+ * internal_quant is not given.
+ *
+ * - activation: kept for compatibility, the cell always applies tanh.
+ * - internal_quant: quantization of the pre-activation sum of a quantized
+ * cell.
+ */
+
 class RNNCell : public Operation {
  public:
   enum ActivationType {
@@ -40,12 +62,14 @@ class RNNCell : public Operation {
     kSIGMOID = 6,
     kHARDSIGMOID = 31, /* temporary use 31 */
   };
-  RNNCell(Graph* graph, ActivationType activation);
+  RNNCell(Graph* graph, ActivationType activation,
+          const Quantization& internal_quant = Quantization());
   std::shared_ptr<Operation> Clone(
       std::shared_ptr<Graph>& graph) const override;
 
  protected:
   const ActivationType activation_;
+  const Quantization internal_quant_;
 };
 
 }  // namespace ops
@@ -0,0 +1,70 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_SCALED_DOT_PRODUCT_ATTENTION_H_
+#define TIM_VX_OPS_SCALED_DOT_PRODUCT_ATTENTION_H_
+
+#include <cstdint>
+#include "tim/vx/builtin_op.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## ScaledDotProductAttention
+ *
+ * Computes softmax(Q * K^T * scale + mask) * V without materializing the
+ * score matrix: the fused kernels keep a running softmax over the keys,
+ * the decomposition used for quantized tensors works on tiles of query rows.
+ *
+ * Inputs are query [head_dim, q_len, heads, batch], key [head_dim, kv_len, ...],
+ * value [value_dim, kv_len, ...] and an optional additive mask
+ * [kv_len, q_len or 1, heads or 1, batch or 1]. Rank can be 2 to 4.
+ * The output is [value_dim, q_len, heads, batch].
+ *
+ * - scale: multiplier of the scores, 0 selects 1 / sqrt(head_dim).
+ * - causal: query i only attends to keys up to i + kv_len - q_len.
+ * - query_tile: query rows per tile of the decomposition, 0 derives it
+ * from the score size.
+ */
+
+class ScaledDotProductAttention : public BuiltinOp {
+ public:
+  ScaledDotProductAttention(Graph* graph, float scale = 0.0f,
+                            bool causal = false, uint32_t query_tile = 0);
+
+  std::shared_ptr<Operation> Clone(
+      std::shared_ptr<Graph>& graph) const override;
+
+ protected:
+  const float scale_;
+  const bool causal_;
+  const uint32_t query_tile_;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_SCALED_DOT_PRODUCT_ATTENTION_H_ */
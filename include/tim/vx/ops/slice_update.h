@@ -0,0 +1,65 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OPS_SLICE_UPDATE_H_
+#define TIM_VX_OPS_SLICE_UPDATE_H_
+
+#include <cstdint>
+#include "tim/vx/builtin_op.h"
+
+namespace tim {
+namespace vx {
+namespace ops {
+
+/**
+ * ## SliceUpdate
+ *
+ * Writes the updates into the output at a runtime offset along axis and
+ * leaves every other element of the output untouched. Used with a
+ * TensorAttribute::VARIABLE output this updates persistent state in place,
+ * e.g. appending the keys and values of new tokens to a KV cache without
+ * copying the whole cache in and out on every step.
+ *
+ * Inputs are the updates and an INT32 start {1}. The updates have the rank
+ * of the output, the same sizes except along axis, where start + size must
+ * not exceed the output size.
+ *
+ * - axis: the axis the start offset applies to.
+ */
+
+class SliceUpdate : public BuiltinOp {
+ public:
+  SliceUpdate(Graph* graph, int32_t axis);
+
+  std::shared_ptr<Operation> Clone(
+      std::shared_ptr<Graph>& graph) const override;
+
+ protected:
+  const int32_t axis_;
+};
+
+}  // namespace ops
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OPS_SLICE_UPDATE_H_ */
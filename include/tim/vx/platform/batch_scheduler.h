@@ -0,0 +1,163 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_PLATFORM_BATCH_SCHEDULER_H_
+#define TIM_VX_PLATFORM_BATCH_SCHEDULER_H_
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "tim/vx/platform/platform.h"
+
+namespace tim {
+namespace vx {
+namespace platform {
+
+/// Latency histogram with power of two microsecond buckets
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBucketCount = 32;
+
+  void Record(std::chrono::microseconds latency);
+  void Merge(const LatencyHistogram& other);
+
+  uint64_t Count() const { return count_; }
+  std::chrono::microseconds Mean() const;
+  std::chrono::microseconds Max() const { return max_; }
+  /// Upper bound of the bucket holding the `percentile` (0-100) sample
+  std::chrono::microseconds Percentile(double percentile) const;
+  /// Number of samples below 2^(i+1) us and at or above 2^i us, bucket 0
+  /// also holds samples below 1us
+  uint64_t Bucket(size_t i) const { return buckets_[i]; }
+
+ private:
+  std::array<uint64_t, kBucketCount> buckets_{};
+  uint64_t count_{0};
+  std::chrono::microseconds total_{0};
+  std::chrono::microseconds max_{0};
+};
+
+struct BatchSchedulerOptions {
+  /// Batch sizes the graph is compiled for, a batch runs on the smallest
+  /// one that fits it. Must not be empty.
+  std::vector<uint32_t> batch_sizes = {1, 4, 8, 16};
+  /// Upper bound of requests coalesced into one batch, clamped to the
+  /// largest compiled batch size
+  uint32_t max_batch_size = 16;
+  /// How long the oldest queued request may wait for others to join it
+  std::chrono::microseconds max_latency{2000};
+};
+
+/// Coalesces single sample requests from many threads into batched runs.
+///
+/// The graph is built and compiled once per batch size. Batch must be the
+/// outermost dimension of every graph input and output, so that samples are
+/// contiguous in the batched tensors. Unused slots of a partial batch are
+/// zero filled and their outputs dropped.
+class BatchScheduler {
+ public:
+  /// Builds the graph for batch size `batch` in `context`
+  using GraphBuilder = std::function<std::shared_ptr<Graph>(
+      const std::shared_ptr<Context>& context, uint32_t batch)>;
+  /// One buffer per graph input or output, in graph order
+  using Sample = std::vector<std::vector<char>>;
+
+  struct Stats {
+    uint64_t requests{0};
+    uint64_t batches{0};
+    /// Submit to the start of the batched run
+    LatencyHistogram queue_latency;
+    /// Duration of batched runs, one sample per batch
+    LatencyHistogram exec_latency;
+    /// Number of batches run at each compiled batch size
+    std::map<uint32_t, uint64_t> batch_size_runs;
+  };
+
+  /// Returns nullptr if any batch size fails to compile
+  static std::shared_ptr<BatchScheduler> Create(
+      const std::shared_ptr<IExecutor>& executor, const GraphBuilder& builder,
+      const BatchSchedulerOptions& options = BatchSchedulerOptions());
+  ~BatchScheduler();
+
+  /// Queue one sample. The future throws std::runtime_error if the inputs
+  /// do not match the graph or the run fails.
+  std::future<Sample> Submit(Sample inputs);
+
+  /// Run what is queued and stop accepting requests
+  void Shutdown();
+
+  Stats GetStats() const;
+
+  /// Bytes of one sample for each graph input / output
+  const std::vector<size_t>& InputSizes() const { return input_sizes_; }
+  const std::vector<size_t>& OutputSizes() const { return output_sizes_; }
+
+ private:
+  struct Variant {
+    uint32_t batch;
+    std::shared_ptr<IExecutable> executable;
+    std::vector<std::shared_ptr<ITensorHandle>> inputs;
+    std::vector<std::shared_ptr<ITensorHandle>> outputs;
+  };
+
+  struct Request {
+    Sample inputs;
+    std::promise<Sample> result;
+    std::chrono::steady_clock::time_point enqueue_time;
+  };
+
+  explicit BatchScheduler(const BatchSchedulerOptions& options);
+  bool AddVariant(const std::shared_ptr<IExecutor>& executor,
+                  const GraphBuilder& builder, uint32_t batch);
+  void WorkerLoop();
+  void RunBatch(std::vector<Request>& batch);
+
+  BatchSchedulerOptions options_;
+  size_t max_batch_{1};
+  /// Sorted by ascending batch size
+  std::vector<Variant> variants_;
+  std::vector<size_t> input_sizes_;
+  std::vector<size_t> output_sizes_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<Request> queue_;
+  bool stopped_{false};
+  Stats stats_;
+  std::thread worker_;
+};
+
+}  // namespace platform
+}  // namespace vx
+}  // namespace tim
+
+#endif
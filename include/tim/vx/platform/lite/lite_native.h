@@ -80,6 +80,10 @@ class LiteNativeExecutable : public IExecutable {
   gcvip_videomemory_t* pre_command_;
 };
 
+/// Owns a video memory buffer. The same handle can be set as the output of
+/// one executable and the input of the next, the NPU then reads what the
+/// previous stage wrote without a copy. Host copies flush and invalidate
+/// the CPU cache.
 class LiteNativeTensorHandle : public ITensorHandle {
  public:
   LiteNativeTensorHandle(const std::shared_ptr<Tensor>& tensr);
@@ -24,6 +24,9 @@
 #ifndef TIM_VX_NATIVE_H_
 #define TIM_VX_NATIVE_H_
 
+#include <mutex>
+#include <thread>
+
 #include "tim/vx/platform/platform.h"
 
 namespace tim {
@@ -43,7 +46,12 @@ class NativeDevice : public IDevice {
 class NativeExecutable : public IExecutable {
  public:
   NativeExecutable(const std::shared_ptr<IExecutor>& executor,
-                   const std::vector<char>& nb_buf, size_t inputs,
+                   std::vector<char> nb_buf, size_t inputs,
+                   size_t outputs);
+  /* The binary is referenced instead of copied, e.g. a file mapped by
+   * ops::NBG::MapFile */
+  NativeExecutable(const std::shared_ptr<IExecutor>& executor,
+                   const std::shared_ptr<const char>& nb_buf, size_t inputs,
                    size_t outputs);
   ~NativeExecutable(){};
   void SetInput(const std::shared_ptr<ITensorHandle>& th) override;
@@ -56,32 +64,112 @@ class NativeExecutable : public IExecutable {
   std::shared_ptr<ITensorHandle> AllocateTensor(
       const TensorSpec& tensor_spec) override;
   bool Verify() override;
+  /// Bytes moved through host memory to feed handles bound from other
+  /// executables, stays zero while their buffers can be shared
+  uint64_t HostBytesCopied() const { return host_bytes_copied_; }
 
  protected:
+  using HandleBinding =
+      std::pair<std::shared_ptr<ITensorHandle>, std::shared_ptr<Tensor>>;
+
+  /// Tensor of nb_graph_ for a handle allocated by another executable,
+  /// backed by the same buffer when the handle has one
+  std::shared_ptr<Tensor> BindForeignHandle(
+      const std::shared_ptr<ITensorHandle>& th, TensorAttribute attr,
+      std::vector<HandleBinding>& copies);
+
   std::shared_ptr<tim::vx::ops::NBG> nb_node_;
-  std::vector<char> nb_buf_;
+  /// Tensors sharing the buffer of another executable's handle, which
+  /// is kept alive here
+  std::vector<HandleBinding> shared_bindings_;
+  /// Bindings that could not share a buffer, copied around each run
+  std::vector<HandleBinding> copied_inputs_;
+  std::vector<HandleBinding> copied_outputs_;
+  uint64_t host_bytes_copied_{0};
 };
 
+/// Runs submitted executables in dependency order.
+///
+/// `executable->Submit(ref)` records an edge ref -> executable, or
+/// executable -> ref with `after = false`, so an executable may depend on
+/// several others. On Trigger() executables whose dependencies are done run
+/// right away: one lane per device, lanes run concurrently. An executable
+/// of another device's executor may be submitted here to run on its own
+/// device. Executables are verified once per Trigger(), on their lane,
+/// instead of on every Submit(). Dependents of a failed executable are
+/// skipped.
 class NativeExecutor : public IExecutor,
                        public std::enable_shared_from_this<NativeExecutor> {
  public:
+  /// Called once per submitted executable after it ran or was skipped,
+  /// from the thread of its lane
+  using TaskCallback = std::function<void(
+      const std::shared_ptr<IExecutable>& executable, bool success)>;
+
   NativeExecutor(const std::shared_ptr<IDevice>& device);
   NativeExecutor(const std::shared_ptr<IDevice>& device,
                  const std::shared_ptr<Context>& context);
-  ~NativeExecutor(){};
+  ~NativeExecutor();
+  /// Fails if ref was not submitted or the edge would make a cycle
   bool Submit(const std::shared_ptr<IExecutable>& executable,
               const std::shared_ptr<IExecutable>& ref,
               bool after = true) override;
+  /// Runs and clears everything submitted so far. With async = true it
+  /// returns at once, Wait() gives the result.
   bool Trigger(bool async = false) override;
+  /// Waits for an async Trigger(), true if every executable succeeded
+  bool Wait();
+  void SetTaskCallback(const TaskCallback& callback);
   std::shared_ptr<IExecutable> Compile(
       const std::shared_ptr<Graph>& graph) override;
+  /// Binary of `graph` for this executor's device, several NativeExecutable
+  /// instances may be created from it. Null on failure.
+  std::shared_ptr<const char> CompileToBinary(
+      const std::shared_ptr<Graph>& graph);
+
+ private:
+  struct TaskNode {
+    std::weak_ptr<IExecutable> executable;
+    std::vector<size_t> next;
+    size_t deps{0};
+  };
+
+  size_t FindTask(const std::shared_ptr<IExecutable>& executable) const;
+  size_t AddTask(const std::shared_ptr<IExecutable>& executable);
+  bool Reaches(size_t from, size_t to) const;
+  /// Does not touch the executor, an async run may outlive it when the
+  /// callback drops the last reference
+  static bool Run(const std::vector<TaskNode>& graph,
+                  const std::shared_ptr<IDevice>& device,
+                  const TaskCallback& callback);
+
+  std::vector<TaskNode> graph_;
+  // Guards task_callback_, Trigger() hands a copy to the run
+  std::mutex callback_mutex_;
+  TaskCallback task_callback_;
+  std::thread async_run_;
+  // Result of the async run, shared with its thread
+  std::shared_ptr<bool> async_status_;
 };
 
+/// A handle from NativeExecutable::AllocateTensor() owns the host buffer
+/// of its input/output tensor. Binding it to another NativeExecutable
+/// creates a tensor on the same buffer, so chained executables exchange
+/// data without copies.
 class NativeTensorHandle : public ITensorHandle {
  public:
   NativeTensorHandle(const std::shared_ptr<Tensor>& tensor);
+  NativeTensorHandle(const std::shared_ptr<Tensor>& tensor,
+                     const std::shared_ptr<char>& buffer, const Graph* graph);
   bool CopyDataToTensor(const void* data, uint32_t size_in_bytes) override;
   bool CopyDataFromTensor(void* data) override;
+  /// Null if the tensor memory is owned by the driver
+  const std::shared_ptr<char>& Buffer() const { return buffer_; }
+  const Graph* Owner() const { return graph_; }
+
+ protected:
+  std::shared_ptr<char> buffer_;
+  const Graph* graph_{nullptr};
 };
 
 }  // namespace platform
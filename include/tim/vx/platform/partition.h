@@ -0,0 +1,171 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_PLATFORM_PARTITION_H_
+#define TIM_VX_PLATFORM_PARTITION_H_
+
+#include <functional>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "tim/vx/operation.h"
+#include "tim/vx/platform/native.h"
+
+namespace tim {
+namespace vx {
+namespace platform {
+
+struct PartitionPolicy {
+  /// Modeled time of an op in us is macs / macs_per_us plus the bytes of
+  /// its inputs, weights and outputs / bytes_per_us
+  double macs_per_us = 500000.0;
+  double bytes_per_us = 4000.0;
+  /// Bytes per us of handing a cut tensor to the next stage, added to the
+  /// time of the consuming stage
+  double transfer_bytes_per_us = 4000.0;
+  /// Relative speed of each device, empty if they are identical
+  std::vector<double> device_speed;
+  /// Replaces the modeled time of `op`, e.g. with a measured profile
+  std::function<double(const std::shared_ptr<Operation>& op,
+                       double modeled_us)>
+      calibrate;
+  /// Compile one instance of every stage per frame in flight so that
+  /// PartitionedGraph::RunPipelined() overlaps the stages
+  bool pipelined = true;
+};
+
+/// Ops in topological order and the tensors between them
+struct CostGraph {
+  static constexpr size_t kNoProducer = std::numeric_limits<size_t>::max();
+
+  struct Node {
+    double cost_us{0};
+    /// Indices of non constant input tensors
+    std::vector<size_t> inputs;
+  };
+  struct Edge {
+    /// Index of the producing op, kNoProducer for graph inputs
+    size_t producer{kNoProducer};
+    uint64_t bytes{0};
+  };
+
+  std::vector<Node> ops;
+  std::vector<Edge> tensors;
+};
+
+struct PartitionPlan {
+  /// Stage of each op of the CostGraph, stage i runs on device i
+  std::vector<uint32_t> op_stage;
+  /// Modeled time of each stage including its incoming transfers
+  std::vector<double> stage_cost_us;
+  /// Modeled time of the whole graph on device 0
+  double total_cost_us{0};
+  /// Bytes of tensors crossing a stage boundary, counted per consuming stage
+  uint64_t cut_bytes{0};
+
+  size_t StageCount() const { return stage_cost_us.size(); }
+  double BottleneckUs() const;
+  /// Pipelined throughput over the unpartitioned graph
+  double PredictedSpeedup() const;
+};
+
+/// Splits the ops into at most `devices` contiguous stages. The slowest
+/// stage is minimized first, then the cut bytes. Stages may be fewer than
+/// devices when transfers outweigh the gain.
+PartitionPlan PlanPartition(const CostGraph& graph, size_t devices,
+                            const PartitionPolicy& policy = PartitionPolicy());
+
+/// One subgraph per stage, compiled for its device, with the cut tensors
+/// bound to shared handles.
+class PartitionedGraph {
+ public:
+  using FrameCallback = std::function<bool(
+      size_t frame, const std::vector<std::shared_ptr<ITensorHandle>>& th)>;
+
+  const PartitionPlan& Plan() const { return plan_; }
+  /// Frames in flight, each owns a set of stage instances and handles
+  size_t Slots() const { return stages_.empty() ? 0 : stages_[0].size(); }
+  /// Handles of the graph inputs / outputs, in the order of the original
+  /// graph
+  const std::vector<std::shared_ptr<ITensorHandle>>& Inputs(
+      size_t slot = 0) const {
+    return inputs_[slot];
+  }
+  const std::vector<std::shared_ptr<ITensorHandle>>& Outputs(
+      size_t slot = 0) const {
+    return outputs_[slot];
+  }
+  /// Subgraph of `stage` before compilation
+  const std::shared_ptr<Graph>& StageGraph(size_t stage) const {
+    return stage_graphs_[stage];
+  }
+
+  /// Runs one frame through the stages in slot 0
+  bool Run();
+  /// Runs `frames` frames, stage i works on frame n while stage i + 1
+  /// works on frame n - 1. `feed` fills the inputs of a frame before its
+  /// first stage runs and `fetch` reads its outputs after the last one.
+  bool RunPipelined(size_t frames, const FrameCallback& feed,
+                    const FrameCallback& fetch);
+
+ private:
+  friend std::shared_ptr<PartitionedGraph> Partition(
+      const std::shared_ptr<Graph>& graph,
+      const std::vector<std::shared_ptr<IDevice>>& devices,
+      const PartitionPolicy& policy);
+
+  PartitionedGraph() = default;
+
+  PartitionPlan plan_;
+  std::vector<std::shared_ptr<NativeExecutor>> executors_;
+  std::vector<std::shared_ptr<Graph>> stage_graphs_;
+  /// Stages each stage reads cut tensors from
+  std::vector<std::vector<size_t>> stage_deps_;
+  /// Indexed by stage, then slot
+  std::vector<std::vector<std::shared_ptr<IExecutable>>> stages_;
+  /// Indexed by slot
+  std::vector<std::vector<std::shared_ptr<ITensorHandle>>> inputs_;
+  std::vector<std::vector<std::shared_ptr<ITensorHandle>>> outputs_;
+};
+
+/// Cost model of the ops of `graph`, `order` receives the ops in the
+/// topological order of the returned CostGraph
+CostGraph BuildCostGraph(const std::shared_ptr<Graph>& graph,
+                         const PartitionPolicy& policy,
+                         std::vector<std::shared_ptr<Operation>>* order);
+
+/// Splits `graph` across `devices` with PlanPartition() and compiles every
+/// stage on its device. `graph` itself is neither compiled nor modified,
+/// inferred tensor shapes are resolved on a copy. Returns nullptr on
+/// failure.
+std::shared_ptr<PartitionedGraph> Partition(
+    const std::shared_ptr<Graph>& graph,
+    const std::vector<std::shared_ptr<IDevice>>& devices,
+    const PartitionPolicy& policy = PartitionPolicy());
+
+}  // namespace platform
+}  // namespace vx
+}  // namespace tim
+
+#endif
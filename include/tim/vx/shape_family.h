@@ -0,0 +1,170 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_SHAPE_FAMILY_H_
+#define TIM_VX_SHAPE_FAMILY_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "tim/vx/tensor.h"
+
+namespace tim {
+namespace vx {
+
+class Context;
+class Graph;
+
+struct ShapeFamilyOptions {
+  // Number of compiled specializations kept, least recently used ones are
+  // released first
+  size_t capacity = 8;
+  // Round input dimension i up to a multiple of bucket_granularity[i] before
+  // looking up a specialization. Inputs are padded to the bucket shape with
+  // zeros, or with the zero point of asymmetric quantized inputs.
+  // 0 or 1 and missing entries keep the dimension exact.
+  ShapeType bucket_granularity;
+};
+
+struct ShapeFamilyStats {
+  uint64_t hits{0};
+  uint64_t misses{0};
+  uint64_t evictions{0};
+  // Run latency of cache hits and of first-seen shapes, the latter include
+  // building and compiling the specialization
+  std::chrono::microseconds hit_latency_total{0};
+  std::chrono::microseconds hit_latency_max{0};
+  std::chrono::microseconds miss_latency_total{0};
+  std::chrono::microseconds miss_latency_max{0};
+  // Percentiles over a uniform sample of at most kLatencySamples runs each
+  std::chrono::microseconds hit_latency_p50{0};
+  std::chrono::microseconds hit_latency_p90{0};
+  std::chrono::microseconds hit_latency_p99{0};
+  std::chrono::microseconds miss_latency_p50{0};
+  std::chrono::microseconds miss_latency_p90{0};
+  std::chrono::microseconds miss_latency_p99{0};
+
+  static constexpr size_t kLatencySamples = 1024;
+
+  double HitRate() const {
+    return hits + misses == 0 ? 0.0 : double(hits) / double(hits + misses);
+  }
+};
+
+/// Runs a model whose input shapes vary between calls.
+///
+/// The builder creates the graph for given input shapes, compiled graphs are
+/// kept in an LRU keyed by the (bucketed) input shapes. All specializations
+/// are built in one context, so kernel programs built for one of them are
+/// reused by the others.
+class ShapeFamily {
+ public:
+  using Builder = std::function<std::shared_ptr<Graph>(
+      const std::shared_ptr<Context>& context,
+      const std::vector<ShapeType>& input_shapes)>;
+  // Shape of output `index` for the unpadded `input_shapes`. Needed to crop
+  // outputs when bucketing pads the inputs.
+  using OutputShapeFunc = std::function<ShapeType(
+      size_t index, const std::vector<ShapeType>& input_shapes)>;
+
+  struct Input {
+    ShapeType shape;
+    const void* data;
+  };
+  struct Output {
+    ShapeType shape;
+    std::vector<char> data;
+  };
+
+  /// A shared context is created if `context` is nullptr
+  ShapeFamily(const Builder& builder,
+              const ShapeFamilyOptions& options = ShapeFamilyOptions(),
+              const OutputShapeFunc& output_shape = nullptr,
+              const std::shared_ptr<Context>& context = nullptr);
+
+  /// Run the specialization for the shapes of `inputs`, building and
+  /// compiling it on first use. Thread safe: a shape is built once while
+  /// callers of the same shape wait for it, runs of one specialization are
+  /// serialized and different specializations run concurrently.
+  bool Run(const std::vector<Input>& inputs, std::vector<Output>& outputs);
+
+  ShapeFamilyStats GetStats() const;
+  size_t Size() const;
+
+ private:
+  using Key = std::vector<ShapeType>;
+  struct Specialization {
+    std::shared_ptr<Graph> graph;
+    // Cleared once the builder returned, graph stays nullptr if it failed
+    bool building{true};
+    // Held while inputs are copied in, the graph runs and outputs copied out
+    std::mutex run_mutex;
+  };
+  struct Entry {
+    Key key;
+    std::shared_ptr<Specialization> specialization;
+  };
+  // Uniform sample of run latencies (reservoir sampling)
+  struct LatencySample {
+    std::vector<std::chrono::microseconds> values;
+    uint64_t seen{0};
+
+    void Add(std::chrono::microseconds latency, uint32_t* seed);
+    std::chrono::microseconds Percentile(uint32_t percent) const;
+  };
+
+  Key BucketShapes(const std::vector<Input>& inputs) const;
+  /// Returns the built specialization of `key`, nullptr if building failed
+  std::shared_ptr<Specialization> Lookup(const Key& key, bool* hit);
+  bool RunSpecialization(Graph* graph, const Key& key,
+                         const std::vector<Input>& inputs,
+                         std::vector<Output>& outputs);
+  void Record(bool hit, std::chrono::microseconds latency);
+
+  Builder builder_;
+  ShapeFamilyOptions options_;
+  OutputShapeFunc output_shape_;
+  std::shared_ptr<Context> context_;
+
+  // Guards the LRU and the statistics, never held while building or running
+  mutable std::mutex mutex_;
+  std::condition_variable built_;
+  // Most recently used first
+  std::list<Entry> lru_;
+  std::map<Key, std::list<Entry>::iterator> index_;
+  ShapeFamilyStats stats_;
+  LatencySample hit_latency_;
+  LatencySample miss_latency_;
+  uint32_t sample_seed_{1};
+};
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_SHAPE_FAMILY_H_ */
@@ -118,8 +118,12 @@ struct TensorSpec {
 
   int64_t GetElementNum() const;
 
+  int64_t GetElementBitSize() const;
+
+  /// Rounded up to a whole byte for INT4 and UINT4
   int64_t GetElementByteSize() const;
 
+  /// Packed size of sub-byte types
   int64_t GetByteSize() const;
 
   inline DataType& GetDataType() { return datatype_; }
@@ -162,6 +166,11 @@ class Tensor {
 namespace utils{
   bool Float32ToDtype(std::shared_ptr<tim::vx::Tensor> tensor, std::vector<float> fval, uint8_t* tensorData);
   bool DtypeToFloat32(std::shared_ptr<tim::vx::Tensor> tensor, uint8_t* tensorData, float* data);
+  /// Packs one 4-bit value per byte of `src` into the INT4/UINT4 layout
+  void Pack4Bit(const uint8_t* src, uint8_t* dst, const ShapeType& shape);
+  /// Reverse of Pack4Bit, INT4 values are sign extended
+  void Unpack4Bit(const uint8_t* src, uint8_t* dst, const ShapeType& shape,
+                  bool is_signed);
 }  //namespace utils
 }  // namespace vx
 }  // namespace tim
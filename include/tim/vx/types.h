@@ -38,7 +38,12 @@ enum class DataType {
   INT64,
   FLOAT16,
   FLOAT32,
-  BOOL8
+  BOOL8,
+  /// 4-bit integers, two per byte with the lower index in the low nibble.
+  /// Each row of shape[0] elements starts on a byte boundary.
+  INT4,
+  UINT4,
+  BFLOAT16
 };
 
 enum class QuantType { NONE, ASYMMETRIC, SYMMETRIC_PER_CHANNEL, DYNAMIC_FIXED_POINT };
@@ -0,0 +1,162 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Times causal self attention as the fused ScaledDotProductAttention op and
+ * as the unfused Matmul -> Multiply -> Add -> Softmax -> Matmul chain, which
+ * writes the whole [seq, seq, heads] score matrix between its ops.
+ *
+ *   attention_benchmark [head_dim] [heads] [loops]
+ *
+ * Sequence lengths 128 to 2048 are measured.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/ops/matmul.h"
+#include "tim/vx/ops/scaled_dot_product_attention.h"
+#include "tim/vx/ops/softmax.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+bool RunAttention(bool fused, uint32_t head_dim, uint32_t seq, uint32_t heads,
+                  uint32_t loops, double* ms_per_run) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType qkv_shape({head_dim, seq, heads});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT16, qkv_shape,
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT16, qkv_shape,
+                                    tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec score_spec(tim::vx::DataType::FLOAT16,
+                                   {seq, seq, heads},
+                                   tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec scale_spec(tim::vx::DataType::FLOAT32, {1},
+                                   tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec mask_spec(tim::vx::DataType::FLOAT32, {seq, seq, 1},
+                                  tim::vx::TensorAttribute::CONSTANT);
+
+    auto query = graph->CreateTensor(input_spec);
+    auto key = graph->CreateTensor(input_spec);
+    auto value = graph->CreateTensor(input_spec);
+    auto output = graph->CreateTensor(output_spec);
+
+    float scale = 1.0f / std::sqrt(static_cast<float>(head_dim));
+    std::vector<float> mask(seq * seq, 0.0f);
+    for (uint32_t i = 0; i < seq; ++i) {
+        for (uint32_t j = i + 1; j < seq; ++j) {
+            mask[i * seq + j] = -65504.0f;
+        }
+    }
+
+    if (fused) {
+        graph->CreateOperation<tim::vx::ops::ScaledDotProductAttention>(
+                 scale, true)
+            ->BindInputs({query, key, value})
+            .BindOutputs({output});
+    } else {
+        auto scores = graph->CreateTensor(score_spec);
+        auto scaled = graph->CreateTensor(score_spec);
+        auto masked = graph->CreateTensor(score_spec);
+        auto probs = graph->CreateTensor(score_spec);
+        auto scale_tensor = graph->CreateTensor(scale_spec, &scale);
+        auto mask_tensor = graph->CreateTensor(mask_spec, mask.data());
+        graph->CreateOperation<tim::vx::ops::Matmul>(false, true)
+            ->BindInputs({query, key})
+            .BindOutputs({scores});
+        graph->CreateOperation<tim::vx::ops::Multiply>()
+            ->BindInputs({scores, scale_tensor})
+            .BindOutputs({scaled});
+        graph->CreateOperation<tim::vx::ops::Add>()
+            ->BindInputs({scaled, mask_tensor})
+            .BindOutputs({masked});
+        graph->CreateOperation<tim::vx::ops::Softmax>(1.0f, 0)
+            ->BindInputs({masked})
+            .BindOutputs({probs});
+        graph->CreateOperation<tim::vx::ops::Matmul>()
+            ->BindInputs({probs, value})
+            .BindOutputs({output});
+    }
+
+    if (!graph->Compile()) {
+        std::cout << "Compile graph fail." << std::endl;
+        return false;
+    }
+    std::vector<uint16_t> input(input_spec.GetElementNum(), 0x3c00);
+    for (auto& tensor : {query, key, value}) {
+        if (!tensor->CopyDataToTensor(input.data(),
+                                      input.size() * sizeof(uint16_t))) {
+            std::cout << "Copy input fail." << std::endl;
+            return false;
+        }
+    }
+    if (!graph->Run()) {
+        std::cout << "Run graph fail." << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        graph->Run();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    *ms_per_run =
+        std::chrono::duration<double, std::milli>(end - start).count() /
+        loops;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t head_dim = argc > 1 ? std::atoi(argv[1]) : 64;
+    uint32_t heads = argc > 2 ? std::atoi(argv[2]) : 8;
+    uint32_t loops = argc > 3 ? std::atoi(argv[3]) : 10;
+    if (loops == 0) loops = 1;
+
+    std::cout << "causal attention, head_dim " << head_dim << ", " << heads
+              << " heads, " << loops << " runs" << std::endl;
+    for (uint32_t seq = 128; seq <= 2048; seq *= 2) {
+        double fused = 0, unfused = 0;
+        if (!RunAttention(false, head_dim, seq, heads, loops, &unfused) ||
+            !RunAttention(true, head_dim, seq, heads, loops, &fused)) {
+            return -1;
+        }
+        std::cout << "seq " << seq << ": unfused " << unfused
+                  << " ms, fused " << fused << " ms, speedup "
+                  << unfused / fused << "x, score matrix "
+                  << static_cast<uint64_t>(seq) * seq * heads * 2
+                  << " bytes" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/pool2d.h"
+#include "tim/vx/platform/batch_scheduler.h"
+#include "tim/vx/platform/native.h"
+#include "tim/vx/tensor.h"
+
+using tim::vx::platform::BatchScheduler;
+using tim::vx::platform::BatchSchedulerOptions;
+
+namespace {
+
+const uint32_t kChannels = 16;
+
+// conv/relu/pool on a 28x28 single channel image, batch outermost
+std::shared_ptr<tim::vx::Graph> BuildGraph(
+    const std::shared_ptr<tim::vx::Context>& context, uint32_t batch) {
+    auto graph = context->CreateGraph();
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32,
+                                   {28, 28, 1, batch},
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32,
+                                    {3, 3, 1, kChannels},
+                                    tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {kChannels},
+                                  tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {},
+                                       tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32,
+                                    {14, 14, kChannels, batch},
+                                    tim::vx::TensorAttribute::OUTPUT);
+
+    static std::vector<float> weight_data(3 * 3 * kChannels, 0.1f);
+    static std::vector<float> bias_data(kChannels, 0.0f);
+    auto input = graph->CreateTensor(input_spec);
+    auto weight = graph->CreateTensor(weight_spec, weight_data.data());
+    auto bias = graph->CreateTensor(bias_spec, bias_data.data());
+    auto conv_out = graph->CreateTensor(transient_spec);
+    auto relu_out = graph->CreateTensor(transient_spec);
+    auto output = graph->CreateTensor(output_spec);
+
+    auto conv = graph->CreateOperation<tim::vx::ops::Conv2d>(
+        kChannels, tim::vx::PadType::SAME, std::array<uint32_t, 2>({3, 3}),
+        std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+    (*conv).BindInputs({input, weight, bias}).BindOutput(conv_out);
+    (*graph->CreateOperation<tim::vx::ops::Relu>())
+        .BindInput(conv_out)
+        .BindOutput(relu_out);
+    (*graph->CreateOperation<tim::vx::ops::Pool2d>(
+         tim::vx::PoolType::MAX, tim::vx::PadType::VALID,
+         std::array<uint32_t, 2>({2, 2}), std::array<uint32_t, 2>({2, 2})))
+        .BindInput(relu_out)
+        .BindOutput(output);
+    return graph;
+}
+
+// Every thread submits one request at a time, like independent clients
+void RunLoad(const std::string& name,
+             const std::shared_ptr<tim::vx::platform::IExecutor>& executor,
+             const BatchSchedulerOptions& options, int threads,
+             int requests) {
+    auto scheduler = BatchScheduler::Create(executor, BuildGraph, options);
+    if (!scheduler) {
+        std::cout << name << ": create scheduler failed" << std::endl;
+        return;
+    }
+
+    std::atomic<int> failures(0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> clients;
+    for (int t = 0; t < threads; ++t) {
+        clients.emplace_back([&]() {
+            BatchScheduler::Sample sample = {
+                std::vector<char>(scheduler->InputSizes()[0], 1)};
+            for (int i = 0; i < requests; ++i) {
+                try {
+                    scheduler->Submit(sample).get();
+                } catch (const std::exception&) {
+                    ++failures;
+                }
+            }
+        });
+    }
+    for (auto& client : clients) client.join();
+    auto end = std::chrono::steady_clock::now();
+    scheduler->Shutdown();
+
+    auto stats = scheduler->GetStats();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    std::cout << name << ": " << stats.requests / seconds << " req/s, "
+              << stats.batches << " batches, " << failures << " failures"
+              << std::endl;
+    std::cout << "  queue p50/p99 : "
+              << stats.queue_latency.Percentile(50).count() << " / "
+              << stats.queue_latency.Percentile(99).count() << " us"
+              << std::endl;
+    std::cout << "  exec  p50/p99 : "
+              << stats.exec_latency.Percentile(50).count() << " / "
+              << stats.exec_latency.Percentile(99).count() << " us"
+              << std::endl;
+    for (const auto& runs : stats.batch_size_runs) {
+        std::cout << "  batch " << runs.first << " x " << runs.second
+                  << std::endl;
+    }
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int threads = argc > 1 ? std::atoi(argv[1]) : 16;
+    int requests = argc > 2 ? std::atoi(argv[2]) : 100;
+
+    auto devices = tim::vx::platform::NativeDevice::Enumerate();
+    if (devices.empty()) {
+        std::cout << "No device found" << std::endl;
+        return -1;
+    }
+    auto executor =
+        std::make_shared<tim::vx::platform::NativeExecutor>(devices[0]);
+
+    BatchSchedulerOptions unbatched;
+    unbatched.batch_sizes = {1};
+    unbatched.max_batch_size = 1;
+    RunLoad("batch 1", executor, unbatched, threads, requests);
+
+    BatchSchedulerOptions batched;
+    RunLoad("batch 1-16", executor, batched, threads, requests);
+    return 0;
+}
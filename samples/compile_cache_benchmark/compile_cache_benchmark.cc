@@ -0,0 +1,125 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tim/vx/compile_option.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/ops/pool2d.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+// A small conv/relu/pool stack, big enough that driver side compilation
+// dominates the start up time
+std::shared_ptr<tim::vx::Graph> BuildGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx,
+    const tim::vx::CompileOption& option) {
+    auto graph = ctx->CreateGraph(option);
+    const uint32_t channels = 16;
+    const uint32_t layers = 4;
+    tim::vx::ShapeType shape({64, 64, channels, 1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                   tim::vx::TensorAttribute::INPUT);
+    auto input = graph->CreateTensor(input_spec);
+
+    std::vector<float> weight_data(3 * 3 * channels * channels, 0.01f);
+    std::vector<float> bias_data(channels, 0.0f);
+    tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32,
+                                    {3, 3, channels, channels},
+                                    tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {channels},
+                                  tim::vx::TensorAttribute::CONSTANT);
+
+    auto current = input;
+    for (uint32_t i = 0; i < layers; ++i) {
+        auto weight = graph->CreateTensor(weight_spec, weight_data.data());
+        auto bias = graph->CreateTensor(bias_spec, bias_data.data());
+        tim::vx::TensorSpec conv_spec(tim::vx::DataType::FLOAT32, shape,
+                                      tim::vx::TensorAttribute::TRANSIENT);
+        auto conv_out = graph->CreateTensor(conv_spec);
+        auto conv = graph->CreateOperation<tim::vx::ops::Conv2d>(
+            channels, tim::vx::PadType::SAME, std::array<uint32_t, 2>({3, 3}),
+            std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+        (*conv).BindInputs({current, weight, bias}).BindOutput(conv_out);
+
+        auto relu_out = graph->CreateTensor(conv_spec);
+        auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+        (*relu).BindInput(conv_out).BindOutput(relu_out);
+        current = relu_out;
+    }
+
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32,
+                                    {32, 32, channels, 1},
+                                    tim::vx::TensorAttribute::OUTPUT);
+    auto output = graph->CreateTensor(output_spec);
+    auto pool = graph->CreateOperation<tim::vx::ops::Pool2d>(
+        tim::vx::PoolType::MAX, tim::vx::PadType::VALID,
+        std::array<uint32_t, 2>({2, 2}), std::array<uint32_t, 2>({2, 2}));
+    (*pool).BindInput(current).BindOutput(output);
+    return graph;
+}
+
+double TimeCompile(const std::shared_ptr<tim::vx::Context>& ctx,
+                   const tim::vx::CompileOption& option) {
+    auto start = std::chrono::high_resolution_clock::now();
+    auto graph = BuildGraph(ctx, option);
+    if (!graph->Compile()) {
+        std::cout << "Compile fail" << std::endl;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string cache_dir = "/tmp";
+    if (argc > 1) {
+        cache_dir = argv[1];
+    }
+
+    auto ctx = tim::vx::Context::Create();
+    tim::vx::CompileOption no_cache;
+    tim::vx::CompileOption with_cache;
+    with_cache.setCompileCacheDir(cache_dir);
+
+    double uncached_ms = TimeCompile(ctx, no_cache);
+    // First run with a cache dir may miss and populate the cache,
+    // the second one is expected to hit it
+    double cold_ms = TimeCompile(ctx, with_cache);
+    double warm_ms = TimeCompile(ctx, with_cache);
+
+    std::cout << "Cache dir        : " << cache_dir << std::endl;
+    std::cout << "No cache         : " << uncached_ms << " ms" << std::endl;
+    std::cout << "Cold (populate)  : " << cold_ms << " ms" << std::endl;
+    std::cout << "Warm (cache hit) : " << warm_ms << " ms" << std::endl;
+    return 0;
+}
@@ -0,0 +1,175 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+/*
+ * Times the host CPU kernels of the custom ovxlib ops. The worker pool size
+ * is fixed per process, compare against a run with VSI_NN_CPU_THREAD_NUM=1.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "vsi_nn_pub.h"
+#include "kernel/vsi_nn_kernel_cpu.h"
+
+namespace {
+
+const uint32_t kWidth = 640;
+const uint32_t kHeight = 480;
+const uint32_t kChannels = 3;
+
+vsi_nn_tensor_id_t AddTensor(vsi_nn_graph_t* graph, vsi_nn_type_e dtype,
+                             vsi_bool is_const, const void* data) {
+    vsi_nn_tensor_attr_t attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.dim_num = 3;
+    attr.size[0] = kWidth;
+    attr.size[1] = kHeight;
+    attr.size[2] = kChannels;
+    attr.dtype.vx_type = dtype;
+    if (dtype == VSI_NN_TYPE_UINT8) {
+        attr.dtype.qnt_type = VSI_NN_QNT_TYPE_AFFINE_ASYMMETRIC;
+        attr.dtype.scale = 1.0f;
+        attr.dtype.zero_point = 0;
+    }
+    attr.is_const = is_const;
+    attr.vtl = FALSE;
+    return vsi_nn_AddTensor(graph, VSI_NN_TENSOR_ID_AUTO, &attr,
+                            (uint8_t*)data);
+}
+
+typedef void (*NodeInit)(vsi_nn_node_t* node);
+
+/* Builds input -> op -> output and reports the average run time. */
+bool Bench(const char* name, vsi_nn_context_t ctx, vsi_nn_op_t op,
+           vsi_nn_type_e dtype, uint32_t input_num, NodeInit init,
+           int iterations) {
+    std::vector<uint8_t> input(kWidth * kHeight * kChannels * 4, 1);
+    float addend = 1.0f;
+    vsi_nn_graph_t* graph = vsi_nn_CreateGraph(ctx, 4, 1);
+    vsi_nn_node_t* node = vsi_nn_AddNode(graph, op, input_num, 1, NULL);
+    node->input.tensors[0] = AddTensor(graph, dtype, FALSE, NULL);
+    if (input_num > 1) {
+        vsi_nn_tensor_attr_t attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.dim_num = 1;
+        attr.size[0] = 1;
+        attr.dtype.vx_type = VSI_NN_TYPE_FLOAT32;
+        attr.is_const = TRUE;
+        node->input.tensors[1] = vsi_nn_AddTensor(
+            graph, VSI_NN_TENSOR_ID_AUTO, &attr, (uint8_t*)&addend);
+    }
+    node->output.tensors[0] = AddTensor(graph, dtype, FALSE, NULL);
+    init(node);
+
+    vsi_nn_tensor_id_t graph_input = node->input.tensors[0];
+    vsi_nn_tensor_id_t graph_output = node->output.tensors[0];
+    bool ok = vsi_nn_SetGraphInputs(graph, &graph_input, 1) &&
+              vsi_nn_SetGraphOutputs(graph, &graph_output, 1) &&
+              VSI_SUCCESS == vsi_nn_SetupGraph(graph, FALSE) &&
+              VSI_SUCCESS == vsi_nn_VerifyGraph(graph);
+    if (ok) {
+        vsi_nn_CopyDataToTensor(graph,
+                                vsi_nn_GetTensor(graph, graph_input),
+                                input.data());
+        ok = VSI_SUCCESS == vsi_nn_RunGraph(graph);
+    }
+    if (ok) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations && ok; ++i) {
+            ok = VSI_SUCCESS == vsi_nn_RunGraph(graph);
+        }
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << name << ": "
+                  << std::chrono::duration<double, std::milli>(end - start)
+                             .count() / iterations
+                  << " ms" << std::endl;
+    } else {
+        std::cout << name << ": failed" << std::endl;
+    }
+    vsi_nn_ReleaseGraph(&graph);
+    return ok;
+}
+
+const float kAffine[6] = {0.9f, 0.1f, -0.1f, 0.9f, 12.0f, -7.0f};
+const float kPerspective[9] = {0.9f, 0.1f, 0.0001f, -0.1f, 0.9f,
+                               0.0002f, 12.0f, -7.0f, 1.0f};
+
+void InitAffineNearest(vsi_nn_node_t* node) {
+    node->nn_param.custom_warp_affine.matrix = kAffine;
+    node->nn_param.custom_warp_affine.type =
+        VSI_NN_INTERPOLATION_NEAREST_NEIGHBOR;
+}
+
+void InitAffineBilinear(vsi_nn_node_t* node) {
+    node->nn_param.custom_warp_affine.matrix = kAffine;
+    node->nn_param.custom_warp_affine.type = VSI_NN_INTERPOLATION_BILINEAR;
+}
+
+void InitPerspective(vsi_nn_node_t* node) {
+    node->nn_param.custom_warp_perspective.matrix = kPerspective;
+    node->nn_param.custom_warp_perspective.type =
+        VSI_NN_INTERPOLATION_BILINEAR;
+}
+
+void InitSoftmax(vsi_nn_node_t* node) {
+    node->nn_param.custom_softmax.axis = 0;
+}
+
+void InitSample(vsi_nn_node_t* node) {
+    node->nn_param.custom_sample.axis = 0;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 20;
+    vsi_nn_context_t ctx = vsi_nn_CreateContext();
+    bool ok = true;
+
+    std::cout << "CPU kernel threads: " << vsi_nn_kernel_cpu_get_thread_num()
+              << std::endl;
+    const vsi_nn_type_e dtypes[] = {VSI_NN_TYPE_FLOAT32, VSI_NN_TYPE_UINT8};
+    for (vsi_nn_type_e dtype : dtypes) {
+        bool u8 = dtype == VSI_NN_TYPE_UINT8;
+        ok = Bench(u8 ? "warp_affine nearest u8" : "warp_affine nearest f32",
+                   ctx, VSI_NN_OP_CUSTOM_WARP_AFFINE, dtype, 1,
+                   InitAffineNearest, iterations) && ok;
+        ok = Bench(u8 ? "warp_affine bilinear u8" : "warp_affine bilinear f32",
+                   ctx, VSI_NN_OP_CUSTOM_WARP_AFFINE, dtype, 1,
+                   InitAffineBilinear, iterations) && ok;
+        ok = Bench(u8 ? "warp_perspective u8" : "warp_perspective f32", ctx,
+                   VSI_NN_OP_CUSTOM_WARP_PERSPECTIVE, dtype, 1,
+                   InitPerspective, iterations) && ok;
+        ok = Bench(u8 ? "softmax u8" : "softmax f32", ctx,
+                   VSI_NN_OP_CUSTOM_SOFTMAX, dtype, 1, InitSoftmax,
+                   iterations) && ok;
+        ok = Bench(u8 ? "sample u8" : "sample f32", ctx,
+                   VSI_NN_OP_CUSTOM_SAMPLE, dtype, 2, InitSample,
+                   iterations) && ok;
+    }
+    vsi_nn_ReleaseContext(&ctx);
+    return ok ? 0 : -1;
+}
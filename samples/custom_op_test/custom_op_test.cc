@@ -25,6 +25,7 @@
 #include "tim/vx/graph.h"
 #include "tim/vx/ops.h"
 #include "custom_gemm.h"
+#include <chrono>
 #include <tuple>
 
 void custom_gemm_single_test(){
@@ -234,9 +235,45 @@ void custom_gemm_op_and_custom_gemm_op_test(){
     std::cout<<std::endl; 
 }
 
+void custom_gemm_chain_setup_time_test(uint32_t chain_len){
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType shape({2, 2});
+    tim::vx::TensorSpec in_spec(tim::vx::DataType::FLOAT32,
+                    shape, tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec mid_spec(tim::vx::DataType::FLOAT32,
+                    shape, tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec out_spec(tim::vx::DataType::FLOAT32,
+                    shape, tim::vx::TensorAttribute::OUTPUT);
+
+    auto weight_tensor = graph->CreateTensor(in_spec);
+    auto cur_tensor = graph->CreateTensor(in_spec);
+    tim::vx::ops::CustomGemm::ParamTuple tuple_list(2,2,2,0,0,1.0,0,1.0,0,1.0,0);
+
+    // Every instance shares one kernel, only the first one builds the program
+    for(uint32_t i=0;i<chain_len;i++){
+        auto next_tensor = graph->CreateTensor(
+            i + 1 == chain_len ? out_spec : mid_spec);
+        auto op_gemm = graph->CreateOperation<tim::vx::ops::CustomGemm>(
+            false,false,tuple_list);
+        (*op_gemm).BindInputs({cur_tensor, weight_tensor}).BindOutputs({next_tensor});
+        cur_tensor = next_tensor;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    graph->Compile();
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout<<"setup "<<chain_len<<" custom gemm ops: "
+             <<std::chrono::duration<double, std::milli>(end - start).count()
+             <<" ms"<<std::endl;
+}
+
 int main(){
     custom_gemm_single_test();
     custom_gemm_op_and_add_op_test();
     custom_gemm_op_and_custom_gemm_op_test();
+    custom_gemm_chain_setup_time_test(1);
+    custom_gemm_chain_setup_time_test(32);
     return 1;
 }
\ No newline at end of file
@@ -0,0 +1,150 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "tim/vx/detection_post_process.h"
+
+namespace {
+
+void RandomBoxes(uint32_t count, std::vector<float>& boxes,
+                 std::vector<float>& scores) {
+    std::mt19937 rng(count);
+    std::uniform_real_distribution<float> pos(0.0f, 600.0f);
+    std::uniform_real_distribution<float> size(8.0f, 80.0f);
+    std::uniform_real_distribution<float> score(0.0f, 1.0f);
+    boxes.resize(count * 4);
+    scores.resize(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        boxes[i * 4 + 0] = pos(rng);
+        boxes[i * 4 + 1] = pos(rng);
+        boxes[i * 4 + 2] = boxes[i * 4 + 0] + size(rng);
+        boxes[i * 4 + 3] = boxes[i * 4 + 1] + size(rng);
+        scores[i] = score(rng);
+    }
+}
+
+// The previous faster-rcnn path: interleaved boxes, full sort, IoU with a
+// division and early-outs, scratch allocated per call
+uint32_t BaselineNms(const std::vector<float>& boxes,
+                     const std::vector<float>& scores, float thresh) {
+    uint32_t count = static_cast<uint32_t>(scores.size());
+    std::vector<float> dets(count * 5);
+    for (uint32_t i = 0; i < count; ++i) {
+        std::copy(&boxes[i * 4], &boxes[i * 4 + 4], &dets[i * 5]);
+        dets[i * 5 + 4] = scores[i];
+    }
+    std::vector<uint32_t> order(count);
+    for (uint32_t i = 0; i < count; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return dets[a * 5 + 4] > dets[b * 5 + 4];
+    });
+    std::vector<uint32_t> is_dead(count, 0);
+    uint32_t kept = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (is_dead[i]) continue;
+        ++kept;
+        const float* a = &dets[order[i] * 5];
+        for (uint32_t j = i + 1; j < count; ++j) {
+            const float* b = &dets[order[j] * 5];
+            if (is_dead[j] || a[0] > b[2] || a[1] > b[3] || a[2] < b[0] ||
+                a[3] < b[1]) {
+                continue;
+            }
+            float w = std::max(0.0f, std::min(a[2], b[2]) -
+                                         std::max(a[0], b[0]) + 1.0f);
+            float h = std::max(0.0f, std::min(a[3], b[3]) -
+                                         std::max(a[1], b[1]) + 1.0f);
+            float inter = w * h;
+            float area_a = (a[2] - a[0] + 1.0f) * (a[3] - a[1] + 1.0f);
+            float area_b = (b[2] - b[0] + 1.0f) * (b[3] - b[1] + 1.0f);
+            if (inter / (area_a + area_b - inter) > thresh) is_dead[j] = 1;
+        }
+    }
+    return kept;
+}
+
+template <typename Func>
+double TimeMs(int iterations, Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() /
+           iterations;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 5;
+    const uint32_t counts[] = {1000, 5000, 10000, 20000, 50000};
+    tim::vx::DetectionPostProcessor processor;
+    tim::vx::NmsOptions options;
+    options.iou_threshold = 0.45f;
+    options.pixel_inclusive = true;
+    options.max_detections = 50000;
+
+    std::cout << "boxes\tbaseline ms\tnms ms\ttop-1000 ms\tkept" << std::endl;
+    for (uint32_t count : counts) {
+        std::vector<float> boxes, scores;
+        RandomBoxes(count, boxes, scores);
+
+        uint32_t baseline_kept = 0;
+        double baseline_ms = TimeMs(iterations, [&]() {
+            baseline_kept = BaselineNms(boxes, scores, options.iou_threshold);
+        });
+
+        options.pre_nms_top_k = 0;
+        std::vector<tim::vx::Detection> detections;
+        bool ok = true;
+        double nms_ms = TimeMs(iterations, [&]() {
+            ok &= processor.Nms(boxes.data(), scores.data(), count, options,
+                                detections);
+        });
+        size_t kept = detections.size();
+
+        options.pre_nms_top_k = 1000;
+        double top_k_ms = TimeMs(iterations, [&]() {
+            ok &= processor.Nms(boxes.data(), scores.data(), count, options,
+                                detections);
+        });
+        if (!ok) {
+            std::cout << "nms failed for " << count << " boxes" << std::endl;
+            return -1;
+        }
+
+        std::cout << count << "\t" << baseline_ms << "\t" << nms_ms << "\t"
+                  << top_k_ms << "\t" << kept << std::endl;
+        if (kept != baseline_kept) {
+            std::cout << "mismatch with baseline: " << baseline_kept
+                      << std::endl;
+            return -1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,162 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+/*
+ * Runs the topology of samples/multi_device/multi_device_demo.cc
+ *
+ *         -->g1--g2-->
+ *    g0-->|           |-->g5
+ *         -->g3--g4-->
+ *
+ * through NativeExecutor. Executables stand in for NBG runs by sleeping
+ * for a fixed time on a simulated device, so the numbers show scheduling
+ * and not device speed. The serial column is the old one at a time order.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tim/vx/platform/native.h"
+
+using tim::vx::platform::IDevice;
+using tim::vx::platform::IExecutable;
+using tim::vx::platform::IExecutor;
+using tim::vx::platform::ITensorHandle;
+using tim::vx::platform::NativeExecutor;
+
+namespace {
+
+class SimulatedDevice : public IDevice {
+ public:
+    explicit SimulatedDevice(device_id_t id) { device_id_ = id; }
+    bool Submit(const std::shared_ptr<tim::vx::Graph>& graph) override {
+        (void)graph;
+        return true;
+    }
+    bool Trigger(bool async = false, async_callback cb = NULL) override {
+        (void)async;
+        (void)cb;
+        return true;
+    }
+    void WaitDeviceIdle() override {}
+    bool DeviceExit() override { return true; }
+};
+
+class SimulatedExecutable : public IExecutable {
+ public:
+    SimulatedExecutable(const std::shared_ptr<IExecutor>& executor,
+                        std::chrono::microseconds duration)
+        : duration_(duration) {
+        executor_ = executor;
+    }
+    void SetInput(const std::shared_ptr<ITensorHandle>& th) override {
+        (void)th;
+    }
+    void SetOutput(const std::shared_ptr<ITensorHandle>& th) override {
+        (void)th;
+    }
+    void GetOutput(
+        const std::vector<std::shared_ptr<ITensorHandle>>& th) override {
+        (void)th;
+    }
+    bool Submit(const std::shared_ptr<IExecutable>& ref,
+                bool after = true) override {
+        return Executor()->Submit(shared_from_this(), ref, after);
+    }
+    bool Trigger(bool async = false) override {
+        (void)async;
+        std::this_thread::sleep_for(duration_);
+        return true;
+    }
+    bool Verify() override { return true; }
+    std::shared_ptr<ITensorHandle> AllocateTensor(
+        const tim::vx::TensorSpec& tensor_spec) override {
+        (void)tensor_spec;
+        return nullptr;
+    }
+
+ private:
+    std::chrono::microseconds duration_;
+};
+
+/* Average ms per run of the demo graph, the g3/g4 branch on executor1 */
+double RunDemo(const std::shared_ptr<NativeExecutor>& executor0,
+               const std::shared_ptr<NativeExecutor>& executor1,
+               std::chrono::microseconds duration, int iterations,
+               bool serial) {
+    std::vector<std::shared_ptr<IExecutable>> g;
+    for (int i = 0; i < 6; ++i) {
+        auto executor = (i == 3 || i == 4) ? executor1 : executor0;
+        g.push_back(std::make_shared<SimulatedExecutable>(executor, duration));
+    }
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        if (serial) {
+            for (auto& executable : g) {
+                executable->Trigger();
+            }
+            continue;
+        }
+        executor0->Submit(g[0], g[0]);
+        executor0->Submit(g[1], g[0]);
+        executor0->Submit(g[2], g[1]);
+        executor0->Submit(g[3], g[0]);
+        executor0->Submit(g[4], g[3]);
+        executor0->Submit(g[5], g[2]);
+        executor0->Submit(g[5], g[4]);
+        executor0->Trigger();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() /
+           iterations;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+    auto executor0 = std::make_shared<NativeExecutor>(
+        std::make_shared<SimulatedDevice>(0), nullptr);
+    auto executor1 = std::make_shared<NativeExecutor>(
+        std::make_shared<SimulatedDevice>(1), nullptr);
+    const int durations_us[] = {0, 1000, 5000};
+
+    std::cout << "run us\tdevices\tserial ms\tdag ms" << std::endl;
+    for (int us : durations_us) {
+        std::chrono::microseconds duration(us);
+        std::cout << us << "\t1\t"
+                  << RunDemo(executor0, executor0, duration, iterations, true)
+                  << "\t"
+                  << RunDemo(executor0, executor0, duration, iterations, false)
+                  << std::endl;
+        std::cout << us << "\t2\t"
+                  << RunDemo(executor0, executor1, duration, iterations, true)
+                  << "\t"
+                  << RunDemo(executor0, executor1, duration, iterations, false)
+                  << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,114 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/fullyconnected.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+const uint32_t kWidth = 1024;
+const uint32_t kLayers = 8;
+
+// A stack of fully connected layers, 32MB of float weights so that loading
+// the constants dominates graph construction
+std::shared_ptr<tim::vx::Graph> BuildGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx,
+    const std::vector<float>& weight_data) {
+    auto graph = ctx->CreateGraph();
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {kWidth, 1},
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32,
+                                    {kWidth, kWidth},
+                                    tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {},
+                                       tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {kWidth, 1},
+                                    tim::vx::TensorAttribute::OUTPUT);
+
+    auto current = graph->CreateTensor(input_spec);
+    for (uint32_t i = 0; i < kLayers; ++i) {
+        auto weight = graph->CreateTensor(weight_spec, weight_data.data());
+        auto fc_out = graph->CreateTensor(transient_spec);
+        auto fc = graph->CreateOperation<tim::vx::ops::FullyConnected>(
+            0, kWidth);
+        (*fc).BindInputs({current, weight}).BindOutput(fc_out);
+
+        auto relu_out = i + 1 == kLayers ? graph->CreateTensor(output_spec)
+                                         : graph->CreateTensor(transient_spec);
+        auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+        (*relu).BindInput(fc_out).BindOutput(relu_out);
+        current = relu_out;
+    }
+    return graph;
+}
+
+template <typename Func>
+double TimeMs(Func func) {
+    auto start = std::chrono::high_resolution_clock::now();
+    func();
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string path = "/tmp/graph_serialization_benchmark.timg";
+    if (argc > 1) {
+        path = argv[1];
+    }
+
+    auto ctx = tim::vx::Context::Create();
+    std::vector<float> weight_data(kWidth * kWidth, 0.001f);
+    if (!BuildGraph(ctx, weight_data)->Serialize(path)) {
+        std::cout << "Serialize fail" << std::endl;
+        return -1;
+    }
+
+    std::shared_ptr<tim::vx::Graph> graph;
+    double build_ms = TimeMs([&]() { graph = BuildGraph(ctx, weight_data); });
+    double build_compile_ms = build_ms + TimeMs([&]() { graph->Compile(); });
+    double load_ms = TimeMs([&]() { graph = ctx->LoadGraph(path); });
+    if (!graph) {
+        std::cout << "Load fail" << std::endl;
+        return -1;
+    }
+    double load_compile_ms = load_ms + TimeMs([&]() { graph->Compile(); });
+
+    std::cout << "File                   : " << path << std::endl;
+    std::cout << "Build from code        : " << build_ms << " ms" << std::endl;
+    std::cout << "Build from code+compile: " << build_compile_ms << " ms"
+              << std::endl;
+    std::cout << "LoadGraph              : " << load_ms << " ms" << std::endl;
+    std::cout << "LoadGraph+compile      : " << load_compile_ms << " ms"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,153 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+/*
+ * Times a bandwidth bound fully connected layer, the single token matrix
+ * vector product of a decoder, with INT8 and with INT4 weights. Each run
+ * streams the whole weight matrix once, so halving its size should show
+ * up directly in the latency.
+ *
+ *   int4_weight_benchmark [input_size] [output_size] [loops]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/fullyconnected.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+struct Result {
+    int64_t weight_bytes;
+    double ms_per_run;
+};
+
+bool RunFullyConnected(tim::vx::DataType weight_type, uint32_t input_size,
+                       uint32_t output_size, uint32_t loops, Result* result) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    bool int4 = weight_type == tim::vx::DataType::INT4;
+    float weight_scale = int4 ? 1.0f / 7 : 1.0f / 127;
+    tim::vx::Quantization in_quant(tim::vx::QuantType::ASYMMETRIC, 1.0f / 255,
+                                   0);
+    tim::vx::Quantization weight_quant(tim::vx::QuantType::ASYMMETRIC,
+                                       weight_scale, 0);
+    tim::vx::Quantization bias_quant(tim::vx::QuantType::ASYMMETRIC,
+                                     weight_scale / 255, 0);
+    tim::vx::Quantization out_quant(tim::vx::QuantType::ASYMMETRIC, 0.25f,
+                                    128);
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8, {input_size, 1},
+                                   tim::vx::TensorAttribute::INPUT, in_quant);
+    tim::vx::TensorSpec weight_spec(weight_type, {input_size, output_size},
+                                    tim::vx::TensorAttribute::CONSTANT,
+                                    weight_quant);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::INT32, {output_size},
+                                  tim::vx::TensorAttribute::CONSTANT,
+                                  bias_quant);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8,
+                                    {output_size, 1},
+                                    tim::vx::TensorAttribute::OUTPUT,
+                                    out_quant);
+
+    /* One byte per value, packed below for INT4 */
+    int32_t qmax = int4 ? 7 : 127;
+    std::vector<uint8_t> weights(weight_spec.GetElementNum());
+    for (size_t i = 0; i < weights.size(); ++i) {
+        weights[i] = static_cast<uint8_t>(
+            static_cast<int8_t>(static_cast<int32_t>(i % (2 * qmax + 1)) -
+                                qmax));
+    }
+    if (int4) {
+        std::vector<uint8_t> packed(weight_spec.GetByteSize());
+        tim::vx::utils::Pack4Bit(weights.data(), packed.data(),
+                                 weight_spec.shape_);
+        weights.swap(packed);
+    }
+    std::vector<int32_t> bias(output_size, 0);
+    std::vector<uint8_t> input(input_size);
+    for (size_t i = 0; i < input.size(); ++i) {
+        input[i] = static_cast<uint8_t>(i % 256);
+    }
+
+    auto input_tensor = graph->CreateTensor(input_spec);
+    auto weight_tensor = graph->CreateTensor(weight_spec, weights.data());
+    auto bias_tensor = graph->CreateTensor(bias_spec, bias.data());
+    auto output_tensor = graph->CreateTensor(output_spec);
+    graph->CreateOperation<tim::vx::ops::FullyConnected>(0, output_size)
+        ->BindInputs({input_tensor, weight_tensor, bias_tensor})
+        .BindOutputs({output_tensor});
+
+    if (!graph->Compile()) {
+        std::cout << "Compile graph fail." << std::endl;
+        return false;
+    }
+    if (!input_tensor->CopyDataToTensor(input.data(), input.size()) ||
+        !graph->Run()) {
+        std::cout << "Run graph fail." << std::endl;
+        return false;
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        graph->Run();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    result->weight_bytes = weight_spec.GetByteSize();
+    result->ms_per_run =
+        std::chrono::duration<double, std::milli>(end - start).count() /
+        loops;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t input_size = argc > 1 ? std::atoi(argv[1]) : 4096;
+    uint32_t output_size = argc > 2 ? std::atoi(argv[2]) : 4096;
+    uint32_t loops = argc > 3 ? std::atoi(argv[3]) : 100;
+    if (loops == 0) loops = 1;
+
+    Result int8, int4;
+    if (!RunFullyConnected(tim::vx::DataType::INT8, input_size, output_size,
+                           loops, &int8) ||
+        !RunFullyConnected(tim::vx::DataType::INT4, input_size, output_size,
+                           loops, &int4)) {
+        return -1;
+    }
+
+    std::cout << "fully connected " << input_size << " -> " << output_size
+              << ", " << loops << " runs" << std::endl;
+    std::cout << "int8 weights: " << int8.weight_bytes << " bytes, "
+              << int8.ms_per_run << " ms" << std::endl;
+    std::cout << "int4 weights: " << int4.weight_bytes << " bytes, "
+              << int4.ms_per_run << " ms" << std::endl;
+    std::cout << "speedup: " << int8.ms_per_run / int4.ms_per_run << "x"
+              << std::endl;
+    return 0;
+}
@@ -0,0 +1,148 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Compiles an elementwise/softmax stack with kernel tuning into a tuning
+ * database, compiles it again loading the stored choices and times both
+ * against the default kernel priorities.
+ *
+ *   kernel_tuning_benchmark [tuning_db] [loops]
+ *
+ * Per-node choices and the estimated speedup are logged at info level
+ * (VSI_NN_LOG_LEVEL=4).
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "tim/vx/compile_option.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/ops/softmax.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+struct Model {
+    std::shared_ptr<tim::vx::Graph> graph;
+    std::shared_ptr<tim::vx::Tensor> input;
+    std::shared_ptr<tim::vx::Tensor> output;
+    double compile_ms;
+};
+
+Model Build(const std::shared_ptr<tim::vx::Context>& ctx,
+            const tim::vx::CompileOption& option) {
+    Model m;
+    auto start = std::chrono::high_resolution_clock::now();
+    m.graph = ctx->CreateGraph(option);
+    tim::vx::ShapeType shape({256, 64, 4});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT16, shape,
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT16, shape,
+                                       tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT16, shape,
+                                    tim::vx::TensorAttribute::OUTPUT);
+    m.input = m.graph->CreateTensor(input_spec);
+    m.output = m.graph->CreateTensor(output_spec);
+
+    auto mul_out = m.graph->CreateTensor(transient_spec);
+    auto mul = m.graph->CreateOperation<tim::vx::ops::Multiply>();
+    (*mul).BindInputs({m.input, m.input}).BindOutput(mul_out);
+
+    auto sigmoid_out = m.graph->CreateTensor(transient_spec);
+    auto sigmoid = m.graph->CreateOperation<tim::vx::ops::Sigmoid>();
+    (*sigmoid).BindInput(mul_out).BindOutput(sigmoid_out);
+
+    auto softmax = m.graph->CreateOperation<tim::vx::ops::Softmax>(1.0f, 0);
+    (*softmax).BindInput(sigmoid_out).BindOutput(m.output);
+
+    if (!m.graph->Compile()) {
+        std::cout << "Compile fail" << std::endl;
+        std::exit(-1);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    m.compile_ms = std::chrono::duration<double, std::milli>(end - start)
+                       .count();
+    return m;
+}
+
+double TimeRun(Model& m, int loops) {
+    std::vector<uint16_t> in_data(m.input->GetSpec().GetElementNum(), 0);
+    m.input->CopyDataToTensor(in_data.data(),
+                              in_data.size() * sizeof(uint16_t));
+    m.graph->Run();
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < loops; ++i) {
+        m.graph->Run();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() /
+           loops;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    std::string db_path = "/tmp/tim_vx_kernel_tuning.db";
+    int loops = 100;
+    if (argc > 1) {
+        db_path = argv[1];
+    }
+    if (argc > 2) {
+        loops = std::atoi(argv[2]);
+    }
+
+    auto ctx = tim::vx::Context::Create();
+    tim::vx::CompileOption default_option;
+    tim::vx::CompileOption tuning_option;
+    tuning_option.setKernelTuning(true);
+    tuning_option.setKernelTuningDB(db_path);
+    tim::vx::CompileOption tuned_option;
+    tuned_option.setKernelTuningDB(db_path);
+
+    auto baseline = Build(ctx, default_option);
+    // Measures nodes missing from the database, a second start only loads
+    auto tuning = Build(ctx, tuning_option);
+    auto tuned = Build(ctx, tuned_option);
+    double baseline_ms = TimeRun(baseline, loops);
+    double tuned_ms = TimeRun(tuned, loops);
+
+    std::cout << "Tuning database  : " << db_path << std::endl;
+    std::cout << "Compile default  : " << baseline.compile_ms << " ms"
+              << std::endl;
+    std::cout << "Compile tuning   : " << tuning.compile_ms << " ms"
+              << std::endl;
+    std::cout << "Compile loaded   : " << tuned.compile_ms << " ms"
+              << std::endl;
+    std::cout << "Run default      : " << baseline_ms << " ms" << std::endl;
+    std::cout << "Run tuned        : " << tuned_ms << " ms" << std::endl;
+    std::cout << "Speedup          : " << baseline_ms / tuned_ms << "x"
+              << std::endl;
+    return 0;
+}
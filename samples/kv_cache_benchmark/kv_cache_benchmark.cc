@@ -0,0 +1,201 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Times a single-token decode loop over a key/value cache of max_len rows.
+ * The baseline keeps the caches and the valid-length mask on the host and
+ * feeds them as graph inputs, copying all of them in on every step. The
+ * in-place variant keeps them in VARIABLE tensors and appends the new row
+ * with SliceUpdate at a runtime position, so only the new token is copied.
+ *
+ *   kv_cache_benchmark [max_len] [head_dim] [heads]
+ *
+ * Each variant decodes max_len steps.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/scaled_dot_product_attention.h"
+#include "tim/vx/ops/slice_update.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+constexpr uint16_t kF16One = 0x3c00;
+constexpr uint16_t kF16Zero = 0x0000;
+constexpr uint16_t kF16Lowest = 0xfbff;  // -65504
+
+struct Result {
+    double ms_per_step;
+    uint64_t bytes_per_step;
+};
+
+bool RunDecode(bool in_place, uint32_t max_len, uint32_t head_dim,
+               uint32_t heads, Result* result) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    tim::vx::ShapeType token_shape({head_dim, 1, heads});
+    tim::vx::ShapeType cache_shape({head_dim, max_len, heads});
+    tim::vx::ShapeType mask_shape({max_len, 1, 1});
+    auto cache_attr = in_place ? tim::vx::TensorAttribute::VARIABLE
+                               : tim::vx::TensorAttribute::INPUT;
+
+    tim::vx::TensorSpec token_spec(tim::vx::DataType::FLOAT16, token_shape,
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT16, token_shape,
+                                    tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec cache_spec(tim::vx::DataType::FLOAT16, cache_shape,
+                                   cache_attr);
+    tim::vx::TensorSpec mask_spec(tim::vx::DataType::FLOAT16, mask_shape,
+                                  cache_attr);
+
+    auto query = graph->CreateTensor(token_spec);
+    auto output = graph->CreateTensor(output_spec);
+    auto key_cache = graph->CreateTensor(cache_spec);
+    auto value_cache = graph->CreateTensor(cache_spec);
+    auto mask = graph->CreateTensor(mask_spec);
+    std::shared_ptr<tim::vx::Tensor> key, value, position;
+
+    if (in_place) {
+        tim::vx::TensorSpec position_spec(tim::vx::DataType::INT32, {1},
+                                          tim::vx::TensorAttribute::INPUT);
+        tim::vx::TensorSpec unmask_spec(tim::vx::DataType::FLOAT16,
+                                        {1, 1, 1},
+                                        tim::vx::TensorAttribute::CONSTANT);
+        key = graph->CreateTensor(token_spec);
+        value = graph->CreateTensor(token_spec);
+        position = graph->CreateTensor(position_spec);
+        auto unmask = graph->CreateTensor(unmask_spec, &kF16Zero);
+
+        graph->CreateOperation<tim::vx::ops::SliceUpdate>(1)
+            ->BindInputs({key, position})
+            .BindOutputs({key_cache});
+        graph->CreateOperation<tim::vx::ops::SliceUpdate>(1)
+            ->BindInputs({value, position})
+            .BindOutputs({value_cache});
+        graph->CreateOperation<tim::vx::ops::SliceUpdate>(0)
+            ->BindInputs({unmask, position})
+            .BindOutputs({mask});
+    }
+    graph->CreateOperation<tim::vx::ops::ScaledDotProductAttention>()
+        ->BindInputs({query, key_cache, value_cache, mask})
+        .BindOutputs({output});
+
+    if (!graph->Compile()) {
+        std::cout << "Compile graph fail." << std::endl;
+        return false;
+    }
+
+    std::vector<uint16_t> token(token_spec.GetElementNum(), kF16One);
+    std::vector<uint16_t> host_cache(cache_spec.GetElementNum(), kF16Zero);
+    std::vector<uint16_t> host_mask(max_len, kF16Lowest);
+    uint32_t token_bytes = token.size() * sizeof(uint16_t);
+    uint32_t cache_bytes = host_cache.size() * sizeof(uint16_t);
+    uint32_t mask_bytes = host_mask.size() * sizeof(uint16_t);
+    uint64_t bytes = 0;
+
+    if (in_place) {
+        // Initial state, written once before decoding.
+        if (!key_cache->CopyDataToTensor(host_cache.data(), cache_bytes) ||
+            !value_cache->CopyDataToTensor(host_cache.data(), cache_bytes) ||
+            !mask->CopyDataToTensor(host_mask.data(), mask_bytes)) {
+            std::cout << "Copy initial state fail." << std::endl;
+            return false;
+        }
+    }
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int32_t pos = 0; pos < static_cast<int32_t>(max_len); ++pos) {
+        bool ok = query->CopyDataToTensor(token.data(), token_bytes);
+        bytes += token_bytes;
+        if (in_place) {
+            ok = ok && key->CopyDataToTensor(token.data(), token_bytes) &&
+                 value->CopyDataToTensor(token.data(), token_bytes) &&
+                 position->CopyDataToTensor(&pos, sizeof(pos));
+            bytes += 2 * token_bytes + sizeof(pos);
+        } else {
+            for (uint32_t h = 0; h < heads; ++h) {
+                for (uint32_t c = 0; c < head_dim; ++c) {
+                    host_cache[(h * max_len + pos) * head_dim + c] =
+                        token[h * head_dim + c];
+                }
+            }
+            host_mask[pos] = kF16Zero;
+            ok = ok &&
+                 key_cache->CopyDataToTensor(host_cache.data(), cache_bytes) &&
+                 value_cache->CopyDataToTensor(host_cache.data(),
+                                               cache_bytes) &&
+                 mask->CopyDataToTensor(host_mask.data(), mask_bytes);
+            bytes += 2 * cache_bytes + mask_bytes;
+        }
+        if (!ok || !graph->Run()) {
+            std::cout << "Decode step " << pos << " fail." << std::endl;
+            return false;
+        }
+        if (!output->CopyDataFromTensor(token.data())) {
+            std::cout << "Copy output fail." << std::endl;
+            return false;
+        }
+        bytes += token_bytes;
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    result->ms_per_step =
+        std::chrono::duration<double, std::milli>(end - start).count() /
+        max_len;
+    result->bytes_per_step = bytes / max_len;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t max_len = argc > 1 ? std::atoi(argv[1]) : 512;
+    uint32_t head_dim = argc > 2 ? std::atoi(argv[2]) : 64;
+    uint32_t heads = argc > 3 ? std::atoi(argv[3]) : 8;
+    if (max_len == 0) max_len = 1;
+
+    Result baseline, in_place;
+    if (!RunDecode(false, max_len, head_dim, heads, &baseline) ||
+        !RunDecode(true, max_len, head_dim, heads, &in_place)) {
+        return -1;
+    }
+
+    std::cout << "decode " << max_len << " steps, head_dim " << head_dim
+              << ", " << heads << " heads" << std::endl;
+    std::cout << "cache as input: " << baseline.ms_per_step << " ms/step, "
+              << baseline.bytes_per_step << " host bytes/step" << std::endl;
+    std::cout << "in-place cache: " << in_place.ms_per_step << " ms/step, "
+              << in_place.bytes_per_step << " host bytes/step" << std::endl;
+    std::cout << "speedup " << baseline.ms_per_step / in_place.ms_per_step
+              << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,97 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+/*
+ * Times the activation LUT work done while setting up the activation
+ * nodes of a transformer encoder, with and without the process wide LUT
+ * cache. Each layer has a GELU in the feed forward block and an ERF from
+ * exporters that decompose exact GELU.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+#include "vsi_nn_pub.h"
+#include "kernel/vsi_nn_kernel_lut.h"
+
+namespace {
+
+std::vector<vsi_nn_kernel_lut_params> EncoderActivations(uint32_t layers) {
+    std::vector<vsi_nn_kernel_lut_params> nodes;
+    for (uint32_t i = 0; i < layers; ++i) {
+        vsi_nn_kernel_lut_params param;
+        memset(&param, 0, sizeof(param));
+        param.act_type = VSI_NN_KERNEL_LUT_GELU;
+        nodes.push_back(param);
+        param.act_type = VSI_NN_KERNEL_LUT_ERF;
+        nodes.push_back(param);
+    }
+    return nodes;
+}
+
+double Uncached(const std::vector<vsi_nn_kernel_lut_params>& nodes,
+                vsi_nn_kernel_lut_table_t* table) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& param : nodes) {
+        vsi_nn_kernel_lut_generate(&param, table);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+double Cached(const std::vector<vsi_nn_kernel_lut_params>& nodes,
+              vsi_nn_kernel_lut_table_t* table) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const auto& param : nodes) {
+        /* Same copy the uncached path ends with. */
+        memcpy(table, vsi_nn_kernel_lut_get_table(&param), sizeof(*table));
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t layers = argc > 1 ? std::atoi(argv[1]) : 24;
+    std::vector<vsi_nn_kernel_lut_params> nodes = EncoderActivations(layers);
+    vsi_nn_kernel_lut_table_t table;
+    uint32_t entries = 0;
+    uint32_t hits = 0;
+    uint32_t misses = 0;
+
+    std::cout << layers << " layers, " << nodes.size()
+              << " activation nodes" << std::endl;
+    std::cout << "uncached: " << Uncached(nodes, &table) << " ms"
+              << std::endl;
+    std::cout << "cached, first model: " << Cached(nodes, &table) << " ms"
+              << std::endl;
+    std::cout << "cached, second model: " << Cached(nodes, &table) << " ms"
+              << std::endl;
+    vsi_nn_kernel_lut_cache_query(&entries, &hits, &misses);
+    std::cout << "tables: " << entries << " hits: " << hits
+              << " misses: " << misses << std::endl;
+    return misses == entries ? 0 : -1;
+}
@@ -55,27 +55,32 @@ int demo(int argc, char** argv) {
   auto input_handle = executable0->AllocateTensor(g0_input0);
   executable0->SetInput(input_handle);  // set input_hanlde
   input_handle->CopyDataToTensor(input_data.data(), input_data.size());
-  executable0->SetOutput(executable0->AllocateTensor(g0_output0)); // set output_handle
-  // executable1
+  auto output_handle0 = executable0->AllocateTensor(g0_output0);
+  executable0->SetOutput(output_handle0); // set output_handle
+  // executable1, reads the output buffer of executable0 without a copy
   auto executable1 = executor->Compile(g1);  // compile to nbg
-  executable1->SetInput(executable1->AllocateTensor(g0_output0));  // set input_hanlde
-  executable1->SetOutput(executable1->AllocateTensor(g1_output0)); // set output_handle
+  executable1->SetInput(output_handle0);  // set input_hanlde
+  auto output_handle1 = executable1->AllocateTensor(g1_output0);
+  executable1->SetOutput(output_handle1); // set output_handle
   // executable2
   auto executable2 = executor->Compile(g2);  // compile to nbg
-  executable2->SetInput(executable2->AllocateTensor(g1_output0));  // set input_hanlde
-  executable2->SetOutput(executable2->AllocateTensor(g2_output0)); // set output_handle
+  executable2->SetInput(output_handle1);  // set input_hanlde
+  auto output_handle2 = executable2->AllocateTensor(g2_output0);
+  executable2->SetOutput(output_handle2); // set output_handle
   // executable3
   auto executable3 = executor->Compile(g3);  // compile to nbg
-  executable3->SetInput(executable3->AllocateTensor(g2_output0));  // set input_hanlde
-  executable3->SetOutput(executable3->AllocateTensor(g3_output0)); // set output_handle
+  executable3->SetInput(output_handle0);  // set input_hanlde
+  auto output_handle3 = executable3->AllocateTensor(g3_output0);
+  executable3->SetOutput(output_handle3); // set output_handle
   // executable4
   auto executable4 = executor->Compile(g4);  // compile to nbg
-  executable4->SetInput(executable4->AllocateTensor(g3_output0));  // set input_hanlde
-  executable4->SetOutput(executable4->AllocateTensor(g4_output0)); // set output_handle
+  executable4->SetInput(output_handle3);  // set input_hanlde
+  auto output_handle4 = executable4->AllocateTensor(g4_output0);
+  executable4->SetOutput(output_handle4); // set output_handle
   // executable5
   auto executable5 = executor->Compile(g5);  // compile to nbg
-  executable5->SetInput(executable5->AllocateTensor(g3_output0));  // set input_hanlde
-  executable5->SetInput(executable5->AllocateTensor(g4_output0));  // set input_hanlde
+  executable5->SetInput(output_handle2);  // set input_hanlde
+  executable5->SetInput(output_handle4);  // set input_hanlde
   executable5->SetOutput(executable5->AllocateTensor(g5_output0)); // set output_handle
 
   /* 1. one way to run */
@@ -0,0 +1,138 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <dirent.h>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tim/utils/nbg_parser/gc_vip_nbg_format.h"
+#include "tim/utils/nbg_parser/nbg_parser.h"
+#include "tim/vx/ops/nbg.h"
+
+namespace {
+
+struct NbgFile {
+    std::string path;
+    std::shared_ptr<const char> data;
+    size_t size;
+};
+
+using ParserInit = nbg_status_e (*)(void*, nbg_uint32_t, nbg_parser_data*);
+
+// What a routing table needs: counts, names and shapes of every I/O
+bool Inspect(const NbgFile& file, ParserInit init) {
+    nbg_parser_data nbg = NBG_NULL;
+    if (init(const_cast<char*>(file.data.get()),
+             static_cast<nbg_uint32_t>(file.size), &nbg) != NBG_SUCCESS) {
+        return false;
+    }
+    uint32_t counts[2] = {0, 0};
+    nbg_parser_query_network(nbg, NBG_PARSER_NETWORK_INPUT_COUNT, &counts[0],
+                             sizeof(counts[0]));
+    nbg_parser_query_network(nbg, NBG_PARSER_NETWORK_OUTPUT_COUNT, &counts[1],
+                             sizeof(counts[1]));
+    for (int io = 0; io < 2; ++io) {
+        auto query = io == 0 ? nbg_parser_query_input : nbg_parser_query_output;
+        for (uint32_t i = 0; i < counts[io]; ++i) {
+            char name[MAX_IO_NAME_LEGTH];
+            uint32_t dims[MAX_NUM_DIMS];
+            uint32_t dim_count = 0;
+            uint32_t format = 0;
+            query(nbg, i, NBG_PARSER_BUFFER_PROP_NAME, name, sizeof(name));
+            query(nbg, i, NBG_PARSER_BUFFER_PROP_NUM_OF_DIMENSION, &dim_count,
+                  sizeof(dim_count));
+            query(nbg, i, NBG_PARSER_BUFFER_PROP_DIMENSIONS, dims, sizeof(dims));
+            query(nbg, i, NBG_PARSER_BUFFER_PROP_DATA_FORMAT, &format,
+                  sizeof(format));
+        }
+    }
+    nbg_parser_destroy(nbg);
+    return true;
+}
+
+double TimeInspect(const std::vector<NbgFile>& files, ParserInit init,
+                   uint32_t loops) {
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t n = 0; n < loops; ++n) {
+        for (const auto& file : files) {
+            if (!Inspect(file, init)) {
+                std::cout << "Failed to parse " << file.path << std::endl;
+            }
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cout << "usage: ./nbg_parser_benchmark nbg_dir [loops]"
+                  << std::endl;
+        return -1;
+    }
+    std::string dir_path = argv[1];
+    uint32_t loops = argc > 2 ? atoi(argv[2]) : 10;
+
+    std::vector<NbgFile> files;
+    DIR* dir = opendir(dir_path.c_str());
+    if (!dir) {
+        std::cout << "Failed to open " << dir_path << std::endl;
+        return -1;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name.size() < 3 || name.compare(name.size() - 3, 3, ".nb") != 0) {
+            continue;
+        }
+        NbgFile file;
+        file.path = dir_path + "/" + name;
+        file.data = tim::vx::ops::NBG::MapFile(file.path, &file.size);
+        if (file.data) {
+            files.push_back(file);
+        }
+    }
+    closedir(dir);
+    if (files.empty()) {
+        std::cout << "No .nb file found in " << dir_path << std::endl;
+        return -1;
+    }
+
+    double eager_ms = TimeInspect(files, nbg_parser_init, loops);
+    double lazy_ms = TimeInspect(files, nbg_parser_init_lazy, loops);
+    double parses = static_cast<double>(files.size()) * loops;
+
+    std::cout << "Files: " << files.size() << ", loops: " << loops
+              << std::endl;
+    std::cout << "nbg_parser_init      : " << eager_ms << " ms, "
+              << eager_ms * 1000 / parses << " us per file" << std::endl;
+    std::cout << "nbg_parser_init_lazy : " << lazy_ms << " ms, "
+              << lazy_ms * 1000 / parses << " us per file" << std::endl;
+    return 0;
+}
@@ -27,8 +27,10 @@
 #include "tim/vx/types.h"
 #include "tim/utils/nbg_parser/nbg_parser.h"
 #include "tim/utils/nbg_parser/gc_vip_nbg_format.h"
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <string>
 #include <assert.h>
 #include <vector>
 #include <map>
@@ -58,6 +60,21 @@ static uint64_t get_perf_count()
 #endif
 }
 
+// Peak resident set size in kB, 0 if unknown
+static uint64_t get_peak_rss()
+{
+#if defined(__linux__) || defined(__ANDROID__)
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return strtoull(line.c_str() + 6, nullptr, 10);
+        }
+    }
+#endif
+    return 0;
+}
+
 static map<_nbg_buffer_quantize_format_e, tim::vx::QuantType> QMap = {
     {NBG_BUFFER_QUANTIZE_NONE, tim::vx::QuantType::NONE},
     {NBG_BUFFER_QUANTIZE_AFFINE_ASYMMETRIC, tim::vx::QuantType::ASYMMETRIC},
@@ -98,19 +115,20 @@ int main(int argc, char** argv) {
         return -1;
     }
 
-    ifstream nbg_file((const char*)argv[1]);
-    assert(nbg_file);
+    uint64_t tmS, tmE;
 
-    nbg_file.seekg(0, ios::end);
-    int nbg_size = nbg_file.tellg();
-    std::vector<char> nbg_buf(nbg_size);
-    nbg_file.seekg(0, ios::beg);
-    nbg_file.read( nbg_buf.data(), nbg_size );
-    nbg_file.close();
+    // Map the binary instead of reading it, pages are only brought in
+    // when the parser and the driver touch them
+    tmS = get_perf_count();
+    size_t nbg_size = 0;
+    auto nbg_buf = tim::vx::ops::NBG::MapFile(argv[1], &nbg_size);
+    tmE = get_perf_count();
+    assert(nbg_buf);
+    printf("Load Time: %ldus\n", (tmE - tmS)/1000);
 
     nbg_parser_data nbg = NBG_NULL;
 
-    nbg_parser_init(nbg_buf.data(), nbg_size, &nbg);
+    nbg_parser_init_lazy(const_cast<char*>(nbg_buf.get()), nbg_size, &nbg);
 
     // Get Inputs
     int input_count = 0;
@@ -220,7 +238,7 @@ int main(int argc, char** argv) {
     auto ctx = tim::vx::Context::Create();
     auto graph = ctx->CreateGraph();
     auto nbg_node = graph->CreateOperation<tim::vx::ops::NBG>(
-        nbg_buf.data(), input_count, output_count);
+        nbg_buf, input_count, output_count);
     for(int i=0; i<input_count; i++) {
         auto input = graph->CreateTensor(input_list[i]);
         (*nbg_node).BindInput(input);
@@ -230,8 +248,6 @@ int main(int argc, char** argv) {
         (*nbg_node).BindOutput(output);
     }
 
-    uint64_t tmS, tmE;
-
     tmS = get_perf_count();
     assert(graph->Compile());
     tmE = get_perf_count();
@@ -241,5 +257,6 @@ int main(int argc, char** argv) {
     assert(graph->Run());
     tmE = get_perf_count();
     printf("Run Time: %ldus\n", (tmE - tmS)/1000);
+    printf("Peak RSS: %lukB\n", (unsigned long)get_peak_rss());
 
 }
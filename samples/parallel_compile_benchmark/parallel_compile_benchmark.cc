@@ -0,0 +1,112 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+// Models differ in input size so that none of them shares compiled state
+std::vector<std::shared_ptr<tim::vx::Graph>> BuildGraphs(
+    const std::shared_ptr<tim::vx::Context>& ctx, int count) {
+    const uint32_t channels = 16;
+    static std::vector<float> weight_data(3 * 3 * channels * channels, 0.01f);
+    std::vector<std::shared_ptr<tim::vx::Graph>> graphs;
+    for (int n = 0; n < count; ++n) {
+        auto graph = ctx->CreateGraph();
+        uint32_t size = 32 + 4 * n;
+        tim::vx::ShapeType shape({size, size, channels, 1});
+        tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                       tim::vx::TensorAttribute::INPUT);
+        tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32,
+                                        {3, 3, channels, channels},
+                                        tim::vx::TensorAttribute::CONSTANT);
+        tim::vx::TensorSpec transient_spec(
+            tim::vx::DataType::FLOAT32, {},
+            tim::vx::TensorAttribute::TRANSIENT);
+        tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                        tim::vx::TensorAttribute::OUTPUT);
+
+        auto current = graph->CreateTensor(input_spec);
+        for (int layer = 0; layer < 4; ++layer) {
+            auto weight = graph->CreateTensor(weight_spec, weight_data.data());
+            auto conv_out = graph->CreateTensor(transient_spec);
+            auto conv = graph->CreateOperation<tim::vx::ops::Conv2d>(
+                channels, tim::vx::PadType::SAME,
+                std::array<uint32_t, 2>({3, 3}),
+                std::array<uint32_t, 2>({1, 1}),
+                std::array<uint32_t, 2>({1, 1}));
+            (*conv).BindInputs({current, weight}).BindOutput(conv_out);
+
+            auto relu_out = layer == 3 ? graph->CreateTensor(output_spec)
+                                       : graph->CreateTensor(transient_spec);
+            (*graph->CreateOperation<tim::vx::ops::Relu>())
+                .BindInput(conv_out)
+                .BindOutput(relu_out);
+            current = relu_out;
+        }
+        graphs.push_back(graph);
+    }
+    return graphs;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 16;
+    uint32_t threads = argc > 2 ? std::atoi(argv[2])
+                                : std::thread::hardware_concurrency();
+
+    auto ctx = tim::vx::Context::CreateShared();
+
+    auto graphs = BuildGraphs(ctx, count);
+    auto start = std::chrono::high_resolution_clock::now();
+    bool status = ctx->CompileAll(graphs, 1);
+    auto end = std::chrono::high_resolution_clock::now();
+    double serial_ms =
+        std::chrono::duration<double, std::milli>(end - start).count();
+
+    graphs = BuildGraphs(ctx, count);
+    start = std::chrono::high_resolution_clock::now();
+    status = ctx->CompileAll(graphs, threads) && status;
+    end = std::chrono::high_resolution_clock::now();
+    double parallel_ms =
+        std::chrono::duration<double, std::milli>(end - start).count();
+
+    std::cout << "Graphs           : " << count << std::endl;
+    std::cout << "1 thread         : " << serial_ms << " ms" << std::endl;
+    std::cout << threads << " threads        : " << parallel_ms << " ms"
+              << std::endl;
+    std::cout << "Speedup          : " << serial_ms / parallel_ms << "x"
+              << std::endl;
+    return status ? 0 : -1;
+}
@@ -0,0 +1,166 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+/*
+ * Splits a chain of convolutions across 1 to 4 devices and runs it
+ * pipelined. Devices missing on the board are emulated by repeating the
+ * enumerated ones, their stages then take turns on the same core. Outputs
+ * are checked against the single device run.
+ */
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/platform/partition.h"
+#include "tim/vx/tensor.h"
+
+using tim::vx::platform::ITensorHandle;
+using tim::vx::platform::PartitionedGraph;
+
+namespace {
+
+const uint32_t kLayers = 8;
+const uint32_t kChannels = 32;
+const uint32_t kSize = 56;
+
+std::shared_ptr<tim::vx::Graph> BuildGraph(
+    const std::shared_ptr<tim::vx::Context>& context) {
+    auto graph = context->CreateGraph();
+    tim::vx::ShapeType shape = {kSize, kSize, kChannels, 1};
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                       tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                    tim::vx::TensorAttribute::OUTPUT);
+    tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32,
+                                    {3, 3, kChannels, kChannels},
+                                    tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {kChannels},
+                                  tim::vx::TensorAttribute::CONSTANT);
+
+    static std::vector<float> weight_data(3 * 3 * kChannels * kChannels,
+                                          1.0f / (9 * kChannels));
+    static std::vector<float> bias_data(kChannels, 0.01f);
+    auto tensor = graph->CreateTensor(input_spec);
+    for (uint32_t i = 0; i < kLayers; ++i) {
+        auto weight = graph->CreateTensor(weight_spec, weight_data.data());
+        auto bias = graph->CreateTensor(bias_spec, bias_data.data());
+        auto conv_out = graph->CreateTensor(transient_spec);
+        auto relu_out = graph->CreateTensor(
+            i + 1 == kLayers ? output_spec : transient_spec);
+        (*graph->CreateOperation<tim::vx::ops::Conv2d>(
+             kChannels, tim::vx::PadType::SAME,
+             std::array<uint32_t, 2>({3, 3}), std::array<uint32_t, 2>({1, 1}),
+             std::array<uint32_t, 2>({1, 1})))
+            .BindInputs({tensor, weight, bias})
+            .BindOutput(conv_out);
+        (*graph->CreateOperation<tim::vx::ops::Relu>())
+            .BindInput(conv_out)
+            .BindOutput(relu_out);
+        tensor = relu_out;
+    }
+    return graph;
+}
+
+std::vector<float> FrameData(size_t frame) {
+    std::vector<float> data(kSize * kSize * kChannels);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<float>((i + frame * 7) % 13) / 13.0f;
+    }
+    return data;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    size_t frames = argc > 1 ? std::atoi(argv[1]) : 64;
+    auto found = tim::vx::platform::NativeDevice::Enumerate();
+    if (found.empty()) {
+        std::cout << "No device found" << std::endl;
+        return -1;
+    }
+    auto context = tim::vx::Context::Create();
+    auto graph = BuildGraph(context);
+
+    std::vector<std::vector<float>> reference;
+    double base_fps = 0;
+    std::cout << "devices\tstages\tpredicted\tframes/s\tspeedup\tmax diff"
+              << std::endl;
+    for (size_t count = 1; count <= 4; ++count) {
+        std::vector<std::shared_ptr<tim::vx::platform::IDevice>> devices;
+        for (size_t i = 0; i < count; ++i) {
+            devices.push_back(found[i % found.size()]);
+        }
+        auto partitioned = tim::vx::platform::Partition(graph, devices);
+        if (!partitioned) {
+            std::cout << count << "\tpartition failed" << std::endl;
+            continue;
+        }
+
+        std::vector<std::vector<float>> results(
+            std::max(frames, partitioned->Slots()));
+        auto feed = [](size_t frame,
+                       const std::vector<std::shared_ptr<ITensorHandle>>& th) {
+            auto data = FrameData(frame);
+            return th[0]->CopyDataToTensor(data.data(),
+                                           data.size() * sizeof(float));
+        };
+        auto fetch = [&](size_t frame,
+                         const std::vector<std::shared_ptr<ITensorHandle>>& th) {
+            results[frame].resize(kSize * kSize * kChannels);
+            return th[0]->CopyDataFromTensor(results[frame].data());
+        };
+        // Warm up, the first run of every stage loads its binary
+        partitioned->RunPipelined(partitioned->Slots(), feed, fetch);
+        auto start = std::chrono::steady_clock::now();
+        bool ok = partitioned->RunPipelined(frames, feed, fetch);
+        auto end = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(end - start).count();
+        double fps = frames / seconds;
+        if (count == 1) {
+            reference = results;
+            base_fps = fps;
+        }
+        float max_diff = 0;
+        for (size_t f = 0; f < frames; ++f) {
+            for (size_t i = 0; i < results[f].size(); ++i) {
+                max_diff = std::max(max_diff,
+                                    std::fabs(results[f][i] - reference[f][i]));
+            }
+        }
+        std::cout << count << "\t" << partitioned->Plan().StageCount() << "\t"
+                  << partitioned->Plan().PredictedSpeedup() << "x\t\t"
+                  << (ok ? fps : 0.0) << "\t\t" << fps / base_fps << "x\t"
+                  << max_diff << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+/*
+ * Runs a 3 stage pipeline of executables, once with every stage on its own
+ * buffers and the host copying between them, once with each output handle
+ * bound as the input of the next stage.
+ */
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/platform/native.h"
+#include "tim/vx/tensor.h"
+
+using tim::vx::platform::IExecutable;
+using tim::vx::platform::IExecutor;
+using tim::vx::platform::ITensorHandle;
+using tim::vx::platform::NativeExecutable;
+
+namespace {
+
+const uint32_t kStages = 3;
+const tim::vx::ShapeType kShape = {128, 128, 32, 1};
+
+tim::vx::TensorSpec Spec(tim::vx::TensorAttribute attr) {
+    return tim::vx::TensorSpec(tim::vx::DataType::FLOAT32, kShape, attr);
+}
+
+std::shared_ptr<IExecutable> CompileStage(
+    const std::shared_ptr<IExecutor>& executor) {
+    auto graph = executor->Contex()->CreateGraph();
+    auto input = graph->CreateTensor(Spec(tim::vx::TensorAttribute::INPUT));
+    auto output = graph->CreateTensor(Spec(tim::vx::TensorAttribute::OUTPUT));
+    (*graph->CreateOperation<tim::vx::ops::Relu>())
+        .BindInput(input)
+        .BindOutput(output);
+    return executor->Compile(graph);
+}
+
+struct Result {
+    double ms;
+    uint64_t bytes;
+};
+
+Result Run(const std::shared_ptr<IExecutor>& executor, bool share,
+           int iterations) {
+    std::vector<std::shared_ptr<IExecutable>> stages;
+    std::vector<std::shared_ptr<ITensorHandle>> inputs;
+    std::vector<std::shared_ptr<ITensorHandle>> outputs;
+    for (uint32_t i = 0; i < kStages; ++i) {
+        auto stage = CompileStage(executor);
+        auto input = (share && i > 0)
+                         ? outputs.back()
+                         : stage->AllocateTensor(
+                               Spec(tim::vx::TensorAttribute::INPUT));
+        auto output =
+            stage->AllocateTensor(Spec(tim::vx::TensorAttribute::OUTPUT));
+        stage->SetInput(input);
+        stage->SetOutput(output);
+        stages.push_back(stage);
+        inputs.push_back(input);
+        outputs.push_back(output);
+    }
+
+    size_t bytes = Spec(tim::vx::TensorAttribute::INPUT).GetByteSize();
+    std::vector<char> frame(bytes, 1);
+    std::vector<char> staging(bytes);
+    uint64_t copied = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int n = 0; n < iterations; ++n) {
+        inputs[0]->CopyDataToTensor(frame.data(), bytes);
+        for (uint32_t i = 0; i < kStages; ++i) {
+            if (!share && i > 0) {
+                outputs[i - 1]->CopyDataFromTensor(staging.data());
+                inputs[i]->CopyDataToTensor(staging.data(), bytes);
+                copied += 2 * bytes;
+            }
+            stages[i]->Submit(stages[i]);
+            executor->Trigger();
+        }
+        outputs.back()->CopyDataFromTensor(staging.data());
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    for (auto& stage : stages) {
+        auto native = std::dynamic_pointer_cast<NativeExecutable>(stage);
+        copied += native ? native->HostBytesCopied() : 0;
+    }
+    return {std::chrono::duration<double, std::milli>(end - start).count() /
+                iterations,
+            copied / iterations};
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+    auto devices = tim::vx::platform::NativeDevice::Enumerate();
+    if (devices.empty()) {
+        std::cout << "No device found" << std::endl;
+        return -1;
+    }
+    auto executor =
+        std::make_shared<tim::vx::platform::NativeExecutor>(devices[0]);
+
+    Result copy = Run(executor, false, iterations);
+    Result shared = Run(executor, true, iterations);
+    std::cout << "mode\tms/run\tinter-stage bytes copied/run" << std::endl;
+    std::cout << "copy\t" << copy.ms << "\t" << copy.bytes << std::endl;
+    std::cout << "shared\t" << shared.ms << "\t" << shared.bytes << std::endl;
+    return 0;
+}
@@ -0,0 +1,193 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Times a uint8 RNNCell as the fused quantized cell against the composite
+ * it used to lower to: two fully connected ops, an add and a tanh with
+ * float32 intermediates, and a data convert of the state.
+ *
+ *   rnn_cell_benchmark [input_size] [num_units] [batch] [loops]
+ *
+ * Also prints the bytes of intermediates each variant writes per step.
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/ops/fullyconnected.h"
+#include "tim/vx/ops/rnn_cell.h"
+#include "tim/vx/ops/simple_operations.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+bool RunCell(bool fused, uint32_t input_size, uint32_t num_units,
+             uint32_t batch, uint32_t loops, double* ms_per_run) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    float in_scale = 1.0f / 255, weight_scale = 1.0f / 128;
+    tim::vx::Quantization in_quant(tim::vx::QuantType::ASYMMETRIC, in_scale,
+                                   0);
+    tim::vx::Quantization weight_quant(tim::vx::QuantType::ASYMMETRIC,
+                                       weight_scale, 128);
+    tim::vx::Quantization state_quant(tim::vx::QuantType::ASYMMETRIC,
+                                      1.0f / 128, 128);
+    tim::vx::Quantization bias_quant(tim::vx::QuantType::ASYMMETRIC,
+                                     in_scale * weight_scale, 0);
+    tim::vx::Quantization recurrent_bias_quant(
+        tim::vx::QuantType::ASYMMETRIC, weight_scale / 128, 0);
+    tim::vx::Quantization internal_quant(tim::vx::QuantType::ASYMMETRIC,
+                                         8.0f / 255, 128);
+
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8,
+                                   {input_size, batch},
+                                   tim::vx::TensorAttribute::INPUT, in_quant);
+    tim::vx::TensorSpec weights_spec(tim::vx::DataType::UINT8,
+                                     {input_size, num_units},
+                                     tim::vx::TensorAttribute::CONSTANT,
+                                     weight_quant);
+    tim::vx::TensorSpec recurrent_spec(tim::vx::DataType::UINT8,
+                                       {num_units, num_units},
+                                       tim::vx::TensorAttribute::CONSTANT,
+                                       weight_quant);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::INT32, {num_units},
+                                  tim::vx::TensorAttribute::CONSTANT,
+                                  bias_quant);
+    tim::vx::TensorSpec recurrent_bias_spec(tim::vx::DataType::INT32,
+                                            {num_units},
+                                            tim::vx::TensorAttribute::CONSTANT,
+                                            recurrent_bias_quant);
+    tim::vx::TensorSpec state_in_spec(tim::vx::DataType::UINT8,
+                                      {num_units, batch},
+                                      tim::vx::TensorAttribute::INPUT,
+                                      state_quant);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8,
+                                    {num_units, batch},
+                                    tim::vx::TensorAttribute::OUTPUT,
+                                    state_quant);
+    tim::vx::TensorSpec float_spec(tim::vx::DataType::FLOAT32, {0, 0},
+                                   tim::vx::TensorAttribute::TRANSIENT);
+
+    std::vector<uint8_t> weights(weights_spec.GetElementNum(), 130);
+    std::vector<uint8_t> recurrent(recurrent_spec.GetElementNum(), 126);
+    std::vector<int32_t> bias(num_units, 0);
+
+    auto input = graph->CreateTensor(input_spec);
+    auto weights_tensor = graph->CreateTensor(weights_spec, weights.data());
+    auto recurrent_tensor =
+        graph->CreateTensor(recurrent_spec, recurrent.data());
+    auto bias_tensor = graph->CreateTensor(bias_spec, bias.data());
+    auto state_in = graph->CreateTensor(state_in_spec);
+    auto output = graph->CreateTensor(output_spec);
+    auto state_out = graph->CreateTensor(output_spec);
+
+    if (fused) {
+        graph
+            ->CreateOperation<tim::vx::ops::RNNCell>(
+                tim::vx::ops::RNNCell::ActivationType::kTANH, internal_quant)
+            ->BindInputs({input, weights_tensor, bias_tensor, state_in,
+                          recurrent_tensor})
+            .BindOutputs({output, state_out});
+    } else {
+        auto recurrent_bias =
+            graph->CreateTensor(recurrent_bias_spec, bias.data());
+        auto fc0_out = graph->CreateTensor(float_spec);
+        auto fc1_out = graph->CreateTensor(float_spec);
+        auto add_out = graph->CreateTensor(float_spec);
+        graph->CreateOperation<tim::vx::ops::FullyConnected>(0, num_units)
+            ->BindInputs({input, weights_tensor, bias_tensor})
+            .BindOutputs({fc0_out});
+        graph->CreateOperation<tim::vx::ops::FullyConnected>(0, num_units)
+            ->BindInputs({state_in, recurrent_tensor, recurrent_bias})
+            .BindOutputs({fc1_out});
+        graph->CreateOperation<tim::vx::ops::Add>()
+            ->BindInputs({fc0_out, fc1_out})
+            .BindOutputs({add_out});
+        graph->CreateOperation<tim::vx::ops::Tanh>()
+            ->BindInputs({add_out})
+            .BindOutputs({output});
+        graph->CreateOperation<tim::vx::ops::DataConvert>()
+            ->BindInputs({output})
+            .BindOutputs({state_out});
+    }
+
+    if (!graph->Compile()) {
+        std::cout << "Compile graph fail." << std::endl;
+        return false;
+    }
+
+    std::vector<uint8_t> in_data(input_spec.GetElementNum(), 128);
+    std::vector<uint8_t> state(state_in_spec.GetElementNum(), 128);
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < loops; ++i) {
+        if (!input->CopyDataToTensor(in_data.data(), in_data.size()) ||
+            !state_in->CopyDataToTensor(state.data(), state.size()) ||
+            !graph->Run() || !state_out->CopyDataFromTensor(state.data())) {
+            std::cout << "Run graph fail." << std::endl;
+            return false;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+
+    *ms_per_run =
+        std::chrono::duration<double, std::milli>(end - start).count() /
+        loops;
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t input_size = argc > 1 ? std::atoi(argv[1]) : 256;
+    uint32_t num_units = argc > 2 ? std::atoi(argv[2]) : 512;
+    uint32_t batch = argc > 3 ? std::atoi(argv[3]) : 1;
+    uint32_t loops = argc > 4 ? std::atoi(argv[4]) : 100;
+    if (loops == 0) loops = 1;
+
+    double composite = 0, fused = 0;
+    if (!RunCell(false, input_size, num_units, batch, loops, &composite) ||
+        !RunCell(true, input_size, num_units, batch, loops, &fused)) {
+        return -1;
+    }
+
+    // Two projections and their sum are written per step.
+    uint64_t sums = 3ull * num_units * batch;
+    std::cout << "uint8 RNNCell, input_size " << input_size << ", "
+              << num_units << " units, batch " << batch << ", " << loops
+              << " steps" << std::endl;
+    std::cout << "composite: " << composite << " ms/step, "
+              << sums * sizeof(float) << " intermediate bytes/step"
+              << std::endl;
+    std::cout << "fused:     " << fused << " ms/step, " << sums
+              << " intermediate bytes/step" << std::endl;
+    std::cout << "speedup " << composite / fused << "x" << std::endl;
+    return 0;
+}
@@ -0,0 +1,135 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/shape_family.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+const uint32_t kChannels = 8;
+
+// Same padded conv + relu for any spatial size, so the output shape equals
+// the input shape
+std::shared_ptr<tim::vx::Graph> BuildGraph(
+    const std::shared_ptr<tim::vx::Context>& context,
+    const std::vector<tim::vx::ShapeType>& input_shapes) {
+    auto graph = context->CreateGraph();
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32,
+                                   input_shapes[0],
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32,
+                                    {3, 3, kChannels, kChannels},
+                                    tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {},
+                                       tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32,
+                                    input_shapes[0],
+                                    tim::vx::TensorAttribute::OUTPUT);
+
+    static std::vector<float> weight_data(3 * 3 * kChannels * kChannels,
+                                          0.01f);
+    auto input = graph->CreateTensor(input_spec);
+    auto weight = graph->CreateTensor(weight_spec, weight_data.data());
+    auto conv_out = graph->CreateTensor(transient_spec);
+    auto output = graph->CreateTensor(output_spec);
+    auto conv = graph->CreateOperation<tim::vx::ops::Conv2d>(
+        kChannels, tim::vx::PadType::SAME, std::array<uint32_t, 2>({3, 3}),
+        std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+    (*conv).BindInputs({input, weight}).BindOutput(conv_out);
+    (*graph->CreateOperation<tim::vx::ops::Relu>())
+        .BindInput(conv_out)
+        .BindOutput(output);
+    return graph;
+}
+
+void RunSequence(const std::string& name,
+                 const tim::vx::ShapeFamilyOptions& options,
+                 const std::vector<tim::vx::ShapeType>& shapes) {
+    tim::vx::ShapeFamily family(
+        BuildGraph, options,
+        [](size_t, const std::vector<tim::vx::ShapeType>& input_shapes) {
+            return input_shapes[0];
+        });
+
+    std::vector<float> input(256 * 256 * kChannels, 1.0f);
+    std::vector<tim::vx::ShapeFamily::Output> outputs;
+    for (const auto& shape : shapes) {
+        if (!family.Run({{shape, input.data()}}, outputs)) {
+            std::cout << name << ": run failed" << std::endl;
+            return;
+        }
+    }
+
+    auto stats = family.GetStats();
+    auto mean = [](std::chrono::microseconds total, uint64_t count) {
+        return count == 0 ? 0 : total.count() / static_cast<int64_t>(count);
+    };
+    std::cout << name << ": hit rate " << stats.HitRate() * 100 << "%, "
+              << stats.misses << " compiles, " << stats.evictions
+              << " evictions" << std::endl;
+    std::cout << "  hit  mean/p50/p90/p99/max : "
+              << mean(stats.hit_latency_total, stats.hits) << " / "
+              << stats.hit_latency_p50.count() << " / "
+              << stats.hit_latency_p90.count() << " / "
+              << stats.hit_latency_p99.count() << " / "
+              << stats.hit_latency_max.count() << " us" << std::endl;
+    std::cout << "  miss mean/p50/p90/p99/max : "
+              << mean(stats.miss_latency_total, stats.misses) << " / "
+              << stats.miss_latency_p50.count() << " / "
+              << stats.miss_latency_p90.count() << " / "
+              << stats.miss_latency_p99.count() << " / "
+              << stats.miss_latency_max.count() << " us" << std::endl;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    int requests = argc > 1 ? std::atoi(argv[1]) : 200;
+
+    // Spatial sizes drawn from 160..256 like resized camera frames
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<uint32_t> size(160, 256);
+    std::vector<tim::vx::ShapeType> shapes;
+    for (int i = 0; i < requests; ++i) {
+        shapes.push_back({size(rng), size(rng), kChannels, 1});
+    }
+
+    tim::vx::ShapeFamilyOptions exact;
+    exact.capacity = 16;
+    RunSequence("exact shapes", exact, shapes);
+
+    tim::vx::ShapeFamilyOptions bucketed = exact;
+    bucketed.bucket_granularity = {32, 32};
+    RunSequence("32 px buckets", bucketed, shapes);
+    return 0;
+}
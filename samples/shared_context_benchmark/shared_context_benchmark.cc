@@ -0,0 +1,96 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/tensor.h"
+
+namespace {
+
+// Each tenant owns one graph with a few shader based ops, so that kernel
+// compilation shows up in its first Compile()
+std::shared_ptr<tim::vx::Graph> BuildTenantGraph(
+    const std::shared_ptr<tim::vx::Context>& ctx) {
+    auto graph = ctx->CreateGraph();
+    tim::vx::ShapeType shape({64, 64, 16, 1});
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                       tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                    tim::vx::TensorAttribute::OUTPUT);
+
+    auto input = graph->CreateTensor(input_spec);
+    auto sum = graph->CreateTensor(transient_spec);
+    auto output = graph->CreateTensor(output_spec);
+    auto add = graph->CreateOperation<tim::vx::ops::Add>();
+    (*add).BindInputs({input, input}).BindOutput(sum);
+    auto sigmoid = graph->CreateOperation<tim::vx::ops::Sigmoid>();
+    (*sigmoid).BindInput(sum).BindOutput(output);
+    return graph;
+}
+
+double RunTenants(uint32_t tenants, bool shared) {
+    std::vector<std::shared_ptr<tim::vx::Context>> contexts;
+    std::vector<std::shared_ptr<tim::vx::Graph>> graphs;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < tenants; ++i) {
+        contexts.push_back(shared ? tim::vx::Context::CreateShared()
+                                  : tim::vx::Context::Create());
+        graphs.push_back(BuildTenantGraph(contexts.back()));
+        if (!graphs.back()->Compile()) {
+            std::cout << "Compile fail for tenant " << i << std::endl;
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    // Graphs must be released before their contexts
+    graphs.clear();
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    uint32_t tenants = 8;
+    if (argc > 1) {
+        tenants = atoi(argv[1]);
+    }
+
+    double exclusive_ms = RunTenants(tenants, false);
+    double shared_ms = RunTenants(tenants, true);
+
+    std::cout << "Tenants: " << tenants << std::endl;
+    std::cout << "Context::Create       : " << exclusive_ms << " ms, "
+              << exclusive_ms / tenants << " ms per tenant" << std::endl;
+    std::cout << "Context::CreateShared : " << shared_ms << " ms, "
+              << shared_ms / tenants << " ms per tenant" << std::endl;
+    return 0;
+}
@@ -0,0 +1,102 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * tim_bench graph builder plugin: a stack of uint8 3x3-style convolutions,
+ * the layer samples/benchmark_test builds from positional arguments.
+ *
+ *   tim_bench --plugin libtim_bench_conv2d.so \
+ *       --plugin-args width,height,in_channels,kernel_w,kernel_h,out_channels,layers
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/conv2d.h"
+#include "tim/vx/tensor.h"
+#include "tim_bench_plugin.h"
+
+extern "C" bool TimBenchBuildGraph(tim::vx::Graph* graph, const char* args) {
+    std::vector<uint32_t> cfg = {224, 224, 32, 3, 3, 32, 1};
+    std::istringstream fields(args ? args : "");
+    std::string field;
+    for (size_t i = 0; i < cfg.size() && std::getline(fields, field, ','); ++i) {
+        if (!field.empty()) cfg[i] = std::strtoul(field.c_str(), nullptr, 10);
+    }
+    const uint32_t width = cfg[0];
+    const uint32_t height = cfg[1];
+    const uint32_t in_channels = cfg[2];
+    const uint32_t kernel_w = cfg[3];
+    const uint32_t kernel_h = cfg[4];
+    const uint32_t out_channels = cfg[5];
+    const uint32_t layers = cfg[6];
+    if (0 == width || 0 == height || 0 == in_channels || 0 == kernel_w ||
+        0 == kernel_h || 0 == out_channels || 0 == layers) {
+        return false;
+    }
+
+    tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 1.0f, 0);
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8,
+                                   {width, height, in_channels, 1},
+                                   tim::vx::TensorAttribute::INPUT, quant);
+    tim::vx::ShapeType out_shape({width, height, out_channels, 1});
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::UINT8, out_shape,
+                                       tim::vx::TensorAttribute::TRANSIENT,
+                                       quant);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8, out_shape,
+                                    tim::vx::TensorAttribute::OUTPUT, quant);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::INT32, {out_channels},
+                                  tim::vx::TensorAttribute::CONSTANT, quant);
+    // Constant data is copied when the tensor is created
+    std::vector<int32_t> bias_data(out_channels, 1);
+
+    auto current = graph->CreateTensor(input_spec);
+    uint32_t channels = in_channels;
+    for (uint32_t layer = 0; layer < layers; ++layer) {
+        tim::vx::TensorSpec weight_spec(
+            tim::vx::DataType::UINT8,
+            {kernel_w, kernel_h, channels, out_channels},
+            tim::vx::TensorAttribute::CONSTANT, quant);
+        std::vector<uint8_t> weight_data(
+            kernel_w * kernel_h * channels * out_channels);
+        for (size_t i = 0; i < weight_data.size(); ++i) {
+            weight_data[i] = static_cast<uint8_t>(i * 7 % 5);
+        }
+        auto weight = graph->CreateTensor(weight_spec, weight_data.data());
+        auto bias = graph->CreateTensor(bias_spec, bias_data.data());
+        auto output = layer + 1 == layers ? graph->CreateTensor(output_spec)
+                                          : graph->CreateTensor(transient_spec);
+        auto conv = graph->CreateOperation<tim::vx::ops::Conv2d>(
+            out_channels, tim::vx::PadType::SAME,
+            std::array<uint32_t, 2>({kernel_w, kernel_h}),
+            std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1}));
+        (*conv).BindInputs({current, weight, bias}).BindOutput(output);
+        current = output;
+        channels = out_channels;
+    }
+    return true;
+}
@@ -0,0 +1,636 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+/*
+ * Model-level benchmark harness. Loads a graph, compiles one copy per
+ * worker, warms up and then runs a fixed number of iterations or for a
+ * fixed duration, and reports latency percentiles, throughput, compile time,
+ * peak RSS and copy-in/run/copy-out times as JSON.
+ *
+ *   tim_bench (--graph model.timg | --nbg model.nb | --plugin lib.so
+ *              [--plugin-args args]) [--warmup N] [--iterations N]
+ *             [--duration seconds] [--threads N] [--devices N] [--relax]
+ *             [--json report.json]
+ *
+ * --graph    graph saved with Graph::Serialize
+ * --nbg      network binary graph, needs TIM_VX_ENABLE_NBG_PARSER
+ * --plugin   graph builder library, see tim_bench_plugin.h
+ * --threads  concurrent workers, each with its own context and graph
+ * --devices  run workers round robin on N devices through the native
+ *            platform executor, needs TIM_VX_ENABLE_PLATFORM
+ *
+ * Every worker runs --iterations iterations, or runs until --duration
+ * elapses if it is set. Latency is copy-in + run + copy-out of one
+ * iteration. The report goes to stdout unless --json is given.
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dlfcn.h>
+#if defined(__linux__) || defined(__ANDROID__)
+#include <sys/resource.h>
+#endif
+
+#include "tim/vx/compile_option.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/tensor.h"
+#include "tim_bench_plugin.h"
+#ifdef TIM_BENCH_ENABLE_NBG
+#include "tim/utils/nbg_parser/gc_vip_nbg_format.h"
+#include "tim/utils/nbg_parser/nbg_parser.h"
+#include "tim/vx/ops/nbg.h"
+#endif
+#ifdef TIM_BENCH_ENABLE_PLATFORM
+#include "tim/vx/platform/native.h"
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double ElapsedMs(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+struct Options {
+    std::string graph_path;
+    std::string nbg_path;
+    std::string plugin_path;
+    std::string plugin_args;
+    std::string json_path;
+    int warmup = 10;
+    int iterations = 100;
+    double duration_s = 0;
+    int threads = 1;
+    int devices = 0;
+    bool relax = false;
+};
+
+void PrintUsage() {
+    std::cerr << "usage: tim_bench (--graph model.timg | --nbg model.nb | "
+                 "--plugin lib.so [--plugin-args args])\n"
+                 "                 [--warmup N] [--iterations N] "
+                 "[--duration seconds] [--threads N]\n"
+                 "                 [--devices N] [--relax] "
+                 "[--json report.json]"
+              << std::endl;
+}
+
+bool ParseOptions(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if ("--relax" == arg) {
+            opt.relax = true;
+            continue;
+        }
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value of " << arg << std::endl;
+            return false;
+        }
+        const char* value = argv[++i];
+        if ("--graph" == arg) {
+            opt.graph_path = value;
+        } else if ("--nbg" == arg) {
+            opt.nbg_path = value;
+        } else if ("--plugin" == arg) {
+            opt.plugin_path = value;
+        } else if ("--plugin-args" == arg) {
+            opt.plugin_args = value;
+        } else if ("--json" == arg) {
+            opt.json_path = value;
+        } else if ("--warmup" == arg) {
+            opt.warmup = std::atoi(value);
+        } else if ("--iterations" == arg) {
+            opt.iterations = std::atoi(value);
+        } else if ("--duration" == arg) {
+            opt.duration_s = std::atof(value);
+        } else if ("--threads" == arg) {
+            opt.threads = std::atoi(value);
+        } else if ("--devices" == arg) {
+            opt.devices = std::atoi(value);
+        } else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    int sources = !opt.graph_path.empty() + !opt.nbg_path.empty() +
+                  !opt.plugin_path.empty();
+    if (1 != sources) {
+        std::cerr << "Exactly one of --graph, --nbg and --plugin is required"
+                  << std::endl;
+        return false;
+    }
+    if (opt.warmup < 0 || opt.iterations <= 0 || opt.duration_s < 0 ||
+        opt.threads <= 0 || opt.devices < 0) {
+        std::cerr << "Invalid iteration, duration, thread or device count"
+                  << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/// Builds an uncompiled copy of the model in a context
+using GraphBuilder = std::function<std::shared_ptr<tim::vx::Graph>(
+    const std::shared_ptr<tim::vx::Context>&, const tim::vx::CompileOption&)>;
+
+#ifdef TIM_BENCH_ENABLE_NBG
+bool QueryNbgSpec(nbg_parser_data nbg, bool input, int index,
+                  tim::vx::TensorSpec& spec) {
+    auto query = [&](nbg_buffer_property_e prop, void* value, uint32_t size) {
+        return input ? nbg_parser_query_input(nbg, index, prop, value, size)
+                     : nbg_parser_query_output(nbg, index, prop, value, size);
+    };
+    unsigned int dim_count = 0;
+    unsigned int dims[MAX_NUM_DIMS];
+    _nbg_buffer_format_e format;
+    _nbg_buffer_quantize_format_e quant_format;
+    float scale = 0;
+    int zero_point = 0;
+    query(NBG_PARSER_BUFFER_PROP_NUM_OF_DIMENSION, &dim_count,
+          sizeof(dim_count));
+    if (0 == dim_count || dim_count > MAX_NUM_DIMS) return false;
+    query(NBG_PARSER_BUFFER_PROP_DIMENSIONS, dims, sizeof(dims[0]) * dim_count);
+    query(NBG_PARSER_BUFFER_PROP_DATA_FORMAT, &format, sizeof(format));
+    query(NBG_PARSER_BUFFER_PROP_QUANT_FORMAT, &quant_format,
+          sizeof(quant_format));
+    query(NBG_PARSER_BUFFER_PROP_SCALE, &scale, sizeof(scale));
+    query(NBG_PARSER_BUFFER_PROP_ZERO_POINT, &zero_point, sizeof(zero_point));
+
+    tim::vx::DataType dtype;
+    switch (format) {
+        case NBG_BUFFER_FORMAT_FP32: dtype = tim::vx::DataType::FLOAT32; break;
+        case NBG_BUFFER_FORMAT_FP16: dtype = tim::vx::DataType::FLOAT16; break;
+        case NBG_BUFFER_FORMAT_UINT8: dtype = tim::vx::DataType::UINT8; break;
+        case NBG_BUFFER_FORMAT_INT8: dtype = tim::vx::DataType::INT8; break;
+        case NBG_BUFFER_FORMAT_UINT16: dtype = tim::vx::DataType::UINT16; break;
+        case NBG_BUFFER_FORMAT_INT16: dtype = tim::vx::DataType::INT16; break;
+        case NBG_BUFFER_FORMAT_UINT32: dtype = tim::vx::DataType::UINT32; break;
+        case NBG_BUFFER_FORMAT_INT32: dtype = tim::vx::DataType::INT32; break;
+        default: return false;
+    }
+    tim::vx::Quantization quant;
+    if (NBG_BUFFER_QUANTIZE_AFFINE_ASYMMETRIC == quant_format) {
+        quant = tim::vx::Quantization(tim::vx::QuantType::ASYMMETRIC, scale,
+                                      zero_point);
+    }
+    spec = tim::vx::TensorSpec(dtype, tim::vx::ShapeType(dims, dims + dim_count),
+                               input ? tim::vx::TensorAttribute::INPUT
+                                     : tim::vx::TensorAttribute::OUTPUT,
+                               quant);
+    return true;
+}
+
+bool NbgBuilder(const std::string& path, GraphBuilder& builder) {
+    size_t size = 0;
+    auto binary = tim::vx::ops::NBG::MapFile(path, &size);
+    if (!binary) return false;
+    nbg_parser_data nbg = NBG_NULL;
+    if (NBG_SUCCESS != nbg_parser_init_lazy(const_cast<char*>(binary.get()),
+                                            size, &nbg)) {
+        return false;
+    }
+    int input_count = 0;
+    int output_count = 0;
+    nbg_parser_query_network(nbg, NBG_PARSER_NETWORK_INPUT_COUNT, &input_count,
+                             sizeof(input_count));
+    nbg_parser_query_network(nbg, NBG_PARSER_NETWORK_OUTPUT_COUNT,
+                             &output_count, sizeof(output_count));
+    std::vector<tim::vx::TensorSpec> inputs(input_count);
+    std::vector<tim::vx::TensorSpec> outputs(output_count);
+    bool status = true;
+    for (int i = 0; i < input_count; ++i) {
+        status = status && QueryNbgSpec(nbg, true, i, inputs[i]);
+    }
+    for (int i = 0; i < output_count; ++i) {
+        status = status && QueryNbgSpec(nbg, false, i, outputs[i]);
+    }
+    nbg_parser_destroy(nbg);
+    if (!status) return false;
+
+    builder = [binary, inputs, outputs](
+                  const std::shared_ptr<tim::vx::Context>& ctx,
+                  const tim::vx::CompileOption& option) {
+        auto graph = ctx->CreateGraph(option);
+        auto nbg_op = graph->CreateOperation<tim::vx::ops::NBG>(
+            binary, inputs.size(), outputs.size());
+        for (const auto& spec : inputs) {
+            (*nbg_op).BindInput(graph->CreateTensor(spec));
+        }
+        for (const auto& spec : outputs) {
+            (*nbg_op).BindOutput(graph->CreateTensor(spec));
+        }
+        return graph;
+    };
+    return true;
+}
+#endif
+
+bool MakeBuilder(const Options& opt, GraphBuilder& builder) {
+    if (!opt.graph_path.empty()) {
+        std::string path = opt.graph_path;
+        builder = [path](const std::shared_ptr<tim::vx::Context>& ctx,
+                         const tim::vx::CompileOption& option) {
+            return ctx->LoadGraph(path, option);
+        };
+        return true;
+    }
+    if (!opt.nbg_path.empty()) {
+#ifdef TIM_BENCH_ENABLE_NBG
+        if (!NbgBuilder(opt.nbg_path, builder)) {
+            std::cerr << "Failed to parse " << opt.nbg_path << std::endl;
+            return false;
+        }
+        return true;
+#else
+        std::cerr << "--nbg needs a build with TIM_VX_ENABLE_NBG_PARSER"
+                  << std::endl;
+        return false;
+#endif
+    }
+
+    // The library stays loaded until exit, graphs may reference its code
+    void* library = dlopen(opt.plugin_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!library) {
+        std::cerr << "Failed to load " << opt.plugin_path << ": " << dlerror()
+                  << std::endl;
+        return false;
+    }
+    auto build = reinterpret_cast<TimBenchBuildGraphFunc>(
+        dlsym(library, TIM_BENCH_BUILD_GRAPH_SYMBOL));
+    if (!build) {
+        std::cerr << opt.plugin_path << " has no "
+                  << TIM_BENCH_BUILD_GRAPH_SYMBOL << std::endl;
+        return false;
+    }
+    std::string args = opt.plugin_args;
+    builder = [build, args](const std::shared_ptr<tim::vx::Context>& ctx,
+                            const tim::vx::CompileOption& option) {
+        auto graph = ctx->CreateGraph(option);
+        return build(graph.get(), args.c_str())
+                   ? graph
+                   : std::shared_ptr<tim::vx::Graph>();
+    };
+    return true;
+}
+
+/// Host side of a graph input or output, works on both tim::vx::Tensor and
+/// platform tensor handles
+struct HostBuffer {
+    std::vector<char> data;
+    std::function<bool(const void*, uint32_t)> write;
+    std::function<bool(void*)> read;
+};
+
+// Random bytes below 0x40 keep float and half values finite whatever the
+// element type is
+void FillInput(std::vector<char>& data, uint32_t seed) {
+    for (auto& byte : data) {
+        seed = seed * 1664525u + 1013904223u;
+        byte = static_cast<char>((seed >> 24) & 0x3f);
+    }
+}
+
+struct Worker {
+    // Keep the model alive while running
+    std::shared_ptr<tim::vx::Context> context;
+    std::shared_ptr<tim::vx::Graph> graph;
+    std::vector<std::shared_ptr<void>> holders;
+    std::function<bool()> run;
+    std::vector<HostBuffer> inputs;
+    std::vector<HostBuffer> outputs;
+    double compile_ms = 0;
+
+    std::vector<double> copy_in_ms;
+    std::vector<double> run_ms;
+    std::vector<double> copy_out_ms;
+    bool ok = true;
+
+    bool Iterate(bool record) {
+        auto t0 = Clock::now();
+        for (auto& in : inputs) {
+            if (!in.write(in.data.data(), in.data.size())) return false;
+        }
+        auto t1 = Clock::now();
+        if (!run()) return false;
+        auto t2 = Clock::now();
+        for (auto& out : outputs) {
+            if (!out.read(out.data.data())) return false;
+        }
+        auto t3 = Clock::now();
+        if (record) {
+            copy_in_ms.push_back(ElapsedMs(t0, t1));
+            run_ms.push_back(ElapsedMs(t1, t2));
+            copy_out_ms.push_back(ElapsedMs(t2, t3));
+        }
+        return true;
+    }
+};
+
+bool SetupGraphWorker(const GraphBuilder& builder,
+                      const tim::vx::CompileOption& option, Worker& w) {
+    w.context = tim::vx::Context::Create();
+    w.graph = builder(w.context, option);
+    if (!w.graph) return false;
+    auto start = Clock::now();
+    if (!w.graph->Compile()) return false;
+    w.compile_ms = ElapsedMs(start, Clock::now());
+
+    auto graph = w.graph;
+    w.run = [graph]() { return graph->Run(); };
+    for (const auto& t : graph->InputsTensor()) {
+        HostBuffer in;
+        in.data.resize(t->GetSpec().GetByteSize());
+        in.write = [t](const void* data, uint32_t size) {
+            return t->CopyDataToTensor(data, size);
+        };
+        w.inputs.push_back(std::move(in));
+    }
+    for (const auto& t : graph->OutputsTensor()) {
+        HostBuffer out;
+        out.data.resize(t->GetSpec().GetByteSize());
+        out.read = [t](void* data) { return t->CopyDataFromTensor(data); };
+        w.outputs.push_back(std::move(out));
+    }
+    return true;
+}
+
+#ifdef TIM_BENCH_ENABLE_PLATFORM
+bool SetupDeviceWorker(const GraphBuilder& builder,
+                       const tim::vx::CompileOption& option,
+                       const std::shared_ptr<tim::vx::platform::IDevice>& device,
+                       Worker& w) {
+    w.context = tim::vx::Context::Create();
+    w.graph = builder(w.context, option);
+    if (!w.graph) return false;
+    auto start = Clock::now();
+    auto executor =
+        std::make_shared<tim::vx::platform::NativeExecutor>(device, w.context);
+    auto executable = executor->Compile(w.graph);
+    if (!executable) return false;
+
+    for (const auto& t : w.graph->InputsTensor()) {
+        auto handle = executable->AllocateTensor(t->GetSpec());
+        executable->SetInput(handle);
+        HostBuffer in;
+        in.data.resize(t->GetSpec().GetByteSize());
+        in.write = [handle](const void* data, uint32_t size) {
+            return handle->CopyDataToTensor(data, size);
+        };
+        w.inputs.push_back(std::move(in));
+    }
+    for (const auto& t : w.graph->OutputsTensor()) {
+        auto handle = executable->AllocateTensor(t->GetSpec());
+        executable->SetOutput(handle);
+        HostBuffer out;
+        out.data.resize(t->GetSpec().GetByteSize());
+        out.read = [handle](void* data) {
+            return handle->CopyDataFromTensor(data);
+        };
+        w.outputs.push_back(std::move(out));
+    }
+    if (!executable->Verify()) return false;
+    w.compile_ms = ElapsedMs(start, Clock::now());
+
+    w.holders.push_back(executor);
+    w.run = [executable]() { return executable->Trigger(); };
+    return true;
+}
+#endif
+
+// Peak resident set size in kB, 0 if unknown
+uint64_t PeakRssKb() {
+#if defined(__linux__) || defined(__ANDROID__)
+    struct rusage usage;
+    if (0 == getrusage(RUSAGE_SELF, &usage)) {
+        return static_cast<uint64_t>(usage.ru_maxrss);
+    }
+#endif
+    return 0;
+}
+
+// Nearest-rank percentile of sorted samples
+double Percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+double Mean(const std::vector<double>& samples) {
+    double sum = 0;
+    for (double v : samples) sum += v;
+    return samples.empty() ? 0 : sum / samples.size();
+}
+
+std::string JsonString(const std::string& s) {
+    std::ostringstream out;
+    out << '"';
+    for (char c : s) {
+        if ('"' == c || '\\' == c) {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                << static_cast<int>(c) << std::dec;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+    return out.str();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!ParseOptions(argc, argv, opt)) {
+        PrintUsage();
+        return -1;
+    }
+#ifndef TIM_BENCH_ENABLE_PLATFORM
+    if (opt.devices > 0) {
+        std::cerr << "--devices needs a build with TIM_VX_ENABLE_PLATFORM"
+                  << std::endl;
+        return -1;
+    }
+#endif
+
+    GraphBuilder builder;
+    if (!MakeBuilder(opt, builder)) {
+        return -1;
+    }
+    tim::vx::CompileOption option;
+    option.setRelaxMode(opt.relax);
+
+#ifdef TIM_BENCH_ENABLE_PLATFORM
+    std::vector<std::shared_ptr<tim::vx::platform::IDevice>> devices;
+    if (opt.devices > 0) {
+        devices = tim::vx::platform::NativeDevice::Enumerate();
+        if (devices.size() < static_cast<size_t>(opt.devices)) {
+            std::cerr << "Only " << devices.size() << " device(s) found"
+                      << std::endl;
+            return -1;
+        }
+        devices.resize(opt.devices);
+    }
+#endif
+
+    // Workers are set up one by one, compile time is not skewed by
+    // concurrent compiles
+    std::vector<Worker> workers(opt.threads);
+    for (int i = 0; i < opt.threads; ++i) {
+        bool status = false;
+#ifdef TIM_BENCH_ENABLE_PLATFORM
+        if (!devices.empty()) {
+            status = SetupDeviceWorker(builder, option,
+                                       devices[i % devices.size()], workers[i]);
+        } else
+#endif
+        {
+            status = SetupGraphWorker(builder, option, workers[i]);
+        }
+        if (!status) {
+            std::cerr << "Failed to build or compile the graph of worker " << i
+                      << std::endl;
+            return -1;
+        }
+        for (auto& in : workers[i].inputs) {
+            FillInput(in.data, i + 1);
+        }
+    }
+
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    Clock::time_point start;
+    Clock::time_point deadline;
+    auto body = [&](Worker& w) {
+        for (int i = 0; i < opt.warmup && w.ok; ++i) {
+            w.ok = w.Iterate(false);
+        }
+        ready++;
+        while (!go) std::this_thread::yield();
+        for (int i = 0; w.ok; ++i) {
+            if (opt.duration_s > 0 ? Clock::now() >= deadline
+                                   : i >= opt.iterations) {
+                break;
+            }
+            w.ok = w.Iterate(true);
+        }
+    };
+    std::vector<std::thread> threads;
+    for (auto& w : workers) {
+        threads.emplace_back(body, std::ref(w));
+    }
+    while (ready < opt.threads) std::this_thread::yield();
+    start = Clock::now();
+    deadline = start + std::chrono::duration_cast<Clock::duration>(
+                           std::chrono::duration<double>(opt.duration_s));
+    go = true;
+    for (auto& t : threads) {
+        t.join();
+    }
+    double wall_ms = ElapsedMs(start, Clock::now());
+
+    bool ok = true;
+    std::vector<double> latency;
+    std::vector<double> copy_in;
+    std::vector<double> run;
+    std::vector<double> copy_out;
+    std::vector<double> compile;
+    for (const auto& w : workers) {
+        ok = ok && w.ok;
+        compile.push_back(w.compile_ms);
+        for (size_t i = 0; i < w.run_ms.size(); ++i) {
+            latency.push_back(w.copy_in_ms[i] + w.run_ms[i] +
+                              w.copy_out_ms[i]);
+        }
+        copy_in.insert(copy_in.end(), w.copy_in_ms.begin(),
+                       w.copy_in_ms.end());
+        run.insert(run.end(), w.run_ms.begin(), w.run_ms.end());
+        copy_out.insert(copy_out.end(), w.copy_out_ms.begin(),
+                        w.copy_out_ms.end());
+    }
+    std::sort(latency.begin(), latency.end());
+
+    std::string source = !opt.graph_path.empty() ? "graph"
+                         : !opt.nbg_path.empty() ? "nbg"
+                                                 : "plugin";
+    std::string path = !opt.graph_path.empty() ? opt.graph_path
+                       : !opt.nbg_path.empty() ? opt.nbg_path
+                                               : opt.plugin_path;
+    std::ostringstream json;
+    json << std::fixed << std::setprecision(3);
+    json << "{\n"
+         << "  \"status\": " << (ok ? "\"ok\"" : "\"run_failed\"") << ",\n"
+         << "  \"source\": " << JsonString(source) << ",\n"
+         << "  \"path\": " << JsonString(path) << ",\n"
+         << "  \"plugin_args\": " << JsonString(opt.plugin_args) << ",\n"
+         << "  \"threads\": " << opt.threads << ",\n"
+         << "  \"devices\": " << opt.devices << ",\n"
+         << "  \"warmup\": " << opt.warmup << ",\n"
+         << "  \"iterations\": " << latency.size() << ",\n"
+         << "  \"wall_ms\": " << wall_ms << ",\n"
+         << "  \"throughput_ips\": "
+         << (wall_ms > 0 ? latency.size() * 1000.0 / wall_ms : 0) << ",\n"
+         << "  \"compile_ms\": {\"mean\": " << Mean(compile)
+         << ", \"max\": " << *std::max_element(compile.begin(), compile.end())
+         << "},\n"
+         << "  \"latency_ms\": {\"min\": "
+         << (latency.empty() ? 0 : latency.front())
+         << ", \"mean\": " << Mean(latency)
+         << ", \"p50\": " << Percentile(latency, 50)
+         << ", \"p90\": " << Percentile(latency, 90)
+         << ", \"p99\": " << Percentile(latency, 99)
+         << ", \"max\": " << (latency.empty() ? 0 : latency.back()) << "},\n"
+         << "  \"phase_ms\": {\"copy_in\": " << Mean(copy_in)
+         << ", \"run\": " << Mean(run) << ", \"copy_out\": " << Mean(copy_out)
+         << "},\n"
+         << "  \"peak_rss_kb\": " << PeakRssKb() << "\n"
+         << "}\n";
+
+    if (opt.json_path.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(opt.json_path, std::ios::trunc);
+        if (!(file << json.str())) {
+            std::cerr << "Failed to write " << opt.json_path << std::endl;
+            return -1;
+        }
+    }
+    return ok ? 0 : -1;
+}
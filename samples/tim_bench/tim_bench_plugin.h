@@ -0,0 +1,43 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_BENCH_PLUGIN_H_
+#define TIM_BENCH_PLUGIN_H_
+
+#include "tim/vx/graph.h"
+
+/*
+ * Graph builder plugins are shared libraries loaded by tim_bench --plugin.
+ * The builder creates the operations of the model in `graph`, graph inputs
+ * and outputs are the tensors it creates with INPUT and OUTPUT attributes.
+ * `args` is the string passed with --plugin-args, empty if not set.
+ * Returns false if the graph can not be built.
+ */
+#define TIM_BENCH_BUILD_GRAPH_SYMBOL "TimBenchBuildGraph"
+
+typedef bool (*TimBenchBuildGraphFunc)(tim::vx::Graph* graph,
+                                       const char* args);
+
+extern "C" bool TimBenchBuildGraph(tim::vx::Graph* graph, const char* args);
+
+#endif /* TIM_BENCH_PLUGIN_H_ */
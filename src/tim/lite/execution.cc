@@ -32,6 +32,7 @@
 #include <iostream>
 #include <cassert>
 #include "handle_private.h"
+#include "mapped_file.h"
 
 #include "vip_lite.h"
 
@@ -41,14 +42,14 @@ namespace lite {
 ExecutionImpl::ExecutionImpl(const void* executable, size_t executable_size) {
     vip_status_e status = VIP_SUCCESS;
     vip_network network = nullptr;
-    std::vector<uint8_t> data(executable_size);
     valid_ = false;
     status = vip_init();
     if (status != VIP_SUCCESS) {
         return;
     }
-    memcpy(data.data(), executable, executable_size);
-    status = vip_create_network(data.data(), data.size(),
+    // Files from CreateFromFile are mapped writable copy-on-write, so the
+    // driver may write to them without touching the file
+    status = vip_create_network(const_cast<void*>(executable), executable_size,
         VIP_CREATE_NETWORK_FROM_MEMORY, &network);
     if (status == VIP_SUCCESS && network) {
         status = vip_prepare_network(network);
@@ -171,5 +172,18 @@ std::shared_ptr<Execution> Execution::Create(
     return exec;
 }
 
+std::shared_ptr<Execution> Execution::CreateFromFile(const std::string& path) {
+    size_t size = 0;
+    auto executable = tim::vx::MapFile(path, &size);
+    if (!executable) {
+        return nullptr;
+    }
+    auto exec = Create(executable.get(), size);
+    if (exec) {
+        std::static_pointer_cast<ExecutionImpl>(exec)->executable_ = executable;
+    }
+    return exec;
+}
+
 }
 }
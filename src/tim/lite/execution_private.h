@@ -53,6 +53,9 @@ class ExecutionImpl : public Execution {
   bool IsValid() const { return valid_; };
   vip_network network() { return network_; };
 
+  // Backing storage of the executable when created from a file
+  std::shared_ptr<const char> executable_;
+
  private:
   std::vector<std::shared_ptr<Handle>> input_handles_;
   std::vector<std::shared_ptr<Handle>> output_handles_;
@@ -69,6 +69,8 @@
 #include "ops/broadcast_layout_inference.h"
 #include "ops/unidirectional_rnn_layout_inference.h"
 #include "ops/bidirectional_rnn_layout_inference.h"
+#include "ops/scaled_dot_product_attention_layout_inference.h"
+#include "ops/slice_update_layout_inference.h"
 
 #include <algorithm>
 #include <deque>
@@ -277,6 +279,9 @@ std::vector<std::shared_ptr<vx::Tensor>> HandleLayoutInfer(
     REGIST_LAYOUT_INFERENCE(VSI_NN_OP_EXPAND_BROADCAST, Broadcast);
     REGIST_LAYOUT_INFERENCE(VSI_NN_OP_UNIDIRECTIONAL_SEQUENCE_RNN, UnidirectionalRnn);
     REGIST_LAYOUT_INFERENCE(VSI_NN_OP_BIDIRECTIONAL_SEQUENCE_RNN, BidirectionalRnn);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_CUSTOM_SCALED_DOT_PRODUCT_ATTENTION,
+                            ScaledDotProductAttention);
+    REGIST_LAYOUT_INFERENCE(VSI_NN_OP_CUSTOM_SLICE_UPDATE, SliceUpdate);
 #ifdef VSI_FEAT_OP_CUSTOM_TINY_YOLOV4_POSTPROCESS
     REGIST_LAYOUT_INFERENCE(VSI_NN_OP_CUSTOM_TINY_YOLOV4_POSTPROCESS, Yolov4);
 #endif
@@ -0,0 +1,72 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020-2023 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef TIM_LAYOUT_INFER_SCALED_DOT_PRODUCT_ATTENTION_LAYOUT_INFERENCE_H_
+#define TIM_LAYOUT_INFER_SCALED_DOT_PRODUCT_ATTENTION_LAYOUT_INFERENCE_H_
+
+#include "tim/vx/ops/scaled_dot_product_attention.h"
+
+#include "builtin_op_impl.h"
+#include "permute_vector.h"
+#include "ops/op_layout_inference.h"
+
+namespace tim {
+namespace transform {
+class ScaledDotProductAttentionLayoutInfer : public OpLayoutInfer {
+ public:
+  ScaledDotProductAttentionLayoutInfer(
+      const std::shared_ptr<vx::Operation> op,
+      std::shared_ptr<layout_inference_impl::LayoutInferContext>& context)
+      : OpLayoutInfer(op, context) {}
+
+  // The op works on axis 0 and 1 and treats the rest as batch, so a permute
+  // shared by all inputs that leaves those two axes alone is kept.
+  void OnInputs(
+      std::vector<std::shared_ptr<vx::Tensor>>& next_tensors) override {
+    auto input_tensors = op_->impl()->InputsTensor();
+    auto required_pv = context_->GetPermuteVector(input_tensors[0]);
+    auto pv = required_pv->AsStdVec();
+    bool keep = pv.size() >= 2 && pv[0] == 0 && pv[1] == 1;
+    for (const auto& i_src : input_tensors) {
+      keep = keep && context_->GetPermuteVector(i_src)->AsStdVec() == pv;
+    }
+    if (!keep) {
+      ReverseInputsPermuteVector();
+      required_pv = MakeShared(required_pv->Rank());
+    }
+
+    auto cloned_op = op_->Clone(context_->infer_graph_);
+    for (const auto& i_src : input_tensors) {
+      (*cloned_op).BindInput(context_->GetMapedTensor(i_src));
+    }
+    auto otensor_infer = CreateOutputsTensor(required_pv);
+    (*cloned_op).BindOutput(otensor_infer[0]);
+    context_->SetPermuteVector(op_->impl()->OutputsTensor()[0], required_pv);
+    next_tensors.push_back(op_->impl()->OutputsTensor()[0]);
+  }
+};
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
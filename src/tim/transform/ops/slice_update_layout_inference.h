@@ -0,0 +1,67 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020-2023 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#ifndef TIM_LAYOUT_INFER_SLICE_UPDATE_LAYOUT_INFERENCE_H_
+#define TIM_LAYOUT_INFER_SLICE_UPDATE_LAYOUT_INFERENCE_H_
+
+#include "tim/vx/ops/slice_update.h"
+
+#include "builtin_op_impl.h"
+#include "permute_vector.h"
+#include "ops/op_layout_inference.h"
+
+namespace tim {
+namespace transform {
+class SliceUpdateLayoutInfer : public OpLayoutInfer {
+ public:
+  SliceUpdateLayoutInfer(
+      const std::shared_ptr<vx::Operation> op,
+      std::shared_ptr<layout_inference_impl::LayoutInferContext>& context)
+      : OpLayoutInfer(op, context) {}
+
+  // The output is persistent state owned by the caller, keep it in the
+  // source layout and expose it through the graph io map so the caller can
+  // still initialize and read it on the inferred graph.
+  void OnInputs(
+      std::vector<std::shared_ptr<vx::Tensor>>& next_tensors) override {
+    ReverseInputsPermuteVector();
+    auto input_tensors = op_->impl()->InputsTensor();
+    auto src_output = op_->impl()->OutputsTensor()[0];
+    auto required_pv = MakeShared(src_output->GetShape().size());
+
+    auto cloned_op = op_->Clone(context_->infer_graph_);
+    for (const auto& i_src : input_tensors) {
+      (*cloned_op).BindInput(context_->GetMapedTensor(i_src));
+    }
+    auto otensor_infer = CreateOutputsTensor(required_pv);
+    (*cloned_op).BindOutput(otensor_infer[0]);
+    context_->UpdateGraphOutputMap(src_output, otensor_infer[0]);
+    context_->SetPermuteVector(src_output, required_pv);
+    next_tensors.push_back(src_output);
+  }
+};
+
+}  // namespace transform
+}  // namespace tim
+
+#endif
@@ -0,0 +1,891 @@
+/****************************************************************************
+ *
+ *    Copyright (c) 2020-2023 Vivante Corporation
+ *
+ *    Permission is hereby granted, free of charge, to any person obtaining a
+ *    copy of this software and associated documentation files (the "Software"),
+ *    to deal in the Software without restriction, including without limitation
+ *    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ *    and/or sell copies of the Software, and to permit persons to whom the
+ *    Software is furnished to do so, subject to the following conditions:
+ *
+ *    The above copyright notice and this permission notice shall be included in
+ *    all copies or substantial portions of the Software.
+ *
+ *    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ *    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ *    DEALINGS IN THE SOFTWARE.
+ *
+ *****************************************************************************/
+#include "tim/transform/quantization.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/operation.h"
+#include "graph_private.h"
+#include "op_impl.h"
+
+namespace tim {
+namespace transform {
+
+namespace {
+
+/* Doubling merges bins pairwise, so the count has to be even */
+uint32_t EvenBins(uint32_t bins) { return std::max(2u, bins + (bins & 1)); }
+
+void QuantRange(vx::DataType type, int32_t* qmin, int32_t* qmax) {
+  switch (type) {
+    case vx::DataType::INT4:
+      *qmin = -8;
+      *qmax = 7;
+      break;
+    case vx::DataType::UINT4:
+      *qmin = 0;
+      *qmax = 15;
+      break;
+    case vx::DataType::INT8:
+      *qmin = std::numeric_limits<int8_t>::min();
+      *qmax = std::numeric_limits<int8_t>::max();
+      break;
+    case vx::DataType::INT16:
+      *qmin = std::numeric_limits<int16_t>::min();
+      *qmax = std::numeric_limits<int16_t>::max();
+      break;
+    case vx::DataType::UINT16:
+      *qmin = std::numeric_limits<uint16_t>::min();
+      *qmax = std::numeric_limits<uint16_t>::max();
+      break;
+    case vx::DataType::INT32:
+      *qmin = std::numeric_limits<int32_t>::min();
+      *qmax = std::numeric_limits<int32_t>::max();
+      break;
+    default:
+      *qmin = std::numeric_limits<uint8_t>::min();
+      *qmax = std::numeric_limits<uint8_t>::max();
+      break;
+  }
+}
+
+}  // namespace
+
+TensorStatistics::TensorStatistics(uint32_t bins)
+    : bins_(EvenBins(bins)),
+      min_(std::numeric_limits<float>::max()),
+      max_(std::numeric_limits<float>::lowest()) {}
+
+void TensorStatistics::Histogram::Add(float value) {
+  size_t n = bins.size();
+  while (value < low) {
+    // The old range becomes the upper half
+    std::vector<uint64_t> merged(n, 0);
+    for (size_t k = 0; k < n; k++) {
+      merged[(n + k) / 2] += bins[k];
+    }
+    bins.swap(merged);
+    low -= n * width;
+    width *= 2;
+  }
+  while (value >= low + n * width) {
+    std::vector<uint64_t> merged(n, 0);
+    for (size_t k = 0; k < n; k++) {
+      merged[k / 2] += bins[k];
+    }
+    bins.swap(merged);
+    width *= 2;
+  }
+  size_t index = static_cast<size_t>((value - low) / width);
+  bins[std::min(index, n - 1)]++;
+}
+
+float TensorStatistics::Histogram::Lower(uint64_t rank) const {
+  uint64_t seen = 0;
+  for (size_t k = 0; k < bins.size(); k++) {
+    seen += bins[k];
+    if (seen > rank) {
+      return low + k * width;
+    }
+  }
+  return low + bins.size() * width;
+}
+
+float TensorStatistics::Histogram::Upper(uint64_t rank) const {
+  return Lower(rank) + width;
+}
+
+void TensorStatistics::Observe(const float* data, size_t count) {
+  float batch_min = std::numeric_limits<float>::max();
+  float batch_max = std::numeric_limits<float>::lowest();
+  for (size_t i = 0; i < count; i++) {
+    if (std::isfinite(data[i])) {
+      batch_min = std::min(batch_min, data[i]);
+      batch_max = std::max(batch_max, data[i]);
+    }
+  }
+  if (batch_min > batch_max) {
+    return;
+  }
+  if (count_ == 0) {
+    const float kMinWidth = 1e-12f;
+    float magnitude = std::max(std::fabs(batch_min), std::fabs(batch_max));
+    values_.low = batch_min;
+    values_.width = std::max((batch_max - batch_min) / bins_, kMinWidth);
+    values_.bins.assign(bins_, 0);
+    magnitudes_.low = 0;
+    magnitudes_.width = std::max(magnitude / bins_, kMinWidth);
+    magnitudes_.bins.assign(bins_, 0);
+  }
+  for (size_t i = 0; i < count; i++) {
+    if (std::isfinite(data[i])) {
+      values_.Add(data[i]);
+      magnitudes_.Add(std::fabs(data[i]));
+      count_++;
+    }
+  }
+  min_ = std::min(min_, batch_min);
+  max_ = std::max(max_, batch_max);
+}
+
+/* TensorRT style entropy calibration, `levels` bins of the quantized
+ * histogram cover [0, threshold) */
+float TensorStatistics::KLThreshold(uint32_t levels) const {
+  const auto& hist = magnitudes_.bins;
+  size_t n = hist.size();
+  size_t last = n;
+  while (last > 0 && hist[last - 1] == 0) {
+    last--;
+  }
+  if (last <= levels) {
+    return last * magnitudes_.width;
+  }
+  size_t best = last;
+  double best_divergence = std::numeric_limits<double>::max();
+  std::vector<double> reference(n), expanded(n);
+  for (size_t i = levels; i <= last; i++) {
+    // Reference: the first i bins with the clipped tail folded in the last
+    double outliers = 0;
+    for (size_t k = i; k < last; k++) {
+      outliers += hist[k];
+    }
+    double reference_sum = outliers;
+    for (size_t k = 0; k < i; k++) {
+      reference[k] = static_cast<double>(hist[k]);
+      reference_sum += reference[k];
+    }
+    reference[i - 1] += outliers;
+    // Candidate: the same bins merged into `levels` and spread back over
+    // the bins that were not empty
+    double expanded_sum = 0;
+    for (size_t j = 0; j < levels; j++) {
+      size_t start = j * i / levels;
+      size_t end = (j + 1) * i / levels;
+      double total = 0;
+      size_t used = 0;
+      for (size_t k = start; k < end; k++) {
+        total += hist[k];
+        used += hist[k] != 0;
+      }
+      for (size_t k = start; k < end; k++) {
+        expanded[k] = (hist[k] != 0) ? total / used : 0;
+        expanded_sum += expanded[k];
+      }
+    }
+    if (expanded_sum == 0) {
+      continue;
+    }
+    const double kEpsilon = 1e-10;
+    double divergence = 0;
+    for (size_t k = 0; k < i; k++) {
+      if (reference[k] == 0) {
+        continue;
+      }
+      double p = reference[k] / reference_sum;
+      double q = std::max(expanded[k] / expanded_sum, kEpsilon);
+      divergence += p * std::log(p / q);
+    }
+    if (divergence < best_divergence) {
+      best_divergence = divergence;
+      best = i;
+    }
+  }
+  return best * magnitudes_.width;
+}
+
+std::pair<float, float> TensorStatistics::Range(
+    const QuantizationOptions& options) const {
+  if (count_ == 0) {
+    return {0.0f, 0.0f};
+  }
+  float low = min_;
+  float high = max_;
+  switch (options.method) {
+    case CalibrationMethod::PERCENTILE: {
+      double tail = std::max(0.0, 100.0 - options.percentile) / 100.0;
+      auto low_rank = static_cast<uint64_t>(std::floor(count_ * tail));
+      auto high_rank = static_cast<uint64_t>(
+          std::ceil(count_ * (1.0 - tail)));
+      low = std::max(low, values_.Lower(low_rank));
+      high = std::min(high, values_.Upper(high_rank > 0 ? high_rank - 1 : 0));
+      break;
+    }
+    case CalibrationMethod::KL_DIVERGENCE: {
+      // Non negative tensors, e.g. after a relu, use every level of the
+      // asymmetric type on one side
+      float threshold = KLThreshold(min_ >= 0 ? 256 : 128);
+      low = std::max(low, -threshold);
+      high = std::min(high, threshold);
+      break;
+    }
+    default:
+      break;
+  }
+  return {std::min(low, 0.0f), std::max(high, 0.0f)};
+}
+
+vx::Quantization AsymmetricQuantization(float min, float max,
+                                        vx::DataType type) {
+  int32_t qmin, qmax;
+  QuantRange(type, &qmin, &qmax);
+  min = std::min(min, 0.0f);
+  max = std::max(max, 0.0f);
+  if (max == min) {
+    return vx::Quantization(vx::QuantType::ASYMMETRIC, 1.0f,
+                            std::max(qmin, std::min(qmax, 0)));
+  }
+  double scale = (static_cast<double>(max) - min) /
+                 (static_cast<double>(qmax) - qmin);
+  // Nudge the zero point to an integer so that 0 is exact
+  double zero_point = std::round(qmin - min / scale);
+  zero_point = std::max<double>(qmin, std::min<double>(qmax, zero_point));
+  return vx::Quantization(vx::QuantType::ASYMMETRIC,
+                          static_cast<float>(scale),
+                          static_cast<int32_t>(zero_point));
+}
+
+vx::Quantization PerChannelQuantization(const std::vector<float>& data,
+                                        const vx::ShapeType& shape,
+                                        int32_t channel_dim,
+                                        vx::DataType type) {
+  int32_t qmin, qmax;
+  QuantRange(type, &qmin, &qmax);
+  size_t inner = 1;
+  for (int32_t i = 0; i < channel_dim; i++) {
+    inner *= shape[i];
+  }
+  size_t channels = shape[channel_dim];
+  std::vector<float> magnitude(channels, 0.0f);
+  for (size_t i = 0; i < data.size(); i++) {
+    auto& m = magnitude[(i / inner) % channels];
+    m = std::max(m, std::fabs(data[i]));
+  }
+  std::vector<float> scales(channels);
+  for (size_t c = 0; c < channels; c++) {
+    scales[c] = magnitude[c] > 0 ? magnitude[c] / qmax : 1.0f;
+  }
+  return vx::Quantization(vx::QuantType::SYMMETRIC_PER_CHANNEL, channel_dim,
+                          scales, std::vector<int32_t>(channels, 0));
+}
+
+namespace {
+
+/* Scale and zero point of element `i` */
+class ElementQuantization {
+ public:
+  explicit ElementQuantization(const vx::TensorSpec& spec) {
+    const auto& quant = spec.quantization_;
+    if (quant.Type() == vx::QuantType::NONE || quant.Scales().empty()) {
+      return;
+    }
+    scales_ = quant.Scales();
+    zero_points_ = quant.ZeroPoints();
+    zero_points_.resize(scales_.size(), 0);
+    if (quant.Type() == vx::QuantType::SYMMETRIC_PER_CHANNEL) {
+      for (int32_t i = 0; i < quant.ChannelDim(); i++) {
+        inner_ *= spec.shape_[i];
+      }
+    }
+  }
+
+  bool Quantized() const { return !scales_.empty(); }
+  float Scale(size_t i) const { return scales_[Channel(i)]; }
+  int32_t ZeroPoint(size_t i) const { return zero_points_[Channel(i)]; }
+
+ private:
+  size_t Channel(size_t i) const { return (i / inner_) % scales_.size(); }
+
+  std::vector<float> scales_;
+  std::vector<int32_t> zero_points_;
+  size_t inner_{1};
+};
+
+template <typename T>
+void QuantizeTo(const std::vector<float>& data, const vx::TensorSpec& spec,
+                std::vector<char>* bytes,
+                double qmin = std::numeric_limits<T>::lowest(),
+                double qmax = std::numeric_limits<T>::max()) {
+  ElementQuantization quant(spec);
+  bytes->resize(data.size() * sizeof(T));
+  T* out = reinterpret_cast<T*>(bytes->data());
+  for (size_t i = 0; i < data.size(); i++) {
+    double value = data[i];
+    if (quant.Quantized()) {
+      value = std::round(value / quant.Scale(i)) + quant.ZeroPoint(i);
+    }
+    out[i] = static_cast<T>(std::max(qmin, std::min(qmax, value)));
+  }
+}
+
+template <typename T>
+void DequantizeFrom(const std::vector<char>& bytes, const vx::TensorSpec& spec,
+                    std::vector<float>* data) {
+  ElementQuantization quant(spec);
+  data->resize(bytes.size() / sizeof(T));
+  const T* in = reinterpret_cast<const T*>(bytes.data());
+  for (size_t i = 0; i < data->size(); i++) {
+    (*data)[i] = quant.Quantized()
+                     ? quant.Scale(i) * (static_cast<float>(in[i]) -
+                                         quant.ZeroPoint(i))
+                     : static_cast<float>(in[i]);
+  }
+}
+
+/* 4-bit data goes through one byte per element and is packed by rows of
+ * shape[0], see vx::utils::Pack4Bit() */
+vx::ShapeType PackedShape(const vx::TensorSpec& spec, size_t count) {
+  return spec.shape_.empty() ? vx::ShapeType{static_cast<uint32_t>(count)}
+                             : spec.shape_;
+}
+
+void QuantizeTo4Bit(const std::vector<float>& data, const vx::TensorSpec& spec,
+                    std::vector<char>* bytes) {
+  int32_t qmin, qmax;
+  QuantRange(spec.datatype_, &qmin, &qmax);
+  std::vector<char> unpacked;
+  QuantizeTo<int8_t>(data, spec, &unpacked, qmin, qmax);
+  auto shape = PackedShape(spec, data.size());
+  vx::TensorSpec packed(spec.datatype_, shape, spec.attr_);
+  bytes->assign(packed.GetByteSize(), 0);
+  vx::utils::Pack4Bit(reinterpret_cast<const uint8_t*>(unpacked.data()),
+                      reinterpret_cast<uint8_t*>(bytes->data()), shape);
+}
+
+void DequantizeFrom4Bit(const std::vector<char>& bytes,
+                        const vx::TensorSpec& spec, std::vector<float>* data) {
+  auto shape = PackedShape(spec, bytes.size() * 2);
+  vx::TensorSpec packed(spec.datatype_, shape, spec.attr_);
+  if (static_cast<int64_t>(bytes.size()) < packed.GetByteSize()) {
+    VSILOGE("Expect %lld bytes of 4-bit data, got %zu",
+            static_cast<long long>(packed.GetByteSize()), bytes.size());
+    return;
+  }
+  bool is_signed = spec.datatype_ == vx::DataType::INT4;
+  std::vector<char> unpacked(packed.GetElementNum());
+  vx::utils::Unpack4Bit(reinterpret_cast<const uint8_t*>(bytes.data()),
+                        reinterpret_cast<uint8_t*>(unpacked.data()), shape,
+                        is_signed);
+  if (is_signed) {
+    DequantizeFrom<int8_t>(unpacked, spec, data);
+  } else {
+    DequantizeFrom<uint8_t>(unpacked, spec, data);
+  }
+}
+
+/* bfloat16 keeps the upper half of a float32, rounded to nearest even */
+void ToBFloat16(const std::vector<float>& data, std::vector<char>* bytes) {
+  bytes->resize(data.size() * sizeof(uint16_t));
+  uint16_t* out = reinterpret_cast<uint16_t*>(bytes->data());
+  for (size_t i = 0; i < data.size(); i++) {
+    uint32_t bits;
+    memcpy(&bits, &data[i], sizeof(bits));
+    if (std::isnan(data[i])) {
+      out[i] = static_cast<uint16_t>((bits >> 16) | 0x0040);
+      continue;
+    }
+    bits += 0x7FFF + ((bits >> 16) & 1);
+    out[i] = static_cast<uint16_t>(bits >> 16);
+  }
+}
+
+void FromBFloat16(const std::vector<char>& bytes, std::vector<float>* data) {
+  data->resize(bytes.size() / sizeof(uint16_t));
+  const uint16_t* in = reinterpret_cast<const uint16_t*>(bytes.data());
+  for (size_t i = 0; i < data->size(); i++) {
+    uint32_t bits = static_cast<uint32_t>(in[i]) << 16;
+    memcpy(&(*data)[i], &bits, sizeof(bits));
+  }
+}
+
+}  // namespace
+
+std::vector<char> QuantizeData(const std::vector<float>& data,
+                               const vx::TensorSpec& spec) {
+  std::vector<char> bytes;
+  switch (spec.datatype_) {
+    case vx::DataType::INT8:
+      QuantizeTo<int8_t>(data, spec, &bytes);
+      break;
+    case vx::DataType::UINT8:
+      QuantizeTo<uint8_t>(data, spec, &bytes);
+      break;
+    case vx::DataType::INT16:
+      QuantizeTo<int16_t>(data, spec, &bytes);
+      break;
+    case vx::DataType::UINT16:
+      QuantizeTo<uint16_t>(data, spec, &bytes);
+      break;
+    case vx::DataType::INT32:
+      QuantizeTo<int32_t>(data, spec, &bytes);
+      break;
+    case vx::DataType::INT4:
+    case vx::DataType::UINT4:
+      QuantizeTo4Bit(data, spec, &bytes);
+      break;
+    case vx::DataType::BFLOAT16:
+      ToBFloat16(data, &bytes);
+      break;
+    case vx::DataType::FLOAT32:
+      bytes.resize(data.size() * sizeof(float));
+      memcpy(bytes.data(), data.data(), bytes.size());
+      break;
+    default:
+      VSILOGE("Unsupported data type %d", static_cast<int>(spec.datatype_));
+      break;
+  }
+  return bytes;
+}
+
+std::vector<float> DequantizeData(const std::vector<char>& data,
+                                  const vx::TensorSpec& spec) {
+  std::vector<float> values;
+  switch (spec.datatype_) {
+    case vx::DataType::INT8:
+      DequantizeFrom<int8_t>(data, spec, &values);
+      break;
+    case vx::DataType::UINT8:
+      DequantizeFrom<uint8_t>(data, spec, &values);
+      break;
+    case vx::DataType::INT16:
+      DequantizeFrom<int16_t>(data, spec, &values);
+      break;
+    case vx::DataType::UINT16:
+      DequantizeFrom<uint16_t>(data, spec, &values);
+      break;
+    case vx::DataType::INT32:
+      DequantizeFrom<int32_t>(data, spec, &values);
+      break;
+    case vx::DataType::INT4:
+    case vx::DataType::UINT4:
+      DequantizeFrom4Bit(data, spec, &values);
+      break;
+    case vx::DataType::BFLOAT16:
+      FromBFloat16(data, &values);
+      break;
+    case vx::DataType::FLOAT32:
+      DequantizeFrom<float>(data, spec, &values);
+      break;
+    default:
+      VSILOGE("Unsupported data type %d", static_cast<int>(spec.datatype_));
+      break;
+  }
+  return values;
+}
+
+namespace {
+
+using TensorMap =
+    std::map<std::shared_ptr<vx::Tensor>, std::shared_ptr<vx::Tensor>>;
+
+std::vector<std::shared_ptr<vx::Operation>>& Operations(
+    const std::shared_ptr<vx::Graph>& graph) {
+  return static_cast<vx::GraphImpl*>(graph.get())->OpVector();
+}
+
+std::shared_ptr<vx::Tensor> CreateConstant(
+    const std::shared_ptr<vx::Graph>& graph, const vx::TensorSpec& spec,
+    std::vector<char> data) {
+  auto owner = std::make_shared<std::vector<char>>(std::move(data));
+  static_cast<vx::GraphImpl*>(graph.get())
+      ->RetainBuffer(std::shared_ptr<const char>(owner, owner->data()));
+  return graph->CreateTensor(spec, owner->data());
+}
+
+std::vector<char> ReadTensor(const std::shared_ptr<vx::Tensor>& tensor) {
+  std::vector<char> data(tensor->GetSpec().GetByteSize());
+  if (!tensor->CopyDataFromTensor(data.data())) {
+    data.clear();
+  }
+  return data;
+}
+
+/* Clones `op` into `graph`, `map` maps every tensor `op` uses */
+void CloneOperation(const std::shared_ptr<vx::Operation>& op,
+                    std::shared_ptr<vx::Graph>& graph, const TensorMap& map) {
+  auto cloned = op->Clone(graph);
+  for (const auto& input : op->impl()->InputsTensor()) {
+    cloned->BindInput(map.at(input));
+  }
+  std::vector<std::shared_ptr<vx::Tensor>> outputs;
+  for (const auto& output : op->impl()->OutputsTensor()) {
+    outputs.push_back(map.at(output));
+  }
+  cloned->BindOutputs(outputs);
+}
+
+}  // namespace
+
+/* Copy of a graph in which every non constant tensor is readable */
+class ObserverGraph {
+ public:
+  ObserverGraph(const std::shared_ptr<vx::Graph>& src_graph,
+                std::shared_ptr<vx::Context>& ctx) {
+    graph_ = ctx->CreateGraph();
+    for (const auto& input : src_graph->InputsTensor()) {
+      Map(input);
+    }
+    for (const auto& op : Operations(src_graph)) {
+      for (const auto& tensor : op->impl()->InputsTensor()) {
+        Map(tensor);
+      }
+      for (const auto& tensor : op->impl()->OutputsTensor()) {
+        Map(tensor);
+      }
+      CloneOperation(op, graph_, map_);
+    }
+    compiled_ = graph_->Compile();
+    if (compiled_) {
+      ResolveShapes();
+    }
+  }
+
+  const std::vector<std::shared_ptr<vx::Tensor>>& Observed() const {
+    return observed_;
+  }
+
+  /// `inputs` holds the raw bytes of each graph input
+  bool Run(const std::vector<std::vector<char>>& inputs) {
+    auto graph_inputs = graph_->InputsTensor();
+    if (!compiled_ || inputs.size() != graph_inputs.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+      if (inputs[i].size() !=
+              static_cast<size_t>(graph_inputs[i]->GetSpec().GetByteSize()) ||
+          !graph_inputs[i]->CopyDataToTensor(inputs[i].data(),
+                                             inputs[i].size())) {
+        return false;
+      }
+    }
+    return graph_->Run();
+  }
+
+  /// Values of `tensor` of the source graph after the last Run()
+  std::vector<float> Read(const std::shared_ptr<vx::Tensor>& tensor) const {
+    auto it = map_.find(tensor);
+    if (it == map_.end()) {
+      return std::vector<float>();
+    }
+    return DequantizeData(ReadTensor(it->second), it->second->GetSpec());
+  }
+
+ private:
+  void Map(const std::shared_ptr<vx::Tensor>& tensor) {
+    if (map_.count(tensor)) {
+      return;
+    }
+    std::shared_ptr<vx::Tensor> mapped;
+    if (tensor->IsPlaceHolder()) {
+      mapped = graph_->CreateTensorPlaceHolder();
+    } else if (tensor->IsConstTensor()) {
+      mapped = CreateConstant(graph_, tensor->GetSpec(), ReadTensor(tensor));
+    } else {
+      vx::TensorSpec spec = tensor->GetSpec();
+      if (!(spec.attr_ & (vx::TensorAttribute::INPUT |
+                          vx::TensorAttribute::VARIABLE))) {
+        spec.SetAttribute(vx::TensorAttribute::OUTPUT);
+      }
+      mapped = graph_->CreateTensor(spec);
+      if (!(spec.attr_ & vx::TensorAttribute::VARIABLE)) {
+        observed_.push_back(tensor);
+      }
+    }
+    map_[tensor] = mapped;
+  }
+
+  /* Outputs may leave their shape to the graph */
+  void ResolveShapes() {
+    auto graph_impl = static_cast<vx::GraphImpl*>(graph_.get());
+    for (const auto& tensor : observed_) {
+      auto& mapped = map_[tensor];
+      if (!mapped->GetShape().empty()) {
+        continue;
+      }
+      vsi_nn_tensor_t* vsi_tensor =
+          vsi_nn_GetTensor(graph_impl->graph(), mapped->GetId());
+      if (vsi_tensor) {
+        vx::ShapeType shape(vsi_tensor->attr.size,
+                            vsi_tensor->attr.size + vsi_tensor->attr.dim_num);
+        mapped->GetSpec().SetShape(shape);
+      }
+    }
+  }
+
+  std::shared_ptr<vx::Graph> graph_;
+  TensorMap map_;
+  std::vector<std::shared_ptr<vx::Tensor>> observed_;
+  bool compiled_{false};
+};
+
+struct Calibrator::Observer : public ObserverGraph {
+  using ObserverGraph::ObserverGraph;
+};
+
+Calibrator::Calibrator(const std::shared_ptr<vx::Graph>& graph,
+                       std::shared_ptr<vx::Context>& ctx,
+                       const QuantizationOptions& options)
+    : options_(options), observer_(new Observer(graph, ctx)) {}
+
+Calibrator::~Calibrator() {}
+
+bool Calibrator::Feed(const std::vector<std::vector<float>>& inputs) {
+  std::vector<std::vector<char>> bytes;
+  for (const auto& input : inputs) {
+    bytes.push_back(QuantizeData(
+        input, vx::TensorSpec(vx::DataType::FLOAT32, {},
+                              vx::TensorAttribute::INPUT)));
+  }
+  if (!observer_->Run(bytes)) {
+    return false;
+  }
+  for (const auto& tensor : observer_->Observed()) {
+    if (tensor->GetDataType() == vx::DataType::FLOAT32) {
+      auto values = observer_->Read(tensor);
+      Observe(tensor, values.data(), values.size());
+    }
+  }
+  return true;
+}
+
+void Calibrator::Observe(const std::shared_ptr<vx::Tensor>& tensor,
+                         const float* data, size_t count) {
+  auto it = statistics_.find(tensor);
+  if (it == statistics_.end()) {
+    it = statistics_
+             .emplace(tensor, TensorStatistics(options_.histogram_bins))
+             .first;
+  }
+  it->second.Observe(data, count);
+}
+
+const TensorStatistics* Calibrator::Statistics(
+    const std::shared_ptr<vx::Tensor>& tensor) const {
+  auto it = statistics_.find(tensor);
+  return it == statistics_.end() ? nullptr : &it->second;
+}
+
+namespace {
+
+bool HasWeights(int32_t kind) {
+  switch (kind) {
+    case VSI_NN_OP_CONV1D:
+    case VSI_NN_OP_CONV2D:
+    case VSI_NN_OP_CONV3D:
+    case VSI_NN_OP_GROUPED_CONV2D:
+    case VSI_NN_OP_DECONVOLUTION:
+    case VSI_NN_OP_FCL2:
+      return true;
+    default:
+      return false;
+  }
+}
+
+std::vector<float> ReadFloats(const std::shared_ptr<vx::Tensor>& tensor) {
+  return DequantizeData(ReadTensor(tensor), tensor->GetSpec());
+}
+
+/* Spec of weights (index 1) and biases (index 2) of ops with weights, the
+ * weights keep their output channels in the last dimension */
+vx::TensorSpec ParameterSpec(const std::shared_ptr<vx::Operation>& op,
+                             size_t index, const std::vector<float>& data,
+                             const TensorMap& map,
+                             const QuantizationOptions& options) {
+  const auto& inputs = op->impl()->InputsTensor();
+  vx::TensorSpec spec = inputs[index]->GetSpec();
+  if (index == 1) {
+    if (options.per_channel_weights &&
+        op->impl()->kind_ != VSI_NN_OP_DECONVOLUTION) {
+      spec.datatype_ = options.weight_type;
+      spec.quantization_ = PerChannelQuantization(
+          data, spec.shape_, static_cast<int32_t>(spec.shape_.size()) - 1,
+          options.weight_type);
+    } else {
+      auto range = std::minmax_element(data.begin(), data.end());
+      spec.datatype_ = options.activation_type;
+      spec.quantization_ = AsymmetricQuantization(
+          data.empty() ? 0.0f : *range.first,
+          data.empty() ? 0.0f : *range.second, options.activation_type);
+    }
+    return spec;
+  }
+  const auto& input_quant = map.at(inputs[0])->GetSpec().quantization_;
+  const auto& weight_quant = map.at(inputs[1])->GetSpec().quantization_;
+  float input_scale =
+      input_quant.Scales().empty() ? 1.0f : input_quant.Scales()[0];
+  std::vector<float> scales;
+  for (float weight_scale : weight_quant.Scales()) {
+    scales.push_back(input_scale * weight_scale);
+  }
+  spec.datatype_ = vx::DataType::INT32;
+  if (weight_quant.Type() == vx::QuantType::SYMMETRIC_PER_CHANNEL) {
+    spec.quantization_ =
+        vx::Quantization(vx::QuantType::SYMMETRIC_PER_CHANNEL, 0, scales,
+                         std::vector<int32_t>(scales.size(), 0));
+  } else {
+    spec.quantization_ = vx::Quantization(
+        vx::QuantType::ASYMMETRIC, scales.empty() ? input_scale : scales[0],
+        0);
+  }
+  return spec;
+}
+
+}  // namespace
+
+std::pair<std::shared_ptr<vx::Graph>, TensorMap> Quantize(
+    const std::shared_ptr<vx::Graph>& src_graph,
+    std::shared_ptr<vx::Context>& ctx, const Calibrator& calibrator) {
+  const auto& options = calibrator.Options();
+  auto graph = ctx->CreateGraph();
+  TensorMap map;
+
+  auto map_activation = [&](const std::shared_ptr<vx::Tensor>& tensor) {
+    if (map.count(tensor)) {
+      return true;
+    }
+    vx::TensorSpec spec = tensor->GetSpec();
+    if (spec.datatype_ == vx::DataType::FLOAT32) {
+      auto statistics = calibrator.Statistics(tensor);
+      if (!statistics) {
+        VSILOGE("Tensor was not calibrated");
+        return false;
+      }
+      auto range = statistics->Range(options);
+      spec.datatype_ = options.activation_type;
+      spec.quantization_ = AsymmetricQuantization(range.first, range.second,
+                                                  options.activation_type);
+    }
+    map[tensor] = graph->CreateTensor(spec);
+    return true;
+  };
+
+  for (const auto& input : src_graph->InputsTensor()) {
+    if (!map_activation(input)) {
+      return {nullptr, TensorMap()};
+    }
+  }
+  for (const auto& op : Operations(src_graph)) {
+    const auto& inputs = op->impl()->InputsTensor();
+    for (size_t i = 0; i < inputs.size(); i++) {
+      const auto& tensor = inputs[i];
+      if (map.count(tensor)) {
+        continue;
+      }
+      if (tensor->IsPlaceHolder()) {
+        map[tensor] = graph->CreateTensorPlaceHolder();
+      } else if (!tensor->IsConstTensor()) {
+        if (!map_activation(tensor)) {
+          return {nullptr, TensorMap()};
+        }
+      } else if (tensor->GetDataType() != vx::DataType::FLOAT32) {
+        map[tensor] =
+            CreateConstant(graph, tensor->GetSpec(), ReadTensor(tensor));
+      } else {
+        auto data = ReadFloats(tensor);
+        vx::TensorSpec spec;
+        if (HasWeights(op->impl()->kind_) && (i == 1 || i == 2)) {
+          spec = ParameterSpec(op, i, data, map, options);
+        } else {
+          auto range = std::minmax_element(data.begin(), data.end());
+          spec = tensor->GetSpec();
+          spec.datatype_ = options.activation_type;
+          spec.quantization_ = AsymmetricQuantization(
+              data.empty() ? 0.0f : *range.first,
+              data.empty() ? 0.0f : *range.second, options.activation_type);
+        }
+        map[tensor] = CreateConstant(graph, spec, QuantizeData(data, spec));
+      }
+    }
+    for (const auto& tensor : op->impl()->OutputsTensor()) {
+      if (!map_activation(tensor)) {
+        return {nullptr, TensorMap()};
+      }
+    }
+    CloneOperation(op, graph, map);
+  }
+  return {graph, map};
+}
+
+std::vector<LayerError> CompareQuantization(
+    const std::shared_ptr<vx::Graph>& src_graph,
+    const std::pair<std::shared_ptr<vx::Graph>, TensorMap>& quantized,
+    std::shared_ptr<vx::Context>& ctx,
+    const std::vector<std::vector<std::vector<float>>>& samples) {
+  ObserverGraph reference(src_graph, ctx);
+  ObserverGraph candidate(quantized.first, ctx);
+  auto src_inputs = src_graph->InputsTensor();
+  auto quant_inputs = quantized.first->InputsTensor();
+
+  std::vector<LayerError> errors;
+  std::vector<double> signal, noise;
+  for (const auto& op : Operations(src_graph)) {
+    for (const auto& tensor : op->impl()->OutputsTensor()) {
+      LayerError error;
+      error.tensor = tensor;
+      errors.push_back(error);
+    }
+  }
+  signal.resize(errors.size(), 0);
+  noise.resize(errors.size(), 0);
+
+  for (const auto& sample : samples) {
+    if (sample.size() != src_inputs.size()) {
+      return std::vector<LayerError>();
+    }
+    std::vector<std::vector<char>> src_bytes, quant_bytes;
+    for (size_t i = 0; i < sample.size(); i++) {
+      src_bytes.push_back(QuantizeData(sample[i], src_inputs[i]->GetSpec()));
+      quant_bytes.push_back(
+          QuantizeData(sample[i], quant_inputs[i]->GetSpec()));
+    }
+    if (!reference.Run(src_bytes) || !candidate.Run(quant_bytes)) {
+      return std::vector<LayerError>();
+    }
+    for (size_t e = 0; e < errors.size(); e++) {
+      auto expected = reference.Read(errors[e].tensor);
+      auto actual = candidate.Read(quantized.second.at(errors[e].tensor));
+      size_t count = std::min(expected.size(), actual.size());
+      for (size_t i = 0; i < count; i++) {
+        double diff = static_cast<double>(actual[i]) - expected[i];
+        signal[e] += static_cast<double>(expected[i]) * expected[i];
+        noise[e] += diff * diff;
+        errors[e].max_abs_error = std::max(
+            errors[e].max_abs_error, static_cast<float>(std::fabs(diff)));
+      }
+    }
+  }
+  for (size_t e = 0; e < errors.size(); e++) {
+    errors[e].sqnr_db = noise[e] > 0
+                            ? 10.0 * std::log10(signal[e] / noise[e])
+                            : std::numeric_limits<double>::infinity();
+  }
+  return errors;
+}
+
+}  // namespace transform
+}  // namespace tim
@@ -0,0 +1,225 @@
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops.h"
+#include "tim/transform/quantization.h"
+
+#include "gtest/gtest.h"
+
+#include <random>
+
+using tim::transform::CalibrationMethod;
+using tim::transform::QuantizationOptions;
+using tim::transform::TensorStatistics;
+
+TEST(TensorStatistics, min_max) {
+  TensorStatistics statistics;
+  std::vector<float> first = {-1.0f, 0.5f, 2.0f};
+  std::vector<float> second = {3.0f};
+  statistics.Observe(first.data(), first.size());
+  statistics.Observe(second.data(), second.size());
+  EXPECT_EQ(4u, statistics.Count());
+  EXPECT_FLOAT_EQ(-1.0f, statistics.Min());
+  EXPECT_FLOAT_EQ(3.0f, statistics.Max());
+  auto range = statistics.Range(QuantizationOptions());
+  EXPECT_FLOAT_EQ(-1.0f, range.first);
+  EXPECT_FLOAT_EQ(3.0f, range.second);
+
+  TensorStatistics positive;
+  std::vector<float> data = {1.0f, 2.0f};
+  positive.Observe(data.data(), data.size());
+  EXPECT_FLOAT_EQ(0.0f, positive.Range(QuantizationOptions()).first);
+}
+
+TEST(TensorStatistics, percentile_drops_outliers) {
+  std::vector<float> data;
+  for (int i = 0; i < 100000; i++) {
+    data.push_back((i % 1000) / 1000.0f);
+  }
+  TensorStatistics statistics;
+  // The histogram grows to hold the outliers of the second batch
+  statistics.Observe(data.data(), data.size());
+  std::vector<float> outliers(10, 1000.0f);
+  statistics.Observe(outliers.data(), outliers.size());
+
+  QuantizationOptions options;
+  options.method = CalibrationMethod::PERCENTILE;
+  options.percentile = 99.9f;
+  auto range = statistics.Range(options);
+  EXPECT_FLOAT_EQ(0.0f, range.first);
+  EXPECT_GE(range.second, 0.99f);
+  EXPECT_LT(range.second, 2.0f);
+
+  options.percentile = 100.0f;
+  EXPECT_FLOAT_EQ(1000.0f, statistics.Range(options).second);
+}
+
+TEST(TensorStatistics, kl_divergence_clips_tail) {
+  std::mt19937 engine(7);
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  std::vector<float> data(200000);
+  for (auto& value : data) {
+    value = normal(engine);
+  }
+  data[0] = -50.0f;
+  data[1] = 50.0f;
+  TensorStatistics statistics;
+  statistics.Observe(data.data(), data.size());
+
+  QuantizationOptions options;
+  options.method = CalibrationMethod::KL_DIVERGENCE;
+  auto range = statistics.Range(options);
+  EXPECT_GT(range.second, 2.0f);
+  EXPECT_LT(range.second, 20.0f);
+  EXPECT_FLOAT_EQ(-range.second, range.first);
+}
+
+TEST(Quantization, asymmetric) {
+  auto quant = tim::transform::AsymmetricQuantization(
+      -1.0f, 1.0f, tim::vx::DataType::UINT8);
+  EXPECT_EQ(tim::vx::QuantType::ASYMMETRIC, quant.Type());
+  EXPECT_FLOAT_EQ(2.0f / 255, quant.Scales()[0]);
+  EXPECT_EQ(128, quant.ZeroPoints()[0]);
+
+  quant = tim::transform::AsymmetricQuantization(0.5f, 2.55f,
+                                                 tim::vx::DataType::UINT8);
+  EXPECT_FLOAT_EQ(0.01f, quant.Scales()[0]);
+  EXPECT_EQ(0, quant.ZeroPoints()[0]);
+
+  quant = tim::transform::AsymmetricQuantization(0.0f, 0.0f,
+                                                 tim::vx::DataType::INT8);
+  EXPECT_FLOAT_EQ(1.0f, quant.Scales()[0]);
+  EXPECT_EQ(0, quant.ZeroPoints()[0]);
+}
+
+TEST(Quantization, per_channel) {
+  std::vector<float> data = {1.0f, -2.0f, 3.0f, 0.5f, 0.0f, 0.0f};
+  auto quant = tim::transform::PerChannelQuantization(data, {2, 3}, 1);
+  EXPECT_EQ(tim::vx::QuantType::SYMMETRIC_PER_CHANNEL, quant.Type());
+  EXPECT_EQ(1, quant.ChannelDim());
+  ASSERT_EQ(3u, quant.Scales().size());
+  EXPECT_FLOAT_EQ(2.0f / 127, quant.Scales()[0]);
+  EXPECT_FLOAT_EQ(3.0f / 127, quant.Scales()[1]);
+  EXPECT_FLOAT_EQ(1.0f, quant.Scales()[2]);
+  EXPECT_EQ(std::vector<int32_t>({0, 0, 0}), quant.ZeroPoints());
+
+  tim::vx::TensorSpec spec(tim::vx::DataType::INT8, {2, 3},
+                           tim::vx::TensorAttribute::CONSTANT, quant);
+  auto bytes = tim::transform::QuantizeData(data, spec);
+  auto q = reinterpret_cast<const int8_t*>(bytes.data());
+  EXPECT_EQ(std::vector<int8_t>({64, -127, 127, 21, 0, 0}),
+            std::vector<int8_t>(q, q + 6));
+  auto values = tim::transform::DequantizeData(bytes, spec);
+  for (size_t i = 0; i < data.size(); i++) {
+    EXPECT_NEAR(data[i], values[i], quant.Scales()[i / 2] / 2);
+  }
+}
+
+TEST(Quantization, quantize_saturates) {
+  tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 0.1f, 10);
+  tim::vx::TensorSpec spec(tim::vx::DataType::UINT8, {4},
+                           tim::vx::TensorAttribute::INPUT, quant);
+  auto bytes =
+      tim::transform::QuantizeData({-5.0f, 0.0f, 0.26f, 100.0f}, spec);
+  EXPECT_EQ(std::vector<char>({0, 10, 13, static_cast<char>(255)}), bytes);
+  EXPECT_EQ(std::vector<float>({-1.0f, 0.0f, 0.3f, 24.5f}),
+            tim::transform::DequantizeData(bytes, spec));
+}
+
+TEST(Quantization, int4_per_channel) {
+  std::vector<float> data = {7.0f, -7.0f, 1.0f, 0.7f, -0.36f, 0.0f};
+  auto quant = tim::transform::PerChannelQuantization(
+      data, {3, 2}, 1, tim::vx::DataType::INT4);
+  ASSERT_EQ(2u, quant.Scales().size());
+  EXPECT_FLOAT_EQ(1.0f, quant.Scales()[0]);
+  EXPECT_FLOAT_EQ(0.1f, quant.Scales()[1]);
+
+  tim::vx::TensorSpec spec(tim::vx::DataType::INT4, {3, 2},
+                           tim::vx::TensorAttribute::CONSTANT, quant);
+  auto bytes = tim::transform::QuantizeData(data, spec);
+  // 7, -7, 1 | 7, -4, 0 with each row padded to a byte
+  EXPECT_EQ(std::vector<char>({static_cast<char>(0x97), 0x01,
+                               static_cast<char>(0xC7), 0x00}),
+            bytes);
+  auto values = tim::transform::DequantizeData(bytes, spec);
+  ASSERT_EQ(data.size(), values.size());
+  for (size_t i = 0; i < data.size(); i++) {
+    EXPECT_NEAR(data[i], values[i], quant.Scales()[i / 3] / 2);
+  }
+}
+
+TEST(Quantization, bfloat16) {
+  tim::vx::TensorSpec spec(tim::vx::DataType::BFLOAT16, {3},
+                           tim::vx::TensorAttribute::INPUT);
+  // both are ties, 1 + 2^-8 rounds down and 1 + 3 * 2^-8 up to even
+  auto bytes =
+      tim::transform::QuantizeData({1.0f, 1.00390625f, 1.01171875f}, spec);
+  ASSERT_EQ(6u, bytes.size());
+  EXPECT_EQ(std::vector<float>({1.0f, 1.0f, 1.015625f}),
+            tim::transform::DequantizeData(bytes, spec));
+}
+
+TEST(Quantization, calibrated_conv2d) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {6, 6, 4, 1},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32, {3, 3, 4, 8},
+                                  tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {8},
+                                tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {6, 6, 8, 1},
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {6, 6, 8, 1},
+                                  tim::vx::TensorAttribute::OUTPUT);
+  std::mt19937 engine(3);
+  std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+  std::vector<float> weight_data(3 * 3 * 4 * 8), bias_data(8);
+  for (auto& value : weight_data) {
+    value = uniform(engine) * 0.2f;
+  }
+  for (auto& value : bias_data) {
+    value = uniform(engine) * 0.1f;
+  }
+  auto input = graph->CreateTensor(input_spec);
+  auto weight = graph->CreateTensor(weight_spec, weight_data.data());
+  auto bias = graph->CreateTensor(bias_spec, bias_data.data());
+  auto conv_out = graph->CreateTensor(transient_spec);
+  auto output = graph->CreateTensor(output_spec);
+  (*graph->CreateOperation<tim::vx::ops::Conv2d>(
+       8, tim::vx::PadType::SAME, std::array<uint32_t, 2>({3, 3}),
+       std::array<uint32_t, 2>({1, 1}), std::array<uint32_t, 2>({1, 1})))
+      .BindInputs({input, weight, bias})
+      .BindOutput(conv_out);
+  (*graph->CreateOperation<tim::vx::ops::Relu>())
+      .BindInput(conv_out)
+      .BindOutput(output);
+
+  std::vector<std::vector<std::vector<float>>> samples(8);
+  for (auto& sample : samples) {
+    sample.emplace_back(6 * 6 * 4);
+    for (auto& value : sample[0]) {
+      value = uniform(engine);
+    }
+  }
+  for (bool per_channel : {false, true}) {
+    QuantizationOptions options;
+    options.per_channel_weights = per_channel;
+    tim::transform::Calibrator calibrator(graph, ctx, options);
+    for (const auto& sample : samples) {
+      ASSERT_TRUE(calibrator.Feed(sample));
+    }
+    ASSERT_TRUE(calibrator.Statistics(conv_out));
+    auto quantized = tim::transform::Quantize(graph, ctx, calibrator);
+    ASSERT_TRUE(quantized.first);
+    EXPECT_EQ(tim::vx::DataType::UINT8,
+              quantized.second[output]->GetDataType());
+    EXPECT_EQ(tim::vx::DataType::INT32, quantized.second[bias]->GetDataType());
+
+    auto errors =
+        tim::transform::CompareQuantization(graph, quantized, ctx, samples);
+    ASSERT_EQ(2u, errors.size());
+    for (const auto& error : errors) {
+      EXPECT_GT(error.sqnr_db, 25.0);
+    }
+  }
+}
@@ -547,6 +547,94 @@ onError:
     return status;
 }
 
+static vip_uint32_t get_io_entry_size(nbg_parser_data_t *nbg)
+{
+    if (nbg->fixed.header.version >= 0x0001000B) {
+        return sizeof(gcvip_bin_inout_entry_t);
+    }
+    else if (nbg->fixed.header.version >= 0x00010004) {
+        return sizeof(gcvip_bin_inout_entry_t) - (MAX_NUM_DIMS - OLD_NBG_FORMAT_DIMS_NUM) * sizeof(nbg_uint32_t);
+    }
+    else {
+        return sizeof(gcvip_bin_inout_entry_t) - sizeof(vip_char_t) * MAX_IO_NAME_LEGTH -
+               (MAX_NUM_DIMS - OLD_NBG_FORMAT_DIMS_NUM) * sizeof(nbg_uint32_t);
+    }
+}
+
+static nbg_status_e check_entry(nbg_reader_t *reader, gcvip_bin_entry_t *entry)
+{
+    if ((entry->offset > reader->total_size) ||
+        (entry->size > reader->total_size - entry->offset)) {
+        nbg_printf("nbg entry out of buffer, offset=%d, size=%d, total size=%d\n",
+                    entry->offset, entry->size, reader->total_size);
+        return NBG_ERROR_FAILURE;
+    }
+
+    return NBG_SUCCESS;
+}
+
+/* Point inputs/outputs to the entry tables inside the NBG data, the tables are
+   only copied out when they are not suitably aligned for in place access. */
+static nbg_status_e locate_nbg_io_data(nbg_parser_data_t *nbg)
+{
+    nbg_status_e status = NBG_SUCCESS;
+    nbg_reader_t *reader = &nbg->reader;
+    vip_uint32_t entry_size = get_io_entry_size(nbg);
+
+    status = check_entry(reader, &nbg->fixed.input_table);
+    if (status != NBG_SUCCESS) {
+        goOnError(status);
+    }
+    status = check_entry(reader, &nbg->fixed.output_table);
+    if (status != NBG_SUCCESS) {
+        goOnError(status);
+    }
+
+    nbg->n_inputs = nbg->fixed.input_table.size / entry_size;
+    nbg->n_outputs = nbg->fixed.output_table.size / entry_size;
+
+    if ((((size_t)(reader->data + nbg->fixed.input_table.offset) |
+          (size_t)(reader->data + nbg->fixed.output_table.offset)) &
+          (sizeof(vip_uint32_t) - 1)) != 0) {
+        if (nbg->fixed.input_table.size > 0) {
+            nbg->inputs = (gcvip_bin_inout_entry_t*)nbg_malloc(nbg->fixed.input_table.size);
+            if (nbg->inputs == NBG_NULL) {
+                nbg_printf("failed to malloc memory for inputs\n");
+                goOnError(NBG_ERROR_FAILURE);
+            }
+            nbg_memcpy(nbg->inputs, reader->data + nbg->fixed.input_table.offset,
+                       nbg->fixed.input_table.size);
+        }
+        if (nbg->fixed.output_table.size > 0) {
+            nbg->outputs = (gcvip_bin_inout_entry_t*)nbg_malloc(nbg->fixed.output_table.size);
+            if (nbg->outputs == NBG_NULL) {
+                nbg_printf("failed to malloc memory for outputs\n");
+                goOnError(NBG_ERROR_FAILURE);
+            }
+            nbg_memcpy(nbg->outputs, reader->data + nbg->fixed.output_table.offset,
+                       nbg->fixed.output_table.size);
+        }
+        return status;
+    }
+
+    if (nbg->n_inputs > 0) {
+        nbg->inputs = (gcvip_bin_inout_entry_t*)(reader->data + nbg->fixed.input_table.offset);
+    }
+    if (nbg->n_outputs > 0) {
+        nbg->outputs = (gcvip_bin_inout_entry_t*)(reader->data + nbg->fixed.output_table.offset);
+    }
+    nbg->in_place = 1;
+
+    return status;
+
+onError:
+    if (nbg->inputs != NBG_NULL) {
+        nbg_free(nbg->inputs);
+        nbg->inputs = NBG_NULL;
+    }
+    return status;
+}
+
 static void *get_io_ptr_by_index(
     nbg_parser_data_t *nbg,
     gcvip_bin_inout_entry_t *io_ptr,
@@ -913,6 +1001,57 @@ onError:
     return status;
 }
 
+/*
+@brief, Initialize NBG parser in lazy mode, the NBG data is referenced instead of copied.
+@param, buffer. a pointer to the start of the NBG data, must outlive the parser.
+@param size, the size of NBG data.
+@param, nbg_t*, the nbg object created by NBG data.
+*/
+nbg_status_e nbg_parser_init_lazy(void *buffer, nbg_uint32_t size, nbg_parser_data *nbg)
+{
+    nbg_parser_data_t *nbg_data = NBG_NULL;
+    nbg_status_e status = NBG_SUCCESS;
+
+    /* the fixed section is read field by field, make sure it can not run out of buffer */
+    if ((buffer == NBG_NULL) || (size < sizeof(gcvip_bin_fixed_t))) {
+        nbg_printf("failed to init nbg parser, invalid buffer=%p, size=%d\n", buffer, size);
+        return NBG_ERROR_INVALID_ARGUMENTS;
+    }
+
+    nbg_data = (nbg_parser_data_t *)nbg_malloc(sizeof(nbg_parser_data_t));
+    if (nbg_data == NBG_NULL) {
+        nbg_printf("failed to malloc memory for nbg object\n");
+        return NBG_ERROR_FAILURE;
+    }
+    nbg_memset(nbg_data, sizeof(nbg_parser_data_t));
+    nbg_data->reader.current_data = (vip_uint8_t*)buffer;
+    nbg_data->reader.data = (vip_uint8_t*)buffer;
+    nbg_data->reader.total_size = size;
+    nbg_data->reader.offset = 0;
+
+    status = read_nbg_fix_data(nbg_data);
+    if (status != NBG_SUCCESS) {
+        nbg_printf("failed to read fix section data\n");
+        goOnError(status);
+    }
+
+    status = locate_nbg_io_data(nbg_data);
+    if (status != NBG_SUCCESS) {
+        nbg_printf("failed to locate input/output tables\n");
+        goOnError(status);
+    }
+
+    if (nbg != NBG_NULL) {
+        *nbg = (nbg_parser_data)nbg_data;
+    }
+
+    return status;
+
+onError:
+    nbg_free(nbg_data);
+    return status;
+}
+
 /*
 @brief, query the input info of network.
 @param nbg, The nbg object created by NBG data.
@@ -942,6 +1081,11 @@ nbg_status_e nbg_parser_query_input(
         return NBG_ERROR_FAILURE;
     }
 
+    if (index >= nbg_data->n_inputs) {
+        nbg_printf("failed to query input, index=%d out of range\n", index);
+        return NBG_ERROR_INVALID_ARGUMENTS;
+    }
+
     input = (gcvip_bin_inout_entry_t *)get_io_ptr_by_index(nbg_data, nbg_data->inputs, index);
 
     status = query_input_output(nbg, input, property, value, size);
@@ -981,6 +1125,11 @@ nbg_status_e nbg_parser_query_output(
         return NBG_ERROR_FAILURE;
     }
 
+    if (index >= nbg_data->n_outputs) {
+        nbg_printf("failed to query output, index=%d out of range\n", index);
+        return NBG_ERROR_INVALID_ARGUMENTS;
+    }
+
     output = (gcvip_bin_inout_entry_t *)get_io_ptr_by_index(nbg_data, nbg_data->outputs, index);
 
     status = query_input_output(nbg, output, property, value, size);
@@ -1098,6 +1247,10 @@ nbg_status_e nbg_parser_destroy(
         nbg_data->reader.total_size = 0;
         nbg_data->reader.offset = 0;
 
+        if (nbg_data->in_place) {
+            nbg_data->inputs = NBG_NULL;
+            nbg_data->outputs = NBG_NULL;
+        }
         if (nbg_data->inputs != NBG_NULL) {
             nbg_free(nbg_data->inputs);
             nbg_data->inputs = NBG_NULL;
@@ -70,6 +70,12 @@ class CustomOpBaseImpl : public BuiltinOpImpl {
   protected:
   const void* op_proc_;
 };
+
+namespace ops {
+/// Forget the programs custom ops built on `context`, it is about to be
+/// released and a later context may reuse its address
+void ReleaseCustomOpPrograms(vx_context context);
+}  // namespace ops
 #endif
 
 }  // namespace vx
@@ -0,0 +1,88 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "common_subexpression_elimination.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "graph_private.h"
+#include "op_impl.h"
+#include "op_signature.h"
+#include "tim/vx/operation.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace {
+
+bool MakeKey(const std::shared_ptr<Operation>& op, std::string& key) {
+  auto outputs = op->impl()->OutputsTensor();
+  if (1 != outputs.size() ||
+      outputs[0]->GetSpec().attr_ != TensorAttribute::TRANSIENT) {
+    return false;
+  }
+
+  OpSignature op_key;
+  if (!AppendOpParams(op, op_key)) return false;
+  for (const auto& t : op->impl()->InputsTensor()) {
+    op_key.Append(t.get());
+  }
+  op_key.Append(outputs[0]->GetSpec());
+  key = op_key.str();
+  return true;
+}
+
+}  // namespace
+
+CommonSubexpressionEliminationStatistics EliminateCommonSubexpressions(
+    GraphImpl* graph) {
+  CommonSubexpressionEliminationStatistics statistics;
+  bool changed = true;
+  // Merging two ops makes their consumers share inputs, iterate to fixed point
+  while (changed) {
+    changed = false;
+    std::map<std::string, std::shared_ptr<Operation>> visited;
+    auto ops = graph->OpVector();
+    for (const auto& op : ops) {
+      std::string key;
+      if (!MakeKey(op, key)) continue;
+      auto kept = visited.find(key);
+      if (visited.end() == kept) {
+        visited[key] = op;
+        continue;
+      }
+      VSILOGD("Merge duplicated op %d.", op->impl()->kind_);
+      graph->ReplaceTensorConsumers(op->impl()->OutputsTensor()[0],
+                                    kept->second->impl()->OutputsTensor()[0]);
+      graph->RemoveOperation(op);
+      statistics.removed_nodes++;
+      changed = true;
+    }
+  }
+  return statistics;
+}
+
+}  // namespace vx
+}  // namespace tim
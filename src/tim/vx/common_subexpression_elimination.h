@@ -0,0 +1,46 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_COMMON_SUBEXPRESSION_ELIMINATION_H_
+#define TIM_VX_COMMON_SUBEXPRESSION_ELIMINATION_H_
+#include <cstdint>
+
+namespace tim {
+namespace vx {
+
+class GraphImpl;
+
+struct CommonSubexpressionEliminationStatistics {
+  uint32_t removed_nodes{0};
+};
+
+/// Merge operations of the same kind and parameters applied to the same input
+/// tensors, consumers of a removed duplicate are redirected to the kept one.
+/// Only operations whose parameters are known to this pass are merged.
+CommonSubexpressionEliminationStatistics EliminateCommonSubexpressions(
+    GraphImpl* graph);
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_COMMON_SUBEXPRESSION_ELIMINATION_H_ */
@@ -0,0 +1,106 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/compile_option.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/ops/reshape.h"
+#include "tim/vx/ops/transpose.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+TEST(common_subexpression_elimination, merge_duplicated_chain) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {2, 3},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {},
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {6},
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto input_t = graph->CreateTensor(input_spec);
+  auto output_t = graph->CreateTensor(output_spec);
+  std::vector<std::shared_ptr<tim::vx::Tensor>> transposed, reshaped;
+  std::vector<std::shared_ptr<tim::vx::Operation>> transposes;
+  // Two identical Transpose + Reshape chains on the same input
+  for (int i = 0; i < 2; ++i) {
+    transposed.push_back(graph->CreateTensor(transient_spec));
+    reshaped.push_back(graph->CreateTensor(transient_spec));
+    auto transpose = graph->CreateOperation<tim::vx::ops::Transpose>(
+        std::vector<uint32_t>({1, 0}));
+    (*transpose).BindInput(input_t).BindOutput(transposed[i]);
+    transposes.push_back(transpose);
+    auto reshape = graph->CreateOperation<tim::vx::ops::Reshape>(
+        std::vector<uint32_t>({6}));
+    (*reshape).BindInput(transposed[i]).BindOutput(reshaped[i]);
+  }
+  auto add = graph->CreateOperation<tim::vx::ops::Add>();
+  (*add).BindInputs({reshaped[0], reshaped[1]}).BindOutput(output_t);
+
+  std::vector<float> in_data = {1, 2, 3, 4, 5, 6};
+  std::vector<float> golden = {2, 6, 10, 4, 8, 12};
+  EXPECT_TRUE(input_t->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float)));
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_EQ(graph->GetConsumersOp(input_t).size(), 1u);
+  EXPECT_EQ(graph->GetProducerOp(transposed[1]), nullptr);
+  EXPECT_EQ(graph->GetProducerOp(reshaped[1]), nullptr);
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<float> output(golden.size());
+  EXPECT_TRUE(output_t->CopyDataFromTensor(output.data()));
+  EXPECT_EQ(golden, output);
+}
+
+TEST(common_subexpression_elimination, keep_different_params) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {2, 2},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {2, 2},
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {2, 2},
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto input_t = graph->CreateTensor(input_spec);
+  auto scaled_t0 = graph->CreateTensor(transient_spec);
+  auto scaled_t1 = graph->CreateTensor(transient_spec);
+  auto output_t = graph->CreateTensor(output_spec);
+
+  auto mul0 = graph->CreateOperation<tim::vx::ops::Multiply>(1.0f);
+  (*mul0).BindInputs({input_t, input_t}).BindOutput(scaled_t0);
+  auto mul1 = graph->CreateOperation<tim::vx::ops::Multiply>(2.0f);
+  (*mul1).BindInputs({input_t, input_t}).BindOutput(scaled_t1);
+  auto add = graph->CreateOperation<tim::vx::ops::Add>();
+  (*add).BindInputs({scaled_t0, scaled_t1}).BindOutput(output_t);
+
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_EQ(graph->GetProducerOp(scaled_t0), mul0);
+  EXPECT_EQ(graph->GetProducerOp(scaled_t1), mul1);
+}
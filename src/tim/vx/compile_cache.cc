@@ -0,0 +1,263 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "compile_cache.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#if defined(__linux__) || defined(__ANDROID__)
+#include <dlfcn.h>
+#include <sys/stat.h>
+#endif
+
+#include "graph_private.h"
+#include "op_impl.h"
+#include "op_signature.h"
+#include "tim/vx/compile_option.h"
+#include "tim/vx/ops/nbg.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace {
+
+// Bump when the content of the fingerprint changes
+constexpr uint32_t kFingerprintVersion = 3;
+
+// FNV-1a, std::hash is not stable across builds
+uint64_t Fnv1a64(const void* data, size_t size,
+                 uint64_t hash = 0xcbf29ce484222325ULL) {
+  auto bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < size; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3ULL;
+  }
+  return hash;
+}
+
+class TensorIndexer {
+ public:
+  explicit TensorIndexer(OpSignature& signature) : signature_(signature) {}
+
+  // Tensors are described by their first appearance so that the fingerprint
+  // does not depend on allocation order or addresses
+  bool Append(const std::shared_ptr<Tensor>& tensor) {
+    if (tensor->IsPlaceHolder()) {
+      signature_.Append(int32_t(-1));
+      return true;
+    }
+    auto found = index_.find(tensor);
+    if (index_.end() != found) {
+      signature_.Append(found->second);
+      return true;
+    }
+    int32_t index = index_.size();
+    index_[tensor] = index;
+    signature_.Append(index).Append(tensor->GetSpec());
+    if (tensor->IsConstTensor()) {
+      std::vector<uint8_t> data(tensor->GetSpec().GetByteSize());
+      if (!tensor->CopyDataFromTensor(data.data())) return false;
+      signature_.Append(Fnv1a64(data.data(), data.size()));
+    }
+    return true;
+  }
+
+ private:
+  OpSignature& signature_;
+  std::map<std::shared_ptr<Tensor>, int32_t> index_;
+};
+
+// Size and modification time of the loaded OpenVX driver library. The
+// OpenVX API version does not change with driver builds, whose NBG format may
+// differ.
+void AppendDriverStamp(OpSignature& signature) {
+  int64_t size = 0;
+  int64_t mtime = 0;
+#if defined(__linux__) || defined(__ANDROID__)
+  // Looked up by name, taking its address would bind it eagerly at load
+  void* symbol = dlsym(RTLD_DEFAULT, "vxCreateContext");
+  Dl_info info;
+  struct stat st;
+  if (nullptr != symbol && 0 != dladdr(symbol, &info) &&
+      nullptr != info.dli_fname && 0 == stat(info.dli_fname, &st)) {
+    size = static_cast<int64_t>(st.st_size);
+    mtime = static_cast<int64_t>(st.st_mtime);
+  }
+#endif
+  signature.Append(size).Append(mtime);
+}
+
+}  // namespace
+
+void AppendTargetSignature(GraphImpl* graph, OpSignature& signature) {
+  signature.Append(vsi_nn_GetVersionMajor())
+      .Append(vsi_nn_GetVersionMinor())
+      .Append(vsi_nn_GetVersionPatch());
+
+  auto ctx = graph->graph()->ctx;
+  vx_uint16 vx_version = 0;
+  vx_uint16 vendor_id = 0;
+  vxQueryContext(ctx->c, VX_CONTEXT_VERSION, &vx_version, sizeof(vx_version));
+  vxQueryContext(ctx->c, VX_CONTEXT_VENDOR_ID, &vendor_id, sizeof(vendor_id));
+  signature.Append(vx_version).Append(vendor_id);
+  vx_char implementation[VX_MAX_IMPLEMENTATION_NAME] = {0};
+  vxQueryContext(ctx->c, VX_CONTEXT_IMPLEMENTATION, implementation,
+                 sizeof(implementation));
+  implementation[VX_MAX_IMPLEMENTATION_NAME - 1] = '\0';
+  std::string driver(implementation);
+  signature.Append(driver.c_str(), uint32_t(driver.size()));
+  AppendDriverStamp(signature);
+  std::string target(ctx->config.target_name);
+  signature.Append(target.c_str(), uint32_t(target.size()));
+  signature.Append(ctx->config.evis.ver).Append(ctx->config.use_40bits_va);
+  signature.Append(ctx->options.enable_shader);
+}
+
+std::string SignatureDigest(const std::string& data) {
+  char digest[64];
+  // A second seed lowers the chance of two signatures sharing one digest
+  snprintf(digest, sizeof(digest), "%016" PRIx64 "%016" PRIx64,
+           Fnv1a64(data.data(), data.size()),
+           Fnv1a64(data.data(), data.size(), 0x84222325cbf29ce4ULL));
+  return std::string(digest);
+}
+
+std::string GraphFingerprint(GraphImpl* graph) {
+  OpSignature signature;
+  signature.Append(kFingerprintVersion);
+  AppendTargetSignature(graph, signature);
+
+  const auto& options = graph->GetCompileOption();
+  signature.Append(options.isRelaxMode())
+      .Append(options.isConstFolding())
+      .Append(options.isDeadNodeElimination())
+      .Append(options.isCommonSubexpressionElimination());
+  // Tuned kernel choices are baked into the compiled graph
+  signature.Append(options.isKernelTuning() ||
+                   !options.getKernelTuningDB().empty());
+
+  TensorIndexer tensors(signature);
+  bool status = true;
+  for (const auto& t : graph->InputsTensor()) {
+    status = status && tensors.Append(t);
+  }
+  for (const auto& t : graph->OutputsTensor()) {
+    status = status && tensors.Append(t);
+  }
+  for (const auto& op : graph->OpVector()) {
+    if (!AppendOpParams(op, signature)) {
+      VSILOGD("Op %d can not be fingerprinted.", op->impl()->kind_);
+      return std::string();
+    }
+    auto inputs = op->impl()->InputsTensor();
+    auto outputs = op->impl()->OutputsTensor();
+    signature.Append(uint32_t(inputs.size())).Append(uint32_t(outputs.size()));
+    for (const auto& t : inputs) {
+      status = status && tensors.Append(t);
+    }
+    for (const auto& t : outputs) {
+      status = status && tensors.Append(t);
+    }
+  }
+  if (!status) return std::string();
+
+  return SignatureDigest(signature.str());
+}
+
+bool LoadCompiledGraph(const std::string& path, std::vector<char>& nbg) {
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) return false;
+  auto size = file.tellg();
+  if (size <= 0) return false;
+  nbg.resize(size);
+  file.seekg(0, std::ios::beg);
+  return static_cast<bool>(file.read(nbg.data(), size));
+}
+
+bool VerifyCompiledGraph(GraphImpl* graph, const std::string& path,
+                         const std::vector<char>& nbg) {
+  // Contents imported once stay valid for the process, the fingerprint covers
+  // the driver in use. A file rewritten since is verified again.
+  static std::mutex verified_mutex;
+  static std::set<std::string> verified;
+  size_t digest = std::hash<std::string>()(std::string(nbg.begin(), nbg.end()));
+  std::string key = path + ":" + std::to_string(nbg.size()) + ":" +
+                    std::to_string(digest);
+  {
+    std::lock_guard<std::mutex> lock(verified_mutex);
+    if (verified.count(key)) return true;
+  }
+
+  auto probe = graph->GetContext()->CreateGraph(CompileOption());
+  auto nbg_op = probe->CreateOperation<ops::NBG>(
+      nbg.data(), graph->InputsTensor().size(), graph->OutputsTensor().size());
+  for (const auto& t : graph->InputsTensor()) {
+    TensorSpec spec = t->GetSpec();
+    spec.attr_ = TensorAttribute::INPUT;
+    nbg_op->BindInput(probe->CreateTensor(spec));
+  }
+  for (const auto& t : graph->OutputsTensor()) {
+    TensorSpec spec = t->GetSpec();
+    spec.attr_ = TensorAttribute::OUTPUT;
+    nbg_op->BindOutput(probe->CreateTensor(spec));
+  }
+  if (!probe->Compile()) return false;
+
+  std::lock_guard<std::mutex> lock(verified_mutex);
+  verified.insert(key);
+  return true;
+}
+
+bool StoreCompiledGraph(const std::string& path, const std::vector<char>& nbg) {
+  // Graphs with the same fingerprint may be stored concurrently, write each
+  // through its own temporary file and let the last rename win
+  static std::atomic<uint64_t> store_count(0);
+  std::string tmp_path =
+      path + ".tmp." +
+      std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) +
+      "." + std::to_string(store_count++);
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!file || !file.write(nbg.data(), nbg.size())) {
+      VSILOGW("Write compiled graph to %s fail.", tmp_path.c_str());
+      return false;
+    }
+  }
+  if (0 != std::rename(tmp_path.c_str(), path.c_str())) {
+    std::remove(tmp_path.c_str());
+    return false;
+  }
+  return true;
+}
+
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,61 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_COMPILE_CACHE_H_
+#define TIM_VX_COMPILE_CACHE_H_
+#include <string>
+#include <vector>
+
+namespace tim {
+namespace vx {
+
+class GraphImpl;
+class OpSignature;
+
+/// Stable fingerprint of `graph` covering operations, parameters, tensor
+/// specs, constant data, compile options and the SDK/driver in use. Returns an
+/// empty string if some operation can not be described by value.
+std::string GraphFingerprint(GraphImpl* graph);
+
+/// Append the SDK, driver and target hardware `graph` is compiled for
+void AppendTargetSignature(GraphImpl* graph, OpSignature& signature);
+
+/// Hex digest of a byte string built by OpSignature
+std::string SignatureDigest(const std::string& data);
+
+/// Read a compiled graph (NBG) stored by StoreCompiledGraph
+bool LoadCompiledGraph(const std::string& path, std::vector<char>& nbg);
+
+/// Import `nbg` loaded from `path` in a scratch graph with the inputs and
+/// outputs of `graph`. Returns false if the driver rejects it, e.g. after a
+/// driver update changed the NBG format.
+bool VerifyCompiledGraph(GraphImpl* graph, const std::string& path,
+                         const std::vector<char>& nbg);
+
+/// Write a compiled graph (NBG), a concurrent reader never sees a partial file
+bool StoreCompiledGraph(const std::string& path, const std::vector<char>& nbg);
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_COMPILE_CACHE_H_ */
@@ -0,0 +1,152 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/compile_option.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/elementwise.h"
+#include "graph_private.h"
+#include "op_impl.h"
+
+#include "gtest/gtest.h"
+
+#include <dirent.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace {
+// Cache directory private to one test, removed with its files
+class ScopedCacheDir {
+ public:
+  ScopedCacheDir() {
+    std::string tmpl = ::testing::TempDir() + "/compile_cache_XXXXXX";
+    std::vector<char> buf(tmpl.begin(), tmpl.end());
+    buf.push_back('\0');
+    if (nullptr != mkdtemp(buf.data())) path_ = buf.data();
+  }
+
+  ~ScopedCacheDir() {
+    if (path_.empty()) return;
+    for (const auto& file : Files()) {
+      std::remove((path_ + "/" + file).c_str());
+    }
+    rmdir(path_.c_str());
+  }
+
+  const std::string& path() const { return path_; }
+
+  std::vector<std::string> Files() const {
+    std::vector<std::string> files;
+    DIR* dir = opendir(path_.c_str());
+    if (nullptr == dir) return files;
+    while (auto entry = readdir(dir)) {
+      std::string name = entry->d_name;
+      if ("." != name && ".." != name) files.push_back(name);
+    }
+    closedir(dir);
+    return files;
+  }
+
+ private:
+  std::string path_;
+};
+
+struct AddReluGraph {
+  std::shared_ptr<tim::vx::Graph> graph;
+  std::shared_ptr<tim::vx::Tensor> input;
+  std::shared_ptr<tim::vx::Tensor> output;
+  std::shared_ptr<tim::vx::Operation> relu;
+};
+
+AddReluGraph BuildAddRelu(const std::shared_ptr<tim::vx::Context>& ctx,
+                          const tim::vx::CompileOption& option) {
+  AddReluGraph g;
+  g.graph = ctx->CreateGraph(option);
+  tim::vx::ShapeType shape({4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  std::vector<float> bias = {-1, -2, 3, 4};
+  g.input = g.graph->CreateTensor(input_spec);
+  auto bias_t = g.graph->CreateTensor(const_spec, bias.data());
+  auto sum_t = g.graph->CreateTensor(transient_spec);
+  g.output = g.graph->CreateTensor(output_spec);
+
+  auto add = g.graph->CreateOperation<tim::vx::ops::Add>();
+  (*add).BindInputs({g.input, bias_t}).BindOutput(sum_t);
+  g.relu = g.graph->CreateOperation<tim::vx::ops::Relu>();
+  (*g.relu).BindInput(sum_t).BindOutput(g.output);
+  return g;
+}
+}  // namespace
+
+TEST(compile_cache, reuse_compiled_graph) {
+  auto ctx = tim::vx::Context::Create();
+  ScopedCacheDir cache_dir;
+  ASSERT_FALSE(cache_dir.path().empty());
+  tim::vx::CompileOption option;
+  option.setCompileCacheDir(cache_dir.path());
+
+  std::vector<float> in_data = {1, 1, 1, 1};
+  std::vector<float> golden = {0, 0, 4, 5};
+
+  // Cold compile stores the compiled graph, warm compile loads it back
+  for (int i = 0; i < 2; ++i) {
+    auto g = BuildAddRelu(ctx, option);
+    EXPECT_TRUE(g.input->CopyDataToTensor(in_data.data(),
+                                          in_data.size() * sizeof(float)));
+    ASSERT_TRUE(g.graph->Compile());
+    if (i == 0) {
+      // Nothing to load from a fresh directory, the compile stores the graph
+      EXPECT_EQ(g.graph->GetProducerOp(g.output), g.relu);
+      EXPECT_EQ(cache_dir.Files().size(), 1u);
+    }
+    if (i == 1) {
+      // The loaded graph replaces every op with one NBG node in slot 0
+      auto producer = g.graph->GetProducerOp(g.output);
+      ASSERT_NE(producer, nullptr);
+      EXPECT_EQ(producer->impl()->kind_, VSI_NN_OP_NBG);
+      vsi_nn_graph_t* vsi_graph =
+          dynamic_cast<tim::vx::GraphImpl*>(g.graph.get())->graph();
+      ASSERT_EQ(vsi_graph->node_num, 1u);
+      EXPECT_EQ(vsi_nn_GetNode(vsi_graph, 0), producer->impl()->node());
+      EXPECT_EQ(cache_dir.Files().size(), 1u);
+    }
+    ASSERT_TRUE(g.graph->Run());
+
+    std::vector<float> output(golden.size());
+    EXPECT_TRUE(g.output->CopyDataFromTensor(output.data()));
+    EXPECT_EQ(golden, output);
+  }
+}
@@ -32,8 +32,31 @@ CompileOption CompileOption::DefaultOptions;
 struct CompileOptionImpl {
   // string: readable name; bool: setup or not; bool: value if setup; bool: default value if not setup;
   using RelaxModeType = std::tuple<std::string, bool, bool, bool>;
+  using ConstFoldingType = std::tuple<std::string, bool, bool, bool>;
+  using DeadNodeEliminationType = std::tuple<std::string, bool, bool, bool>;
+  using CommonSubexpressionEliminationType =
+      std::tuple<std::string, bool, bool, bool>;
+  using KernelTuningType = std::tuple<std::string, bool, bool, bool>;
+  // string: readable name; bool: setup or not; string: value if setup; string: default value if not setup;
+  using CompileCacheDirType =
+      std::tuple<std::string, bool, std::string, std::string>;
+  using KernelTuningDBType =
+      std::tuple<std::string, bool, std::string, std::string>;
   CompileOptionImpl() {
     relax_mode_ = RelaxModeType(std::string("RelaxMode"), false, false, false);
+    const_folding_ =
+        ConstFoldingType(std::string("ConstFolding"), false, false, false);
+    dead_node_elimination_ = DeadNodeEliminationType(
+        std::string("DeadNodeElimination"), false, true, true);
+    common_subexpression_elimination_ = CommonSubexpressionEliminationType(
+        std::string("CommonSubexpressionElimination"), false, true, true);
+    compile_cache_dir_ = CompileCacheDirType(std::string("CompileCacheDir"),
+                                             false, std::string(),
+                                             std::string());
+    kernel_tuning_ =
+        KernelTuningType(std::string("KernelTuning"), false, false, false);
+    kernel_tuning_db_ = KernelTuningDBType(std::string("KernelTuningDB"), false,
+                                           std::string(), std::string());
   }
 
   bool RelaxMode() const {
@@ -46,7 +69,77 @@ struct CompileOptionImpl {
                                     : std::get<3>(relax_mode_);
   }
 
+  bool ConstFolding() const {
+    return std::get<1>(const_folding_) ? std::get<2>(const_folding_)
+                                       : std::get<3>(const_folding_);
+  }
+
+  bool& ConstFolding() {
+    return std::get<1>(const_folding_) ? std::get<2>(const_folding_)
+                                       : std::get<3>(const_folding_);
+  }
+
+  bool DeadNodeElimination() const {
+    return std::get<1>(dead_node_elimination_)
+               ? std::get<2>(dead_node_elimination_)
+               : std::get<3>(dead_node_elimination_);
+  }
+
+  bool& DeadNodeElimination() {
+    return std::get<1>(dead_node_elimination_)
+               ? std::get<2>(dead_node_elimination_)
+               : std::get<3>(dead_node_elimination_);
+  }
+
+  bool CommonSubexpressionElimination() const {
+    return std::get<1>(common_subexpression_elimination_)
+               ? std::get<2>(common_subexpression_elimination_)
+               : std::get<3>(common_subexpression_elimination_);
+  }
+
+  bool& CommonSubexpressionElimination() {
+    return std::get<1>(common_subexpression_elimination_)
+               ? std::get<2>(common_subexpression_elimination_)
+               : std::get<3>(common_subexpression_elimination_);
+  }
+
+  const std::string& CompileCacheDir() const {
+    return std::get<1>(compile_cache_dir_) ? std::get<2>(compile_cache_dir_)
+                                           : std::get<3>(compile_cache_dir_);
+  }
+
+  std::string& CompileCacheDir() {
+    return std::get<1>(compile_cache_dir_) ? std::get<2>(compile_cache_dir_)
+                                           : std::get<3>(compile_cache_dir_);
+  }
+
+  bool KernelTuning() const {
+    return std::get<1>(kernel_tuning_) ? std::get<2>(kernel_tuning_)
+                                       : std::get<3>(kernel_tuning_);
+  }
+
+  bool& KernelTuning() {
+    return std::get<1>(kernel_tuning_) ? std::get<2>(kernel_tuning_)
+                                       : std::get<3>(kernel_tuning_);
+  }
+
+  const std::string& KernelTuningDB() const {
+    return std::get<1>(kernel_tuning_db_) ? std::get<2>(kernel_tuning_db_)
+                                          : std::get<3>(kernel_tuning_db_);
+  }
+
+  std::string& KernelTuningDB() {
+    return std::get<1>(kernel_tuning_db_) ? std::get<2>(kernel_tuning_db_)
+                                          : std::get<3>(kernel_tuning_db_);
+  }
+
   RelaxModeType relax_mode_;
+  ConstFoldingType const_folding_;
+  DeadNodeEliminationType dead_node_elimination_;
+  CommonSubexpressionEliminationType common_subexpression_elimination_;
+  CompileCacheDirType compile_cache_dir_;
+  KernelTuningType kernel_tuning_;
+  KernelTuningDBType kernel_tuning_db_;
 };
 
 CompileOption::CompileOption() : impl_(new CompileOptionImpl()) {}
@@ -56,5 +149,53 @@ bool CompileOption::isRelaxMode() const { return this->impl_->RelaxMode(); }
 bool CompileOption::setRelaxMode(bool enable) {
   return this->impl_->RelaxMode() = enable;
 }
+
+bool CompileOption::isConstFolding() const {
+  return this->impl_->ConstFolding();
+}
+
+bool CompileOption::setConstFolding(bool enable) {
+  return this->impl_->ConstFolding() = enable;
+}
+
+bool CompileOption::isDeadNodeElimination() const {
+  return this->impl_->DeadNodeElimination();
+}
+
+bool CompileOption::setDeadNodeElimination(bool enable) {
+  return this->impl_->DeadNodeElimination() = enable;
+}
+
+bool CompileOption::isCommonSubexpressionElimination() const {
+  return this->impl_->CommonSubexpressionElimination();
+}
+
+bool CompileOption::setCommonSubexpressionElimination(bool enable) {
+  return this->impl_->CommonSubexpressionElimination() = enable;
+}
+
+std::string CompileOption::getCompileCacheDir() const {
+  return this->impl_->CompileCacheDir();
+}
+
+bool CompileOption::setCompileCacheDir(const std::string& dir) {
+  return !(this->impl_->CompileCacheDir() = dir).empty();
+}
+
+bool CompileOption::isKernelTuning() const {
+  return this->impl_->KernelTuning();
+}
+
+bool CompileOption::setKernelTuning(bool enable) {
+  return this->impl_->KernelTuning() = enable;
+}
+
+std::string CompileOption::getKernelTuningDB() const {
+  return this->impl_->KernelTuningDB();
+}
+
+bool CompileOption::setKernelTuningDB(const std::string& path) {
+  return !(this->impl_->KernelTuningDB() = path).empty();
+}
 }  // namespace vx
 }  // namespace tim
@@ -33,4 +33,69 @@ TEST(compile_option, relax_mode) {
   EXPECT_TRUE(opt.isRelaxMode() == true);
 
   EXPECT_TRUE(tim::vx::CompileOption::DefaultOptions.isRelaxMode() == false);
-}
\ No newline at end of file
+}
+TEST(compile_option, const_folding) {
+  tim::vx::CompileOption opt;
+
+  EXPECT_TRUE(opt.isConstFolding() == false);
+  opt.setConstFolding(true);
+  EXPECT_TRUE(opt.isConstFolding() == true);
+
+  EXPECT_TRUE(tim::vx::CompileOption::DefaultOptions.isConstFolding() == false);
+}
+
+TEST(compile_option, dead_node_elimination) {
+  tim::vx::CompileOption opt;
+
+  EXPECT_TRUE(opt.isDeadNodeElimination() == true);
+  opt.setDeadNodeElimination(false);
+  EXPECT_TRUE(opt.isDeadNodeElimination() == false);
+
+  EXPECT_TRUE(tim::vx::CompileOption::DefaultOptions.isDeadNodeElimination() ==
+              true);
+}
+
+TEST(compile_option, common_subexpression_elimination) {
+  tim::vx::CompileOption opt;
+
+  EXPECT_TRUE(opt.isCommonSubexpressionElimination() == true);
+  opt.setCommonSubexpressionElimination(false);
+  EXPECT_TRUE(opt.isCommonSubexpressionElimination() == false);
+
+  EXPECT_TRUE(tim::vx::CompileOption::DefaultOptions
+                  .isCommonSubexpressionElimination() == true);
+}
+
+TEST(compile_option, compile_cache_dir) {
+  tim::vx::CompileOption opt;
+
+  EXPECT_TRUE(opt.getCompileCacheDir().empty());
+  EXPECT_TRUE(opt.setCompileCacheDir("/tmp/tim_vx_cache"));
+  EXPECT_EQ(opt.getCompileCacheDir(), "/tmp/tim_vx_cache");
+  EXPECT_FALSE(opt.setCompileCacheDir());
+
+  EXPECT_TRUE(tim::vx::CompileOption::DefaultOptions.getCompileCacheDir()
+                  .empty());
+}
+
+TEST(compile_option, kernel_tuning) {
+  tim::vx::CompileOption opt;
+
+  EXPECT_TRUE(opt.isKernelTuning() == false);
+  opt.setKernelTuning(true);
+  EXPECT_TRUE(opt.isKernelTuning() == true);
+
+  EXPECT_TRUE(tim::vx::CompileOption::DefaultOptions.isKernelTuning() == false);
+}
+
+TEST(compile_option, kernel_tuning_db) {
+  tim::vx::CompileOption opt;
+
+  EXPECT_TRUE(opt.getKernelTuningDB().empty());
+  EXPECT_TRUE(opt.setKernelTuningDB("/tmp/tim_vx_tuning.db"));
+  EXPECT_EQ(opt.getKernelTuningDB(), "/tmp/tim_vx_tuning.db");
+  EXPECT_FALSE(opt.setKernelTuningDB());
+
+  EXPECT_TRUE(tim::vx::CompileOption::DefaultOptions.getKernelTuningDB()
+                  .empty());
+}
@@ -0,0 +1,352 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "const_folding.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "graph_private.h"
+#include "op_impl.h"
+#include "tensor_private.h"
+#include "tim/vx/operation.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace {
+
+struct ConstValue {
+  TensorSpec spec;
+  std::vector<uint8_t> data;
+};
+
+using Evaluator = std::function<bool(const std::shared_ptr<Operation>& op,
+                                     std::vector<ConstValue>& inputs,
+                                     ConstValue& output)>;
+
+bool IsFoldableType(const TensorSpec& spec) {
+  // INT64 has no float conversion, 4-bit data is packed two per byte
+  return spec.datatype_ != DataType::UNKNOWN &&
+         spec.datatype_ != DataType::INT64 &&
+         spec.GetElementBitSize() >= 8;
+}
+
+bool IsSameType(const TensorSpec& a, const TensorSpec& b) {
+  return a.datatype_ == b.datatype_ && a.quantization_ == b.quantization_;
+}
+
+bool ToFloat(ConstValue& value, std::vector<float>& out) {
+  if (QuantType::SYMMETRIC_PER_CHANNEL == value.spec.quantization_.Type()) {
+    return false;
+  }
+  vsi_nn_dtype_t dtype;
+  memset(&dtype, 0x00, sizeof(dtype));
+  PackTensorDtype(value.spec, &dtype);
+  out.resize(value.spec.GetElementNum());
+  return out.size() == vsi_nn_DtypeConvertRawDataToFloat32(
+                           value.data.data(), value.data.size(), &dtype,
+                           out.data(), out.size());
+}
+
+bool FromFloat(std::vector<float>& in, ConstValue& value) {
+  if (QuantType::SYMMETRIC_PER_CHANNEL == value.spec.quantization_.Type()) {
+    return false;
+  }
+  vsi_nn_dtype_t dtype;
+  memset(&dtype, 0x00, sizeof(dtype));
+  PackTensorDtype(value.spec, &dtype);
+  value.data.resize(value.spec.GetByteSize());
+  return in.size() == vsi_nn_DtypeConvertFloat32ToRawData(
+                          in.data(), in.size(), value.data.data(),
+                          value.data.size(), &dtype);
+}
+
+// Move `data` (laid out as `output.spec` shape) into `output` with
+// requantization if the element types differ
+bool StoreAs(ConstValue& src, ConstValue& output) {
+  if (IsSameType(src.spec, output.spec)) {
+    output.data = std::move(src.data);
+    return true;
+  }
+  std::vector<float> values;
+  return ToFloat(src, values) && FromFloat(values, output);
+}
+
+bool EvalReshape(const std::shared_ptr<Operation>& op,
+                 std::vector<ConstValue>& inputs, ConstValue& output) {
+  auto node = op->impl()->node();
+  std::vector<int64_t> size;
+#ifdef _VSI_NN_OP_RESHAPE2_H
+  for (uint32_t i = 0; i < node->nn_param.reshape2.dim_num; ++i) {
+    size.push_back(static_cast<int32_t>(node->nn_param.reshape2.size[i]));
+  }
+#else
+  for (uint32_t i = 0; i < node->nn_param.reshape.dim_num; ++i) {
+    size.push_back(static_cast<int32_t>(node->nn_param.reshape.size[i]));
+  }
+#endif
+
+  const auto& in_shape = inputs[0].spec.shape_;
+  int64_t total = inputs[0].spec.GetElementNum();
+  int64_t known = 1;
+  int32_t neg_idx = -1;
+  for (size_t i = 0; i < size.size(); ++i) {
+    if (0 == size[i]) {
+      // Same rule as ovxlib: 0 keeps the input dimension
+      if (i >= in_shape.size()) return false;
+      size[i] = in_shape[i];
+    }
+    if (-1 == size[i]) {
+      if (-1 != neg_idx) return false;
+      neg_idx = i;
+    } else {
+      known *= size[i];
+    }
+  }
+  if (-1 != neg_idx) {
+    if (0 == known || 0 != total % known) return false;
+    size[neg_idx] = total / known;
+    known = total;
+  }
+  if (known != total) return false;
+
+  output.spec.shape_.assign(size.begin(), size.end());
+  ConstValue src{output.spec, std::move(inputs[0].data)};
+  src.spec.datatype_ = inputs[0].spec.datatype_;
+  src.spec.quantization_ = inputs[0].spec.quantization_;
+  return StoreAs(src, output);
+}
+
+bool EvalTranspose(const std::shared_ptr<Operation>& op,
+                   std::vector<ConstValue>& inputs, ConstValue& output) {
+  auto node = op->impl()->node();
+  const auto& in_shape = inputs[0].spec.shape_;
+  const uint32_t rank = node->nn_param.permute.dim_num;
+  if (rank != in_shape.size()) return false;
+  std::vector<uint32_t> perm(node->nn_param.permute.perm,
+                             node->nn_param.permute.perm + rank);
+
+  ShapeType out_shape(rank);
+  for (uint32_t i = 0; i < rank; ++i) {
+    if (perm[i] >= rank) return false;
+    out_shape[i] = in_shape[perm[i]];
+  }
+
+  std::vector<int64_t> in_strides(rank, 1);
+  for (uint32_t i = 1; i < rank; ++i) {
+    in_strides[i] = in_strides[i - 1] * in_shape[i - 1];
+  }
+
+  const int64_t elem_size = inputs[0].spec.GetElementByteSize();
+  const int64_t count = inputs[0].spec.GetElementNum();
+  std::vector<uint8_t> data(inputs[0].data.size());
+  std::vector<uint32_t> coord(rank, 0);
+  for (int64_t out_idx = 0; out_idx < count; ++out_idx) {
+    int64_t in_idx = 0;
+    for (uint32_t i = 0; i < rank; ++i) {
+      in_idx += coord[i] * in_strides[perm[i]];
+    }
+    memcpy(data.data() + out_idx * elem_size,
+           inputs[0].data.data() + in_idx * elem_size, elem_size);
+    for (uint32_t i = 0; i < rank; ++i) {
+      if (++coord[i] < out_shape[i]) break;
+      coord[i] = 0;
+    }
+  }
+
+  output.spec.shape_ = out_shape;
+  ConstValue src{output.spec, std::move(data)};
+  src.spec.datatype_ = inputs[0].spec.datatype_;
+  src.spec.quantization_ = inputs[0].spec.quantization_;
+  return StoreAs(src, output);
+}
+
+bool EvalConvert(const std::shared_ptr<Operation>& op,
+                 std::vector<ConstValue>& inputs, ConstValue& output) {
+  (void)op;
+  output.spec.shape_ = inputs[0].spec.shape_;
+  return StoreAs(inputs[0], output);
+}
+
+bool BroadcastShape(const ShapeType& a, const ShapeType& b, ShapeType& out) {
+  out.resize(std::max(a.size(), b.size()));
+  for (size_t i = 0; i < out.size(); ++i) {
+    uint32_t da = i < a.size() ? a[i] : 1;
+    uint32_t db = i < b.size() ? b[i] : 1;
+    if (da != db && da != 1 && db != 1) return false;
+    out[i] = std::max(da, db);
+  }
+  return true;
+}
+
+// Index into a tensor of `shape` broadcasted to `out_shape`, shapes are
+// aligned from the innermost dimension as ovxlib does
+int64_t BroadcastIndex(const std::vector<uint32_t>& coord,
+                       const ShapeType& shape) {
+  int64_t idx = 0;
+  int64_t stride = 1;
+  for (size_t i = 0; i < shape.size(); ++i) {
+    idx += (shape[i] == 1 ? 0 : coord[i]) * stride;
+    stride *= shape[i];
+  }
+  return idx;
+}
+
+Evaluator MakeBinaryEvaluator(std::function<float(float, float, float)> fn) {
+  return [fn](const std::shared_ptr<Operation>& op,
+              std::vector<ConstValue>& inputs, ConstValue& output) -> bool {
+    auto node = op->impl()->node();
+    float scale = 1.0f;
+    if (VSI_NN_OP_MULTIPLY == node->op) {
+      scale = node->nn_param.multiply.scale;
+    } else if (VSI_NN_OP_DIVIDE == node->op) {
+      scale = node->nn_param.divide.scale;
+    }
+
+    ShapeType out_shape;
+    if (!BroadcastShape(inputs[0].spec.shape_, inputs[1].spec.shape_,
+                        out_shape)) {
+      return false;
+    }
+    std::vector<float> a, b;
+    if (!ToFloat(inputs[0], a) || !ToFloat(inputs[1], b)) return false;
+
+    output.spec.shape_ = out_shape;
+    std::vector<float> result(output.spec.GetElementNum());
+    std::vector<uint32_t> coord(out_shape.size(), 0);
+    for (size_t i = 0; i < result.size(); ++i) {
+      result[i] = fn(a[BroadcastIndex(coord, inputs[0].spec.shape_)],
+                     b[BroadcastIndex(coord, inputs[1].spec.shape_)], scale);
+      for (size_t d = 0; d < coord.size(); ++d) {
+        if (++coord[d] < out_shape[d]) break;
+        coord[d] = 0;
+      }
+    }
+    return FromFloat(result, output);
+  };
+}
+
+const std::map<int32_t, Evaluator>& Evaluators() {
+  static const std::map<int32_t, Evaluator> evaluators = {
+#ifdef _VSI_NN_OP_RESHAPE2_H
+      {VSI_NN_OP_RESHAPE2, EvalReshape},
+#else
+      {VSI_NN_OP_RESHAPE, EvalReshape},
+#endif
+      {VSI_NN_OP_PERMUTE, EvalTranspose},
+      {VSI_NN_OP_DATACONVERT, EvalConvert},
+      {VSI_NN_OP_CAST, EvalConvert},
+      {VSI_NN_OP_ADD, MakeBinaryEvaluator(
+                          [](float a, float b, float) { return a + b; })},
+      {VSI_NN_OP_SUBTRACT, MakeBinaryEvaluator(
+                               [](float a, float b, float) { return a - b; })},
+      {VSI_NN_OP_MULTIPLY,
+       MakeBinaryEvaluator([](float a, float b, float s) { return a * b * s; })},
+      {VSI_NN_OP_DIVIDE,
+       MakeBinaryEvaluator([](float a, float b, float s) { return a / b * s; })},
+      {VSI_NN_OP_MINIMUM, MakeBinaryEvaluator(
+                              [](float a, float b, float) { return std::min(a, b); })},
+      {VSI_NN_OP_MAXIMUM, MakeBinaryEvaluator(
+                              [](float a, float b, float) { return std::max(a, b); })},
+  };
+  return evaluators;
+}
+
+bool IsFoldable(const std::shared_ptr<Operation>& op) {
+  if (nullptr == op->impl()->node() || op->impl()->kind_ == -1) return false;
+  if (Evaluators().end() == Evaluators().find(op->impl()->kind_)) return false;
+
+  auto inputs = op->impl()->InputsTensor();
+  auto outputs = op->impl()->OutputsTensor();
+  if (inputs.empty() || 1 != outputs.size()) return false;
+  for (const auto& t : inputs) {
+    if (!t->IsConstTensor() || t->IsPlaceHolder() ||
+        !IsFoldableType(t->GetSpec())) {
+      return false;
+    }
+  }
+  // Graph outputs must still be written by the device
+  return outputs[0]->GetSpec().attr_ == TensorAttribute::TRANSIENT &&
+         IsFoldableType(outputs[0]->GetSpec());
+}
+
+}  // namespace
+
+ConstFoldingStatistics ConstantFolding(GraphImpl* graph) {
+  ConstFoldingStatistics statistics;
+  bool changed = true;
+  // Folded results may make their consumers foldable, iterate to fixed point
+  while (changed) {
+    changed = false;
+    auto ops = graph->OpVector();
+    for (const auto& op : ops) {
+      if (!IsFoldable(op)) continue;
+
+      std::vector<ConstValue> inputs;
+      uint64_t io_bytes = 0;
+      bool status = true;
+      for (const auto& t : op->impl()->InputsTensor()) {
+        ConstValue value{t->GetSpec(), {}};
+        value.data.resize(value.spec.GetByteSize());
+        status = status && t->CopyDataFromTensor(value.data.data());
+        io_bytes += value.data.size();
+        inputs.push_back(std::move(value));
+      }
+
+      auto out_tensor = op->impl()->OutputsTensor()[0];
+      ConstValue output{out_tensor->GetSpec(), {}};
+      ShapeType declared_shape = output.spec.shape_;
+      status = status &&
+               Evaluators().at(op->impl()->kind_)(op, inputs, output);
+      if (status && !declared_shape.empty() &&
+          declared_shape != output.spec.shape_) {
+        VSILOGW("Op %d: folded shape mismatches the output tensor.",
+                op->impl()->kind_);
+        status = false;
+      }
+      if (!status) {
+        VSILOGD("Op %d: skip constant folding.", op->impl()->kind_);
+        continue;
+      }
+
+      output.spec.attr_ = TensorAttribute::CONSTANT;
+      auto folded = graph->CreateTensor(output.spec, output.data.data());
+      graph->ReplaceTensorConsumers(out_tensor, folded);
+      graph->RemoveOperation(op);
+
+      io_bytes += output.data.size();
+      statistics.folded_nodes++;
+      statistics.saved_bytes += io_bytes;
+      changed = true;
+    }
+  }
+  return statistics;
+}
+
+}  // namespace vx
+}  // namespace tim
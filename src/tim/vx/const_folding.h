@@ -0,0 +1,48 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_CONST_FOLDING_H_
+#define TIM_VX_CONST_FOLDING_H_
+
+#include <cstdint>
+
+namespace tim {
+namespace vx {
+
+class GraphImpl;
+
+struct ConstFoldingStatistics {
+  uint32_t folded_nodes{0};
+  // Bytes no longer read or written by device kernels on each run
+  uint64_t saved_bytes{0};
+};
+
+/// Evaluate operations whose inputs are all CONSTANT on host and replace their
+/// outputs with new constant tensors. Operations producing graph outputs and
+/// composed operations are kept untouched.
+ConstFoldingStatistics ConstantFolding(GraphImpl* graph);
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_CONST_FOLDING_H_ */
@@ -0,0 +1,111 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/compile_option.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/ops/reshape.h"
+#include "tim/vx/ops/transpose.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+TEST(const_folding, fold_constant_subgraph) {
+  auto ctx = tim::vx::Context::Create();
+  tim::vx::CompileOption option;
+  option.setConstFolding(true);
+  auto graph = ctx->CreateGraph(option);
+
+  tim::vx::ShapeType shape({2, 3});
+  tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, {3, 2},
+                                 tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {1},
+                                tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {},
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  std::vector<float> weight = {1, 2, 3, 4, 5, 6};
+  float bias = 10;
+  auto weight_t = graph->CreateTensor(const_spec, weight.data());
+  auto bias_t = graph->CreateTensor(bias_spec, &bias);
+  auto transposed_t = graph->CreateTensor(transient_spec);
+  auto biased_t = graph->CreateTensor(transient_spec);
+  auto input_t = graph->CreateTensor(input_spec);
+  auto output_t = graph->CreateTensor(output_spec);
+
+  // Both Transpose and the first Add only see constants and get folded
+  auto transpose = graph->CreateOperation<tim::vx::ops::Transpose>(
+      std::vector<uint32_t>({1, 0}));
+  (*transpose).BindInput(weight_t).BindOutput(transposed_t);
+  auto add_bias = graph->CreateOperation<tim::vx::ops::Add>();
+  (*add_bias).BindInputs({transposed_t, bias_t}).BindOutput(biased_t);
+  auto add = graph->CreateOperation<tim::vx::ops::Add>();
+  (*add).BindInputs({input_t, biased_t}).BindOutput(output_t);
+
+  std::vector<float> in_data = {1, 1, 1, 1, 1, 1};
+  std::vector<float> golden = {12, 15, 13, 16, 14, 17};
+  EXPECT_TRUE(input_t->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float)));
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_TRUE(graph->GetConsumersOp(weight_t).empty());
+  EXPECT_EQ(graph->GetProducerOp(biased_t), nullptr);
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<float> output(golden.size());
+  EXPECT_TRUE(output_t->CopyDataFromTensor(output.data()));
+  EXPECT_EQ(golden, output);
+}
+
+TEST(const_folding, keep_graph_output) {
+  auto ctx = tim::vx::Context::Create();
+  tim::vx::CompileOption option;
+  option.setConstFolding(true);
+  auto graph = ctx->CreateGraph(option);
+
+  tim::vx::TensorSpec const_spec(tim::vx::DataType::FLOAT32, {4},
+                                 tim::vx::TensorAttribute::CONSTANT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {2, 2},
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  std::vector<float> data = {1, 2, 3, 4};
+  auto const_t = graph->CreateTensor(const_spec, data.data());
+  auto output_t = graph->CreateTensor(output_spec);
+
+  auto reshape = graph->CreateOperation<tim::vx::ops::Reshape>(
+      std::vector<uint32_t>({2, 2}));
+  (*reshape).BindInput(const_t).BindOutput(output_t);
+
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_EQ(graph->GetProducerOp(output_t), reshape);
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<float> output(data.size());
+  EXPECT_TRUE(output_t->CopyDataFromTensor(output.data()));
+  EXPECT_EQ(data, output);
+}
@@ -23,8 +23,15 @@
 *****************************************************************************/
 #include "tim/vx/context.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+#include "builtin_op_impl.h"
 #include "context_private.h"
 #include "graph_private.h"
+#include "graph_serialization.h"
 #include "tim/vx/graph.h"
 #include "tim/vx/compile_option.h"
 #include "vsi_nn_pub.h"
@@ -32,11 +39,42 @@
 namespace tim {
 namespace vx {
 
+namespace {
+void ReleaseContext(vsi_nn_context_t context) {
+#ifdef TIM_VX_ENABLE_CUSTOM_OP
+  ops::ReleaseCustomOpPrograms(context->c);
+#endif
+  vsi_nn_ReleaseContext(&context);
+}
+}  // namespace
+
+std::shared_ptr<_vsi_nn_context_t> AcquireSharedContext() {
+  static std::mutex pool_mutex;
+  static std::weak_ptr<_vsi_nn_context_t> pool;
+
+  std::lock_guard<std::mutex> lock(pool_mutex);
+  auto context = pool.lock();
+  if (!context) {
+    vsi_nn_context_t raw = vsi_nn_CreateContext();
+    if (!raw) {
+      VSILOGE("Create shared context fail.");
+      return nullptr;
+    }
+    context.reset(raw, ReleaseContext);
+    pool = context;
+  }
+  return context;
+}
+
 ContextImpl::ContextImpl() : context_(vsi_nn_CreateContext()) {}
 
+ContextImpl::ContextImpl(const std::shared_ptr<_vsi_nn_context_t>& shared)
+    : context_(shared.get()), shared_context_(shared) {}
+
 ContextImpl::~ContextImpl() {
-  if (context_) {
-    vsi_nn_ReleaseContext(&context_);
+  if (context_ && !shared_context_) {
+    ReleaseContext(context_);
+    context_ = nullptr;
   }
 }
 
@@ -46,6 +84,14 @@ std::shared_ptr<Context> Context::Create() {
   return std::make_shared<ContextImpl>();
 }
 
+std::shared_ptr<Context> Context::CreateShared() {
+  auto shared = AcquireSharedContext();
+  if (!shared) {
+    return nullptr;
+  }
+  return std::make_shared<ContextImpl>(shared);
+}
+
 std::shared_ptr<Graph> ContextImpl::CreateGraph() {
   return std::make_shared<GraphImpl>(this);
 }
@@ -54,6 +100,48 @@ std::shared_ptr<Graph> ContextImpl::CreateGraph(const CompileOption& options) {
   return std::make_shared<GraphImpl>(this, options);
 }
 
+std::shared_ptr<Graph> ContextImpl::LoadGraph(const std::string& path) {
+  return DeserializeGraph(this, path, CompileOption::DefaultOptions);
+}
+
+std::shared_ptr<Graph> ContextImpl::LoadGraph(const std::string& path,
+                                              const CompileOption& options) {
+  return DeserializeGraph(this, path, options);
+}
+
+// Graph compile only touches graph-owned state plus process wide registries
+// which are either immutable after load (op tables) or locked (kernel backends,
+// client ops, custom op programs), so distinct graphs compile concurrently.
+bool ContextImpl::CompileAll(const std::vector<std::shared_ptr<Graph>>& graphs,
+                             uint32_t threads) {
+  if (0 == threads) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads = std::min<uint32_t>(threads, graphs.size());
+
+  std::atomic<size_t> next(0);
+  std::atomic<bool> status(true);
+  auto worker = [&graphs, &next, &status]() {
+    for (size_t i = next++; i < graphs.size(); i = next++) {
+      if (!graphs[i]->Compile()) {
+        VSILOGE("Compile graph %zu fail.", i);
+        status = false;
+      }
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (uint32_t i = 1; i < threads; ++i) {
+    workers.emplace_back(worker);
+  }
+  // The calling thread takes a share of the graphs as well
+  worker();
+  for (auto& t : workers) {
+    t.join();
+  }
+  return status;
+}
+
 bool ContextImpl::isClOnly() {
     return VSI_NN_HW_EVIS_NONE == context_->config.evis.ver;
 }
@@ -24,22 +24,37 @@
 #ifndef TIM_VX_CONTEXT_PRIVATE_H_
 #define TIM_VX_CONTEXT_PRIVATE_H_
 #include "tim/vx/context.h"
+
+#include <memory>
+
 #include "vsi_nn_pub.h"
 
 namespace tim {
 namespace vx {
 
+/// Return the process-wide low-level context, it is created on first use and
+/// released once the last holder drops it
+std::shared_ptr<_vsi_nn_context_t> AcquireSharedContext();
+
 class ContextImpl : public Context {
  public:
   ContextImpl();
+  explicit ContextImpl(const std::shared_ptr<_vsi_nn_context_t>& shared);
   ~ContextImpl();
   vsi_nn_context_t context();
   std::shared_ptr<Graph> CreateGraph() override;
   std::shared_ptr<Graph> CreateGraph(const CompileOption&) override;
+  std::shared_ptr<Graph> LoadGraph(const std::string& path) override;
+  std::shared_ptr<Graph> LoadGraph(const std::string& path,
+                                   const CompileOption& options) override;
+  bool CompileAll(const std::vector<std::shared_ptr<Graph>>& graphs,
+                  uint32_t threads) override;
   bool isClOnly() override;
   
  protected:
   vsi_nn_context_t context_;
+  // Keeps context_ alive when it is borrowed from the shared pool
+  std::shared_ptr<_vsi_nn_context_t> shared_context_;
 };
 
 }  // namespace vx
@@ -22,12 +22,125 @@
 *
 *****************************************************************************/
 #include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "context_private.h"
+#include "vsi_nn_pub.h"
 #include "gtest/gtest.h"
 
+#include <thread>
+#include <vector>
+
 TEST(Context, create) {
     auto ctx0 = tim::vx::Context::Create();
     {auto ctx0 = tim::vx::Context::Create();}
     auto ctx1 = tim::vx::Context::Create();
     EXPECT_TRUE(nullptr != ctx0);
     EXPECT_TRUE(nullptr != ctx1);
-}
\ No newline at end of file
+}
+TEST(Context, create_shared) {
+    auto ctx0 = tim::vx::Context::CreateShared();
+    {
+        // Dropping a holder keeps the pooled context alive for the others
+        auto tmp = tim::vx::Context::CreateShared();
+        EXPECT_TRUE(nullptr != tmp);
+    }
+    auto ctx1 = tim::vx::Context::CreateShared();
+    ASSERT_TRUE(nullptr != ctx0);
+    ASSERT_TRUE(nullptr != ctx1);
+    EXPECT_TRUE(ctx0 != ctx1);
+    EXPECT_EQ(ctx0->isClOnly(), ctx1->isClOnly());
+    EXPECT_EQ(std::static_pointer_cast<tim::vx::ContextImpl>(ctx0)->context(),
+              std::static_pointer_cast<tim::vx::ContextImpl>(ctx1)->context());
+
+    // Graphs of ctx1 still compile and run once ctx0 is released
+    auto graph0 = ctx0->CreateGraph();
+    ctx0.reset();
+    graph0.reset();
+    auto graph1 = ctx1->CreateGraph();
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {4},
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {4},
+                                    tim::vx::TensorAttribute::OUTPUT);
+    auto input = graph1->CreateTensor(input_spec);
+    auto output = graph1->CreateTensor(output_spec);
+    (*graph1->CreateOperation<tim::vx::ops::Relu>())
+        .BindInput(input)
+        .BindOutput(output);
+    EXPECT_TRUE(graph1->Compile());
+
+    std::vector<float> in_data = {-1.0f, 2.0f, -3.0f, 4.0f};
+    std::vector<float> golden = {0.0f, 2.0f, 0.0f, 4.0f};
+    EXPECT_TRUE(input->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float)));
+    EXPECT_TRUE(graph1->Run());
+    std::vector<float> out_data(golden.size());
+    EXPECT_TRUE(output->CopyDataFromTensor(out_data.data()));
+    EXPECT_EQ(golden, out_data);
+}
+
+TEST(Context, compile_all) {
+    auto ctx = tim::vx::Context::CreateShared();
+    std::vector<std::shared_ptr<tim::vx::Graph>> graphs;
+    std::vector<std::shared_ptr<tim::vx::Tensor>> inputs;
+    std::vector<std::shared_ptr<tim::vx::Tensor>> outputs;
+    for (uint32_t i = 1; i <= 16; ++i) {
+        auto graph = ctx->CreateGraph();
+        tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {i, 2},
+                                       tim::vx::TensorAttribute::INPUT);
+        tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {i, 2},
+                                        tim::vx::TensorAttribute::OUTPUT);
+        inputs.push_back(graph->CreateTensor(input_spec));
+        outputs.push_back(graph->CreateTensor(output_spec));
+        (*graph->CreateOperation<tim::vx::ops::Relu>())
+            .BindInput(inputs.back())
+            .BindOutput(outputs.back());
+        graphs.push_back(graph);
+    }
+
+    EXPECT_TRUE(ctx->CompileAll(graphs, 4));
+    for (size_t i = 0; i < graphs.size(); ++i) {
+        std::vector<float> in_data(2 * (i + 1), -1.0f);
+        in_data[0] = 3.0f;
+        EXPECT_TRUE(inputs[i]->CopyDataToTensor(
+            in_data.data(), in_data.size() * sizeof(float)));
+        EXPECT_TRUE(graphs[i]->Run());
+        std::vector<float> out_data(in_data.size());
+        EXPECT_TRUE(outputs[i]->CopyDataFromTensor(out_data.data()));
+        EXPECT_EQ(3.0f, out_data[0]);
+        EXPECT_EQ(0.0f, out_data.back());
+    }
+}
+
+// Client ops are registered while other threads look ops up during setup
+TEST(Context, concurrent_client_op_registry) {
+    const vsi_nn_op_t base = 0x7f000000;
+    vsi_nn_op_proc_t proc = {NULL, NULL, NULL, NULL, NULL, NULL, 3, 1};
+    ASSERT_TRUE(vsi_nn_OpRegisterClient(base, &proc));
+
+    std::vector<std::thread> threads;
+    std::vector<int> failures(8, 0);
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([t, base, &failures]() {
+            vsi_nn_op_proc_t own = {NULL, NULL, NULL, NULL, NULL, NULL,
+                                    uint32_t(t), 1};
+            for (int i = 1; i <= 200; ++i) {
+                vsi_nn_op_t op = base + t * 1000 + i;
+                if (!vsi_nn_OpRegisterClient(op, &own)) ++failures[t];
+                auto shared = vsi_nn_OpGetClient(base);
+                if (!shared || 3 != shared->input_num) ++failures[t];
+                auto found = vsi_nn_OpGetClient(op);
+                if (!found || uint32_t(t) != found->input_num) ++failures[t];
+            }
+            for (int i = 1; i <= 200; ++i) {
+                vsi_nn_OpRemoveClient(base + t * 1000 + i);
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    vsi_nn_OpRemoveClient(base);
+
+    EXPECT_EQ(std::vector<int>(8, 0), failures);
+    EXPECT_FALSE(vsi_nn_OpIsRegistered(base));
+    EXPECT_FALSE(vsi_nn_OpIsRegistered(base + 1));
+}
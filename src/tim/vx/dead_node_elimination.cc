@@ -0,0 +1,103 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "dead_node_elimination.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+#include "graph_private.h"
+#include "op_impl.h"
+#include "tim/vx/operation.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+
+DeadNodeEliminationStatistics EliminateDeadNodes(GraphImpl* graph) {
+  DeadNodeEliminationStatistics statistics;
+  auto ops = graph->OpVector();
+
+  // Composed operations share their outputs with internal operations, so a
+  // tensor may have more than one producer here
+  std::map<std::shared_ptr<Tensor>, std::vector<std::shared_ptr<Operation>>>
+      producers;
+  std::set<std::shared_ptr<Operation>> live_ops;
+  std::vector<std::shared_ptr<Tensor>> worklist = graph->OutputsTensor();
+  auto mark_live = [&live_ops, &worklist](const std::shared_ptr<Operation>& op) {
+    if (live_ops.insert(op).second) {
+      auto inputs = op->impl()->InputsTensor();
+      worklist.insert(worklist.end(), inputs.begin(), inputs.end());
+    }
+  };
+
+  for (const auto& op : ops) {
+    auto outputs = op->impl()->OutputsTensor();
+    if (outputs.empty()) {
+      mark_live(op);
+    }
+    for (const auto& t : outputs) {
+      producers[t].push_back(op);
+      if (!(t->GetSpec().attr_ & TensorAttribute::TRANSIENT)) {
+        mark_live(op);
+      }
+    }
+  }
+
+  std::set<std::shared_ptr<Tensor>> live_tensors;
+  while (!worklist.empty()) {
+    auto tensor = worklist.back();
+    worklist.pop_back();
+    if (!live_tensors.insert(tensor).second) continue;
+    auto producer = producers.find(tensor);
+    if (producers.end() == producer) continue;
+    for (const auto& op : producer->second) {
+      mark_live(op);
+    }
+  }
+
+  std::set<std::shared_ptr<Tensor>> dead_tensors;
+  for (const auto& op : ops) {
+    if (live_ops.count(op)) continue;
+    for (const auto& t : op->impl()->InputsTensor()) {
+      if (!live_tensors.count(t)) dead_tensors.insert(t);
+    }
+    for (const auto& t : op->impl()->OutputsTensor()) {
+      dead_tensors.insert(t);
+    }
+    VSILOGD("Remove dead op %d.", op->impl()->kind_);
+    graph->RemoveOperation(op);
+    statistics.removed_nodes++;
+  }
+  for (const auto& t : dead_tensors) {
+    if (!t->IsPlaceHolder() &&
+        !(t->GetSpec().attr_ & (TensorAttribute::INPUT | TensorAttribute::OUTPUT))) {
+      statistics.unused_tensors++;
+    }
+  }
+  return statistics;
+}
+
+}  // namespace vx
+}  // namespace tim
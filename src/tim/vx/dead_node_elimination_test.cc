@@ -0,0 +1,138 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/compile_option.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/elementwise.h"
+#include "tim/vx/ops/simple_operations.h"
+#include "graph_private.h"
+#include "op_impl.h"
+
+#include "gtest/gtest.h"
+
+#include <set>
+#include <vector>
+
+TEST(dead_node_elimination, remove_unreachable_branch) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType shape({4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto input_t = graph->CreateTensor(input_spec);
+  auto dead_t0 = graph->CreateTensor(transient_spec);
+  auto dead_t1 = graph->CreateTensor(transient_spec);
+  auto output_t = graph->CreateTensor(output_spec);
+
+  auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInput(input_t).BindOutput(output_t);
+  // Auxiliary branch whose result is never used
+  auto dead_neg = graph->CreateOperation<tim::vx::ops::Neg>();
+  (*dead_neg).BindInput(input_t).BindOutput(dead_t0);
+  auto dead_add = graph->CreateOperation<tim::vx::ops::Add>();
+  (*dead_add).BindInputs({dead_t0, input_t}).BindOutput(dead_t1);
+
+  std::vector<float> in_data = {-1, 2, -3, 4};
+  std::vector<float> golden = {0, 2, 0, 4};
+  EXPECT_TRUE(input_t->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float)));
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_EQ(graph->GetProducerOp(dead_t0), nullptr);
+  EXPECT_EQ(graph->GetProducerOp(dead_t1), nullptr);
+  EXPECT_EQ(graph->GetConsumersOp(input_t).size(), 1u);
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<float> output(golden.size());
+  EXPECT_TRUE(output_t->CopyDataFromTensor(output.data()));
+  EXPECT_EQ(golden, output);
+}
+
+TEST(dead_node_elimination, disabled_by_option) {
+  auto ctx = tim::vx::Context::Create();
+  tim::vx::CompileOption option;
+  option.setDeadNodeElimination(false);
+  auto graph = ctx->CreateGraph(option);
+
+  tim::vx::ShapeType shape({4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, shape,
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto input_t = graph->CreateTensor(input_spec);
+  auto dead_t = graph->CreateTensor(transient_spec);
+  auto output_t = graph->CreateTensor(output_spec);
+
+  auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+  (*relu).BindInput(input_t).BindOutput(output_t);
+  auto dead_neg = graph->CreateOperation<tim::vx::ops::Neg>();
+  (*dead_neg).BindInput(input_t).BindOutput(dead_t);
+
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_EQ(graph->GetProducerOp(dead_t), dead_neg);
+}
+
+TEST(dead_node_elimination, nodes_added_after_removal_fill_the_table) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+  auto graph_impl = dynamic_cast<tim::vx::GraphImpl*>(graph.get());
+
+  tim::vx::ShapeType shape({4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto input_t = graph->CreateTensor(input_spec);
+
+  std::vector<std::shared_ptr<tim::vx::Operation>> ops;
+  for (int i = 0; i < 3; i++) {
+    ops.push_back(graph->CreateOperation<tim::vx::ops::Relu>());
+    (*ops.back()).BindInput(input_t).BindOutput(
+        graph->CreateTensor(output_spec));
+  }
+  graph_impl->RemoveOperation(ops[0]);
+  auto added = graph->CreateOperation<tim::vx::ops::Neg>();
+  (*added).BindInput(input_t).BindOutput(graph->CreateTensor(output_spec));
+
+  vsi_nn_graph_t* vsi_graph = graph_impl->graph();
+  ASSERT_EQ(3u, vsi_graph->node_num);
+  std::set<uint32_t> uids;
+  for (uint32_t i = 0; i < vsi_graph->node_num; i++) {
+    vsi_nn_node_t* node = vsi_nn_GetNode(vsi_graph, i);
+    ASSERT_NE(nullptr, node) << "node " << i;
+    EXPECT_EQ(i + 1, node->uid);
+    uids.insert(node->uid);
+  }
+  EXPECT_EQ(3u, uids.size());
+  EXPECT_EQ(added->impl()->node(), vsi_nn_GetNode(vsi_graph, 2));
+}
@@ -0,0 +1,113 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/detection_post_process.h"
+
+#include <type_traits>
+
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+
+static_assert(sizeof(Detection) == sizeof(vsi_nn_detection_t) &&
+                  std::is_standard_layout<Detection>::value,
+              "Detection must match vsi_nn_detection_t");
+
+namespace {
+
+vsi_nn_detection_nms_param_t ToNmsParam(const NmsOptions& options) {
+  vsi_nn_detection_nms_param_t param;
+  param.iou_thresh = options.iou_threshold;
+  param.score_thresh = options.score_threshold;
+  param.pre_nms_top_k = options.pre_nms_top_k;
+  param.pixel_inclusive = options.pixel_inclusive ? TRUE : FALSE;
+  return param;
+}
+
+vsi_nn_detection_t* ToC(std::vector<Detection>& detections) {
+  return reinterpret_cast<vsi_nn_detection_t*>(detections.data());
+}
+
+}  // namespace
+
+DetectionPostProcessor::DetectionPostProcessor(uint32_t max_boxes)
+    : workspace_(vsi_nn_DetectionCreateWorkspace(max_boxes)) {}
+
+DetectionPostProcessor::~DetectionPostProcessor() {
+  vsi_nn_DetectionReleaseWorkspace(&workspace_);
+}
+
+bool DetectionPostProcessor::DecodeBoxes(const float* deltas,
+                                         const float* anchors, uint32_t count,
+                                         const std::array<float, 4>& variance,
+                                         float* boxes) {
+  return VSI_SUCCESS == vsi_nn_DetectionDecodeBoxes(deltas, anchors, count,
+                                                    variance.data(), boxes);
+}
+
+bool DetectionPostProcessor::Nms(const float* boxes, const float* scores,
+                                 uint32_t count, const NmsOptions& options,
+                                 std::vector<Detection>& detections) {
+  auto param = ToNmsParam(options);
+  uint32_t kept = 0;
+  detections.resize(options.max_detections);
+  vsi_status status =
+      vsi_nn_DetectionNms(workspace_, boxes, scores, count, &param,
+                          ToC(detections), options.max_detections, &kept);
+  detections.resize(kept);
+  return VSI_SUCCESS == status;
+}
+
+bool DetectionPostProcessor::MultiClassNms(
+    const float* boxes, const float* scores, uint32_t count,
+    uint32_t num_classes, uint32_t first_class, const NmsOptions& options,
+    std::vector<Detection>& detections) {
+  auto param = ToNmsParam(options);
+  uint32_t kept = 0;
+  detections.resize(options.max_detections);
+  vsi_status status = vsi_nn_DetectionMultiClassNms(
+      workspace_, boxes, scores, count, num_classes, first_class, &param,
+      ToC(detections), options.max_detections, &kept);
+  detections.resize(kept);
+  return VSI_SUCCESS == status;
+}
+
+bool DetectionPostProcessor::BatchedNms(const float* boxes,
+                                        const float* scores,
+                                        const uint32_t* class_ids,
+                                        uint32_t count,
+                                        const NmsOptions& options,
+                                        std::vector<Detection>& detections) {
+  auto param = ToNmsParam(options);
+  uint32_t kept = 0;
+  detections.resize(options.max_detections);
+  vsi_status status = vsi_nn_DetectionBatchedNms(
+      workspace_, boxes, scores, class_ids, count, &param, ToC(detections),
+      options.max_detections, &kept);
+  detections.resize(kept);
+  return VSI_SUCCESS == status;
+}
+
+}  // namespace vx
+}  // namespace tim
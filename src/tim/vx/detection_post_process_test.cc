@@ -0,0 +1,255 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/detection_post_process.h"
+
+#include <algorithm>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+float Iou(const float* a, const float* b) {
+  float w = std::min(a[2], b[2]) - std::max(a[0], b[0]);
+  float h = std::min(a[3], b[3]) - std::max(a[1], b[1]);
+  if (w < 0 || h < 0) return 0.0f;
+  float inter = w * h;
+  float area_a = (a[2] - a[0]) * (a[3] - a[1]);
+  float area_b = (b[2] - b[0]) * (b[3] - b[1]);
+  return inter / (area_a + area_b - inter);
+}
+
+// Straightforward greedy NMS used as reference
+std::vector<uint32_t> ReferenceNms(const std::vector<float>& boxes,
+                                   const std::vector<float>& scores,
+                                   float iou_threshold, float score_threshold) {
+  std::vector<uint32_t> order;
+  for (uint32_t i = 0; i < scores.size(); ++i) {
+    if (scores[i] > score_threshold) order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+    return scores[a] > scores[b];
+  });
+  std::vector<uint32_t> keep;
+  for (auto i : order) {
+    bool suppressed = false;
+    for (auto k : keep) {
+      if (Iou(&boxes[i * 4], &boxes[k * 4]) > iou_threshold) {
+        suppressed = true;
+        break;
+      }
+    }
+    if (!suppressed) keep.push_back(i);
+  }
+  return keep;
+}
+
+void RandomBoxes(uint32_t count, uint32_t seed, std::vector<float>& boxes,
+                 std::vector<float>& scores) {
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> pos(0.0f, 300.0f);
+  std::uniform_real_distribution<float> size(5.0f, 60.0f);
+  std::uniform_real_distribution<float> score(0.0f, 1.0f);
+  boxes.resize(count * 4);
+  scores.resize(count);
+  for (uint32_t i = 0; i < count; ++i) {
+    boxes[i * 4 + 0] = pos(rng);
+    boxes[i * 4 + 1] = pos(rng);
+    boxes[i * 4 + 2] = boxes[i * 4 + 0] + size(rng);
+    boxes[i * 4 + 3] = boxes[i * 4 + 1] + size(rng);
+    scores[i] = score(rng);
+  }
+}
+
+}  // namespace
+
+TEST(DetectionPostProcess, nms_basic) {
+  // 0 and 1 overlap heavily, 2 is apart
+  std::vector<float> boxes = {0, 0, 10, 10, 1, 1, 11, 11, 50, 50, 60, 60};
+  std::vector<float> scores = {0.8f, 0.9f, 0.7f};
+  tim::vx::DetectionPostProcessor processor;
+  tim::vx::NmsOptions options;
+
+  std::vector<tim::vx::Detection> result;
+  ASSERT_TRUE(processor.Nms(boxes.data(), scores.data(), 3, options, result));
+  ASSERT_EQ(2u, result.size());
+  EXPECT_EQ(1u, result[0].index);
+  EXPECT_FLOAT_EQ(0.9f, result[0].score);
+  EXPECT_EQ(2u, result[1].index);
+
+  options.score_threshold = 0.75f;
+  std::vector<tim::vx::Detection> filtered;
+  ASSERT_TRUE(
+      processor.Nms(boxes.data(), scores.data(), 3, options, filtered));
+  ASSERT_EQ(1u, filtered.size());
+  EXPECT_EQ(1u, filtered[0].index);
+}
+
+TEST(DetectionPostProcess, nms_matches_reference) {
+  std::vector<float> boxes, scores;
+  tim::vx::DetectionPostProcessor processor;
+  tim::vx::NmsOptions options;
+  options.iou_threshold = 0.45f;
+  options.score_threshold = 0.2f;
+  options.max_detections = 5000;
+
+  for (uint32_t seed = 0; seed < 5; ++seed) {
+    RandomBoxes(2000, seed, boxes, scores);
+    auto expected = ReferenceNms(boxes, scores, options.iou_threshold,
+                                 options.score_threshold);
+    std::vector<tim::vx::Detection> result;
+    ASSERT_TRUE(
+        processor.Nms(boxes.data(), scores.data(), 2000, options, result));
+    ASSERT_EQ(expected.size(), result.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(expected[i], result[i].index);
+    }
+  }
+}
+
+TEST(DetectionPostProcess, nms_top_k_and_limit) {
+  std::vector<float> boxes, scores;
+  RandomBoxes(1000, 7, boxes, scores);
+  tim::vx::DetectionPostProcessor processor(1000);
+  tim::vx::NmsOptions options;
+  options.pre_nms_top_k = 50;
+  options.max_detections = 1000;
+
+  std::vector<tim::vx::Detection> result;
+  ASSERT_TRUE(
+      processor.Nms(boxes.data(), scores.data(), 1000, options, result));
+  ASSERT_LE(result.size(), 50u);
+  std::vector<float> sorted = scores;
+  std::sort(sorted.begin(), sorted.end(), std::greater<float>());
+  for (auto& d : result) {
+    EXPECT_GE(d.score, sorted[49]);
+  }
+
+  options.pre_nms_top_k = 0;
+  options.max_detections = 3;
+  std::vector<tim::vx::Detection> limited;
+  ASSERT_TRUE(
+      processor.Nms(boxes.data(), scores.data(), 1000, options, limited));
+  ASSERT_EQ(3u, limited.size());
+  EXPECT_FLOAT_EQ(sorted[0], limited[0].score);
+}
+
+TEST(DetectionPostProcess, multi_class_and_batched) {
+  // Same box twice, scored for different classes
+  std::vector<float> boxes = {0, 0, 10, 10, 0, 0, 10, 10};
+  // 3 classes, class 0 is background
+  std::vector<float> scores = {0.9f, 0.8f, 0.1f, 0.9f, 0.1f, 0.7f};
+  tim::vx::DetectionPostProcessor processor;
+  tim::vx::NmsOptions options;
+  options.score_threshold = 0.5f;
+
+  std::vector<tim::vx::Detection> per_class;
+  ASSERT_TRUE(
+      processor.MultiClassNms(boxes.data(), scores.data(), 2, 3, 1, options,
+                              per_class));
+  ASSERT_EQ(2u, per_class.size());
+  EXPECT_EQ(0u, per_class[0].index);
+  EXPECT_EQ(1u, per_class[0].class_id);
+  EXPECT_EQ(1u, per_class[1].index);
+  EXPECT_EQ(2u, per_class[1].class_id);
+
+  std::vector<float> batch_scores = {0.8f, 0.7f};
+  std::vector<uint32_t> class_ids = {1, 2};
+  std::vector<tim::vx::Detection> batched;
+  ASSERT_TRUE(
+      processor.BatchedNms(boxes.data(), batch_scores.data(), class_ids.data(),
+                           2, options, batched));
+  ASSERT_EQ(2u, batched.size());
+  EXPECT_EQ(2u, batched[1].class_id);
+
+  class_ids[1] = 1;
+  std::vector<tim::vx::Detection> same_class;
+  ASSERT_TRUE(
+      processor.BatchedNms(boxes.data(), batch_scores.data(), class_ids.data(),
+                           2, options, same_class));
+  ASSERT_EQ(1u, same_class.size());
+  EXPECT_EQ(0u, same_class[0].index);
+}
+
+TEST(DetectionPostProcess, pixel_inclusive_overlaps_sub_pixel_gaps) {
+  // The boxes are 0.5 apart, the + 1 of pixel inclusive widths makes them
+  // share half a pixel column as in py-faster-rcnn
+  std::vector<float> boxes = {0, 0, 10, 10, 10.5f, 0, 20.5f, 10};
+  std::vector<float> scores = {0.9f, 0.8f};
+  tim::vx::DetectionPostProcessor processor;
+  tim::vx::NmsOptions options;
+  options.pixel_inclusive = true;
+  options.iou_threshold = 0.01f;
+
+  std::vector<tim::vx::Detection> result;
+  ASSERT_TRUE(processor.Nms(boxes.data(), scores.data(), 2, options, result));
+  EXPECT_EQ(1u, result.size());
+
+  // More than a pixel apart the boxes are disjoint
+  boxes[4] = 11.5f;
+  boxes[6] = 21.5f;
+  ASSERT_TRUE(processor.Nms(boxes.data(), scores.data(), 2, options, result));
+  EXPECT_EQ(2u, result.size());
+
+  // Without the offset a sub-pixel gap is disjoint as well
+  boxes[4] = 10.5f;
+  boxes[6] = 20.5f;
+  options.pixel_inclusive = false;
+  ASSERT_TRUE(processor.Nms(boxes.data(), scores.data(), 2, options, result));
+  EXPECT_EQ(2u, result.size());
+}
+
+TEST(DetectionPostProcess, failure_is_not_an_empty_result) {
+  std::vector<float> boxes = {0, 0, 10, 10};
+  std::vector<float> scores = {0.1f};
+  tim::vx::DetectionPostProcessor processor;
+  tim::vx::NmsOptions options;
+  options.score_threshold = 0.5f;
+
+  std::vector<tim::vx::Detection> result(1);
+  EXPECT_TRUE(processor.Nms(boxes.data(), scores.data(), 1, options, result));
+  EXPECT_TRUE(result.empty());
+
+  result.resize(1);
+  EXPECT_FALSE(processor.Nms(boxes.data(), nullptr, 1, options, result));
+  EXPECT_TRUE(result.empty());
+  EXPECT_FALSE(processor.BatchedNms(boxes.data(), scores.data(), nullptr, 1,
+                                    options, result));
+}
+
+TEST(DetectionPostProcess, decode_boxes) {
+  std::vector<float> anchors = {50, 40, 20, 10, 0, 0, 4, 8};
+  std::vector<float> deltas = {0, 0, 0, 0, 1, -1, 0, 0};
+  std::vector<float> boxes(8);
+  ASSERT_TRUE(tim::vx::DetectionPostProcessor::DecodeBoxes(
+      deltas.data(), anchors.data(), 2, {0.1f, 0.1f, 0.2f, 0.2f},
+      boxes.data()));
+  EXPECT_FLOAT_EQ(40.0f, boxes[0]);
+  EXPECT_FLOAT_EQ(35.0f, boxes[1]);
+  EXPECT_FLOAT_EQ(60.0f, boxes[2]);
+  EXPECT_FLOAT_EQ(45.0f, boxes[3]);
+  // cx = 0 + 1 * 0.1 * 4, cy = 0 - 1 * 0.1 * 8
+  EXPECT_FLOAT_EQ(0.4f - 2.0f, boxes[4]);
+  EXPECT_FLOAT_EQ(-0.8f - 4.0f, boxes[5]);
+}
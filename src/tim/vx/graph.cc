@@ -23,14 +23,18 @@
 *****************************************************************************/
 #include "tim/vx/graph.h"
 #include <algorithm>
+#include <cinttypes>
+#include <cstdio>
 
 #ifdef ENABLE_TENSOR_CACHE
 #include <openssl/evp.h>
 #include <cstring>
 #endif
 
+#include "compile_cache.h"
 #include "context_private.h"
 #include "graph_private.h"
+#include "graph_serialization.h"
 #include "op_impl.h"
 #include "tensor_private.h"
 #include "tim/vx/context.h"
@@ -96,7 +100,12 @@ GraphImpl::GraphImpl(ContextImpl* context, const CompileOption& options)
       not_consumed_output_cnt_(0),
       options_(options){}
 
-GraphImpl::~GraphImpl() { vsi_nn_ReleaseGraph(&graph_); }
+GraphImpl::~GraphImpl() {
+  for (auto& node : detached_nodes_) {
+    vsi_nn_ReleaseNode(&node);
+  }
+  vsi_nn_ReleaseGraph(&graph_);
+}
 
 #ifdef ENABLE_TENSOR_CACHE
 std::map<std::string, std::shared_ptr<tim::vx::Tensor>>& GraphImpl::GetTensorCacheMap() {
@@ -105,27 +114,7 @@ std::map<std::string, std::shared_ptr<tim::vx::Tensor>>& GraphImpl::GetTensorCac
 
 const std::string GraphImpl::CalculateCacheKey(const TensorSpec& spec, const void* data) {
   std::string md5_key;
-  uint32_t data_size = 1;
-  for (auto it = spec.shape_.begin(); it != spec.shape_.end(); ++it) {
-    data_size *= *it;
-  }
-  switch (spec.datatype_) {
-    case DataType::INT16:
-    case DataType::UINT16:
-    case DataType::FLOAT16:
-      data_size *= 2;
-      break;
-    case DataType::INT32:
-    case DataType::UINT32:
-    case DataType::FLOAT32:
-      data_size *= 4;
-      break;
-    case DataType::INT64:
-      data_size *= 8;
-      break;
-    default:
-      break;
-  }
+  uint32_t data_size = spec.GetByteSize();
   if (data_size < 512) {
     md5_key = calculateMd5Secret32(std::string((const char*)data, data_size));
   } else {
@@ -226,6 +215,64 @@ std::shared_ptr<Operation> GraphImpl::GetProducerOp(
   }
 }
 
+void GraphImpl::RemoveOperation(const std::shared_ptr<Operation>& op) {
+  op_vector_.erase(std::remove(op_vector_.begin(), op_vector_.end(), op),
+                   op_vector_.end());
+  for (auto& consumers : tensor_consumers_) {
+    auto& ops = consumers.second;
+    ops.erase(std::remove(ops.begin(), ops.end(), op), ops.end());
+  }
+  for (auto it = tensor_producer_.begin(); it != tensor_producer_.end();) {
+    if (it->second == op) {
+      it = tensor_producer_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+
+  auto node = op->impl()->node();
+  if (nullptr == node) return;
+  // ovxlib walks node ids in [0, node_num) without holes, move the last node
+  // into the released slot to keep the table dense
+  uint32_t last = graph_->node_num - 1;
+  for (uint32_t i = 0; i < graph_->node_num; ++i) {
+    if (vsi_nn_GetNode(graph_, i) != node) continue;
+    vsi_nn_MapRemove(graph_->node_table, (vsi_nn_map_key_t)i);
+    if (i != last) {
+      auto moved = vsi_nn_GetNode(graph_, last);
+      vsi_nn_MapRemove(graph_->node_table, (vsi_nn_map_key_t)last);
+      vsi_nn_MapAdd(graph_->node_table, (vsi_nn_map_key_t)i, (void*)moved);
+      // Ops number uid as their node id plus one, see BuiltinOpImpl
+      moved->uid = i + 1;
+    }
+    graph_->node_num--;
+    // Nodes added later take the next id, which must follow the last slot
+    graph_->cur_nid = graph_->node_num;
+    detached_nodes_.push_back(node);
+    break;
+  }
+}
+
+void GraphImpl::ReplaceTensorConsumers(const std::shared_ptr<Tensor>& src,
+                                       const std::shared_ptr<Tensor>& dst) {
+  auto consumers = tensor_consumers_.find(src);
+  if (tensor_consumers_.end() == consumers) return;
+
+  for (const auto& op : consumers->second) {
+    auto& inputs = op->impl()->inputs_tensor_;
+    auto node = op->impl()->node();
+    for (size_t i = 0; i < inputs.size(); ++i) {
+      if (inputs[i] != src) continue;
+      inputs[i] = dst;
+      if (nullptr != node) {
+        node->input.tensors[i] = dst->GetId();
+      }
+    }
+    tensor_consumers_[dst].push_back(op);
+  }
+  tensor_consumers_.erase(src);
+}
+
 void GraphImpl::PrintGraph() const { vsi_nn_PrintGraph(this->graph_); }
 
 std::shared_ptr<Tensor> GraphImpl::CreateTensor(const TensorSpec& spec,
@@ -289,9 +336,53 @@ std::shared_ptr<Tensor> GraphImpl::CreateTensorPlaceHolder() {
   return tensor_placeholder_;
 }
 
+void GraphImpl::Optimize() {
+  if (options_.isDeadNodeElimination()) {
+    dead_node_elimination_statistics_ = EliminateDeadNodes(this);
+    if (dead_node_elimination_statistics_.removed_nodes > 0) {
+      VSILOGI("Dead node elimination: %u node(s) and %u tensor(s) pruned.",
+              dead_node_elimination_statistics_.removed_nodes,
+              dead_node_elimination_statistics_.unused_tensors);
+    }
+  }
+  if (options_.isCommonSubexpressionElimination()) {
+    common_subexpression_elimination_statistics_ =
+        EliminateCommonSubexpressions(this);
+    if (common_subexpression_elimination_statistics_.removed_nodes > 0) {
+      VSILOGI("Common subexpression elimination: %u node(s) merged.",
+              common_subexpression_elimination_statistics_.removed_nodes);
+    }
+  }
+  if (options_.isConstFolding()) {
+    const_folding_statistics_ = ConstantFolding(this);
+    VSILOGI("Constant folding: %u node(s) folded, %" PRIu64
+            " byte(s) of device traffic saved per run.",
+            const_folding_statistics_.folded_nodes,
+            const_folding_statistics_.saved_bytes);
+  }
+  // Runs last, kernels are chosen for the nodes that are finally instanced
+  if (options_.isKernelTuning() || !options_.getKernelTuningDB().empty()) {
+    kernel_tuning_statistics_ = TuneKernels(this);
+    float default_ms = 0;
+    float tuned_ms = 0;
+    for (const auto& choice : kernel_tuning_statistics_.choices) {
+      default_ms += choice.record.default_ms;
+      tuned_ms += choice.record.best_ms;
+    }
+    VSILOGI("Kernel tuning: %u node(s) tuned, %u choice(s) loaded, %u node(s)"
+            " measured, %.3f ms -> %.3f ms (%.2fx).",
+            kernel_tuning_statistics_.tuned_nodes,
+            kernel_tuning_statistics_.loaded_nodes,
+            kernel_tuning_statistics_.measured_nodes, default_ms, tuned_ms,
+            tuned_ms > 0 ? default_ms / tuned_ms : 1.0f);
+  }
+}
+
 bool GraphImpl::Setup() {
   bool status = true;
 
+  std::call_once(optimize_once_, [this]() { this->Optimize(); });
+
   auto major = vsi_nn_GetVersionMajor();
   auto minor = vsi_nn_GetVersionMinor();
   auto patch = vsi_nn_GetVersionPatch();
@@ -318,6 +409,59 @@ bool GraphImpl::Setup() {
   return status;
 }
 
+void GraphImpl::LoadCompileCache() {
+  std::string dir = options_.getCompileCacheDir();
+  if (dir.empty()) {
+    return;
+  }
+  std::string fingerprint = GraphFingerprint(this);
+  if (fingerprint.empty()) {
+    VSILOGI("Graph can not be fingerprinted, compile cache is skipped.");
+    return;
+  }
+  std::string path = dir + "/" + fingerprint + ".nb";
+  if (!LoadCompiledGraph(path, compile_cache_nbg_)) {
+    compile_cache_path_ = path;
+    return;
+  }
+  // Original operations are only dropped once the cached graph imports
+  if (!VerifyCompiledGraph(this, path, compile_cache_nbg_)) {
+    VSILOGW("Compiled graph %s can not be imported, evict it and compile.",
+            path.c_str());
+    std::remove(path.c_str());
+    compile_cache_nbg_.clear();
+    compile_cache_path_ = path;
+    return;
+  }
+
+  VSILOGI("Load compiled graph from %s.", path.c_str());
+  auto original_ops = op_vector_;
+  for (const auto& op : original_ops) {
+    RemoveOperation(op);
+  }
+  // The node table is empty again, the NBG node takes id 0
+  auto nbg = CreateOperation<ops::NBG>(compile_cache_nbg_.data(),
+                                       inputs_tensor_.size(),
+                                       outputs_tensor_.size());
+  (*nbg).BindInputs(inputs_tensor_).BindOutputs(outputs_tensor_);
+}
+
+void GraphImpl::StoreCompileCache() {
+  size_t size = 0;
+  if (VSI_SUCCESS != vsi_nn_GenerateNBG(graph_, nullptr, &size) || 0 == size) {
+    VSILOGW("Generate compiled graph for compile cache fail.");
+    return;
+  }
+  std::vector<char> nbg(size);
+  if (VSI_SUCCESS != vsi_nn_GenerateNBG(graph_, nbg.data(), &size)) {
+    VSILOGW("Generate compiled graph for compile cache fail.");
+    return;
+  }
+  if (StoreCompiledGraph(compile_cache_path_, nbg)) {
+    VSILOGI("Store compiled graph to %s.", compile_cache_path_.c_str());
+  }
+}
+
 bool GraphImpl::Compile() {
   bool status = true;
   if (not_consumed_input_cnt_ > 0 ) {
@@ -327,7 +471,13 @@ bool GraphImpl::Compile() {
   if (not_consumed_output_cnt_ != 0) {
     VSILOGW("Graph has free output, OUTPUT tensor may be created but not consumed.");
   }
+  std::call_once(compile_cache_once_, [this]() { this->LoadCompileCache(); });
   status = Setup();
+  if (status && !compile_cache_path_.empty()) {
+    // Generating binary graph doesn't impact current graph's execution
+    StoreCompileCache();
+    compile_cache_path_.clear();
+  }
   std::call_once(verify_graph_once_, [&status, this]() {
     status = (VSI_SUCCESS == vsi_nn_VerifyGraph(this->graph_));
   });
@@ -343,5 +493,9 @@ bool GraphImpl::Run() {
   return ((Compile()) && (VSI_SUCCESS == vsi_nn_RunGraph(graph_)));
 }
 
+bool GraphImpl::Serialize(const std::string& path) {
+  return SerializeGraph(this, path);
+}
+
 }  // namespace vx
 }  // namespace tim
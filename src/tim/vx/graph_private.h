@@ -34,6 +34,10 @@
 #include "tim/vx/tensor.h"
 #include "tim/vx/compile_option.h"
 #include "context_private.h"
+#include "common_subexpression_elimination.h"
+#include "const_folding.h"
+#include "dead_node_elimination.h"
+#include "kernel_tuning.h"
 
 #include "vsi_nn_pub.h"
 
@@ -82,15 +86,46 @@ class GraphImpl : public Graph {
   bool Compile() override;
   bool CompileToBinary(void* buf, size_t* size) override;
   bool Run() override;
+  bool Serialize(const std::string& path) override;
   void ProduceInput() { not_consumed_input_cnt_++; }
   void ProduceOutput() { not_consumed_output_cnt_++; }
   void ConsumeInput() { not_consumed_input_cnt_--; }
   void ConsumeOutput() { not_consumed_output_cnt_--; }
 
+  std::vector<std::shared_ptr<Operation>>& OpVector() { return op_vector_; }
+  const CompileOption& GetCompileOption() const { return options_; }
+  ContextImpl* GetContext() const { return context_; }
+  /// Keep `buffer` alive as long as the graph, e.g. constant data of tensors
+  void RetainBuffer(const std::shared_ptr<const char>& buffer) {
+    retained_buffers_.push_back(buffer);
+  }
+  /// Remove `op` from the graph, its low-level node is kept alive until the
+  /// graph is released so that the detached operation is still valid
+  void RemoveOperation(const std::shared_ptr<Operation>& op);
+  /// Redirect every consumer of `src` to `dst`
+  void ReplaceTensorConsumers(const std::shared_ptr<Tensor>& src,
+                              const std::shared_ptr<Tensor>& dst);
+  const ConstFoldingStatistics& GetConstFoldingStatistics() const {
+    return const_folding_statistics_;
+  }
+  const DeadNodeEliminationStatistics& GetDeadNodeEliminationStatistics()
+      const {
+    return dead_node_elimination_statistics_;
+  }
+  const CommonSubexpressionEliminationStatistics&
+  GetCommonSubexpressionEliminationStatistics() const {
+    return common_subexpression_elimination_statistics_;
+  }
+  const KernelTuningStatistics& GetKernelTuningStatistics() const {
+    return kernel_tuning_statistics_;
+  }
+
  protected:
   ContextImpl* context_;
   vsi_nn_graph_t* graph_;
   std::shared_ptr<Tensor> tensor_placeholder_;
+  std::once_flag compile_cache_once_;
+  std::once_flag optimize_once_;
   std::once_flag setio_once_;
   std::once_flag setup_once_;
   std::once_flag verify_graph_once_;
@@ -106,9 +141,25 @@ class GraphImpl : public Graph {
   std::map<std::string, std::shared_ptr<tim::vx::Tensor>> cached_tensor_;
 #endif
   CompileOption options_;
+  std::vector<vsi_nn_node_t*> detached_nodes_;
+  std::vector<std::shared_ptr<const char>> retained_buffers_;
+  // Compiled graph loaded from the compile cache, referenced by the NBG node
+  std::vector<char> compile_cache_nbg_;
+  // Where to store the compiled graph after setup on a cache miss
+  std::string compile_cache_path_;
+  ConstFoldingStatistics const_folding_statistics_;
+  DeadNodeEliminationStatistics dead_node_elimination_statistics_;
+  CommonSubexpressionEliminationStatistics
+      common_subexpression_elimination_statistics_;
+  KernelTuningStatistics kernel_tuning_statistics_;
  private:
  /// Setup graph
   bool Setup();
+  /// Run graph level optimizations enabled by compile options
+  void Optimize();
+  /// Replace all operations with a cached compiled graph if there is one
+  void LoadCompileCache();
+  void StoreCompileCache();
 };
 
 }  // namespace vx
@@ -0,0 +1,357 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "graph_serialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+#include "context_private.h"
+#include "graph_private.h"
+#include "mapped_file.h"
+#include "op_impl.h"
+#include "op_signature.h"
+#include "tim/vx/builtin_op.h"
+#include "tim/vx/tensor.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace {
+
+constexpr char kMagic[4] = {'T', 'I', 'M', 'G'};
+constexpr uint32_t kFormatVersion = 1;
+// The blob starts on a page boundary so that it stays page aligned in the
+// mapping, every tensor in it is aligned for vector loads.
+constexpr uint64_t kBlobAlignment = 4096;
+constexpr uint64_t kDataAlignment = 64;
+
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint64_t meta_size;
+  uint64_t blob_offset;
+  uint64_t blob_size;
+};
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+/// Builtin operation restored from its kind and raw parameters. nn_param
+/// arrays point into storage owned by the operation.
+class SerializedOp : public BuiltinOp {
+ public:
+  SerializedOp(Graph* graph, int32_t kind, int in_cnt, int out_cnt,
+               DataLayout layout)
+      : BuiltinOp(graph, kind, in_cnt, out_cnt, layout) {}
+
+  bool LoadParams(ParamReader& reader) {
+    auto node = impl_->node();
+    reader.SetStorage(&param_storage_);
+    reader.Read(node->vx_param);
+    return VisitOpParams(impl_->kind_, node->nn_param, reader) && reader.ok();
+  }
+
+  std::shared_ptr<Operation> Clone(
+      std::shared_ptr<Graph>& graph) const override {
+    auto op = graph->CreateOperation<SerializedOp>(
+        impl_->kind_, impl_->input_cnt_, impl_->output_cnt_, impl_->layout_);
+    OpSignature params;
+    params.Append(impl_->node()->vx_param);
+    VisitOpParams(impl_->kind_, impl_->node()->nn_param, params);
+    ParamReader reader(params.str().data(), params.str().size());
+    op->LoadParams(reader);
+    return op;
+  }
+
+ private:
+  std::vector<std::vector<char>> param_storage_;
+};
+
+/// Numbers tensors in the order they are first seen, placeholders are -1
+class TensorTable {
+ public:
+  int32_t Add(const std::shared_ptr<Tensor>& tensor) {
+    if (tensor->IsPlaceHolder()) return -1;
+    auto it = index_.find(tensor);
+    if (index_.end() != it) return it->second;
+    int32_t index = static_cast<int32_t>(tensors_.size());
+    index_[tensor] = index;
+    tensors_.push_back(tensor);
+    return index;
+  }
+
+  const std::vector<std::shared_ptr<Tensor>>& tensors() const {
+    return tensors_;
+  }
+
+ private:
+  std::map<std::shared_ptr<Tensor>, int32_t> index_;
+  std::vector<std::shared_ptr<Tensor>> tensors_;
+};
+
+void WriteSpec(const TensorSpec& spec, OpSignature& meta) {
+  meta.Append(spec);
+  meta.Append(spec.quantization_.Fl());
+}
+
+bool ReadSpec(ParamReader& reader, TensorSpec& spec) {
+  DataType datatype;
+  TensorAttribute attr;
+  ShapeType shape;
+  QuantType quant_type;
+  int32_t channel_dim;
+  std::vector<float> scales;
+  std::vector<int32_t> zero_points;
+  int8_t fl;
+  reader.Read(datatype);
+  reader.Read(attr);
+  reader.Read(shape);
+  reader.Read(quant_type);
+  reader.Read(channel_dim);
+  reader.Read(scales);
+  reader.Read(zero_points);
+  reader.Read(fl);
+  if (!reader.ok() || shape.size() > VSI_NN_MAX_DIM_NUM) return false;
+
+  Quantization quant =
+      QuantType::DYNAMIC_FIXED_POINT == quant_type
+          ? Quantization(quant_type, fl)
+          : Quantization(quant_type, channel_dim, scales, zero_points);
+  spec = TensorSpec(datatype, shape, attr, quant);
+  return true;
+}
+
+void WritePadding(std::ofstream& file, uint64_t size) {
+  static const char kZeros[kBlobAlignment] = {0};
+  while (size > 0) {
+    uint64_t chunk = std::min<uint64_t>(size, sizeof(kZeros));
+    file.write(kZeros, chunk);
+    size -= chunk;
+  }
+}
+
+}  // namespace
+
+bool SerializeGraph(GraphImpl* graph, const std::string& path) {
+  TensorTable table;
+  for (const auto& tensor : graph->InputsTensor()) table.Add(tensor);
+  for (const auto& tensor : graph->OutputsTensor()) table.Add(tensor);
+
+  OpSignature ops;
+  ops.Append(static_cast<uint32_t>(graph->OpVector().size()));
+  for (const auto& op : graph->OpVector()) {
+    const auto& impl = op->impl();
+    auto node = impl->node();
+    if (nullptr == node || -1 == impl->kind_ || !HasOpParams(impl->kind_)) {
+      VSILOGE("Op kind %d can not be serialized", impl->kind_);
+      return false;
+    }
+    ops.Append(impl->kind_)
+        .Append(impl->layout_)
+        .Append(impl->input_cnt_)
+        .Append(impl->output_cnt_)
+        .Append(node->vx_param);
+    VisitOpParams(impl->kind_, node->nn_param, ops);
+
+    std::vector<int32_t> inputs;
+    std::vector<int32_t> outputs;
+    for (const auto& tensor : impl->InputsTensor()) {
+      inputs.push_back(table.Add(tensor));
+    }
+    for (const auto& tensor : impl->OutputsTensor()) {
+      outputs.push_back(table.Add(tensor));
+    }
+    ops.Append(inputs.data(), static_cast<uint32_t>(inputs.size()));
+    ops.Append(outputs.data(), static_cast<uint32_t>(outputs.size()));
+  }
+
+  OpSignature meta;
+  uint64_t blob_size = 0;
+  std::vector<uint64_t> data_offsets;
+  meta.Append(static_cast<uint32_t>(table.tensors().size()));
+  for (const auto& tensor : table.tensors()) {
+    const auto& spec = tensor->GetSpec();
+    uint64_t offset = 0;
+    uint64_t size = 0;
+    if (tensor->IsConstTensor()) {
+      offset = AlignUp(blob_size, kDataAlignment);
+      size = static_cast<uint64_t>(spec.GetByteSize());
+      blob_size = offset + size;
+    }
+    data_offsets.push_back(offset);
+    WriteSpec(spec, meta);
+    meta.Append(offset).Append(size);
+  }
+
+  FileHeader header;
+  memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.version = kFormatVersion;
+  header.meta_size = meta.str().size() + ops.str().size();
+  header.blob_offset =
+      AlignUp(sizeof(FileHeader) + header.meta_size, kBlobAlignment);
+  header.blob_size = blob_size;
+
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  if (!file) {
+    VSILOGE("Failed to create %s", path.c_str());
+    return false;
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(meta.str().data(), meta.str().size());
+  file.write(ops.str().data(), ops.str().size());
+
+  uint64_t position = sizeof(FileHeader) + header.meta_size;
+  std::vector<char> data;
+  for (size_t i = 0; i < table.tensors().size(); ++i) {
+    const auto& tensor = table.tensors()[i];
+    if (!tensor->IsConstTensor()) continue;
+    uint64_t offset = header.blob_offset + data_offsets[i];
+    WritePadding(file, offset - position);
+    data.resize(tensor->GetSpec().GetByteSize());
+    if (!tensor->CopyDataFromTensor(data.data())) {
+      VSILOGE("Failed to read constant tensor %zu", i);
+      return false;
+    }
+    file.write(data.data(), data.size());
+    position = offset + data.size();
+  }
+  WritePadding(file, header.blob_offset + header.blob_size - position);
+  return file.good();
+}
+
+std::shared_ptr<Graph> DeserializeGraph(ContextImpl* context,
+                                        const std::string& path,
+                                        const CompileOption& options) {
+  size_t size = 0;
+  auto mapping = MapFile(path, &size);
+  if (!mapping) return nullptr;
+
+  FileHeader header;
+  if (size < sizeof(header)) {
+    VSILOGE("%s is not a serialized graph", path.c_str());
+    return nullptr;
+  }
+  memcpy(&header, mapping.get(), sizeof(header));
+  if (0 != memcmp(header.magic, kMagic, sizeof(kMagic)) ||
+      kFormatVersion != header.version) {
+    VSILOGE("%s is not a serialized graph of version %u", path.c_str(),
+            kFormatVersion);
+    return nullptr;
+  }
+  if (header.meta_size > size - sizeof(header) || header.blob_offset > size ||
+      header.blob_size > size - header.blob_offset) {
+    VSILOGE("%s is truncated", path.c_str());
+    return nullptr;
+  }
+
+  auto graph = std::make_shared<GraphImpl>(context, options);
+  graph->RetainBuffer(mapping);
+  const char* blob = mapping.get() + header.blob_offset;
+  ParamReader reader(mapping.get() + sizeof(header), header.meta_size);
+
+  uint32_t tensor_count = 0;
+  reader.Read(tensor_count);
+  std::vector<std::shared_ptr<Tensor>> tensors;
+  for (uint32_t i = 0; i < tensor_count && reader.ok(); ++i) {
+    TensorSpec spec;
+    uint64_t offset = 0;
+    uint64_t data_size = 0;
+    if (!ReadSpec(reader, spec) || !reader.Read(offset) ||
+        !reader.Read(data_size)) {
+      break;
+    }
+    if (0 == data_size) {
+      tensors.push_back(graph->CreateTensor(spec));
+      continue;
+    }
+    if (offset > header.blob_size || data_size > header.blob_size - offset ||
+        static_cast<int64_t>(data_size) != spec.GetByteSize()) {
+      VSILOGE("Constant tensor %u of %s is out of range", i, path.c_str());
+      return nullptr;
+    }
+    tensors.push_back(graph->CreateTensor(spec, blob + offset));
+  }
+
+  auto bind = [&](const std::shared_ptr<Operation>& op,
+                  const std::vector<int32_t>& indices, bool is_input) {
+    for (int32_t index : indices) {
+      if (index < -1 || index >= static_cast<int32_t>(tensors.size())) {
+        return false;
+      }
+      auto tensor = -1 == index ? graph->CreateTensorPlaceHolder()
+                                : tensors[index];
+      if (is_input) {
+        op->BindInput(tensor);
+      } else {
+        op->BindOutput(tensor);
+      }
+    }
+    return true;
+  };
+
+  uint32_t op_count = 0;
+  reader.Read(op_count);
+  for (uint32_t i = 0; i < op_count && reader.ok(); ++i) {
+    int32_t kind = -1;
+    DataLayout layout;
+    int32_t input_cnt = 0;
+    int32_t output_cnt = 0;
+    reader.Read(kind);
+    reader.Read(layout);
+    reader.Read(input_cnt);
+    reader.Read(output_cnt);
+    if (!reader.ok() || !HasOpParams(kind)) {
+      VSILOGE("Op %u of %s has unsupported kind %d", i, path.c_str(), kind);
+      return nullptr;
+    }
+
+    auto op = graph->CreateOperation<SerializedOp>(kind, input_cnt,
+                                                   output_cnt, layout);
+    std::vector<int32_t> inputs;
+    std::vector<int32_t> outputs;
+    if (!op->LoadParams(reader) || !reader.Read(inputs) ||
+        !reader.Read(outputs)) {
+      break;
+    }
+    auto node = op->impl()->node();
+    if (inputs.size() > node->input.num || outputs.size() > node->output.num ||
+        !bind(op, inputs, true) || !bind(op, outputs, false)) {
+      VSILOGE("Op %u of %s has invalid tensors", i, path.c_str());
+      return nullptr;
+    }
+  }
+
+  if (!reader.ok()) {
+    VSILOGE("%s is corrupted", path.c_str());
+    return nullptr;
+  }
+  return graph;
+}
+
+}  // namespace vx
+}  // namespace tim
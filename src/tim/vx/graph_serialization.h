@@ -0,0 +1,52 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_GRAPH_SERIALIZATION_H_
+#define TIM_VX_GRAPH_SERIALIZATION_H_
+
+#include <memory>
+#include <string>
+
+#include "tim/vx/compile_option.h"
+#include "tim/vx/graph.h"
+
+namespace tim {
+namespace vx {
+
+class ContextImpl;
+class GraphImpl;
+
+/// Save `graph` to `path`. The file holds a header, the op and tensor
+/// descriptions, then a page aligned blob with the constant tensor data.
+bool SerializeGraph(GraphImpl* graph, const std::string& path);
+
+/// Rebuild a graph saved by SerializeGraph. The file is mapped copy-on-write
+/// and constant tensors are created straight from the mapping.
+std::shared_ptr<Graph> DeserializeGraph(ContextImpl* context,
+                                        const std::string& path,
+                                        const CompileOption& options);
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_GRAPH_SERIALIZATION_H_ */
@@ -0,0 +1,571 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops.h"
+
+#include "graph_private.h"
+#include "op_signature.h"
+#include "gtest/gtest.h"
+
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+using BuildFunc = std::function<void(const std::shared_ptr<tim::vx::Graph>&)>;
+
+std::vector<std::vector<char>> RunGraph(
+    const std::shared_ptr<tim::vx::Graph>& graph) {
+  for (const auto& input : graph->InputsTensor()) {
+    std::vector<char> data(input->GetSpec().GetByteSize());
+    for (size_t i = 0; i < data.size(); ++i) {
+      data[i] = static_cast<char>(i % 7);
+    }
+    EXPECT_TRUE(input->CopyDataToTensor(data.data(), data.size()));
+  }
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<std::vector<char>> outputs;
+  for (const auto& output : graph->OutputsTensor()) {
+    outputs.emplace_back(output->GetSpec().GetByteSize());
+    EXPECT_TRUE(output->CopyDataFromTensor(outputs.back().data()));
+  }
+  return outputs;
+}
+
+void ExpectRoundTrip(const std::string& name, const BuildFunc& build) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+  build(graph);
+
+  std::string path = ::testing::TempDir() + "/" + name + ".timg";
+  ASSERT_TRUE(graph->Serialize(path));
+  auto loaded = ctx->LoadGraph(path);
+  ASSERT_TRUE(loaded);
+  EXPECT_EQ(graph->InputsTensor().size(), loaded->InputsTensor().size());
+  EXPECT_EQ(graph->OutputsTensor().size(), loaded->OutputsTensor().size());
+
+  // Parameters are compared before compile, layout inference rewrites them
+  auto& ops = static_cast<tim::vx::GraphImpl*>(graph.get())->OpVector();
+  auto& loaded_ops = static_cast<tim::vx::GraphImpl*>(loaded.get())->OpVector();
+  ASSERT_EQ(ops.size(), loaded_ops.size());
+  for (size_t i = 0; i < ops.size(); ++i) {
+    tim::vx::OpSignature params;
+    tim::vx::OpSignature loaded_params;
+    EXPECT_TRUE(tim::vx::AppendOpParams(ops[i], params));
+    EXPECT_TRUE(tim::vx::AppendOpParams(loaded_ops[i], loaded_params));
+    EXPECT_EQ(params.str(), loaded_params.str()) << name << " op " << i;
+  }
+
+  auto golden = RunGraph(graph);
+  EXPECT_EQ(golden, RunGraph(loaded));
+}
+
+std::shared_ptr<tim::vx::Tensor> Input(
+    const std::shared_ptr<tim::vx::Graph>& g, const tim::vx::ShapeType& shape,
+    tim::vx::DataType type = tim::vx::DataType::FLOAT32) {
+  return g->CreateTensor(
+      tim::vx::TensorSpec(type, shape, tim::vx::TensorAttribute::INPUT));
+}
+
+std::shared_ptr<tim::vx::Tensor> Output(
+    const std::shared_ptr<tim::vx::Graph>& g, const tim::vx::ShapeType& shape,
+    tim::vx::DataType type = tim::vx::DataType::FLOAT32) {
+  return g->CreateTensor(
+      tim::vx::TensorSpec(type, shape, tim::vx::TensorAttribute::OUTPUT));
+}
+
+template <typename T>
+std::shared_ptr<tim::vx::Tensor> Constant(
+    const std::shared_ptr<tim::vx::Graph>& g, const tim::vx::ShapeType& shape,
+    tim::vx::DataType type, const std::vector<T>& data) {
+  return g->CreateTensor(
+      tim::vx::TensorSpec(type, shape, tim::vx::TensorAttribute::CONSTANT),
+      data.data());
+}
+
+std::shared_ptr<tim::vx::Tensor> Weights(
+    const std::shared_ptr<tim::vx::Graph>& g,
+    const tim::vx::ShapeType& shape) {
+  uint32_t size = 1;
+  for (auto dim : shape) size *= dim;
+  std::vector<float> data(size);
+  for (uint32_t i = 0; i < size; ++i) data[i] = (i % 5) * 0.25f - 0.5f;
+  return Constant(g, shape, tim::vx::DataType::FLOAT32, data);
+}
+
+const tim::vx::ShapeType kShape = {4, 3, 2, 1};
+
+/// Single op reading `inputs` inputs of kShape and writing `out`
+template <typename OpType, typename... Params>
+BuildFunc Elementwise(int inputs, tim::vx::ShapeType out, Params... params) {
+  return [=](const std::shared_ptr<tim::vx::Graph>& g) {
+    auto op = g->CreateOperation<OpType>(params...);
+    for (int i = 0; i < inputs; ++i) op->BindInput(Input(g, kShape));
+    op->BindOutput(Output(g, out));
+  };
+}
+
+template <typename OpType, typename... Params>
+BuildFunc Unary(Params... params) {
+  return Elementwise<OpType>(1, kShape, params...);
+}
+
+template <typename OpType, typename... Params>
+BuildFunc Binary(Params... params) {
+  return Elementwise<OpType>(2, kShape, params...);
+}
+
+/// Logical ops take and produce BOOL8 tensors
+template <typename OpType>
+BuildFunc Logical(int inputs) {
+  return [=](const std::shared_ptr<tim::vx::Graph>& g) {
+    auto op = g->CreateOperation<OpType>();
+    for (int i = 0; i < inputs; ++i) {
+      op->BindInput(Input(g, kShape, tim::vx::DataType::BOOL8));
+    }
+    op->BindOutput(Output(g, kShape, tim::vx::DataType::BOOL8));
+  };
+}
+
+/// Normalization ops with per-channel constant parameters of `param_shape`
+template <typename OpType, typename... Params>
+BuildFunc Normalization(int param_count, tim::vx::ShapeType param_shape,
+                        Params... params) {
+  return [=](const std::shared_ptr<tim::vx::Graph>& g) {
+    auto op = g->CreateOperation<OpType>(params...);
+    op->BindInput(Input(g, kShape));
+    for (int i = 0; i < param_count; ++i) {
+      std::vector<float> data(param_shape[0], 0.5f + i);
+      op->BindInput(
+          Constant(g, param_shape, tim::vx::DataType::FLOAT32, data));
+    }
+    op->BindOutput(Output(g, kShape));
+  };
+}
+
+/// Cos has no ops:: wrapper yet
+class CosOp : public tim::vx::BuiltinOp {
+ public:
+  explicit CosOp(tim::vx::Graph* graph)
+      : BuiltinOp(graph, VSI_NN_OP_COS, 1, 1) {}
+
+  std::shared_ptr<tim::vx::Operation> Clone(
+      std::shared_ptr<tim::vx::Graph>& graph) const override {
+    return graph->CreateOperation<CosOp>();
+  }
+};
+
+struct OpCase {
+  int32_t kind;
+  const char* name;
+  BuildFunc build;
+};
+
+/// One case per op kind with a parameter visitor, OpParamKinds() must stay
+/// covered by this table
+std::vector<OpCase> OpCases() {
+  using namespace tim::vx;
+  using namespace tim::vx::ops;
+  using Array2 = std::array<uint32_t, 2>;
+  return {
+      {VSI_NN_OP_ADD, "add", Binary<Add>()},
+      {VSI_NN_OP_SUBTRACT, "sub", Binary<Sub>()},
+      {VSI_NN_OP_MINIMUM, "minimum", Binary<Minimum>()},
+      {VSI_NN_OP_MAXIMUM, "maximum", Binary<Maximum>()},
+      {VSI_NN_OP_POW, "pow", Binary<Pow>()},
+      {VSI_NN_OP_FLOORDIV, "floordiv", Binary<FloorDiv>()},
+      {VSI_NN_OP_MULTIPLY, "multiply", Binary<Multiply>(0.5f)},
+      {VSI_NN_OP_DIVIDE, "divide", Binary<Div>(2.0f)},
+      {VSI_NN_OP_ADDN, "addn",
+       Elementwise<AddN>(3, kShape, static_cast<uint32_t>(3))},
+      {VSI_NN_OP_SELECT, "select",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<Select>())
+             .BindInputs({Input(g, kShape, DataType::BOOL8), Input(g, kShape),
+                          Input(g, kShape)})
+             .BindOutput(Output(g, kShape));
+       }},
+      {VSI_NN_OP_DATACONVERT, "dataconvert",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<DataConvert>())
+             .BindInput(Input(g, kShape))
+             .BindOutput(Output(g, kShape, DataType::FLOAT16));
+       }},
+      {VSI_NN_OP_CAST, "cast",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<Cast>())
+             .BindInput(Input(g, kShape))
+             .BindOutput(Output(g, kShape, DataType::INT32));
+       }},
+      {VSI_NN_OP_NEG, "neg", Unary<Neg>()},
+      {VSI_NN_OP_ABS, "abs", Unary<Abs>()},
+      {VSI_NN_OP_EXP, "exp", Unary<Exp>()},
+      {VSI_NN_OP_LOG, "log", Unary<Log>()},
+      {VSI_NN_OP_SIN, "sin", Unary<Sin>()},
+      {VSI_NN_OP_COS, "cos", Unary<CosOp>()},
+      {VSI_NN_OP_SQRT, "sqrt", Unary<Sqrt>()},
+      {VSI_NN_OP_RSQRT, "rsqrt", Unary<Rsqrt>()},
+      {VSI_NN_OP_SQUARE, "square", Unary<Square>()},
+      {VSI_NN_OP_RCP, "rcp", Unary<Rcp>()},
+      {VSI_NN_OP_FLOOR, "floor", Unary<Floor>()},
+      {VSI_NN_OP_CEIL, "ceil", Unary<Ceil>()},
+      {VSI_NN_OP_ROUND, "round", Unary<Round>()},
+      {VSI_NN_OP_ERF, "erf", Unary<Erf>()},
+      {VSI_NN_OP_LOGICAL_NOT, "logical_not", Logical<LogicalNot>(1)},
+      {VSI_NN_OP_RELU, "relu", Unary<Relu>()},
+      {VSI_NN_OP_RELU1, "relu1", Unary<Relu1>()},
+      {VSI_NN_OP_RELU6, "relu6", Unary<Relu6>()},
+      {VSI_NN_OP_SIGMOID, "sigmoid", Unary<Sigmoid>()},
+      {VSI_NN_OP_MISH, "mish", Unary<Mish>()},
+      {VSI_NN_OP_SOFTRELU, "softrelu", Unary<SoftRelu>()},
+      {VSI_NN_OP_SIGN, "sign", Unary<Sign>()},
+      {VSI_NN_OP_SOFTSIGN, "softsign", Unary<SoftSign>()},
+      {VSI_NN_OP_TANH, "tanh", Unary<Tanh>()},
+      {VSI_NN_OP_LEAKY_RELU, "leaky_relu", Unary<LeakyRelu>(0.2f)},
+      {VSI_NN_OP_ELU, "elu", Unary<Elu>(0.7f)},
+      {VSI_NN_OP_SWISH, "swish", Unary<Swish>()},
+      {VSI_NN_OP_PRELU, "prelu",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<Prelu>(0))
+             .BindInputs({Input(g, kShape), Weights(g, {4})})
+             .BindOutput(Output(g, kShape));
+       }},
+      {VSI_NN_OP_HARD_SIGMOID, "hard_sigmoid", Unary<HardSigmoid>(0.3f, 0.4f)},
+      {VSI_NN_OP_LINEAR, "linear", Unary<Linear>(2.0f, 1.0f)},
+      {VSI_NN_OP_GELU, "gelu", Unary<Gelu>(false)},
+      {VSI_NN_OP_SELU, "selu", Unary<Selu>(1.5f, 1.1f)},
+      {VSI_NN_OP_CELU, "celu", Unary<Celu>(0.8f)},
+      {VSI_NN_OP_CLIP, "clip", Unary<Clip>(-0.5f, 0.5f)},
+      {VSI_NN_OP_BATCH_NORM, "batch_norm",
+       Normalization<BatchNorm>(4, {2}, 1e-3f)},
+      {VSI_NN_OP_INSTANCE_NORM, "instance_norm",
+       Normalization<InstanceNormalization>(2, {2}, 1e-4f)},
+      {VSI_NN_OP_LAYER_NORM, "layer_norm",
+       Normalization<LayerNormalization>(2, {4}, 0, 1e-4f)},
+      {VSI_NN_OP_L2_NORMALIZE, "l2_normalize", Unary<L2Normalization>(0)},
+      {VSI_NN_OP_LRN2, "lrn",
+       Unary<LocalResponseNormalization>(static_cast<uint32_t>(3), 0.5f,
+                                         0.75f, 1.0f, 2)},
+      {VSI_NN_OP_SOFTMAX, "softmax", Unary<Softmax>(0.5f, 0)},
+      {VSI_NN_OP_LOG_SOFTMAX, "log_softmax", Unary<LogSoftmax>(0, 0.5f)},
+      {VSI_NN_OP_PERMUTE, "permute",
+       Elementwise<Transpose>(1, {3, 4, 2, 1},
+                              std::vector<uint32_t>({1, 0, 2, 3}))},
+      {VSI_NN_OP_RESHAPE2, "reshape",
+       Elementwise<Reshape>(1, {12, 2}, std::vector<uint32_t>({12, 2}))},
+      {VSI_NN_OP_SQUEEZE, "squeeze",
+       Elementwise<Squeeze>(1, {4, 3, 2}, std::vector<uint32_t>({3}))},
+      {VSI_NN_OP_SLICE, "slice",
+       Elementwise<Slice>(1, {2, 3, 2, 1}, static_cast<uint32_t>(4),
+                          std::vector<int32_t>({1, 0, 0, 0}),
+                          std::vector<int32_t>({2, 3, 2, 1}))},
+      {VSI_NN_OP_STRIDED_SLICE, "strided_slice",
+       Elementwise<StridedSlice>(1, {2, 3, 2, 1},
+                                 std::vector<int32_t>({0, 0, 0, 0}),
+                                 std::vector<int32_t>({4, 3, 2, 1}),
+                                 std::vector<int32_t>({2, 1, 1, 1}), 0, 0, 0)},
+      {VSI_NN_OP_PAD, "pad",
+       Elementwise<Pad>(1, {5, 4, 2, 1}, std::vector<uint32_t>({1, 0, 0, 0}),
+                        std::vector<uint32_t>({0, 1, 0, 0}), 1)},
+      {VSI_NN_OP_REDUCE, "reduce",
+       Elementwise<ReduceSum>(1, {1, 3, 2, 1}, std::vector<int32_t>({0}),
+                              true)},
+      {VSI_NN_OP_ARGMAX, "argmax",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<ArgMax>(0))
+             .BindInput(Input(g, kShape))
+             .BindOutput(Output(g, {3, 2, 1}, DataType::INT32));
+       }},
+      {VSI_NN_OP_ARGMIN, "argmin",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<ArgMin>(1))
+             .BindInput(Input(g, kShape))
+             .BindOutput(Output(g, {4, 2, 1}, DataType::INT32));
+       }},
+      {VSI_NN_OP_CONCAT, "concat",
+       Elementwise<Concat>(2, {8, 3, 2, 1}, static_cast<uint32_t>(0), 2)},
+      {VSI_NN_OP_SPLIT, "split",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<Split>(0, std::vector<uint32_t>({1, 3})))
+             .BindInput(Input(g, kShape))
+             .BindOutputs({Output(g, {1, 3, 2, 1}), Output(g, {3, 3, 2, 1})});
+       }},
+      {VSI_NN_OP_STACK, "stack",
+       Elementwise<Stack>(2, {2, 4, 3, 2, 1}, static_cast<uint32_t>(0), 2)},
+      {VSI_NN_OP_UNSTACK, "unstack",
+       [](const std::shared_ptr<Graph>& g) {
+         auto op = g->CreateOperation<Unstack>(2, 2);
+         op->BindInput(Input(g, kShape));
+         op->BindOutputs({Output(g, {4, 3, 1}), Output(g, {4, 3, 1})});
+       }},
+      {VSI_NN_OP_TILE, "tile",
+       Elementwise<Tile>(1, {8, 3, 2, 1}, std::vector<int32_t>({2, 1, 1, 1}))},
+      {VSI_NN_OP_GATHER, "gather",
+       [](const std::shared_ptr<Graph>& g) {
+         std::vector<int32_t> indices = {2, 0};
+         (*g->CreateOperation<Gather>(0))
+             .BindInputs({Input(g, kShape),
+                          Constant(g, {2}, DataType::INT32, indices)})
+             .BindOutput(Output(g, {2, 3, 2, 1}));
+       }},
+      {VSI_NN_OP_TOPK, "topk",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<Topk>(2))
+             .BindInput(Input(g, {4, 3}))
+             .BindOutputs({Output(g, {2, 3}),
+                           Output(g, {2, 3}, DataType::INT32)});
+       }},
+      {VSI_NN_OP_DEPTH2SPACE, "depth2space",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<DepthToSpace>(2))
+             .BindInput(Input(g, {2, 2, 4, 1}))
+             .BindOutput(Output(g, {4, 4, 1, 1}));
+       }},
+      {VSI_NN_OP_SPACE2DEPTH, "space2depth",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<SpaceToDepth>(std::vector<int>({2, 2})))
+             .BindInput(Input(g, {4, 4, 1, 1}))
+             .BindOutput(Output(g, {2, 2, 4, 1}));
+       }},
+      {VSI_NN_OP_RESIZE, "resize",
+       Elementwise<Resize>(1, {8, 6, 2, 1}, ResizeType::BILINEAR, 0.0f, false,
+                           true, 6, 8)},
+      {VSI_NN_OP_RELATIONAL_OPS, "relational",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<Greater>())
+             .BindInputs({Input(g, kShape), Input(g, kShape)})
+             .BindOutput(Output(g, kShape, DataType::BOOL8));
+       }},
+      {VSI_NN_OP_LOGICAL_OPS, "logical", Logical<LogicalOr>(2)},
+      {VSI_NN_OP_MATRIXMUL, "matmul",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<Matmul>(false, true))
+             .BindInputs({Input(g, {4, 3}), Input(g, {4, 5})})
+             .BindOutput(Output(g, {5, 3}));
+       }},
+      {VSI_NN_OP_CONV2D, "conv2d",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<Conv2d>(PadType::SAME, Array2({1, 1}),
+                                      Array2({1, 1})))
+             .BindInputs({Input(g, {4, 4, 2, 1}), Weights(g, {3, 3, 2, 3}),
+                          Weights(g, {3})})
+             .BindOutput(Output(g, {4, 4, 3, 1}));
+       }},
+      {VSI_NN_OP_DECONVOLUTION, "deconv",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<DeConv2d>(2, PadType::SAME, Array2({3, 3}),
+                                        Array2({1, 1}), Array2({1, 1}),
+                                        std::array<uint32_t, 4>({0, 0, 0, 0}),
+                                        2))
+             .BindInputs({Input(g, {3, 3, 2, 1}), Weights(g, {3, 3, 2, 1})})
+             .BindOutput(Output(g, {5, 5, 2, 1}));
+       }},
+      {VSI_NN_OP_POOL, "pool",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<Pool2d>(PoolType::AVG, PadType::VALID,
+                                      Array2({2, 2}), Array2({2, 2})))
+             .BindInput(Input(g, {4, 4, 2, 1}))
+             .BindOutput(Output(g, {2, 2, 2, 1}));
+       }},
+      {VSI_NN_OP_FCL2, "fully_connected",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<FullyConnected>(0, 3))
+             .BindInputs({Input(g, {4, 2}), Weights(g, {4, 3}),
+                          Weights(g, {3})})
+             .BindOutput(Output(g, {3, 2}));
+       }},
+      {VSI_NN_OP_CUSTOM_SCALED_DOT_PRODUCT_ATTENTION, "sdpa",
+       [](const std::shared_ptr<Graph>& g) {
+         (*g->CreateOperation<ScaledDotProductAttention>(0.5f, true))
+             .BindInputs({Input(g, {4, 3, 1}), Input(g, {4, 5, 1}),
+                          Input(g, {4, 5, 1})})
+             .BindOutput(Output(g, {4, 3, 1}));
+       }},
+      {VSI_NN_OP_CUSTOM_SLICE_UPDATE, "slice_update",
+       [](const std::shared_ptr<Graph>& g) {
+         std::vector<int32_t> start = {1};
+         auto cache = g->CreateTensor(TensorSpec(DataType::FLOAT32, {2, 4},
+                                                 TensorAttribute::VARIABLE));
+         (*g->CreateOperation<SliceUpdate>(1))
+             .BindInputs({Input(g, {2, 1}),
+                          Constant(g, {1}, DataType::INT32, start)})
+             .BindOutput(cache);
+         (*g->CreateOperation<Add>())
+             .BindInputs({cache, cache})
+             .BindOutput(Output(g, {2, 4}));
+       }},
+  };
+}
+}  // namespace
+
+TEST(graph_serialization, op_cases_cover_every_param_visitor) {
+  std::set<int32_t> covered;
+  for (const auto& op_case : OpCases()) covered.insert(op_case.kind);
+  for (int32_t kind : tim::vx::OpParamKinds()) {
+    EXPECT_TRUE(covered.count(kind)) << "no round-trip case for kind " << kind;
+  }
+}
+
+TEST(graph_serialization, every_op_kind_round_trip) {
+  std::set<int32_t> kinds;
+  for (int32_t kind : tim::vx::OpParamKinds()) kinds.insert(kind);
+  for (const auto& op_case : OpCases()) {
+    if (!kinds.count(op_case.kind)) continue;
+    SCOPED_TRACE(op_case.name);
+    ExpectRoundTrip(std::string("op_") + op_case.name, op_case.build);
+  }
+}
+
+TEST(graph_serialization, float_conv_pool_fc_softmax) {
+  ExpectRoundTrip("float_cnn", [](const std::shared_ptr<tim::vx::Graph>& g) {
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {8, 8, 2, 1},
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec weight_spec(tim::vx::DataType::FLOAT32, {3, 3, 2, 4},
+                                    tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::FLOAT32, {4},
+                                  tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec fc_weight_spec(tim::vx::DataType::FLOAT32, {64, 10},
+                                       tim::vx::TensorAttribute::CONSTANT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {},
+                                       tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {10, 1},
+                                    tim::vx::TensorAttribute::OUTPUT);
+
+    std::vector<float> weight(3 * 3 * 2 * 4);
+    for (size_t i = 0; i < weight.size(); ++i) weight[i] = (i % 5) * 0.1f;
+    std::vector<float> bias = {0.5f, -0.5f, 1.0f, 0.0f};
+    std::vector<float> fc_weight(64 * 10);
+    for (size_t i = 0; i < fc_weight.size(); ++i) {
+      fc_weight[i] = (i % 3) * 0.01f;
+    }
+
+    auto input = g->CreateTensor(input_spec);
+    auto weight_t = g->CreateTensor(weight_spec, weight.data());
+    auto bias_t = g->CreateTensor(bias_spec, bias.data());
+    auto fc_weight_t = g->CreateTensor(fc_weight_spec, fc_weight.data());
+    auto conv_out = g->CreateTensor(transient_spec);
+    auto relu_out = g->CreateTensor(transient_spec);
+    auto pool_out = g->CreateTensor(transient_spec);
+    auto reshape_out = g->CreateTensor(transient_spec);
+    auto fc_out = g->CreateTensor(transient_spec);
+    auto output = g->CreateTensor(output_spec);
+
+    auto conv = g->CreateOperation<tim::vx::ops::Conv2d>(
+        tim::vx::PadType::SAME, std::array<uint32_t, 2>({1, 1}),
+        std::array<uint32_t, 2>({1, 1}));
+    (*conv).BindInputs({input, weight_t, bias_t}).BindOutput(conv_out);
+    (*g->CreateOperation<tim::vx::ops::Relu>())
+        .BindInput(conv_out)
+        .BindOutput(relu_out);
+    (*g->CreateOperation<tim::vx::ops::Pool2d>(
+         tim::vx::PoolType::MAX, tim::vx::PadType::VALID,
+         std::array<uint32_t, 2>({2, 2}), std::array<uint32_t, 2>({2, 2})))
+        .BindInput(relu_out)
+        .BindOutput(pool_out);
+    (*g->CreateOperation<tim::vx::ops::Reshape>(
+         std::vector<uint32_t>({64, 1})))
+        .BindInput(pool_out)
+        .BindOutput(reshape_out);
+    (*g->CreateOperation<tim::vx::ops::FullyConnected>(0, 10))
+        .BindInputs({reshape_out, fc_weight_t})
+        .BindOutput(fc_out);
+    (*g->CreateOperation<tim::vx::ops::Softmax>(1.0f, 0))
+        .BindInput(fc_out)
+        .BindOutput(output);
+  });
+}
+
+TEST(graph_serialization, per_channel_quantized_conv) {
+  ExpectRoundTrip("quant_conv", [](const std::shared_ptr<tim::vx::Graph>& g) {
+    tim::vx::Quantization input_quant(tim::vx::QuantType::ASYMMETRIC, 0.5f,
+                                      3);
+    tim::vx::Quantization weight_quant(
+        tim::vx::QuantType::SYMMETRIC_PER_CHANNEL, 3, {0.1f, 0.2f},
+        {0, 0});
+    tim::vx::Quantization bias_quant(
+        tim::vx::QuantType::SYMMETRIC_PER_CHANNEL, 0, {0.05f, 0.1f}, {0, 0});
+    tim::vx::Quantization output_quant(tim::vx::QuantType::ASYMMETRIC, 0.25f,
+                                       10);
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8, {4, 4, 2, 1},
+                                   tim::vx::TensorAttribute::INPUT,
+                                   input_quant);
+    tim::vx::TensorSpec weight_spec(tim::vx::DataType::INT8, {2, 2, 2, 2},
+                                    tim::vx::TensorAttribute::CONSTANT,
+                                    weight_quant);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::INT32, {2},
+                                  tim::vx::TensorAttribute::CONSTANT,
+                                  bias_quant);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8, {3, 3, 2, 1},
+                                    tim::vx::TensorAttribute::OUTPUT,
+                                    output_quant);
+
+    std::vector<int8_t> weight = {1, 2, 3, 4, -1, -2, -3, -4,
+                                  5, 6, 7, 8, -5, -6, -7, -8};
+    std::vector<int32_t> bias = {10, -10};
+    auto input = g->CreateTensor(input_spec);
+    auto weight_t = g->CreateTensor(weight_spec, weight.data());
+    auto bias_t = g->CreateTensor(bias_spec, bias.data());
+    auto output = g->CreateTensor(output_spec);
+
+    auto conv = g->CreateOperation<tim::vx::ops::Conv2d>(
+        tim::vx::PadType::VALID, std::array<uint32_t, 2>({1, 1}),
+        std::array<uint32_t, 2>({1, 1}));
+    (*conv).BindInputs({input, weight_t, bias_t}).BindOutput(output);
+  });
+}
+
+TEST(graph_serialization, shape_ops) {
+  ExpectRoundTrip("shape_ops", [](const std::shared_ptr<tim::vx::Graph>& g) {
+    tim::vx::TensorSpec a_spec(tim::vx::DataType::FLOAT32, {3, 2},
+                               tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec b_spec(tim::vx::DataType::FLOAT32, {4, 3},
+                               tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {},
+                                       tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {8, 3},
+                                    tim::vx::TensorAttribute::OUTPUT);
+
+    auto a = g->CreateTensor(a_spec);
+    auto b = g->CreateTensor(b_spec);
+    auto transposed = g->CreateTensor(transient_spec);
+    auto padded = g->CreateTensor(transient_spec);
+    auto output = g->CreateTensor(output_spec);
+
+    (*g->CreateOperation<tim::vx::ops::Transpose>(
+         std::vector<uint32_t>({1, 0})))
+        .BindInput(a)
+        .BindOutput(transposed);
+    (*g->CreateOperation<tim::vx::ops::Pad>(std::vector<uint32_t>({1, 0}),
+                                            std::vector<uint32_t>({1, 0}), 0))
+        .BindInput(transposed)
+        .BindOutput(padded);
+    (*g->CreateOperation<tim::vx::ops::Concat>(0, 2))
+        .BindInputs({padded, b})
+        .BindOutput(output);
+  });
+}
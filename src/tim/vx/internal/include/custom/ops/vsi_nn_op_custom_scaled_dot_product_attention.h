@@ -0,0 +1,63 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#ifndef _VSI_NN_OP_CUSTOM_SCALED_DOT_PRODUCT_ATTENTION_H
+#define _VSI_NN_OP_CUSTOM_SCALED_DOT_PRODUCT_ATTENTION_H
+
+#include "vsi_nn_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * softmax(scale * Q * K^T + mask) * V
+ *
+ * Inputs are query [head_dim, q_len, ...], key [head_dim, kv_len, ...],
+ * value [value_dim, kv_len, ...] and an optional additive mask
+ * [kv_len, q_len or 1, ...] broadcast over the outer dims. The output is
+ * [value_dim, q_len, ...].
+ *
+ * Kernels walk the keys with a running softmax and never store the
+ * [kv_len, q_len] scores. Quantized graphs, or graphs with shaders
+ * disabled, are lowered to Matmul/Softmax tiles of query_tile rows.
+ */
+typedef struct _vsi_nn_custom_scaled_dot_product_attention_param
+{
+    struct _custom_scaled_dot_product_attention_local_data_t* local;
+    /* 0 selects 1 / sqrt(head_dim) */
+    float scale;
+    /* query i sees keys up to i + kv_len - q_len */
+    int32_t causal;
+    /* 0 derives the tile height from the score size */
+    uint32_t query_tile;
+} vsi_nn_custom_scaled_dot_product_attention_param;
+_compiler_assert(offsetof(vsi_nn_custom_scaled_dot_product_attention_param, local) == 0, \
+    vsi_nn_custom_scaled_dot_product_attention_h );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
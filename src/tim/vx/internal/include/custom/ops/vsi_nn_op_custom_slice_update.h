@@ -0,0 +1,52 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#ifndef _VSI_NN_OP_CUSTOM_SLICE_UPDATE_H
+#define _VSI_NN_OP_CUSTOM_SLICE_UPDATE_H
+
+#include "vsi_nn_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Write inputs[0] into outputs[0] at offset inputs[1][0] along axis.
+ *
+ * inputs[1] is an INT32 tensor read at run time, so the offset can move
+ * every run without a rebuild. Only the updated rows are written: the rest
+ * of outputs[0] keeps what the previous run or the application left in it,
+ * which is how a persistent (non virtual) tensor such as a KV cache grows
+ * in place. The output shape must be given.
+ */
+typedef struct _vsi_nn_custom_slice_update_param
+{
+    int32_t axis;
+} vsi_nn_custom_slice_update_param;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -31,5 +31,7 @@
 #include "custom/ops/vsi_nn_op_custom_warp_affine.h"
 #include "custom/ops/vsi_nn_op_custom_warp_perspective.h"
 #include "custom/ops/vsi_nn_op_custom_sample.h"
+#include "custom/ops/vsi_nn_op_custom_scaled_dot_product_attention.h"
+#include "custom/ops/vsi_nn_op_custom_slice_update.h"
 
 #endif
@@ -816,6 +816,19 @@ vsi_status vsi_nn_kernel_tensor_write
     size_t size
     );
 
+/*
+ * Write the patch [start, end) of a tensor, elements outside of it are
+ * left as they are. buffer holds the patch densely in the tensor dtype.
+ */
+vsi_status vsi_nn_kernel_tensor_write_patch
+    (
+    vsi_nn_kernel_tensor_t tensor,
+    const vsi_nn_kernel_tensor_attr_t * attr,
+    const void * buffer,
+    const vsi_size_t * start,
+    const vsi_size_t * end
+    );
+
 static VSI_INLINE_API vsi_size_t vsi_nn_kernel_tensor_attr_get_size
     ( const vsi_nn_kernel_tensor_attr_t * attr )
 {
@@ -1044,6 +1057,11 @@ OVXLIB_API vsi_nn_kernel_t * vsi_nn_KernelCreate
     vsi_nn_kernel_type_e type
     );
 
+OVXLIB_API void vsi_nn_KernelRelease
+    (
+    vsi_nn_kernel_t ** kernel
+    );
+
 OVXLIB_API void vsi_nn_KernelAddSource
     (
     vsi_nn_kernel_t * kernel,
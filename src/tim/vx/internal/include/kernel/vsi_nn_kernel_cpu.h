@@ -0,0 +1,99 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#ifndef _VSI_NN_KERNEL_CPU_H
+#define _VSI_NN_KERNEL_CPU_H
+
+#include <stdint.h>
+#include "kernel/vsi_nn_kernel.h"
+
+__BEGIN_DECLS
+
+/*
+ * Execution helpers for VSI_NN_KERNEL_TYPE_CPU kernels.
+ *
+ * Work is split over a lazily created, process wide worker pool. The
+ * number of threads defaults to the number of online cores and can be
+ * overridden with VSI_NN_CPU_THREAD_NUM. Calls made while the pool is
+ * busy, e.g. from another graph or from inside a task, run inline.
+ * The helpers are exported so client CPU kernels can share the pool.
+ */
+
+typedef void (* vsi_nn_kernel_cpu_task_t)
+    (
+    vsi_size_t begin,
+    vsi_size_t end,
+    void * user_data
+    );
+
+OVXLIB_API uint32_t vsi_nn_kernel_cpu_get_thread_num
+    ( void );
+
+/*
+ * Run task over [0, total), split into ranges of at least grain items.
+ * Returns after every range has completed.
+ */
+OVXLIB_API void vsi_nn_kernel_cpu_parallel_for
+    (
+    vsi_size_t total,
+    vsi_size_t grain,
+    vsi_nn_kernel_cpu_task_t task,
+    void * user_data
+    );
+
+/*
+ * Check whether data can be moved between two tensors without the
+ * float round trip: same storage type and same quantization.
+ */
+OVXLIB_API vsi_bool vsi_nn_kernel_cpu_is_same_quant
+    (
+    const vsi_nn_kernel_tensor_attr_t * attr0,
+    const vsi_nn_kernel_tensor_attr_t * attr1
+    );
+
+/*
+ * Convert float values to the storage type of attr, e.g. to build a
+ * LUT or a border value once instead of converting every element.
+ */
+OVXLIB_API vsi_status vsi_nn_kernel_cpu_quantize
+    (
+    const vsi_nn_kernel_tensor_attr_t * attr,
+    const float * buffer,
+    size_t size,
+    void * out
+    );
+
+/*
+ * Fill table with the float value of every 8-bit code of an U8/I8
+ * tensor, indexed by the raw byte. Used to build 256 entry LUTs.
+ */
+OVXLIB_API vsi_status vsi_nn_kernel_cpu_dequantize_table
+    (
+    const vsi_nn_kernel_tensor_attr_t * attr,
+    float table[256]
+    );
+
+__END_DECLS
+
+#endif
@@ -26,6 +26,7 @@
 #define _VSI_NN_KERNEL_LUT_H
 
 #include <stdint.h>
+#include "kernel/vsi_nn_kernel.h"
 
 __BEGIN_DECLS
 
@@ -76,6 +77,39 @@ typedef struct  _vsi_nn_kernel_lut_params
     float params[16];
 } vsi_nn_kernel_lut_params;
 
+typedef struct _vsi_nn_kernel_lut_table
+{
+    float index[VSI_NN_KERNEL_LUT_MAX_SIZE];
+    float value[VSI_NN_KERNEL_LUT_MAX_SIZE];
+} vsi_nn_kernel_lut_table_t;
+
+/*
+ * Fill table for param, without going through the cache.
+ */
+OVXLIB_API vsi_status vsi_nn_kernel_lut_generate
+    (
+    const vsi_nn_kernel_lut_params * param,
+    vsi_nn_kernel_lut_table_t * table
+    );
+
+/*
+ * Get the process wide, read only table for param, keyed by act_type,
+ * params and the sign/clamp flags. Tables live until process exit.
+ * Returns NULL on failure or when the cache is full, callers then fall
+ * back to vsi_nn_kernel_lut_generate().
+ */
+OVXLIB_API const vsi_nn_kernel_lut_table_t * vsi_nn_kernel_lut_get_table
+    (
+    const vsi_nn_kernel_lut_params * param
+    );
+
+OVXLIB_API void vsi_nn_kernel_lut_cache_query
+    (
+    uint32_t * entries,
+    uint32_t * hits,
+    uint32_t * misses
+    );
+
 vsi_status vsi_nn_kernel_lut
     (
     vx_lut index_lut,
@@ -83,6 +117,27 @@ vsi_status vsi_nn_kernel_lut
     vsi_nn_kernel_lut_params *param
     );
 
+/*
+ * Get the index and value luts for param. Nodes of the same context with
+ * the same activation share one pair of vx_lut objects, each returned
+ * reference is owned by the caller and released with vxReleaseLUT().
+ */
+vsi_status vsi_nn_kernel_lut_create
+    (
+    vx_context context,
+    vsi_nn_kernel_lut_params * param,
+    vx_lut * index_lut,
+    vx_lut * output_lut
+    );
+
+/*
+ * Drop the luts shared by nodes of context, called on context release.
+ */
+void vsi_nn_kernel_lut_release_context
+    (
+    vx_context context
+    );
+
 __END_DECLS
 
 #endif
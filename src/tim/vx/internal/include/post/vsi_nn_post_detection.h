@@ -0,0 +1,147 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef _VSI_NN_POST_DETECTION_H_
+#define _VSI_NN_POST_DETECTION_H_
+
+#include "vsi_nn_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Host side detection post processing shared by SSD/YOLO style models
+ * and the faster-rcnn helper.
+ *
+ * Boxes are float[4] corners (x1, y1, x2, y2). All scratch memory lives in
+ * a workspace which only grows, so steady state calls do not allocate.
+ * A workspace must not be used by two threads at the same time.
+ */
+typedef struct _vsi_nn_detection_workspace_t vsi_nn_detection_workspace_t;
+
+typedef struct _vsi_nn_detection_t
+{
+    /* index of the box in the input */
+    uint32_t index;
+    uint32_t class_id;
+    float score;
+} VSI_PUBLIC_TYPE vsi_nn_detection_t;
+
+typedef struct _vsi_nn_detection_nms_param_t
+{
+    float iou_thresh;
+    /* boxes with score <= score_thresh are dropped before NMS */
+    float score_thresh;
+    /* keep the top k candidates (per class) before NMS, 0 keeps all */
+    uint32_t pre_nms_top_k;
+    /* width = x2 - x1 + 1, the caffe/faster-rcnn pixel convention */
+    vsi_bool pixel_inclusive;
+} VSI_PUBLIC_TYPE vsi_nn_detection_nms_param_t;
+
+OVXLIB_API vsi_nn_detection_workspace_t * vsi_nn_DetectionCreateWorkspace
+    (
+    uint32_t max_boxes
+    );
+
+OVXLIB_API void vsi_nn_DetectionReleaseWorkspace
+    (
+    vsi_nn_detection_workspace_t ** workspace
+    );
+
+/*
+ * Decode center-size regressions against anchors, SSD style.
+ * deltas: count x (dx, dy, dw, dh), anchors: count x (cx, cy, w, h),
+ * variance scales the four deltas. boxes receives count x (x1, y1, x2, y2).
+ */
+OVXLIB_API vsi_status vsi_nn_DetectionDecodeBoxes
+    (
+    const float * deltas,
+    const float * anchors,
+    uint32_t count,
+    const float variance[4],
+    float * boxes
+    );
+
+/*
+ * Single class NMS. Results are sorted by descending score, at most
+ * capacity of them are written and their number is stored to kept.
+ * Returns VSI_FAILURE on invalid arguments or allocation failure, kept is
+ * 0 then.
+ */
+OVXLIB_API vsi_status vsi_nn_DetectionNms
+    (
+    vsi_nn_detection_workspace_t * workspace,
+    const float * boxes,
+    const float * scores,
+    uint32_t count,
+    const vsi_nn_detection_nms_param_t * param,
+    vsi_nn_detection_t * detections,
+    uint32_t capacity,
+    uint32_t * kept
+    );
+
+/*
+ * NMS run independently for every class in [first_class, class_num).
+ * scores is count x class_num, first_class = 1 skips a background class.
+ * Results of all classes are merged by descending score, kept and the
+ * status are as for vsi_nn_DetectionNms().
+ */
+OVXLIB_API vsi_status vsi_nn_DetectionMultiClassNms
+    (
+    vsi_nn_detection_workspace_t * workspace,
+    const float * boxes,
+    const float * scores,
+    uint32_t count,
+    uint32_t class_num,
+    uint32_t first_class,
+    const vsi_nn_detection_nms_param_t * param,
+    vsi_nn_detection_t * detections,
+    uint32_t capacity,
+    uint32_t * kept
+    );
+
+/*
+ * One NMS pass over boxes that already carry a class, e.g. YOLO argmax.
+ * Boxes only suppress boxes of the same class: every class is shifted to
+ * its own coordinate range so they never overlap. kept and the status are
+ * as for vsi_nn_DetectionNms().
+ */
+OVXLIB_API vsi_status vsi_nn_DetectionBatchedNms
+    (
+    vsi_nn_detection_workspace_t * workspace,
+    const float * boxes,
+    const float * scores,
+    const uint32_t * class_ids,
+    uint32_t count,
+    const vsi_nn_detection_nms_param_t * param,
+    vsi_nn_detection_t * detections,
+    uint32_t capacity,
+    uint32_t * kept
+    );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
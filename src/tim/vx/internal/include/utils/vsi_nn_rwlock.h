@@ -0,0 +1,55 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#ifndef _VSI_NN_RWLOCK_H
+#define _VSI_NN_RWLOCK_H
+
+/*
+ * Statically initialized reader/writer lock for process wide registries.
+ * Readers may run concurrently, e.g. graphs being set up from several
+ * threads, registration takes the lock exclusively.
+ */
+#if (defined(_MSC_VER) || defined(_WIN32) || defined(__MINGW32))
+#include <windows.h>
+
+typedef SRWLOCK vsi_nn_rwlock_t;
+#define VSI_NN_RWLOCK_INITIALIZER SRWLOCK_INIT
+#define vsi_nn_rwlock_rdlock(lock)   AcquireSRWLockShared(lock)
+#define vsi_nn_rwlock_rdunlock(lock) ReleaseSRWLockShared(lock)
+#define vsi_nn_rwlock_wrlock(lock)   AcquireSRWLockExclusive(lock)
+#define vsi_nn_rwlock_wrunlock(lock) ReleaseSRWLockExclusive(lock)
+
+#else
+#include <pthread.h>
+
+typedef pthread_rwlock_t vsi_nn_rwlock_t;
+#define VSI_NN_RWLOCK_INITIALIZER PTHREAD_RWLOCK_INITIALIZER
+#define vsi_nn_rwlock_rdlock(lock)   pthread_rwlock_rdlock(lock)
+#define vsi_nn_rwlock_rdunlock(lock) pthread_rwlock_unlock(lock)
+#define vsi_nn_rwlock_wrlock(lock)   pthread_rwlock_wrlock(lock)
+#define vsi_nn_rwlock_wrunlock(lock) pthread_rwlock_unlock(lock)
+
+#endif
+
+#endif
@@ -54,7 +54,12 @@ typedef struct _vsi_nn_node_attr_t
 {
     int32_t const_tensor_preload_type;
     int32_t enable_op_constraint_check;
-    int32_t reserved[6];
+    /** Bitmask of (1 << vsi_nn_kernel_type_e) tried first by the kernel
+     *  selector, 0 keeps the default priorities. */
+    int32_t preferred_kernel_types;
+    /** Bitmask of kernel types the selector instanced for this node. */
+    int32_t selected_kernel_types;
+    int32_t reserved[4];
 } vsi_nn_node_attr_t;
 
 /** Node structure */
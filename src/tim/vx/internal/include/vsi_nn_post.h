@@ -26,5 +26,6 @@
 
 #include "post/vsi_nn_post_fasterrcnn.h"
 #include "post/vsi_nn_post_cmupose.h"
+#include "post/vsi_nn_post_detection.h"
 
 #endif
\ No newline at end of file
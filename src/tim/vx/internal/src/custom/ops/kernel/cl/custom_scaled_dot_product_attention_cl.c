@@ -0,0 +1,334 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vsi_nn_types.h"
+#include "vsi_nn_tensor.h"
+#include "vsi_nn_graph.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_error.h"
+#include "vsi_nn_prv.h"
+#include "vsi_nn_tensor_util.h"
+#include "utils/vsi_nn_util.h"
+#include "kernel/vsi_nn_kernel.h"
+
+__BEGIN_DECLS
+
+/*
+ * Define kernel meta.
+ */
+#define _KERNEL_SOURCE_NAME     "custom_scaled_dot_product_attention"
+/* Size of the per work item query and accumulator arrays in the source */
+#define _MAX_HEAD_DIM           (128)
+
+typedef struct
+{
+    uint32_t key;
+    char * function_name;
+    const char * source_name;
+} _kernel_map_type;
+
+static const _kernel_map_type _custom_scaled_dot_product_attention_kernel_map[] =
+{
+    { 0, CVIVANTE_NAMESPACE("cl.custom_scaled_dot_product_attention"),
+        _KERNEL_SOURCE_NAME },
+    { 1, CVIVANTE_NAMESPACE("cl.custom_scaled_dot_product_attention_mask"),
+        _KERNEL_SOURCE_NAME },
+};
+
+/*
+ * Kernel params
+ */
+static vx_param_description_t _custom_scaled_dot_product_attention_kernel_param_def[] =
+{
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+};
+#define _SDPA_PARAM_NUM  _cnt_of_array( _custom_scaled_dot_product_attention_kernel_param_def )
+
+static vx_param_description_t _custom_scaled_dot_product_attention_mask_kernel_param_def[] =
+{
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+};
+#define _SDPA_MASK_PARAM_NUM  _cnt_of_array( _custom_scaled_dot_product_attention_mask_kernel_param_def )
+#define _SDPA_MAX_PARAM_NUM   _SDPA_MASK_PARAM_NUM
+
+#define _IO_NUM                 (5)
+
+/*
+ * Kernel initializer
+ */
+DEF_KERNEL_INITIALIZER(_custom_scaled_dot_product_attention_initializer)
+    (
+    vsi_nn_kernel_node_t                node,
+    const vsi_nn_kernel_node_param_t  * param,
+    size_t                              param_size
+    )
+{
+    gpu_param_t gpu_param = {
+        2,         // workdim
+        {0, 0, 0}, // globalWorkOffset: control the start location be processed in the image
+        {0, 0, 0}, // globalWorkScale: how many pixels could be processed by a single thread
+        {0, 0, 0}, // localWorkSize: local group size in thread
+        {0, 0, 0}  // globalWorkSize: image size in thread
+        };
+
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_tensor_attr_t * attr = NULL;
+    vsi_size_array_t * q_shape = NULL;
+
+    /* One work item per query row, the query is always param 0 */
+    attr = vsi_nn_kernel_tensor_attr_create( (vsi_nn_kernel_tensor_t)param[0] );
+    CHECK_PTR_FAIL_GOTO( attr, "Create tensor attr buffer fail.", final );
+
+    q_shape = attr->shape;
+
+    gpu_param.global_scale[0] = 1;
+    gpu_param.global_scale[1] = 1;
+    gpu_param.global_size[0] = q_shape->data[1];
+    gpu_param.global_size[1] = q_shape->size > 2 ? q_shape->data[2] : 1;
+
+    status = vsi_nn_kernel_gpu_config( node, &gpu_param );
+
+final:
+    if ( attr )
+    {
+        vsi_nn_kernel_tensor_attr_release( &attr );
+    }
+
+    return status;
+} /* _custom_scaled_dot_product_attention_initializer() */
+
+
+/*
+ * Query kernel
+ */
+static vsi_status _query_kernel
+    (
+    vsi_nn_kernel_t * kernel,
+    vsi_bool has_mask
+    )
+{
+    const _kernel_map_type * kernel_map = _custom_scaled_dot_product_attention_kernel_map;
+
+    snprintf( kernel->info.name, VX_MAX_KERNEL_NAME, "%s",
+        kernel_map[has_mask].function_name );
+    if ( has_mask )
+    {
+        kernel->info.parameters = _custom_scaled_dot_product_attention_mask_kernel_param_def;
+        kernel->info.numParams  = _SDPA_MASK_PARAM_NUM;
+    }
+    else
+    {
+        kernel->info.parameters = _custom_scaled_dot_product_attention_kernel_param_def;
+        kernel->info.numParams  = _SDPA_PARAM_NUM;
+    }
+    kernel->info.initialize = _custom_scaled_dot_product_attention_initializer;
+    // Register code source
+    vsi_nn_kernel_add_source( kernel, VSI_NN_GPU_SOURCE_FMT_CODE, 1,
+            kernel_map[has_mask].source_name );
+    // Register binary source
+    vsi_nn_kernel_add_source( kernel, VSI_NN_GPU_SOURCE_FMT_EXECUTABLE, 1,
+            kernel_map[has_mask].source_name );
+
+    return VSI_SUCCESS;
+} /* _query_kernel() */
+
+static vsi_bool _is_float
+    (
+    vsi_nn_tensor_t * tensor
+    )
+{
+    vsi_nn_kernel_dtype_e dtype = vsi_nn_kernel_map_dtype( tensor->attr.dtype.vx_type );
+
+    return dtype == F16 || dtype == F32;
+} /* _is_float() */
+
+/* Fold every dim from 2 on into one, the kernel walks [x, y, z] */
+static vsi_nn_tensor_t * _reshape_3d
+    (
+    vsi_nn_graph_t * graph,
+    vsi_nn_tensor_t * tensor
+    )
+{
+    vsi_size_t shape[3] = { 1, 1, 1 };
+    uint32_t i = 0;
+
+    for ( i = 0; i < tensor->attr.dim_num; i++ )
+    {
+        shape[vsi_nn_min( i, 2 )] *= tensor->attr.size[i];
+    }
+    return vsi_nn_reshape_tensor( graph, tensor, shape, 3 );
+} /* _reshape_3d() */
+
+static vsi_nn_kernel_node_t _setup
+    (
+    vsi_nn_graph_t              * graph,
+    vsi_nn_tensor_t            ** inputs,
+    size_t                        input_num,
+    vsi_nn_tensor_t            ** outputs,
+    size_t                        output_num,
+    const vsi_nn_kernel_param_t * params,
+    vsi_nn_kernel_t             * kernel
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_node_param_t node_params[_SDPA_MAX_PARAM_NUM] = {NULL};
+    vsi_nn_kernel_node_t node = NULL;
+    vsi_nn_tensor_t * rs_tensors[_IO_NUM] = { NULL };
+    vsi_nn_tensor_t * mask = input_num > 3 ? inputs[3] : NULL;
+    vsi_bool has_mask = mask != NULL;
+    size_t param_num = has_mask ? _SDPA_MASK_PARAM_NUM : _SDPA_PARAM_NUM;
+    size_t scalar_index = has_mask ? 5 : 4;
+    float scale = vsi_nn_kernel_param_get_float32( params, "scale" );
+    int32_t causal = vsi_nn_kernel_param_get_int32( params, "causal" );
+    int32_t mask_row_step = 0;
+    int32_t mask_z_step = 0;
+    size_t i = 0;
+
+    for ( i = 0; i < 3; i++ )
+    {
+        if ( !_is_float( inputs[i] ) )
+        {
+            return NULL;
+        }
+    }
+    if ( !_is_float( outputs[0] ) ||
+         inputs[0]->attr.size[0] > _MAX_HEAD_DIM ||
+         inputs[2]->attr.size[0] > _MAX_HEAD_DIM )
+    {
+        return NULL;
+    }
+
+    if ( has_mask )
+    {
+        vsi_size_t mask_outer = 1;
+
+        if ( !_is_float( mask ) )
+        {
+            return NULL;
+        }
+        mask_row_step = mask->attr.dim_num > 1 && mask->attr.size[1] > 1;
+        /* The mask broadcasts over all outer dims or over none of them */
+        for ( i = 2; i < mask->attr.dim_num; i++ )
+        {
+            mask_outer *= mask->attr.size[i];
+        }
+        if ( mask_outer > 1 )
+        {
+            for ( i = 2; i < inputs[0]->attr.dim_num; i++ )
+            {
+                if ( i >= mask->attr.dim_num ||
+                     mask->attr.size[i] != inputs[0]->attr.size[i] )
+                {
+                    return NULL;
+                }
+            }
+            mask_z_step = 1;
+        }
+    }
+
+    rs_tensors[0] = _reshape_3d( graph, inputs[0] );
+    rs_tensors[1] = _reshape_3d( graph, inputs[1] );
+    rs_tensors[2] = _reshape_3d( graph, inputs[2] );
+    if ( has_mask )
+    {
+        rs_tensors[3] = _reshape_3d( graph, mask );
+    }
+    rs_tensors[4] = _reshape_3d( graph, outputs[0] );
+
+    for ( i = 0; i < _IO_NUM; i++ )
+    {
+        if ( rs_tensors[i] && !vsi_nn_kernel_gpu_check_shape(
+                rs_tensors[i]->attr.size, rs_tensors[i]->attr.dim_num ) )
+        {
+            goto final;
+        }
+    }
+
+    status = _query_kernel( kernel, has_mask );
+    if ( VSI_SUCCESS == status )
+    {
+        node = vsi_nn_kernel_create_node( graph, kernel );
+        if ( node )
+        {
+            /* Set inputs and outputs */
+            vsi_nn_kernel_node_pack_io( node_params, param_num,
+                    rs_tensors, has_mask ? 4 : 3, &rs_tensors[4], 1 );
+
+            node_params[scalar_index] = vsi_nn_kernel_scalar_create(
+                    graph, F32, &scale );
+            node_params[scalar_index + 1] = vsi_nn_kernel_scalar_create(
+                    graph, I32, &causal );
+            if ( has_mask )
+            {
+                node_params[scalar_index + 2] = vsi_nn_kernel_scalar_create(
+                        graph, I32, &mask_row_step );
+                node_params[scalar_index + 3] = vsi_nn_kernel_scalar_create(
+                        graph, I32, &mask_z_step );
+            }
+
+            /* Pass parameters to node. */
+            status  = vsi_nn_kernel_node_pass_param( node, node_params, param_num );
+            CHECK_STATUS_FAIL_GOTO( status, final );
+        }
+    }
+
+final:
+    for ( i = 0; i < _IO_NUM; i++ )
+    {
+        if ( rs_tensors[i] )
+        {
+            vsi_nn_ReleaseTensor( &rs_tensors[i] );
+        }
+    }
+    for ( i = scalar_index; i < param_num; i++ )
+    {
+        if ( node_params[i] )
+        {
+            vsi_nn_kernel_scalar_release( &node_params[i] );
+        }
+    }
+
+    return node;
+} /* _setup() */
+
+__END_DECLS
+
+REGISTER_BACKEND_CL( custom_scaled_dot_product_attention, _setup )
@@ -0,0 +1,270 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vsi_nn_types.h"
+#include "vsi_nn_tensor.h"
+#include "vsi_nn_graph.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_error.h"
+#include "vsi_nn_prv.h"
+#include "vsi_nn_tensor_util.h"
+#include "utils/vsi_nn_util.h"
+#include "kernel/vsi_nn_kernel.h"
+
+__BEGIN_DECLS
+
+/*
+ * Define kernel meta.
+ */
+#define _KERNEL_SOURCE_NAME     "custom_slice_update"
+
+typedef enum
+{
+    _SLICE_UPDATE_FLOAT = 0,
+    _SLICE_UPDATE_UINT,
+    _SLICE_UPDATE_INT,
+} _slice_update_type_e;
+
+typedef struct
+{
+    uint32_t key;
+    char * function_name;
+    const char * source_name;
+} _kernel_map_type;
+
+static const _kernel_map_type _custom_slice_update_kernel_map[] =
+{
+    { _SLICE_UPDATE_FLOAT, CVIVANTE_NAMESPACE("cl.custom_slice_update_F32"),
+        _KERNEL_SOURCE_NAME },
+    { _SLICE_UPDATE_UINT, CVIVANTE_NAMESPACE("cl.custom_slice_update_U32"),
+        _KERNEL_SOURCE_NAME },
+    { _SLICE_UPDATE_INT, CVIVANTE_NAMESPACE("cl.custom_slice_update_I32"),
+        _KERNEL_SOURCE_NAME },
+};
+
+/*
+ * Kernel params
+ */
+static vx_param_description_t _custom_slice_update_kernel_param_def[] =
+{
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+};
+#define _CUSTOM_SLICE_UPDATE_PARAM_NUM  _cnt_of_array( _custom_slice_update_kernel_param_def )
+
+/*
+ * Kernel initializer
+ */
+DEF_KERNEL_INITIALIZER(_custom_slice_update_initializer)
+    (
+    vsi_nn_kernel_node_t                node,
+    const vsi_nn_kernel_node_param_t  * param,
+    size_t                              param_size
+    )
+{
+    gpu_param_t gpu_param = {
+        3,         // workdim
+        {0, 0, 0}, // globalWorkOffset: control the start location be processed in the image
+        {0, 0, 0}, // globalWorkScale: how many pixels could be processed by a single thread
+        {0, 0, 0}, // localWorkSize: local group size in thread
+        {0, 0, 0}  // globalWorkSize: image size in thread
+        };
+
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_tensor_attr_t * attr = NULL;
+    vsi_size_array_t * in_shape = NULL;
+
+    /* One work item per element of the update */
+    attr = vsi_nn_kernel_tensor_attr_create( (vsi_nn_kernel_tensor_t)param[0] );
+    CHECK_PTR_FAIL_GOTO( attr, "Create tensor attr buffer fail.", final );
+
+    in_shape = attr->shape;
+
+    gpu_param.global_scale[0] = 1;
+    gpu_param.global_scale[1] = 1;
+    gpu_param.global_scale[2] = 1;
+    gpu_param.global_size[0] = in_shape->data[0];
+    gpu_param.global_size[1] = in_shape->data[1];
+    gpu_param.global_size[2] = in_shape->size > 2 ? in_shape->data[2] : 1;
+
+    status = vsi_nn_kernel_gpu_config( node, &gpu_param );
+
+final:
+    if ( attr )
+    {
+        vsi_nn_kernel_tensor_attr_release( &attr );
+    }
+
+    return status;
+} /* _custom_slice_update_initializer() */
+
+
+/*
+ * Query kernel
+ */
+static vsi_status _query_kernel
+    (
+    vsi_nn_kernel_t * kernel,
+    _slice_update_type_e type
+    )
+{
+    const _kernel_map_type * kernel_map = &_custom_slice_update_kernel_map[type];
+
+    snprintf( kernel->info.name, VX_MAX_KERNEL_NAME, "%s", kernel_map->function_name );
+    kernel->info.parameters  = _custom_slice_update_kernel_param_def;
+    kernel->info.numParams   = _CUSTOM_SLICE_UPDATE_PARAM_NUM;
+    kernel->info.initialize  = _custom_slice_update_initializer;
+    // Register code source
+    vsi_nn_kernel_add_source( kernel, VSI_NN_GPU_SOURCE_FMT_CODE, 1,
+            kernel_map->source_name );
+    // Register binary source
+    vsi_nn_kernel_add_source( kernel, VSI_NN_GPU_SOURCE_FMT_EXECUTABLE, 1,
+            kernel_map->source_name );
+
+    return VSI_SUCCESS;
+} /* _query_kernel() */
+
+/*
+ * Float tensors convert on read and write, anything else is moved as is
+ * and so needs the same dtype and quantization on both sides.
+ */
+static vsi_bool _get_type
+    (
+    vsi_nn_tensor_t * input,
+    vsi_nn_tensor_t * output,
+    _slice_update_type_e * type
+    )
+{
+    vsi_nn_kernel_dtype_e in_dtype = vsi_nn_kernel_map_dtype( input->attr.dtype.vx_type );
+    vsi_nn_kernel_dtype_e out_dtype = vsi_nn_kernel_map_dtype( output->attr.dtype.vx_type );
+
+    if ( ( in_dtype == F16 || in_dtype == F32 ) &&
+         ( out_dtype == F16 || out_dtype == F32 ) )
+    {
+        *type = _SLICE_UPDATE_FLOAT;
+        return TRUE;
+    }
+    if ( !vsi_nn_is_same_type( input, output ) )
+    {
+        return FALSE;
+    }
+    switch ( in_dtype )
+    {
+        case U8:
+        case U16:
+        case U32:
+            *type = _SLICE_UPDATE_UINT;
+            return TRUE;
+        case I8:
+        case I16:
+        case I32:
+            *type = _SLICE_UPDATE_INT;
+            return TRUE;
+        default:
+            return FALSE;
+    }
+} /* _get_type() */
+
+static vsi_nn_kernel_node_t _setup
+    (
+    vsi_nn_graph_t              * graph,
+    vsi_nn_tensor_t            ** inputs,
+    size_t                        input_num,
+    vsi_nn_tensor_t            ** outputs,
+    size_t                        output_num,
+    const vsi_nn_kernel_param_t * params,
+    vsi_nn_kernel_t             * kernel
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_node_param_t node_params[_CUSTOM_SLICE_UPDATE_PARAM_NUM] = {NULL};
+    vsi_nn_kernel_node_t node = NULL;
+    vsi_nn_tensor_t * rs_tensors[3] = { NULL };
+    vsi_size_t in_shape[3] = { 1, 1, 1 };
+    vsi_size_t out_shape[3] = { 1, 1, 1 };
+    vsi_size_t start_shape[3] = { 1, 1, 1 };
+    int32_t axis = vsi_nn_kernel_param_get_int32( params, "axis" );
+    _slice_update_type_e type = _SLICE_UPDATE_FLOAT;
+    uint32_t i = 0;
+
+    if ( !_get_type( inputs[0], outputs[0], &type ) )
+    {
+        return NULL;
+    }
+
+    /* [inner, axis, outer], the kernel only moves rows along y */
+    for ( i = 0; i < outputs[0]->attr.dim_num; i++ )
+    {
+        uint32_t dim = (int32_t)i < axis ? 0 : ( (int32_t)i == axis ? 1 : 2 );
+
+        in_shape[dim] *= inputs[0]->attr.size[i];
+        out_shape[dim] *= outputs[0]->attr.size[i];
+    }
+    if ( !vsi_nn_kernel_gpu_check_shape( in_shape, 3 ) ||
+         !vsi_nn_kernel_gpu_check_shape( out_shape, 3 ) )
+    {
+        return NULL;
+    }
+
+    rs_tensors[0] = vsi_nn_reshape_tensor( graph, inputs[0], in_shape, 3 );
+    rs_tensors[1] = vsi_nn_reshape_tensor( graph, inputs[1], start_shape, 3 );
+    rs_tensors[2] = vsi_nn_reshape_tensor( graph, outputs[0], out_shape, 3 );
+
+    status = _query_kernel( kernel, type );
+    if ( VSI_SUCCESS == status )
+    {
+        node = vsi_nn_kernel_create_node( graph, kernel );
+        if ( node )
+        {
+            /* Set inputs and outputs */
+            vsi_nn_kernel_node_pack_io( node_params, _CUSTOM_SLICE_UPDATE_PARAM_NUM,
+                    rs_tensors, 2, &rs_tensors[2], 1 );
+
+            /* Pass parameters to node. */
+            status  = vsi_nn_kernel_node_pass_param( node, node_params,
+                _CUSTOM_SLICE_UPDATE_PARAM_NUM );
+            CHECK_STATUS_FAIL_GOTO( status, final );
+        }
+    }
+
+final:
+    for ( i = 0; i < 3; i++ )
+    {
+        if ( rs_tensors[i] )
+        {
+            vsi_nn_ReleaseTensor( &rs_tensors[i] );
+        }
+    }
+
+    return node;
+} /* _setup() */
+
+__END_DECLS
+
+REGISTER_BACKEND_CL( custom_slice_update, _setup )
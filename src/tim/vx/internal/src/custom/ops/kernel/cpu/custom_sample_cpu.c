@@ -22,6 +22,7 @@
 *
 *****************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "vsi_nn_types.h"
 #include "vsi_nn_platform.h"
@@ -34,6 +35,7 @@
 #include "utils/vsi_nn_util.h"
 #include "utils/vsi_nn_dtype_util.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "kernel/vsi_nn_kernel_cpu.h"
 #include "libnnext/vsi_nn_vxkernel.h"
 
 #define _CPU_ARG_NUM            (1)
@@ -47,6 +49,69 @@
 
 __BEGIN_DECLS
 
+typedef struct
+{
+    const void * input;
+    void * output;
+    float addend;
+    /* Set when input and output are both 8-bit, maps code to code. */
+    vsi_bool use_lut;
+    uint8_t lut[256];
+} _sample_args_t;
+
+static void _sample_task
+    (
+    vsi_size_t begin,
+    vsi_size_t end,
+    void * user_data
+    )
+{
+    const _sample_args_t * args = (const _sample_args_t *)user_data;
+    vsi_size_t i = 0;
+
+    if ( args->use_lut )
+    {
+        const uint8_t * in = (const uint8_t *)args->input;
+        uint8_t * out = (uint8_t *)args->output;
+        for ( i = begin; i < end; i++ )
+        {
+            out[i] = args->lut[in[i]];
+        }
+    }
+    else
+    {
+        const float * in = (const float *)args->input;
+        float * out = (float *)args->output;
+        float addend = args->addend;
+        for ( i = begin; i < end; i++ )
+        {
+            out[i] = in[i] + addend;
+        }
+    }
+} /* _sample_task() */
+
+static vsi_bool _build_lut
+    (
+    const vsi_nn_kernel_tensor_attr_t * in_attr,
+    const vsi_nn_kernel_tensor_attr_t * out_attr,
+    _sample_args_t * args
+    )
+{
+    float table[256];
+    uint32_t i = 0;
+
+    if ( ( out_attr->dtype != U8 && out_attr->dtype != I8 ) ||
+        VSI_SUCCESS != vsi_nn_kernel_cpu_dequantize_table( in_attr, table ) )
+    {
+        return FALSE;
+    }
+    for ( i = 0; i < 256; i++ )
+    {
+        table[i] += args->addend;
+    }
+    return VSI_SUCCESS == vsi_nn_kernel_cpu_quantize( out_attr, table, 256, args->lut );
+} /* _build_lut() */
+
 DEF_KERNEL_EXECUTOR(_softmax_compute)
     (
     vsi_nn_kernel_node_t node,
@@ -55,12 +120,15 @@ DEF_KERNEL_EXECUTOR(_softmax_compute)
     )
 {
     vsi_status status = VX_SUCCESS;
-    float *buffer[_CPU_IO_NUM] = {NULL};
+    void *buffer[_CPU_IO_NUM] = {NULL};
     vsi_nn_kernel_tensor_t tensors[_CPU_IO_NUM] = {NULL};
     vsi_nn_kernel_tensor_attr_t *attr[_CPU_IO_NUM] = {NULL};
+    _sample_args_t args;
     uint32_t i = 0, out_elements = 0;
+    size_t elem_bytes = sizeof(float);
     int32_t axis;
 
+    memset(&args, 0, sizeof(args));
     tensors[0] = (vsi_nn_kernel_tensor_t)param[0]; // input0
     tensors[1] = (vsi_nn_kernel_tensor_t)param[1]; // input1
     tensors[2] = (vsi_nn_kernel_tensor_t)param[2]; // output
@@ -68,30 +136,47 @@ DEF_KERNEL_EXECUTOR(_softmax_compute)
     attr[0] = vsi_nn_kernel_tensor_attr_create(tensors[0]);
     attr[1] = vsi_nn_kernel_tensor_attr_create(tensors[1]);
     attr[2] = vsi_nn_kernel_tensor_attr_create(tensors[2]);
+    CHECK_PTR_FAIL_GOTO(attr[0], "Create tensor attr buffer fail.", final);
+    CHECK_PTR_FAIL_GOTO(attr[1], "Create tensor attr buffer fail.", final);
+    CHECK_PTR_FAIL_GOTO(attr[2], "Create tensor attr buffer fail.", final);
 
     status = vsi_nn_kernel_scalar_read_int32((vsi_nn_kernel_scalar_t)param[3], &axis);
     CHECK_STATUS_FAIL_GOTO(status, final );
 
-    /* alloc the float32 data buffer */
-    buffer[0] = (float *)vsi_nn_kernel_tensor_create_buffer(tensors[0], attr[0], TRUE);
-    CHECK_PTR_FAIL_GOTO(buffer[0], "Create input0 buffer fail.", final);
-
-    buffer[1] = (float *)vsi_nn_kernel_tensor_create_buffer(tensors[1], attr[1], TRUE);
+    buffer[1] = vsi_nn_kernel_tensor_create_buffer(tensors[1], attr[1], TRUE);
     CHECK_PTR_FAIL_GOTO(buffer[1], "Create input1 buffer fail.", final);
+    args.addend = ((float *)buffer[1])[0];
+
+    /* 8-bit data goes through a LUT, no float round trip. */
+    args.use_lut = _build_lut(attr[0], attr[2], &args);
+    if (args.use_lut)
+    {
+        elem_bytes = 1;
+    }
+
+    buffer[0] = vsi_nn_kernel_tensor_create_buffer(tensors[0], attr[0], !args.use_lut);
+    CHECK_PTR_FAIL_GOTO(buffer[0], "Create input0 buffer fail.", final);
 
     out_elements = (uint32_t)vsi_nn_kernel_tensor_attr_get_size(attr[2]);
-    buffer[2] = (float *)malloc(out_elements * sizeof(float));
+    buffer[2] = malloc(out_elements * elem_bytes);
     CHECK_PTR_FAIL_GOTO( buffer[2], "Create output buffer fail.", final );
-    memset(buffer[2], 0, out_elements * sizeof(float));
+    memset(buffer[2], 0, out_elements * elem_bytes);
 
     /* CPU implement */
-    for(i = 0; i < out_elements; i++)
+    args.input = buffer[0];
+    args.output = buffer[2];
+    vsi_nn_kernel_cpu_parallel_for(out_elements, 16384, _sample_task, &args);
+
+    if (args.use_lut)
     {
-        buffer[2][i] = buffer[0][i] + buffer[1][0];
+        status = vsi_nn_kernel_tensor_write(
+            tensors[2], attr[2], buffer[2], out_elements );
+    }
+    else
+    {
+        status = vsi_nn_kernel_tensor_write_from_float(
+            tensors[2], attr[2], (float *)buffer[2], out_elements );
     }
-
-    status = vsi_nn_kernel_tensor_write_from_float(
-        tensors[2], attr[2], buffer[2], out_elements );
 final:
     for(i = 0; i < _CPU_IO_NUM; i ++)
     {
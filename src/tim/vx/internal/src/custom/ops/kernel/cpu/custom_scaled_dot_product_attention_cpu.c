@@ -0,0 +1,355 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "vsi_nn_types.h"
+#include "vsi_nn_tensor.h"
+#include "vsi_nn_graph.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_error.h"
+#include "vsi_nn_prv.h"
+#include "vsi_nn_tensor_util.h"
+#include "utils/vsi_nn_util.h"
+#include "kernel/vsi_nn_kernel.h"
+#include "kernel/vsi_nn_kernel_cpu.h"
+#include "libnnext/vx_lib_nnext.h"
+
+__BEGIN_DECLS
+
+/*
+ * Define kernel meta.
+ */
+#define _INPUT_NUM          (4)
+#define _OUTPUT_NUM         (1)
+#define _CPU_IO_NUM         (_INPUT_NUM + _OUTPUT_NUM)
+#define _KERNEL_NAME        CVIVANTE_NAMESPACE("cpu.custom_scaled_dot_product_attention")
+
+
+/*
+ * Kernel params
+ */
+static vx_param_description_t _custom_scaled_dot_product_attention_kernel_param_def[] =
+{
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_OPTIONAL},
+    {VX_OUTPUT, VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    // Add kererl parameters here
+};
+#define _CUSTOM_SCALED_DOT_PRODUCT_ATTENTION_PARAM_NUM \
+    _cnt_of_array( _custom_scaled_dot_product_attention_kernel_param_def )
+#define _MASK_INDEX             (3)
+#define SCALAR_INPUT_SCALE      (5)
+#define SCALAR_INPUT_CAUSAL     (6)
+
+typedef struct
+{
+    const float * query;
+    const float * key;
+    const float * value;
+    const float * mask;
+    float * output;
+    vsi_size_t head_dim;
+    vsi_size_t value_dim;
+    vsi_size_t q_len;
+    vsi_size_t kv_len;
+    /* Outer dims of the output and the mask, the mask broadcasts on 1 */
+    vsi_size_t outer[2];
+    vsi_size_t mask_rows;
+    vsi_size_t mask_outer[2];
+    float scale;
+    int32_t causal;
+} _attention_args_t;
+
+/*
+ * One query row per item. Softmax is accumulated online over the keys,
+ * so the scores of a row are never stored.
+ */
+static void _attention_rows
+    (
+    vsi_size_t begin,
+    vsi_size_t end,
+    void * user_data
+    )
+{
+    _attention_args_t * args = (_attention_args_t *)user_data;
+    vsi_size_t d = args->head_dim;
+    vsi_size_t dv = args->value_dim;
+    vsi_size_t offset = args->kv_len - args->q_len;
+    float * acc = NULL;
+    vsi_size_t r = 0;
+    vsi_size_t j = 0;
+    vsi_size_t k = 0;
+
+    acc = (float *)malloc( dv * sizeof(float) );
+    if ( NULL == acc )
+    {
+        VSILOGE("Create accumulator buffer fail.");
+        return;
+    }
+
+    for ( r = begin; r < end; r++ )
+    {
+        vsi_size_t row = r % args->q_len;
+        vsi_size_t z = r / args->q_len;
+        vsi_size_t z0 = z % args->outer[0];
+        vsi_size_t z1 = z / args->outer[0];
+        vsi_size_t keys = args->causal ? row + offset + 1 : args->kv_len;
+        const float * q = args->query + r * d;
+        const float * key = args->key + z * args->kv_len * d;
+        const float * value = args->value + z * args->kv_len * dv;
+        const float * mask = NULL;
+        float * out = args->output + r * dv;
+        float max_score = -INFINITY;
+        float sum = 0.0f;
+
+        if ( args->mask )
+        {
+            mask = args->mask + ( ( ( args->mask_outer[1] == 1 ? 0 : z1 ) *
+                args->mask_outer[0] + ( args->mask_outer[0] == 1 ? 0 : z0 ) ) *
+                args->mask_rows + ( args->mask_rows == 1 ? 0 : row ) ) * args->kv_len;
+        }
+        memset( acc, 0, dv * sizeof(float) );
+
+        for ( j = 0; j < keys; j++ )
+        {
+            float score = 0.0f;
+            float weight = 0.0f;
+
+            for ( k = 0; k < d; k++ )
+            {
+                score += q[k] * key[j * d + k];
+            }
+            score *= args->scale;
+            if ( mask )
+            {
+                score += mask[j];
+            }
+            if ( score == -INFINITY )
+            {
+                continue;
+            }
+            if ( score > max_score )
+            {
+                float rescale = expf( max_score - score );
+
+                for ( k = 0; k < dv; k++ )
+                {
+                    acc[k] *= rescale;
+                }
+                sum *= rescale;
+                max_score = score;
+            }
+            weight = expf( score - max_score );
+            sum += weight;
+            for ( k = 0; k < dv; k++ )
+            {
+                acc[k] += weight * value[j * dv + k];
+            }
+        }
+
+        /* A row with every key masked out produces zeros */
+        for ( k = 0; k < dv; k++ )
+        {
+            out[k] = sum > 0.0f ? acc[k] / sum : 0.0f;
+        }
+    }
+
+    free( acc );
+} /* _attention_rows() */
+
+static void _get_outer
+    (
+    const vsi_nn_kernel_tensor_attr_t * attr,
+    vsi_size_t * outer
+    )
+{
+    outer[0] = attr->shape->size > 2 ? attr->shape->data[2] : 1;
+    outer[1] = attr->shape->size > 3 ? attr->shape->data[3] : 1;
+} /* _get_outer() */
+
+/*
+ * Kernel function
+ */
+DEF_KERNEL_EXECUTOR(_compute)
+    (
+    vsi_nn_kernel_node_t                node,
+    const vsi_nn_kernel_node_param_t  * param,
+    size_t                              param_size
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    float * buffer[_CPU_IO_NUM] = { NULL };
+    vsi_nn_kernel_tensor_t tensors[_CPU_IO_NUM] = { NULL };
+    vsi_nn_kernel_tensor_attr_t * attr[_CPU_IO_NUM] = { NULL };
+    _attention_args_t args;
+    vsi_size_t out_elements = 0;
+    vsi_size_t rows = 0;
+    size_t i = 0;
+
+    memset( &args, 0, sizeof(args) );
+    for ( i = 0; i < _CPU_IO_NUM; i++ )
+    {
+        tensors[i] = (vsi_nn_kernel_tensor_t)param[i];
+        if ( NULL == tensors[i] )
+        {
+            continue;
+        }
+        attr[i] = vsi_nn_kernel_tensor_attr_create( tensors[i] );
+        CHECK_PTR_FAIL_GOTO( attr[i], "Create tensor attr buffer fail.", final );
+    }
+
+    status = vsi_nn_kernel_scalar_read_float32(
+        (vsi_nn_kernel_scalar_t)param[SCALAR_INPUT_SCALE], &args.scale );
+    CHECK_STATUS_FAIL_GOTO( status, final );
+    status = vsi_nn_kernel_scalar_read_int32(
+        (vsi_nn_kernel_scalar_t)param[SCALAR_INPUT_CAUSAL], &args.causal );
+    CHECK_STATUS_FAIL_GOTO( status, final );
+    status = VSI_FAILURE;
+
+    for ( i = 0; i < _INPUT_NUM; i++ )
+    {
+        if ( tensors[i] )
+        {
+            buffer[i] = (float *)vsi_nn_kernel_tensor_create_buffer(
+                tensors[i], attr[i], TRUE );
+            CHECK_PTR_FAIL_GOTO( buffer[i], "Create input buffer fail.", final );
+        }
+    }
+
+    out_elements = vsi_nn_kernel_tensor_attr_get_size( attr[_INPUT_NUM] );
+    buffer[_INPUT_NUM] = (float *)malloc( out_elements * sizeof(float) );
+    CHECK_PTR_FAIL_GOTO( buffer[_INPUT_NUM], "Create output buffer fail.", final );
+
+    args.query = buffer[0];
+    args.key = buffer[1];
+    args.value = buffer[2];
+    args.mask = buffer[_MASK_INDEX];
+    args.output = buffer[_INPUT_NUM];
+    args.head_dim = attr[0]->shape->data[0];
+    args.q_len = attr[0]->shape->data[1];
+    args.kv_len = attr[1]->shape->data[1];
+    args.value_dim = attr[2]->shape->data[0];
+    _get_outer( attr[0], args.outer );
+    if ( args.mask )
+    {
+        args.mask_rows = attr[_MASK_INDEX]->shape->size > 1 ?
+            attr[_MASK_INDEX]->shape->data[1] : 1;
+        _get_outer( attr[_MASK_INDEX], args.mask_outer );
+    }
+
+    rows = args.q_len * args.outer[0] * args.outer[1];
+    vsi_nn_kernel_cpu_parallel_for( rows,
+        vsi_nn_max( 1, 4096 / vsi_nn_max( 1, args.kv_len * args.head_dim ) ),
+        _attention_rows, &args );
+
+    status = vsi_nn_kernel_tensor_write_from_float( tensors[_INPUT_NUM],
+        attr[_INPUT_NUM], buffer[_INPUT_NUM], out_elements );
+    CHECK_STATUS_FAIL_GOTO( status, final );
+final:
+    for( i = 0; i < _CPU_IO_NUM; i ++ )
+    {
+        if( buffer[i] )
+        {
+            free( buffer[i] );
+        }
+        vsi_nn_kernel_tensor_attr_release( &attr[i] );
+    }
+    return status;
+} /* _compute() */
+
+
+/*
+ * Query kernel
+ */
+static vsi_status _query_kernel
+    (
+    vsi_nn_kernel_t * kernel,
+    vsi_nn_tensor_t * const * const inputs,
+    vsi_nn_tensor_t * const * const outputs
+    /* Add extra params */
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    snprintf( kernel->info.name, VX_MAX_KERNEL_NAME, "%s",  _KERNEL_NAME );
+    kernel->info.function    = _compute;
+    kernel->info.parameters  = _custom_scaled_dot_product_attention_kernel_param_def;
+    kernel->info.numParams   = _CUSTOM_SCALED_DOT_PRODUCT_ATTENTION_PARAM_NUM;
+    status = VSI_SUCCESS;
+
+    return status;
+} /* _query_kernel() */
+
+
+static vsi_nn_kernel_node_t _setup
+    (
+    vsi_nn_graph_t              * graph,
+    vsi_nn_tensor_t            ** inputs,
+    size_t                        input_num,
+    vsi_nn_tensor_t            ** outputs,
+    size_t                        output_num,
+    const vsi_nn_kernel_param_t * params,
+    vsi_nn_kernel_t             * kernel
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_node_param_t node_params[_CUSTOM_SCALED_DOT_PRODUCT_ATTENTION_PARAM_NUM];
+    vsi_nn_kernel_node_t node = NULL;
+    float scale = vsi_nn_kernel_param_get_float32( params, "scale" );
+    int32_t causal = vsi_nn_kernel_param_get_int32( params, "causal" );
+
+    status = _query_kernel( kernel, inputs, outputs /* Add extra params */ );
+    if ( VSI_SUCCESS == status)
+    {
+        node = vsi_nn_kernel_create_node( graph, kernel );
+        if ( node )
+        {
+            /* Set inputs and outputs */
+            vsi_nn_kernel_node_pack_io( node_params, _CUSTOM_SCALED_DOT_PRODUCT_ATTENTION_PARAM_NUM,
+                    inputs, input_num, outputs, output_num );
+            node_params[SCALAR_INPUT_SCALE] = vsi_nn_kernel_scalar_create(
+                graph, F32, &scale );
+            node_params[SCALAR_INPUT_CAUSAL] = vsi_nn_kernel_scalar_create(
+                graph, I32, &causal );
+
+            /* Pass parameters to node. */
+            status  = vsi_nn_kernel_node_pass_param( node, node_params,
+                _CUSTOM_SCALED_DOT_PRODUCT_ATTENTION_PARAM_NUM );
+            vsi_nn_kernel_scalar_release( &node_params[SCALAR_INPUT_SCALE] );
+            vsi_nn_kernel_scalar_release( &node_params[SCALAR_INPUT_CAUSAL] );
+        }
+    }
+    return node;
+} /* _setup() */
+
+__END_DECLS
+
+REGISTER_BACKEND_CPU( custom_scaled_dot_product_attention, _setup )
@@ -0,0 +1,212 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vsi_nn_types.h"
+#include "vsi_nn_tensor.h"
+#include "vsi_nn_graph.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_error.h"
+#include "vsi_nn_prv.h"
+#include "vsi_nn_tensor_util.h"
+#include "utils/vsi_nn_util.h"
+#include "kernel/vsi_nn_kernel.h"
+#include "kernel/vsi_nn_kernel_cpu.h"
+#include "libnnext/vx_lib_nnext.h"
+
+__BEGIN_DECLS
+
+/*
+ * Define kernel meta.
+ */
+#define _INPUT_NUM          (2)
+#define _OUTPUT_NUM         (1)
+#define _CPU_IO_NUM         (_INPUT_NUM + _OUTPUT_NUM)
+#define _KERNEL_NAME        CVIVANTE_NAMESPACE("cpu.custom_slice_update")
+
+
+/*
+ * Kernel params
+ */
+static vx_param_description_t _custom_slice_update_kernel_param_def[] =
+{
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_OUTPUT, VX_TYPE_TENSOR, VX_PARAMETER_STATE_REQUIRED},
+    {VX_INPUT,  VX_TYPE_SCALAR, VX_PARAMETER_STATE_REQUIRED},
+    // Add kererl parameters here
+};
+#define _CUSTOM_SLICE_UPDATE_PARAM_NUM  _cnt_of_array( _custom_slice_update_kernel_param_def )
+#define SCALAR_INPUT_AXIS       (3)
+
+/*
+ * Kernel function
+ */
+DEF_KERNEL_EXECUTOR(_compute)
+    (
+    vsi_nn_kernel_node_t                node,
+    const vsi_nn_kernel_node_param_t  * param,
+    size_t                              param_size
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    void * buffer[_CPU_IO_NUM] = { NULL };
+    vsi_nn_kernel_tensor_t tensors[_CPU_IO_NUM] = { NULL };
+    vsi_nn_kernel_tensor_attr_t * attr[_CPU_IO_NUM] = { NULL };
+    vsi_size_t start[VSI_NN_MAX_DIM_NUM] = { 0 };
+    vsi_size_t end[VSI_NN_MAX_DIM_NUM] = { 0 };
+    vsi_size_t update_elements = 0;
+    int32_t axis = 0;
+    int32_t offset = 0;
+    size_t i = 0;
+
+    for ( i = 0; i < _CPU_IO_NUM; i++ )
+    {
+        tensors[i] = (vsi_nn_kernel_tensor_t)param[i];
+        attr[i] = vsi_nn_kernel_tensor_attr_create( tensors[i] );
+        CHECK_PTR_FAIL_GOTO( attr[i], "Create tensor attr buffer fail.", final );
+    }
+
+    status = vsi_nn_kernel_scalar_read_int32(
+        (vsi_nn_kernel_scalar_t)param[SCALAR_INPUT_AXIS], &axis );
+    CHECK_STATUS_FAIL_GOTO( status, final );
+    status = VSI_FAILURE;
+
+    buffer[1] = vsi_nn_kernel_tensor_create_buffer( tensors[1], attr[1], FALSE );
+    CHECK_PTR_FAIL_GOTO( buffer[1], "Create start buffer fail.", final );
+    offset = ((const int32_t *)buffer[1])[0];
+    if ( offset < 0 || (vsi_size_t)offset + attr[0]->shape->data[axis] >
+         attr[2]->shape->data[axis] )
+    {
+        VSILOGE("Slice update at %d runs past the end of the output", offset);
+        goto final;
+    }
+
+    /* Only the patch is converted and written, never the whole output */
+    update_elements = vsi_nn_kernel_tensor_attr_get_size( attr[0] );
+    if ( vsi_nn_kernel_cpu_is_same_quant( attr[0], attr[2] ) )
+    {
+        buffer[0] = vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], FALSE );
+        CHECK_PTR_FAIL_GOTO( buffer[0], "Create input buffer fail.", final );
+    }
+    else
+    {
+        buffer[0] = vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
+        CHECK_PTR_FAIL_GOTO( buffer[0], "Create input buffer fail.", final );
+        buffer[2] = malloc( update_elements *
+            vsi_nn_kernel_dtype_get_bytes( attr[2]->dtype ) );
+        CHECK_PTR_FAIL_GOTO( buffer[2], "Create output buffer fail.", final );
+        status = vsi_nn_kernel_cpu_quantize( attr[2], (const float *)buffer[0],
+            update_elements, buffer[2] );
+        CHECK_STATUS_FAIL_GOTO( status, final );
+    }
+
+    for ( i = 0; i < attr[2]->shape->size; i++ )
+    {
+        end[i] = attr[0]->shape->data[i];
+    }
+    start[axis] = (vsi_size_t)offset;
+    end[axis] += (vsi_size_t)offset;
+
+    status = vsi_nn_kernel_tensor_write_patch( tensors[2], attr[2],
+        buffer[2] ? buffer[2] : buffer[0], start, end );
+    CHECK_STATUS_FAIL_GOTO( status, final );
+final:
+    for( i = 0; i < _CPU_IO_NUM; i ++ )
+    {
+        if( buffer[i] )
+        {
+            free( buffer[i] );
+        }
+        vsi_nn_kernel_tensor_attr_release( &attr[i] );
+    }
+    return status;
+} /* _compute() */
+
+
+/*
+ * Query kernel
+ */
+static vsi_status _query_kernel
+    (
+    vsi_nn_kernel_t * kernel,
+    vsi_nn_tensor_t * const * const inputs,
+    vsi_nn_tensor_t * const * const outputs
+    /* Add extra params */
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    snprintf( kernel->info.name, VX_MAX_KERNEL_NAME, "%s",  _KERNEL_NAME );
+    kernel->info.function    = _compute;
+    kernel->info.parameters  = _custom_slice_update_kernel_param_def;
+    kernel->info.numParams   = _CUSTOM_SLICE_UPDATE_PARAM_NUM;
+    status = VSI_SUCCESS;
+
+    return status;
+} /* _query_kernel() */
+
+
+static vsi_nn_kernel_node_t _setup
+    (
+    vsi_nn_graph_t              * graph,
+    vsi_nn_tensor_t            ** inputs,
+    size_t                        input_num,
+    vsi_nn_tensor_t            ** outputs,
+    size_t                        output_num,
+    const vsi_nn_kernel_param_t * params,
+    vsi_nn_kernel_t             * kernel
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_node_param_t node_params[_CUSTOM_SLICE_UPDATE_PARAM_NUM];
+    vsi_nn_kernel_node_t node = NULL;
+    int32_t axis = vsi_nn_kernel_param_get_int32( params, "axis" );
+
+    status = _query_kernel( kernel, inputs, outputs /* Add extra params */ );
+    if ( VSI_SUCCESS == status)
+    {
+        node = vsi_nn_kernel_create_node( graph, kernel );
+        if ( node )
+        {
+            /* Set inputs and outputs */
+            vsi_nn_kernel_node_pack_io( node_params, _CUSTOM_SLICE_UPDATE_PARAM_NUM,
+                    inputs, input_num, outputs, output_num );
+            node_params[SCALAR_INPUT_AXIS] = vsi_nn_kernel_scalar_create(
+                graph, I32, &axis );
+
+            /* Pass parameters to node. */
+            status  = vsi_nn_kernel_node_pass_param( node, node_params,
+                _CUSTOM_SLICE_UPDATE_PARAM_NUM );
+            vsi_nn_kernel_scalar_release( &node_params[SCALAR_INPUT_AXIS] );
+        }
+    }
+    return node;
+} /* _setup() */
+
+__END_DECLS
+
+REGISTER_BACKEND_CPU( custom_slice_update, _setup )
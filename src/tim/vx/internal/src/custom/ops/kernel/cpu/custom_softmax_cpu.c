@@ -22,6 +22,7 @@
 *
 *****************************************************************************/
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "vsi_nn_types.h"
 #include "vsi_nn_platform.h"
@@ -34,6 +35,7 @@
 #include "utils/vsi_nn_util.h"
 #include "utils/vsi_nn_dtype_util.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "kernel/vsi_nn_kernel_cpu.h"
 #include "libnnext/vsi_nn_vxkernel.h"
 
 #define _CPU_ARG_NUM            (1)
@@ -47,6 +49,116 @@
 
 __BEGIN_DECLS
 
+typedef struct
+{
+    const float * input;
+    /* Native 8-bit input, the raw codes index exp_table. */
+    const uint8_t * codes;
+    const float * table;
+    float * output;
+    vsi_size_t size;
+    vsi_size_t slice;
+    float max_value;
+    float inv_sum;
+    float * partial;
+    float exp_table[256];
+} _softmax_args_t;
+
+static void _softmax_max
+    (
+    vsi_size_t begin,
+    vsi_size_t end,
+    void * user_data
+    )
+{
+    _softmax_args_t * args = (_softmax_args_t *)user_data;
+    vsi_size_t s = 0;
+    vsi_size_t i = 0;
+
+    for ( s = begin; s < end; s++ )
+    {
+        vsi_size_t first = s * args->slice;
+        vsi_size_t last = vsi_nn_min( first + args->slice, args->size );
+        float fMax = args->codes ? args->table[args->codes[first]] : args->input[first];
+
+        if ( args->codes )
+        {
+            for ( i = first; i < last; i++ )
+            {
+                fMax = vsi_nn_max( fMax, args->table[args->codes[i]] );
+            }
+        }
+        else
+        {
+            for ( i = first; i < last; i++ )
+            {
+                fMax = vsi_nn_max( fMax, args->input[i] );
+            }
+        }
+        args->partial[s] = fMax;
+    }
+} /* _softmax_max() */
+
+static void _softmax_exp
+    (
+    vsi_size_t begin,
+    vsi_size_t end,
+    void * user_data
+    )
+{
+    _softmax_args_t * args = (_softmax_args_t *)user_data;
+    float * output = args->output;
+    vsi_size_t s = 0;
+    vsi_size_t i = 0;
+
+    for ( s = begin; s < end; s++ )
+    {
+        vsi_size_t first = s * args->slice;
+        vsi_size_t last = vsi_nn_min( first + args->slice, args->size );
+        float fProbSum = 0.0f;
+
+        if ( args->codes )
+        {
+            for ( i = first; i < last; i++ )
+            {
+                output[i] = args->exp_table[args->codes[i]];
+            }
+        }
+        else
+        {
+            for ( i = first; i < last; i++ )
+            {
+                output[i] = expf( args->input[i] - args->max_value );
+            }
+        }
+        for ( i = first; i < last; i++ )
+        {
+            fProbSum += output[i];
+        }
+        args->partial[s] = fProbSum;
+    }
+} /* _softmax_exp() */
+
+static void _softmax_normalize
+    (
+    vsi_size_t begin,
+    vsi_size_t end,
+    void * user_data
+    )
+{
+    _softmax_args_t * args = (_softmax_args_t *)user_data;
+    float * output = args->output;
+    float scale = args->inv_sum;
+    vsi_size_t first = begin * args->slice;
+    vsi_size_t last = vsi_nn_min( end * args->slice, args->size );
+    vsi_size_t i = 0;
+
+    for ( i = first; i < last; i++ )
+    {
+        output[i] *= scale;
+    }
+} /* _softmax_normalize() */
+
 DEF_KERNEL_EXECUTOR(_softmax_exec)
     (
     vsi_nn_kernel_node_t node,
@@ -55,53 +167,93 @@ DEF_KERNEL_EXECUTOR(_softmax_exec)
     )
 {
     vsi_status status = VX_SUCCESS;
-    float* buffer[_CPU_IO_NUM] = { NULL };
+    void* buffer[_CPU_IO_NUM] = { NULL };
     vsi_nn_kernel_tensor_t tensors[_CPU_IO_NUM] = { NULL };
     vsi_nn_kernel_tensor_attr_t* attr[_CPU_IO_NUM] = { NULL };
+    _softmax_args_t args;
+    float table[256];
+    float* partial = NULL;
     uint32_t i = 0;
     uint32_t out_elements;
+    vsi_size_t slice_num = 0;
     int32_t sf_axis;
-    float fMax = 0.0;
     float fProbSum = 0.0f;
 
+    memset( &args, 0, sizeof(args) );
     tensors[0] = (vsi_nn_kernel_tensor_t)param[0];
     tensors[1] = (vsi_nn_kernel_tensor_t)param[1];
 
     attr[0] = vsi_nn_kernel_tensor_attr_create( tensors[0] );
     attr[1] = vsi_nn_kernel_tensor_attr_create( tensors[1] );
+    CHECK_PTR_FAIL_GOTO( attr[0], "Create tensor attr buffer fail.", final );
+    CHECK_PTR_FAIL_GOTO( attr[1], "Create tensor attr buffer fail.", final );
 
     status = vsi_nn_kernel_scalar_read_int32((vsi_nn_kernel_scalar_t)param[2], &sf_axis);
     CHECK_STATUS_FAIL_GOTO(status, final );
 
     out_elements = (uint32_t)vsi_nn_kernel_tensor_attr_get_size( attr[1] );
+    if ( 0 == out_elements )
+    {
+        goto final;
+    }
 
     /* alloc the float32 data buffer */
-    buffer[1] = (float *)malloc(out_elements * sizeof(float));
-    CHECK_PTR_FAIL_GOTO( buffer[1], "Create input buffer fail.", final );
-    memset(buffer[1], 0, out_elements * sizeof(float));
+    buffer[1] = malloc(out_elements * sizeof(float));
+    CHECK_PTR_FAIL_GOTO( buffer[1], "Create output buffer fail.", final );
 
-    buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
+    /* 8-bit input is dequantized through a 256 entry table instead. */
+    if ( VSI_SUCCESS == vsi_nn_kernel_cpu_dequantize_table( attr[0], table ) )
+    {
+        buffer[0] = vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], FALSE );
+        args.codes = (const uint8_t*)buffer[0];
+        args.table = table;
+    }
+    else
+    {
+        buffer[0] = vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
+        args.input = (const float*)buffer[0];
+    }
     CHECK_PTR_FAIL_GOTO( buffer[0], "Create input buffer fail.", final );
 
+    slice_num = vsi_nn_min( (vsi_size_t)vsi_nn_kernel_cpu_get_thread_num() * 4, out_elements );
+    partial = (float*)malloc( slice_num * sizeof(float) );
+    CHECK_PTR_FAIL_GOTO( partial, "Create partial buffer fail.", final );
+
+    args.output = (float*)buffer[1];
+    args.size = out_elements;
+    args.slice = (out_elements + slice_num - 1) / slice_num;
+    args.partial = partial;
+    slice_num = (out_elements + args.slice - 1) / args.slice;
+
     /* Softmax implement */
-    for ( i = 0; i < out_elements; i++)
+    vsi_nn_kernel_cpu_parallel_for( slice_num, 1, _softmax_max, &args );
+    args.max_value = partial[0];
+    for ( i = 1; i < slice_num; i++ )
     {
-        fMax = buffer[0][i] > fMax ? buffer[0][i] : fMax;
+        args.max_value = vsi_nn_max( args.max_value, partial[i] );
     }
 
-    for ( i = 0; i < out_elements; i++)
+    if ( args.codes )
     {
-        buffer[1][i] = (float)expf(buffer[0][i] - fMax);
-        fProbSum += buffer[1][i];
+        for ( i = 0; i < 256; i++ )
+        {
+            args.exp_table[i] = expf( table[i] - args.max_value );
+        }
     }
-    for ( i = 0; i < out_elements; i++)
+    vsi_nn_kernel_cpu_parallel_for( slice_num, 1, _softmax_exp, &args );
+    for ( i = 0; i < slice_num; i++ )
     {
-        buffer[1][i] =  buffer[1][i] / fProbSum;
+        fProbSum += partial[i];
     }
+
+    args.inv_sum = 1.0f / fProbSum;
+    vsi_nn_kernel_cpu_parallel_for( slice_num, 1, _softmax_normalize, &args );
+
     status = vsi_nn_kernel_tensor_write_from_float(
-        tensors[1], attr[1], buffer[1], out_elements );
+        tensors[1], attr[1], (float*)buffer[1], out_elements );
 
 final:
+    vsi_nn_safe_free( partial );
     for( i = 0; i < _CPU_IO_NUM; i ++ )
     {
         if( buffer[i] )
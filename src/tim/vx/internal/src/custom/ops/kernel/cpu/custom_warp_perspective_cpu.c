@@ -26,6 +26,7 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <math.h>
 #include "vsi_nn_types.h"
 #include "vsi_nn_tensor.h"
 #include "vsi_nn_graph.h"
@@ -35,6 +36,7 @@
 #include "vsi_nn_tensor_util.h"
 #include "utils/vsi_nn_util.h"
 #include "kernel/vsi_nn_kernel.h"
+#include "kernel/vsi_nn_kernel_cpu.h"
 #include "libnnext/vx_lib_nnext.h"
 
 __BEGIN_DECLS
@@ -70,6 +72,35 @@ static vx_param_description_t _custom_warp_perspective_kernel_param_def[] =
 #define SCALAR_INPUT_TYPE       (2)
 #define SCALAR_MATRIX_OFFSET    (3)
 
+#define _WARP_BORDER_VALUE   (205.0f)
+
+typedef enum
+{
+    _WARP_FLOAT = 0,
+    /* Same dtype and quantization in and out, work on raw elements. */
+    _WARP_NATIVE,
+    /* Native 8-bit data, bilinear blend done on codes. */
+    _WARP_NATIVE_U8,
+    _WARP_NATIVE_I8,
+} _warp_mode_e;
+
+typedef struct
+{
+    const void * src;
+    void * dst;
+    _warp_mode_e mode;
+    int32_t type;
+    float matrix[9];
+    vsi_size_t in_width;
+    vsi_size_t in_height;
+    vsi_size_t width;
+    vsi_size_t height;
+    size_t elem_bytes;
+    /* Border in the domain the kernel samples in: float or 8-bit code. */
+    float border;
+    uint8_t border_raw[sizeof(float)];
+} _warp_args_t;
+
 static void _transform_perspective
     (
     vsi_size_t dst_x,
@@ -85,34 +116,177 @@ static void _transform_perspective
     *src_y = (dst_x * m[1] + dst_y * m[4] + m[7]) / z;
 }
 
-static vsi_bool _read_pixel
+static VSI_INLINE_API vsi_bool _is_out_of_bounds
+    (
+    const _warp_args_t * args,
+    float x,
+    float y
+    )
+{
+    return (x < 0 || y < 0 || x >= args->in_width || y >= args->in_height);
+}
+
+static VSI_INLINE_API float _read_pixel
     (
-    float *base,
-    vsi_nn_kernel_tensor_attr_t *attr,
+    const _warp_args_t * args,
+    const void * base,
     float x,
-    float y,
-    float *pixel
+    float y
     )
 {
-    vsi_size_t width = attr->shape->data[0];
-    vsi_size_t height = attr->shape->data[1];
-    vsi_bool out_of_bounds = (x < 0 || y < 0 || x >= width || y >= height);
-    vsi_size_t bx = 0, by = 0;
+    vsi_size_t index = 0;
 
-    if (out_of_bounds)
+    if (_is_out_of_bounds(args, x, y))
+    {
+        return args->border;
+    }
+    index = (vsi_size_t)y * args->in_width + (vsi_size_t)x;
+    switch (args->mode)
     {
-        *pixel = 205.0f;
-        return TRUE;
+        case _WARP_NATIVE_U8:
+            return (float)((const uint8_t *)base)[index];
+        case _WARP_NATIVE_I8:
+            return (float)((const int8_t *)base)[index];
+        default:
+            return ((const float *)base)[index];
     }
+}
+
+static VSI_INLINE_API float _bilinear
+    (
+    const _warp_args_t * args,
+    const void * base,
+    float xf,
+    float yf
+    )
+{
+    float x0 = floorf(xf);
+    float y0 = floorf(yf);
+    float ar = xf - x0;
+    float ab = yf - y0;
+    float al = 1.0f - ar;
+    float at = 1.0f - ab;
+    float tl = _read_pixel(args, base, x0, y0);
+    float tr = _read_pixel(args, base, x0 + 1, y0);
+    float bl = _read_pixel(args, base, x0, y0 + 1);
+    float br = _read_pixel(args, base, x0 + 1, y0 + 1);
+
+    return tl * al * at + tr * ar * at + bl * al * ab + br * ar * ab;
+}
+
+/*
+ * Process output rows [begin, end), a row is (batch, y) flattened.
+ */
+static void _warp_rows
+    (
+    vsi_size_t begin,
+    vsi_size_t end,
+    void * user_data
+    )
+{
+    const _warp_args_t * args = (const _warp_args_t *)user_data;
+    vsi_size_t in_plane = args->in_width * args->in_height;
+    vsi_size_t width = args->width;
+    size_t elem_bytes = args->elem_bytes;
+    vsi_size_t row = 0;
+    vsi_size_t x = 0;
 
-    // bounded x/y
-    bx = x < 0 ? 0 : x >= width ? width - 1 : (vsi_size_t)x;
-    by = y < 0 ? 0 : y >= height ? height - 1 : (vsi_size_t)y;
+    for (row = begin; row < end; row++)
+    {
+        vsi_size_t b = row / args->height;
+        vsi_size_t y = row % args->height;
 
-    *pixel = base[by * width + bx];
+        for (x = 0; x < width; x++)
+        {
+            float xf = 0;
+            float yf = 0;
 
-    return TRUE;
-}
+            _transform_perspective(x, y, args->matrix, &xf, &yf);
+            if (args->mode == _WARP_FLOAT)
+            {
+                const float *src_base = (const float *)args->src + b * in_plane;
+                float *dst = (float *)args->dst + row * width + x;
+
+                if (args->type == VSI_NN_INTERPOLATION_NEAREST_NEIGHBOR)
+                {
+                    *dst = _read_pixel(args, src_base, xf, yf);
+                }
+                else
+                {
+                    *dst = _bilinear(args, src_base, xf, yf);
+                }
+            }
+            else if (args->type == VSI_NN_INTERPOLATION_NEAREST_NEIGHBOR)
+            {
+                const uint8_t *src_base = (const uint8_t *)args->src + b * in_plane * elem_bytes;
+                uint8_t *dst = (uint8_t *)args->dst + (row * width + x) * elem_bytes;
+                const uint8_t *pixel = args->border_raw;
+
+                if (!_is_out_of_bounds(args, xf, yf))
+                {
+                    pixel = src_base + ((vsi_size_t)yf * args->in_width + (vsi_size_t)xf) * elem_bytes;
+                }
+                memcpy(dst, pixel, elem_bytes);
+            }
+            else
+            {
+                const uint8_t *src_base = (const uint8_t *)args->src + b * in_plane;
+                float code = (float)vsi_rint(_bilinear(args, src_base, xf, yf));
+
+                if (args->mode == _WARP_NATIVE_U8)
+                {
+                    ((uint8_t *)args->dst)[row * width + x] = (uint8_t)vsi_nn_clamp(code, 0, 255);
+                }
+                else
+                {
+                    ((int8_t *)args->dst)[row * width + x] = (int8_t)vsi_nn_clamp(code, -128, 127);
+                }
+            }
+        }
+    }
+} /* _warp_rows() */
+
+/*
+ * Pick the native mode for args->type and fill the border in its domain.
+ */
+static _warp_mode_e _get_native_mode
+    (
+    const vsi_nn_kernel_tensor_attr_t * in_attr,
+    const vsi_nn_kernel_tensor_attr_t * out_attr,
+    int32_t type,
+    _warp_args_t * args
+    )
+{
+    float border = _WARP_BORDER_VALUE;
+    float table[256];
+
+    if (!vsi_nn_kernel_cpu_is_same_quant(in_attr, out_attr))
+    {
+        return _WARP_FLOAT;
+    }
+    if (type == VSI_NN_INTERPOLATION_NEAREST_NEIGHBOR)
+    {
+        args->elem_bytes = vsi_nn_kernel_dtype_get_bytes(in_attr->dtype);
+        if (args->elem_bytes > sizeof(args->border_raw) ||
+            VSI_SUCCESS != vsi_nn_kernel_cpu_quantize(in_attr, &border, 1, args->border_raw))
+        {
+            return _WARP_FLOAT;
+        }
+        return _WARP_NATIVE;
+    }
+    if (VSI_SUCCESS != vsi_nn_kernel_cpu_dequantize_table(in_attr, table))
+    {
+        return _WARP_FLOAT;
+    }
+    /*
+     * 8-bit codes map to values affinely, so blending codes equals blending
+     * values. The border goes through the inverse map unclamped, which keeps
+     * edge pixels identical to the float path.
+     */
+    args->border = (border - table[0]) / (table[1] - table[0]);
+    args->elem_bytes = 1;
+    return in_attr->dtype == U8 ? _WARP_NATIVE_U8 : _WARP_NATIVE_I8;
+} /* _get_native_mode() */
 
 /*
  * Kernel function
@@ -125,92 +299,75 @@ DEF_KERNEL_EXECUTOR(_compute)
     )
 {
     vsi_status status = VSI_FAILURE;
-    float* buffer[_CPU_IO_NUM] = { NULL };
+    void* buffer[_CPU_IO_NUM] = { NULL };
     vsi_nn_kernel_tensor_t tensors[_CPU_IO_NUM] = { NULL };
     vsi_nn_kernel_tensor_attr_t* attr[_CPU_IO_NUM] = { NULL };
-    int32_t type = 0;
-    float matrix[9] = {0};
+    _warp_args_t args;
     vsi_size_t i = 0;
-    vsi_size_t b = 0;
-    vsi_size_t x = 0;
-    vsi_size_t y = 0;
     vsi_size_t out_elements = 0;
-    vsi_size_t width = 0;
-    vsi_size_t height = 0;
     vsi_size_t outer_size = 1;
 
+    memset(&args, 0, sizeof(args));
     tensors[0] = (vsi_nn_kernel_tensor_t)param[0];
     tensors[1] = (vsi_nn_kernel_tensor_t)param[1];
 
     attr[0] = vsi_nn_kernel_tensor_attr_create( tensors[0] );
     attr[1] = vsi_nn_kernel_tensor_attr_create( tensors[1] );
+    CHECK_PTR_FAIL_GOTO( attr[0], "Create tensor attr buffer fail.", final );
+    CHECK_PTR_FAIL_GOTO( attr[1], "Create tensor attr buffer fail.", final );
 
     out_elements = vsi_nn_kernel_tensor_attr_get_size( attr[1] );
 
-    /* alloc the float32 data buffer */
-    buffer[1] = (float *)malloc(out_elements * sizeof(float));
-    CHECK_PTR_FAIL_GOTO( buffer[1], "Create input buffer fail.", final );
-    memset(buffer[1], 0, out_elements * sizeof(float));
-
-    buffer[0] = (float*)vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0], TRUE );
-    CHECK_PTR_FAIL_GOTO( buffer[0], "Create input buffer fail.", final );
-
     status = vsi_nn_kernel_scalar_read_int32((vsi_nn_kernel_scalar_t)param[SCALAR_INPUT_TYPE],
-        &type);
+        &args.type);
     CHECK_STATUS_FAIL_GOTO(status, final );
     for (i = 0; i < 9; i++)
     {
         status = vsi_nn_kernel_scalar_read_float32((vsi_nn_kernel_scalar_t)param[SCALAR_MATRIX_OFFSET + i],
-            &matrix[i]);
+            &args.matrix[i]);
         CHECK_STATUS_FAIL_GOTO(status, final );
     }
 
-    width = attr[1]->shape->data[0];
-    height = attr[1]->shape->data[1];
+    args.border = _WARP_BORDER_VALUE;
+    args.mode = _get_native_mode(attr[0], attr[1], args.type, &args);
+    if (args.mode == _WARP_FLOAT)
+    {
+        args.elem_bytes = sizeof(float);
+    }
+
+    /* Native modes keep the tensor data as is, no float round trip. */
+    buffer[1] = malloc(out_elements * args.elem_bytes);
+    CHECK_PTR_FAIL_GOTO( buffer[1], "Create output buffer fail.", final );
+    memset(buffer[1], 0, out_elements * args.elem_bytes);
+
+    buffer[0] = vsi_nn_kernel_tensor_create_buffer( tensors[0], attr[0],
+        args.mode == _WARP_FLOAT );
+    CHECK_PTR_FAIL_GOTO( buffer[0], "Create input buffer fail.", final );
+
+    args.src = buffer[0];
+    args.dst = buffer[1];
+    args.in_width = attr[0]->shape->data[0];
+    args.in_height = attr[0]->shape->data[1];
+    args.width = attr[1]->shape->data[0];
+    args.height = attr[1]->shape->data[1];
     for(i = 2; i < (vsi_size_t)attr[1]->shape->size; ++i)
     {
         outer_size *= attr[1]->shape->data[i];
     }
-    // Do something
-    for (b = 0; b < outer_size; b++)
-    {
-        float *src_base = buffer[0] + b * attr[0]->shape->data[0] * attr[0]->shape->data[1];
-        float *dst_base = buffer[1] + b * width * height;
-        for (y = 0; y < height; y++)
-        {
-            for (x = 0; x < width; x++)
-            {
-                float xf = 0;
-                float yf = 0;
-                float dst = 0;
 
-                _transform_perspective(x, y, matrix, &xf, &yf);
-                if (type == VSI_NN_INTERPOLATION_NEAREST_NEIGHBOR)
-                {
-                    _read_pixel(src_base, attr[0], xf, yf, &dst);
-                    dst_base[y * width + x] = dst;
-                }
-                else
-                {
-                    float tl = 0, tr = 0, bl = 0, br = 0;
-                    float ar = xf - floorf(xf);
-                    float ab = yf - floorf(yf);
-                    float al = 1.0f - ar;
-                    float at = 1.0f - ab;
-
-                    _read_pixel(src_base, attr[0], floorf(xf), floorf(yf), &tl);
-                    _read_pixel(src_base, attr[0], floorf(xf) + 1, floorf(yf), &tr);
-                    _read_pixel(src_base, attr[0], floorf(xf), floorf(yf) + 1, &bl);
-                    _read_pixel(src_base, attr[0], floorf(xf) + 1, floorf(yf) + 1, &br);
-
-                    dst_base[y * width + x] = tl * al * at + tr * ar * at + bl * al * ab + br * ar * ab;
-                }
-            }
-        }
-    }
+    vsi_nn_kernel_cpu_parallel_for( outer_size * args.height,
+        vsi_nn_max( 1, 4096 / args.width ), _warp_rows, &args );
 
-    status = vsi_nn_kernel_tensor_write_from_float( tensors[1], attr[1],
-            buffer[1], out_elements );
+    if (args.mode == _WARP_FLOAT)
+    {
+        status = vsi_nn_kernel_tensor_write_from_float( tensors[1], attr[1],
+                (float *)buffer[1], out_elements );
+    }
+    else
+    {
+        status = vsi_nn_kernel_tensor_write( tensors[1], attr[1],
+                buffer[1], out_elements * args.elem_bytes );
+    }
     CHECK_STATUS_FAIL_GOTO( status, final );
 final:
     for( i = 0; i < _CPU_IO_NUM; i ++ )
@@ -0,0 +1,636 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+
+#include <string.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "vsi_nn_types.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_error.h"
+#include "vsi_nn_node.h"
+#include "vsi_nn_prv.h"
+#include "vsi_nn_ops.h"
+#include "vsi_nn_tensor.h"
+#include "vsi_nn_tensor_util.h"
+#include "vsi_nn_internal_node.h"
+#include "utils/vsi_nn_util.h"
+#include "utils/vsi_nn_dtype_util.h"
+#include "kernel/vsi_nn_kernel.h"
+
+typedef struct _custom_scaled_dot_product_attention_local_data_t {
+    vsi_bool use_internal_node;
+    /* [tile, tile] upper triangle of the causal mask, shared by all tiles */
+    vsi_nn_tensor_t * causal_block;
+} custom_scaled_dot_product_attention_local_data_t;
+
+/*
+ Declare number of input and output.
+ */
+#define _INPUT_NUM          (4)
+#define _OUTPUT_NUM         (1)
+
+#define _QUERY              (0)
+#define _KEY                (1)
+#define _VALUE              (2)
+#define _MASK               (3)
+
+/* Scores of one fallback tile are kept under this many elements */
+#define _TILE_SCORE_BUDGET  (1 << 20)
+#define _MIN_QUERY_TILE     (16)
+/* Finite so that F16 intermediates stay finite */
+#define _MASKED_SCORE       (-65504.0f)
+
+static vsi_bool _is_float
+    (
+    vsi_nn_tensor_t * tensor
+    )
+{
+    return tensor->attr.dtype.qnt_type == VSI_NN_QNT_TYPE_NONE &&
+        ( tensor->attr.dtype.vx_type == VSI_NN_TYPE_FLOAT16 ||
+          tensor->attr.dtype.vx_type == VSI_NN_TYPE_FLOAT32 );
+} /* _is_float() */
+
+static float _get_scale
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs
+    )
+{
+    float scale = self->nn_param.custom_scaled_dot_product_attention.scale;
+
+    if ( scale == 0.0f )
+    {
+        scale = 1.0f / sqrtf( (float)inputs[_QUERY]->attr.size[0] );
+    }
+    return scale;
+} /* _get_scale() */
+
+static uint32_t _get_query_tile
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs
+    )
+{
+    uint32_t q_len = (uint32_t)inputs[_QUERY]->attr.size[1];
+    uint32_t tile = self->nn_param.custom_scaled_dot_product_attention.query_tile;
+    vsi_size_t row = inputs[_KEY]->attr.size[1];
+    uint32_t i = 0;
+
+    if ( 0 == tile )
+    {
+        for ( i = 2; i < inputs[_QUERY]->attr.dim_num; i++ )
+        {
+            row *= inputs[_QUERY]->attr.size[i];
+        }
+        tile = (uint32_t)vsi_nn_max( _MIN_QUERY_TILE,
+            _TILE_SCORE_BUDGET / vsi_nn_max( row, 1 ) );
+    }
+    return vsi_nn_min( tile, q_len );
+} /* _get_query_tile() */
+
+static vsi_nn_tensor_t * _new_tensor
+    (
+    vsi_nn_node_t * self,
+    const vsi_nn_dtype_t * dtype
+    )
+{
+    vsi_nn_tensor_attr_t attr;
+
+    vsi_nn_internal_init_tensor_attr( &attr, dtype, TRUE );
+    return vsi_nn_internal_new_tensor( self, &attr, 0.0f )->t;
+} /* _new_tensor() */
+
+static vsi_nn_tensor_t * _convert
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t * input,
+    const vsi_nn_dtype_t * dtype
+    )
+{
+    vsi_nn_internal_node_t * curr = NULL;
+    vsi_nn_tensor_t * output = NULL;
+
+    if ( input->attr.dtype.vx_type == dtype->vx_type &&
+         input->attr.dtype.qnt_type == dtype->qnt_type )
+    {
+        return input;
+    }
+    output = _new_tensor( self, dtype );
+    curr = vsi_nn_internal_new_node( self, VSI_NN_OP_DATACONVERT, 0, 0 );
+    curr->inputs[0] = input;
+    curr->outputs[0] = output;
+    vsi_nn_internal_setup_node( self, curr );
+    return output;
+} /* _convert() */
+
+/* Slice [start, start + length) of dims 0 and 1, keep the outer dims */
+static vsi_nn_tensor_t * _slice
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t * input,
+    uint32_t start0,
+    uint32_t length0,
+    uint32_t start1,
+    uint32_t length1
+    )
+{
+    vsi_nn_internal_node_t * curr = NULL;
+    vsi_nn_tensor_t * output = NULL;
+    uint32_t * start = NULL;
+    uint32_t * length = NULL;
+    uint32_t dim_num = (uint32_t)input->attr.dim_num;
+    uint32_t i = 0;
+
+    if ( start0 == 0 && length0 == input->attr.size[0] &&
+         start1 == 0 && length1 == input->attr.size[1] )
+    {
+        return input;
+    }
+    output = _new_tensor( self, &input->attr.dtype );
+    curr = vsi_nn_internal_new_node( self, VSI_NN_OP_SLICE, 0, 0 );
+    start = (uint32_t *)vsi_nn_internal_new_node_param( curr,
+        sizeof(uint32_t) * dim_num );
+    length = (uint32_t *)vsi_nn_internal_new_node_param( curr,
+        sizeof(uint32_t) * dim_num );
+    for ( i = 0; i < dim_num; i++ )
+    {
+        start[i] = 0;
+        length[i] = (uint32_t)input->attr.size[i];
+    }
+    start[0] = start0;
+    length[0] = length0;
+    start[1] = start1;
+    length[1] = length1;
+    curr->node->nn_param.slice.dims = dim_num;
+    curr->node->nn_param.slice.start = start;
+    curr->node->nn_param.slice.length = length;
+    curr->inputs[0] = input;
+    curr->outputs[0] = output;
+    vsi_nn_internal_setup_node( self, curr );
+    return output;
+} /* _slice() */
+
+static vsi_nn_tensor_t * _binary
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_op_t op,
+    vsi_nn_tensor_t * input0,
+    vsi_nn_tensor_t * input1,
+    vsi_nn_tensor_t * output,
+    vsi_bool transpose_b
+    )
+{
+    vsi_nn_internal_node_t * curr = NULL;
+
+    if ( NULL == output )
+    {
+        output = _new_tensor( self, &input0->attr.dtype );
+    }
+    curr = vsi_nn_internal_new_node( self, op, 0, 0 );
+    if ( VSI_NN_OP_MATRIXMUL == op )
+    {
+        curr->node->nn_param.matrixmul.transpose[1] = transpose_b;
+    }
+    curr->inputs[0] = input0;
+    curr->inputs[1] = input1;
+    curr->outputs[0] = output;
+    vsi_nn_internal_setup_node( self, curr );
+    return output;
+} /* _binary() */
+
+static vsi_status _create_causal_block
+    (
+    vsi_nn_node_t * self,
+    uint32_t dim_num,
+    uint32_t tile,
+    const vsi_nn_dtype_t * dtype
+    )
+{
+    custom_scaled_dot_product_attention_local_data_t * local =
+        self->nn_param.custom_scaled_dot_product_attention.local;
+    vsi_nn_tensor_attr_t attr;
+    uint32_t stride = vsi_nn_TypeGetBytes( dtype->vx_type );
+    uint8_t * data = NULL;
+    uint32_t i = 0;
+    uint32_t j = 0;
+
+    data = (uint8_t *)malloc( (size_t)tile * tile * stride );
+    CHECK_PTR_FAIL_GOTO( data, "Create buffer fail.", final );
+    for ( j = 0; j < tile; j++ )
+    {
+        for ( i = 0; i < tile; i++ )
+        {
+            vsi_nn_Float32ToDtype( i > j ? _MASKED_SCORE : 0.0f,
+                &data[(j * tile + i) * stride], dtype );
+        }
+    }
+
+    memset( &attr, 0, sizeof(attr) );
+    attr.dim_num = dim_num;
+    for ( i = 0; i < dim_num; i++ )
+    {
+        attr.size[i] = 1;
+    }
+    attr.size[0] = tile;
+    attr.size[1] = tile;
+    attr.is_const = TRUE;
+    attr.vtl = FALSE;
+    memcpy( &attr.dtype, dtype, sizeof(vsi_nn_dtype_t) );
+    local->causal_block = vsi_nn_CreateTensorFromData( self->graph, data, &attr );
+
+final:
+    vsi_nn_safe_free( data );
+    return local->causal_block ? VSI_SUCCESS : VSI_FAILURE;
+} /* _create_causal_block() */
+
+/* Causal mask of the last rows of a tile over keys [0, keys) */
+static vsi_nn_tensor_t * _causal_tile
+    (
+    vsi_nn_node_t * self,
+    uint32_t rows,
+    uint32_t keys
+    )
+{
+    custom_scaled_dot_product_attention_local_data_t * local =
+        self->nn_param.custom_scaled_dot_product_attention.local;
+    vsi_nn_tensor_t * block = local->causal_block;
+    vsi_nn_internal_node_t * curr = NULL;
+    vsi_nn_tensor_t * output = NULL;
+    uint32_t * front = NULL;
+    uint32_t * back = NULL;
+    uint32_t dim_num = (uint32_t)block->attr.dim_num;
+
+    block = _slice( self, block, 0, rows, 0, rows );
+    if ( keys == rows )
+    {
+        return block;
+    }
+    /* Keys before the diagonal block are all visible */
+    output = _new_tensor( self, &block->attr.dtype );
+    curr = vsi_nn_internal_new_node( self, VSI_NN_OP_PAD, 0, 0 );
+    front = (uint32_t *)vsi_nn_internal_new_node_param( curr, sizeof(uint32_t) * dim_num );
+    back = (uint32_t *)vsi_nn_internal_new_node_param( curr, sizeof(uint32_t) * dim_num );
+    memset( front, 0, sizeof(uint32_t) * dim_num );
+    memset( back, 0, sizeof(uint32_t) * dim_num );
+    front[0] = keys - rows;
+    curr->node->nn_param.pad.front_size = front;
+    curr->node->nn_param.pad.back_size = back;
+    curr->node->nn_param.pad.dim_num = (uint8_t)dim_num;
+    curr->node->nn_param.pad.const_val = 0;
+    curr->node->nn_param.pad.mode = VSI_NN_PAD_MODE_CONSTANT;
+    curr->inputs[0] = block;
+    curr->outputs[0] = output;
+    vsi_nn_internal_setup_node( self, curr );
+    return output;
+} /* _causal_tile() */
+
+/*
+ * Lower to Matmul/Softmax over tiles of query rows, only one tile of
+ * scores is live at a time. A causal tile stops at its last visible key.
+ */
+static vsi_bool _setup_internal
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs,
+    vsi_nn_tensor_t ** outputs
+    )
+{
+    vsi_nn_custom_scaled_dot_product_attention_param * p =
+        &self->nn_param.custom_scaled_dot_product_attention;
+    vsi_nn_internal_node_t * curr = NULL;
+    vsi_nn_tensor_t ** tiles = NULL;
+    vsi_nn_tensor_t * query = NULL;
+    vsi_nn_tensor_t * key = NULL;
+    vsi_nn_tensor_t * value = NULL;
+    vsi_nn_tensor_t * mask = inputs[_MASK];
+    vsi_nn_dtype_t dtype;
+    uint32_t q_len = (uint32_t)inputs[_QUERY]->attr.size[1];
+    uint32_t kv_len = (uint32_t)inputs[_KEY]->attr.size[1];
+    uint32_t offset = kv_len - q_len;
+    uint32_t tile = _get_query_tile( self, inputs );
+    uint32_t tile_num = (q_len + tile - 1) / tile;
+    uint32_t row = 0;
+    uint32_t t = 0;
+    vsi_bool ret = FALSE;
+
+    memset( &dtype, 0, sizeof(dtype) );
+    dtype.qnt_type = VSI_NN_QNT_TYPE_NONE;
+    dtype.vx_type = inputs[_QUERY]->attr.dtype.vx_type == VSI_NN_TYPE_FLOAT32 ?
+        VSI_NN_TYPE_FLOAT32 : VSI_NN_TYPE_FLOAT16;
+
+    if ( p->causal && VSI_SUCCESS != _create_causal_block( self,
+            (uint32_t)inputs[_QUERY]->attr.dim_num, tile, &dtype ) )
+    {
+        return FALSE;
+    }
+
+    /* Scale the queries once instead of every score tile */
+    query = _new_tensor( self, &dtype );
+    curr = vsi_nn_internal_new_node( self, VSI_NN_OP_LINEAR, 0, 0 );
+    curr->node->nn_param.linear.a = _get_scale( self, inputs );
+    curr->node->nn_param.linear.b = 0.0f;
+    curr->inputs[0] = inputs[_QUERY];
+    curr->outputs[0] = query;
+    vsi_nn_internal_setup_node( self, curr );
+
+    key = _convert( self, inputs[_KEY], &dtype );
+    value = _convert( self, inputs[_VALUE], &dtype );
+    if ( mask )
+    {
+        mask = _convert( self, mask, &dtype );
+    }
+
+    tiles = (vsi_nn_tensor_t **)malloc( sizeof(vsi_nn_tensor_t *) * tile_num );
+    CHECK_PTR_FAIL_GOTO( tiles, "Create buffer fail.", final );
+
+    for ( t = 0; t < tile_num; t++ )
+    {
+        uint32_t rows = vsi_nn_min( tile, q_len - row );
+        uint32_t keys = p->causal ? vsi_nn_min( kv_len, row + rows + offset ) : kv_len;
+        vsi_nn_tensor_t * scores = NULL;
+        vsi_nn_tensor_t * probs = NULL;
+
+        scores = _binary( self, VSI_NN_OP_MATRIXMUL,
+            _slice( self, query, 0, (uint32_t)query->attr.size[0], row, rows ),
+            _slice( self, key, 0, (uint32_t)inputs[_KEY]->attr.size[0], 0, keys ),
+            NULL, TRUE );
+        if ( mask )
+        {
+            uint32_t mask_rows = (uint32_t)inputs[_MASK]->attr.size[1];
+            scores = _binary( self, VSI_NN_OP_ADD, scores,
+                _slice( self, mask, 0, keys,
+                    mask_rows == 1 ? 0 : row, mask_rows == 1 ? 1 : rows ),
+                NULL, FALSE );
+        }
+        if ( p->causal )
+        {
+            scores = _binary( self, VSI_NN_OP_ADD, scores,
+                _causal_tile( self, rows, keys ), NULL, FALSE );
+        }
+
+        probs = _new_tensor( self, &dtype );
+        curr = vsi_nn_internal_new_node( self, VSI_NN_OP_SOFTMAX, 0, 0 );
+        curr->node->nn_param.softmax.beta = 1.0f;
+        curr->node->nn_param.softmax.axis = 0;
+        curr->inputs[0] = scores;
+        curr->outputs[0] = probs;
+        vsi_nn_internal_setup_node( self, curr );
+
+        tiles[t] = _binary( self, VSI_NN_OP_MATRIXMUL, probs,
+            _slice( self, value, 0, (uint32_t)inputs[_VALUE]->attr.size[0], 0, keys ),
+            tile_num == 1 ? outputs[0] : _new_tensor( self, &dtype ), FALSE );
+        row += rows;
+    }
+
+    if ( tile_num > 1 )
+    {
+        curr = vsi_nn_internal_new_node( self, VSI_NN_OP_CONCAT, tile_num, 1 );
+        curr->node->nn_param.concat.axis = 1;
+        for ( t = 0; t < tile_num; t++ )
+        {
+            curr->inputs[t] = tiles[t];
+        }
+        curr->outputs[0] = outputs[0];
+        vsi_nn_internal_setup_node( self, curr );
+    }
+    ret = TRUE;
+
+final:
+    vsi_nn_safe_free( tiles );
+    return ret;
+} /* _setup_internal() */
+
+static vsi_status op_compute
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs,
+    vsi_nn_tensor_t ** outputs
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_param_t * param = NULL;
+    vsi_nn_kernel_node_t n = NULL;
+    vsi_nn_custom_scaled_dot_product_attention_param * p =
+        &self->nn_param.custom_scaled_dot_product_attention;
+
+    if ( p->local->use_internal_node )
+    {
+        return vsi_nn_internal_compute_node( self );
+    }
+
+    param = vsi_nn_kernel_param_create();
+    vsi_nn_kernel_param_add_float32( param, "scale", _get_scale( self, inputs ) );
+    vsi_nn_kernel_param_add_int32( param, "causal", p->causal );
+
+    n = vsi_nn_kernel_selector( self->graph,
+            "custom_scaled_dot_product_attention",
+            inputs, _INPUT_NUM,
+            outputs, _OUTPUT_NUM, param );
+    if ( n != NULL )
+    {
+        self->n = (vx_node)n;
+        status = VSI_SUCCESS;
+    }
+
+    vsi_nn_kernel_param_release( &param );
+
+    return status;
+} /* op_compute() */
+
+static vsi_bool op_check
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs,
+    vsi_nn_tensor_t ** outputs
+    )
+{
+    vsi_nn_tensor_t * query = inputs[_QUERY];
+    vsi_nn_tensor_t * key = inputs[_KEY];
+    vsi_nn_tensor_t * value = inputs[_VALUE];
+    vsi_nn_tensor_t * mask = inputs[_MASK];
+    uint32_t i = 0;
+
+    if ( query->attr.dim_num < 2 || query->attr.dim_num > 4 ||
+         key->attr.dim_num != query->attr.dim_num ||
+         value->attr.dim_num != query->attr.dim_num )
+    {
+        VSILOGE("Query, key and value need the same rank in [2, 4]");
+        return FALSE;
+    }
+    if ( key->attr.size[0] != query->attr.size[0] ||
+         value->attr.size[1] != key->attr.size[1] )
+    {
+        VSILOGE("Head size or sequence length mismatch");
+        return FALSE;
+    }
+    for ( i = 2; i < query->attr.dim_num; i++ )
+    {
+        if ( key->attr.size[i] != query->attr.size[i] ||
+             value->attr.size[i] != query->attr.size[i] )
+        {
+            VSILOGE("Outer dim %u of query, key and value differs", i);
+            return FALSE;
+        }
+    }
+    if ( self->nn_param.custom_scaled_dot_product_attention.causal &&
+         key->attr.size[1] < query->attr.size[1] )
+    {
+        VSILOGE("Causal attention needs at least as many keys as queries");
+        return FALSE;
+    }
+    if ( mask )
+    {
+        if ( mask->attr.dim_num > query->attr.dim_num ||
+             mask->attr.size[0] != key->attr.size[1] ||
+             ( mask->attr.dim_num > 1 && mask->attr.size[1] != 1 &&
+               mask->attr.size[1] != query->attr.size[1] ) )
+        {
+            VSILOGE("Mask must be [kv_len, q_len or 1, ...]");
+            return FALSE;
+        }
+        for ( i = 2; i < mask->attr.dim_num; i++ )
+        {
+            if ( mask->attr.size[i] != 1 &&
+                 mask->attr.size[i] != query->attr.size[i] )
+            {
+                VSILOGE("Mask dim %u does not broadcast", i);
+                return FALSE;
+            }
+        }
+    }
+    return TRUE;
+} /* op_check() */
+
+static vsi_bool op_setup
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs,
+    vsi_nn_tensor_t ** outputs
+    )
+{
+    custom_scaled_dot_product_attention_local_data_t * local =
+        self->nn_param.custom_scaled_dot_product_attention.local;
+    vsi_bool use_kernel = FALSE;
+
+    if ( VSI_NN_DIM_AUTO == outputs[0]->attr.dim_num )
+    {
+        outputs[0]->attr.dim_num = inputs[_QUERY]->attr.dim_num;
+        memmove( outputs[0]->attr.size, inputs[_QUERY]->attr.size,
+            inputs[_QUERY]->attr.dim_num * sizeof(vsi_size_t) );
+        outputs[0]->attr.size[0] = inputs[_VALUE]->attr.size[0];
+    }
+
+    /*
+     * The kernels compute in float. Quantized graphs keep the work on the
+     * NN engine through the decomposition, as do graphs without shaders,
+     * where only the CPU kernel would be left.
+     */
+    use_kernel = self->graph->ctx->options.enable_shader &&
+        _is_float( inputs[_QUERY] ) && _is_float( inputs[_KEY] ) &&
+        _is_float( inputs[_VALUE] ) && _is_float( outputs[0] ) &&
+        ( NULL == inputs[_MASK] || _is_float( inputs[_MASK] ) );
+
+    vsi_nn_internal_init_node_wksp( self );
+    if ( use_kernel )
+    {
+        return TRUE;
+    }
+    local->use_internal_node = TRUE;
+    return _setup_internal( self, inputs, outputs );
+} /* op_setup() */
+
+static vsi_status op_init
+    (
+    vsi_nn_node_t * self
+    )
+{
+    vsi_nn_custom_scaled_dot_product_attention_param * p =
+        &self->nn_param.custom_scaled_dot_product_attention;
+
+    p->local = (custom_scaled_dot_product_attention_local_data_t *)
+        malloc( sizeof(custom_scaled_dot_product_attention_local_data_t) );
+    if ( NULL == p->local )
+    {
+        return VSI_FAILURE;
+    }
+    memset( p->local, 0, sizeof(custom_scaled_dot_product_attention_local_data_t) );
+    p->scale = 0.0f;
+    p->causal = FALSE;
+    p->query_tile = 0;
+
+    return VSI_SUCCESS;
+} /* op_init() */
+
+static vsi_status op_deinit
+    (
+    vsi_nn_node_t * self
+    )
+{
+    vsi_nn_custom_scaled_dot_product_attention_param * p =
+        &self->nn_param.custom_scaled_dot_product_attention;
+
+    if ( p->local && p->local->causal_block )
+    {
+        vsi_nn_ReleaseTensor( &p->local->causal_block );
+    }
+    vsi_nn_safe_free( p->local );
+    vsi_nn_internal_deinit_node_wksp( self );
+
+    return vsi_nn_op_common_deinit( self );
+} /* op_deinit() */
+
+static vsi_status op_optimize
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs,
+    vsi_nn_tensor_t ** outputs,
+    vsi_nn_opt_direction_e direction
+    )
+{
+    if ( self->nn_param.custom_scaled_dot_product_attention.local->use_internal_node )
+    {
+        return vsi_nn_internal_optimize_node( self, direction );
+    }
+    return VSI_SUCCESS;
+} /* op_optimize() */
+
+__BEGIN_DECLS
+
+/* Registrar */
+DEF_OP_REG
+    (
+    /* op_name    */ CUSTOM_SCALED_DOT_PRODUCT_ATTENTION,
+    /* init       */ op_init,
+    /* compute    */ op_compute,
+    /* deinit     */ op_deinit,
+    /* check      */ op_check,
+    /* setup      */ op_setup,
+    /* optimize   */ op_optimize,
+    /* input_num  */ _INPUT_NUM,
+    /* output_num */ _OUTPUT_NUM
+    );
+
+__END_DECLS
@@ -0,0 +1,174 @@
+/****************************************************************************
+*
+*    Copyright (c) 2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+
+#include <string.h>
+#include <stdlib.h>
+
+#include "vsi_nn_types.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_node.h"
+#include "vsi_nn_prv.h"
+#include "vsi_nn_ops.h"
+#include "vsi_nn_tensor.h"
+#include "vsi_nn_tensor_util.h"
+#include "utils/vsi_nn_util.h"
+#include "kernel/vsi_nn_kernel.h"
+
+/*
+ Declare number of input and output.
+ */
+#define _INPUT_NUM          (2)
+#define _OUTPUT_NUM         (1)
+
+static int32_t _get_axis
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** outputs
+    )
+{
+    int32_t axis = self->nn_param.custom_slice_update.axis;
+
+    return axis < 0 ? axis + (int32_t)outputs[0]->attr.dim_num : axis;
+} /* _get_axis() */
+
+static vsi_status op_compute
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs,
+    vsi_nn_tensor_t ** outputs
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_param_t * param = NULL;
+    vsi_nn_kernel_node_t n = NULL;
+
+    param = vsi_nn_kernel_param_create();
+    vsi_nn_kernel_param_add_int32( param, "axis", _get_axis( self, outputs ) );
+
+    n = vsi_nn_kernel_selector( self->graph,
+            "custom_slice_update",
+            inputs, _INPUT_NUM,
+            outputs, _OUTPUT_NUM, param );
+    if ( n != NULL )
+    {
+        self->n = (vx_node)n;
+        status = VSI_SUCCESS;
+    }
+
+    vsi_nn_kernel_param_release( &param );
+
+    return status;
+} /* op_compute() */
+
+static vsi_bool op_check
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs,
+    vsi_nn_tensor_t ** outputs
+    )
+{
+    int32_t axis = _get_axis( self, outputs );
+    uint32_t i = 0;
+
+    if ( VSI_NN_DIM_AUTO == outputs[0]->attr.dim_num )
+    {
+        VSILOGE("Slice update needs the shape of its output");
+        return FALSE;
+    }
+    if ( axis < 0 || axis >= (int32_t)outputs[0]->attr.dim_num ||
+         inputs[0]->attr.dim_num != outputs[0]->attr.dim_num )
+    {
+        VSILOGE("Invalid axis %d or rank mismatch",
+            self->nn_param.custom_slice_update.axis);
+        return FALSE;
+    }
+    for ( i = 0; i < outputs[0]->attr.dim_num; i++ )
+    {
+        if ( (int32_t)i == axis ? inputs[0]->attr.size[i] > outputs[0]->attr.size[i]
+                                : inputs[0]->attr.size[i] != outputs[0]->attr.size[i] )
+        {
+            VSILOGE("Update does not fit the output at dim %u", i);
+            return FALSE;
+        }
+    }
+    if ( inputs[1]->attr.dtype.vx_type != VSI_NN_TYPE_INT32 ||
+         vsi_nn_GetElementNum( inputs[1] ) != 1 )
+    {
+        VSILOGE("Start must be a single INT32 value");
+        return FALSE;
+    }
+    return TRUE;
+} /* op_check() */
+
+static vsi_bool op_setup
+    (
+    vsi_nn_node_t * self,
+    vsi_nn_tensor_t ** inputs,
+    vsi_nn_tensor_t ** outputs
+    )
+{
+    /* The output is the persistent tensor being updated, never inferred */
+    return VSI_NN_DIM_AUTO != outputs[0]->attr.dim_num;
+} /* op_setup() */
+
+static vsi_status op_init
+    (
+    vsi_nn_node_t * self
+    )
+{
+    self->nn_param.custom_slice_update.axis = 1;
+
+    return VSI_SUCCESS;
+} /* op_init() */
+
+static vsi_status op_deinit
+    (
+    vsi_nn_node_t* self
+    )
+{
+    vsi_status status = VSI_SUCCESS;
+
+    status = vsi_nn_op_common_deinit(self);
+
+    return status;
+} /* op_deinit() */
+
+__BEGIN_DECLS
+
+/* Registrar */
+DEF_OP_REG
+    (
+    /* op_name    */ CUSTOM_SLICE_UPDATE,
+    /* init       */ op_init,
+    /* compute    */ op_compute,
+    /* deinit     */ op_deinit,
+    /* check      */ op_check,
+    /* setup      */ op_setup,
+    /* optimize   */ NULL,
+    /* input_num  */ _INPUT_NUM,
+    /* output_num */ _OUTPUT_NUM
+    );
+
+__END_DECLS
@@ -37,6 +37,7 @@
 #include "vsi_nn_tensor_util.h"
 #include "utils/vsi_nn_dtype_util.h"
 #include "vsi_nn_tensor_util_prv.h"
+#include "vsi_nn_types_prv.h"
 
 #include "libnnext/vsi_nn_libnnext_resource.h"
 #if VSI_USE_VXC_BINARY
@@ -1159,6 +1160,36 @@ void vsi_nn_kernel_reset
     }
 } /* vsi_nn_kernel_reset() */
 
+/*
+ * Move the allowed kernel types set in `preferred` ahead of the others,
+ * keeping the relative order, so unsupported preferences still fall back.
+ */
+static void _kernel_selector_prefer
+    (
+    vsi_nn_kernel_selector_t * selector,
+    int32_t preferred
+    )
+{
+    vsi_nn_kernel_pirority_t sorted[VSI_NN_KERNEL_TYPE_NUM];
+    int32_t i;
+    int32_t n = 0;
+    for( i = 0; i < selector->allow_kernel_num; i ++ )
+    {
+        if( preferred & (1 << selector->pirority[i].kernel_type) )
+        {
+            sorted[n ++] = selector->pirority[i];
+        }
+    }
+    for( i = 0; i < selector->allow_kernel_num; i ++ )
+    {
+        if( !(preferred & (1 << selector->pirority[i].kernel_type)) )
+        {
+            sorted[n ++] = selector->pirority[i];
+        }
+    }
+    memcpy( selector->pirority, sorted, n * sizeof(vsi_nn_kernel_pirority_t) );
+} /* _kernel_selector_prefer() */
+
 vsi_nn_kernel_node_t vsi_nn_kernel_selector
     (
     vsi_nn_graph_t* graph,
@@ -1174,6 +1205,7 @@ vsi_nn_kernel_node_t vsi_nn_kernel_selector
     vsi_nn_kernel_t * kernel;
     const vsi_nn_kernel_backend_t* backend;
     vsi_nn_kernel_selector_t selector;
+    vsi_nn_node_t* compute_node = NULL;
     vsi_status status = VSI_SUCCESS;
     if( !kernel_name )
     {
@@ -1216,6 +1248,12 @@ vsi_nn_kernel_node_t vsi_nn_kernel_selector
         vsi_nn_kernel_pirority_set( &selector,
                 default_pirority, _cnt_of_array(default_pirority) );
     }
+    compute_node = ((vsi_nn_graph_prv_t*)graph)->compute_node;
+    if( compute_node && compute_node->attr.preferred_kernel_types )
+    {
+        _kernel_selector_prefer( &selector,
+                compute_node->attr.preferred_kernel_types );
+    }
     /**
      * All kernels for one operation will share the same id.
      */
@@ -1264,6 +1302,10 @@ vsi_nn_kernel_node_t vsi_nn_kernel_selector
             {
                 VSILOGD("Instance %s node with kernel \"%s\" ",
                     vsi_nn_kernel_type_str(type), kernel_name);
+                if( compute_node )
+                {
+                    compute_node->attr.selected_kernel_types |= (int32_t)(1 << type);
+                }
                 break;
             }
         }
@@ -1534,6 +1576,11 @@ vsi_nn_kernel_t * vsi_nn_KernelCreate(vsi_nn_kernel_type_e type)
     return vsi_nn_kernel_create(type);
 }/* vsi_nn_KernelCreate() */
 
+void vsi_nn_KernelRelease(vsi_nn_kernel_t ** kernel)
+{
+    vsi_nn_kernel_release(kernel);
+}/* vsi_nn_KernelRelease() */
+
 void vsi_nn_kernel_add_source_internal
     (
         vsi_nn_kernel_t * kernel,
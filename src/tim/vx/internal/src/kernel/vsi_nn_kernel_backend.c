@@ -30,23 +30,24 @@
 #include "vsi_nn_ops.h"
 #include "kernel/vsi_nn_kernel.h"
 #include "utils/vsi_nn_hashmap.h"
+#include "utils/vsi_nn_rwlock.h"
 
-static vsi_nn_kernel_unique_id_t _global_id()
-    {
-        static vsi_nn_kernel_unique_id_t global_id = 0;
-        return global_id ++;
-    } /* _global_id() */
+/* Guards s_backends, see vsi_nn_rwlock.h */
+static vsi_nn_rwlock_t s_backends_lock = VSI_NN_RWLOCK_INITIALIZER;
+static vsi_nn_hashmap_t* s_backends = NULL;
+static vsi_nn_kernel_unique_id_t s_global_id = 0;
 
+/* Caller holds s_backends_lock for writing */
 static vsi_nn_hashmap_t* _backends()
     {
-        static vsi_nn_hashmap_t* backends = NULL;
-        if( !backends )
+        if( !s_backends )
         {
-            backends = vsi_nn_hashmap_create();
+            s_backends = vsi_nn_hashmap_create();
         }
-        return backends;
+        return s_backends;
     } /* _backends() */
 
+/* Caller holds s_backends_lock for writing */
 static vsi_nn_kernel_backend_t* _get_or_new_backend
     ( const char* kernel_name )
 {
@@ -66,7 +67,7 @@ static vsi_nn_kernel_backend_t* _get_or_new_backend
         }
         memset( backend, 0, sizeof(vsi_nn_kernel_backend_t) );
         vsi_nn_hashmap_add( backends, kernel_name, backend );
-        backend->unique_id = _global_id();
+        backend->unique_id = s_global_id ++;
     }
     return backend;
 } /* _get_or_new_backend() */
@@ -79,6 +80,7 @@ void vsi_nn_kernel_backend_register
     )
 {
     vsi_nn_kernel_backend_t* backend = NULL;
+    vsi_nn_rwlock_wrlock( &s_backends_lock );
     backend = _get_or_new_backend( kernel_name );
     VSI_ASSERT( backend != NULL );
     if( backend->setup[kernel_type] )
@@ -87,6 +89,7 @@ void vsi_nn_kernel_backend_register
         VSI_ASSERT( FALSE );
     }
     backend->setup[kernel_type] = setup_func;
+    vsi_nn_rwlock_wrunlock( &s_backends_lock );
 } /* vsi_nn_register_backend() */
 
 void vsi_nn_kernel_selector_register
@@ -96,24 +99,32 @@ void vsi_nn_kernel_selector_register
     )
 {
     vsi_nn_kernel_backend_t* backend = NULL;
+    vsi_nn_rwlock_wrlock( &s_backends_lock );
     backend = _get_or_new_backend( kernel_name );
     VSI_ASSERT( backend != NULL );
     backend->select = selector_func;
+    vsi_nn_rwlock_wrunlock( &s_backends_lock );
 } /* vsi_nn_kernel_selector_register() */
 
 const vsi_nn_kernel_backend_t* vsi_nn_kernel_backend_get( const char* key )
 {
-    vsi_nn_hashmap_t* backends = _backends();
     const vsi_nn_kernel_backend_t* backend = NULL;
-    backend = (const vsi_nn_kernel_backend_t*)vsi_nn_hashmap_get( backends, key );
+    /* Backends are never removed before deinit, the returned pointer stays
+     * valid after the lock is released. */
+    vsi_nn_rwlock_rdlock( &s_backends_lock );
+    backend = (const vsi_nn_kernel_backend_t*)vsi_nn_hashmap_get( s_backends, key );
+    vsi_nn_rwlock_rdunlock( &s_backends_lock );
     return backend;
 } /* vsi_nn_backend_get() */
 
 vsi_status vsi_nn_kernel_backend_init( void )
 {
     vsi_status status = VSI_SUCCESS;
-    // TODO: Multi-thread support
-    if( _backends() != NULL )
+    vsi_nn_hashmap_t* backends = NULL;
+    vsi_nn_rwlock_wrlock( &s_backends_lock );
+    backends = _backends();
+    vsi_nn_rwlock_wrunlock( &s_backends_lock );
+    if( backends != NULL )
     {
         return status;
     }
@@ -140,15 +151,17 @@ vsi_status vsi_nn_kernel_backend_init( void )
 
 void vsi_nn_kernel_backend_deinit()
 {
-    vsi_nn_hashmap_t* backends = _backends();
-    vsi_nn_hashmap_item_t* p = vsi_nn_hashmap_iter( backends, NULL );
+    vsi_nn_hashmap_item_t* p = NULL;
     vsi_nn_hashmap_item_t* next;
+    vsi_nn_rwlock_wrlock( &s_backends_lock );
+    p = vsi_nn_hashmap_iter( s_backends, NULL );
     while( p )
     {
-        next = vsi_nn_hashmap_iter( backends, p );
+        next = vsi_nn_hashmap_iter( s_backends, p );
         free( p->data );
         p = next;
     }
-    vsi_nn_hashmap_release( &backends );
+    vsi_nn_hashmap_release( &s_backends );
+    vsi_nn_rwlock_wrunlock( &s_backends_lock );
 } /* vsi_nn_kernel_backend_deinit() */
 
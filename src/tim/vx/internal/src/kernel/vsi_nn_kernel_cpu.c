@@ -0,0 +1,322 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "vsi_nn_types.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_error.h"
+#include "utils/vsi_nn_util.h"
+#include "kernel/vsi_nn_kernel.h"
+#include "kernel/vsi_nn_kernel_cpu.h"
+
+#if !(defined(_MSC_VER) || defined(_WIN32) || defined(__MINGW32))
+#include <pthread.h>
+#include <unistd.h>
+#define _CPU_POOL_ENABLED   (1)
+#endif
+
+#define _CPU_MAX_THREAD_NUM (64)
+/* Ranges handed out per thread, more ranges balance uneven rows better. */
+#define _CPU_RANGES_PER_THREAD (4)
+
+#ifdef _CPU_POOL_ENABLED
+typedef struct
+{
+    pthread_mutex_t mutex;
+    pthread_cond_t job_cond;
+    pthread_cond_t done_cond;
+    uint32_t thread_num;
+    uint64_t generation;
+    vsi_nn_kernel_cpu_task_t task;
+    void * user_data;
+    vsi_size_t total;
+    vsi_size_t chunk;
+    vsi_size_t next;
+    vsi_size_t running;
+} _cpu_pool_t;
+
+static _cpu_pool_t s_pool =
+{
+    PTHREAD_MUTEX_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    PTHREAD_COND_INITIALIZER,
+    1, 0, NULL, NULL, 0, 0, 0, 0
+};
+static pthread_once_t s_pool_once = PTHREAD_ONCE_INIT;
+/* One job at a time, callers that find the pool busy run inline. */
+static pthread_mutex_t s_submit_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* Called with s_pool.mutex held, returns with it held. */
+static void _run_ranges_locked
+    ( void )
+{
+    while ( s_pool.next < s_pool.total )
+    {
+        vsi_nn_kernel_cpu_task_t task = s_pool.task;
+        void * user_data = s_pool.user_data;
+        vsi_size_t begin = s_pool.next;
+        vsi_size_t end = vsi_nn_min( begin + s_pool.chunk, s_pool.total );
+
+        s_pool.next = end;
+        s_pool.running ++;
+        pthread_mutex_unlock( &s_pool.mutex );
+        task( begin, end, user_data );
+        pthread_mutex_lock( &s_pool.mutex );
+        s_pool.running --;
+    }
+    if ( 0 == s_pool.running )
+    {
+        pthread_cond_broadcast( &s_pool.done_cond );
+    }
+} /* _run_ranges_locked() */
+
+static void * _worker
+    ( void * arg )
+{
+    uint64_t seen = 0;
+
+    (void)arg;
+    pthread_mutex_lock( &s_pool.mutex );
+    for ( ;; )
+    {
+        while ( seen == s_pool.generation )
+        {
+            pthread_cond_wait( &s_pool.job_cond, &s_pool.mutex );
+        }
+        seen = s_pool.generation;
+        _run_ranges_locked();
+    }
+    return NULL;
+} /* _worker() */
+
+static void _create_pool
+    ( void )
+{
+    char * env_s = NULL;
+    long thread_num = sysconf( _SC_NPROCESSORS_ONLN );
+    uint32_t i = 0;
+
+    env_s = vsi_nn_getenv( "VSI_NN_CPU_THREAD_NUM" );
+    if ( env_s )
+    {
+        thread_num = atol( env_s );
+    }
+    thread_num = vsi_nn_clamp( thread_num, 1, _CPU_MAX_THREAD_NUM );
+
+    /* The calling thread takes work too, so spawn one less. */
+    for ( i = 1; i < (uint32_t)thread_num; i ++ )
+    {
+        pthread_t thread;
+        if ( 0 != pthread_create( &thread, NULL, _worker, NULL ) )
+        {
+            VSILOGW("Create cpu kernel worker fail, use %u threads.", i);
+            break;
+        }
+        pthread_detach( thread );
+    }
+    s_pool.thread_num = i;
+} /* _create_pool() */
+#endif
+
+uint32_t vsi_nn_kernel_cpu_get_thread_num
+    ( void )
+{
+#ifdef _CPU_POOL_ENABLED
+    pthread_once( &s_pool_once, _create_pool );
+    return s_pool.thread_num;
+#else
+    return 1;
+#endif
+} /* vsi_nn_kernel_cpu_get_thread_num() */
+
+void vsi_nn_kernel_cpu_parallel_for
+    (
+    vsi_size_t total,
+    vsi_size_t grain,
+    vsi_nn_kernel_cpu_task_t task,
+    void * user_data
+    )
+{
+    uint32_t thread_num = 0;
+    vsi_size_t chunk = 0;
+
+    if ( 0 == total || !task )
+    {
+        return;
+    }
+    grain = vsi_nn_max( grain, 1 );
+    thread_num = vsi_nn_kernel_cpu_get_thread_num();
+    if ( thread_num <= 1 || total <= grain )
+    {
+        task( 0, total, user_data );
+        return;
+    }
+    chunk = (total + thread_num * _CPU_RANGES_PER_THREAD - 1)
+        / (thread_num * _CPU_RANGES_PER_THREAD);
+    chunk = vsi_nn_max( chunk, grain );
+
+#ifdef _CPU_POOL_ENABLED
+    if ( 0 != pthread_mutex_trylock( &s_submit_lock ) )
+    {
+        task( 0, total, user_data );
+        return;
+    }
+    pthread_mutex_lock( &s_pool.mutex );
+    s_pool.task = task;
+    s_pool.user_data = user_data;
+    s_pool.total = total;
+    s_pool.chunk = chunk;
+    s_pool.next = 0;
+    s_pool.running = 0;
+    s_pool.generation ++;
+    pthread_cond_broadcast( &s_pool.job_cond );
+
+    _run_ranges_locked();
+    while ( s_pool.next < s_pool.total || s_pool.running > 0 )
+    {
+        pthread_cond_wait( &s_pool.done_cond, &s_pool.mutex );
+    }
+    s_pool.task = NULL;
+    s_pool.user_data = NULL;
+    pthread_mutex_unlock( &s_pool.mutex );
+    pthread_mutex_unlock( &s_submit_lock );
+#else
+    (void)chunk;
+    task( 0, total, user_data );
+#endif
+} /* vsi_nn_kernel_cpu_parallel_for() */
+
+vsi_bool vsi_nn_kernel_cpu_is_same_quant
+    (
+    const vsi_nn_kernel_tensor_attr_t * attr0,
+    const vsi_nn_kernel_tensor_attr_t * attr1
+    )
+{
+    if ( !attr0 || !attr1 || attr0->dtype != attr1->dtype )
+    {
+        return FALSE;
+    }
+    /* Packed 4 bit data can not be addressed per element. */
+    if ( attr0->dtype == I4 || attr0->dtype == U4 )
+    {
+        return FALSE;
+    }
+    if ( !vsi_nn_kernel_tensor_attr_is_quantized( attr0 ) )
+    {
+        return !vsi_nn_kernel_tensor_attr_is_quantized( attr1 );
+    }
+    if ( attr0->quant != attr1->quant )
+    {
+        return FALSE;
+    }
+    switch ( attr0->quant )
+    {
+        case VSI_NN_KERNEL_QUANT_DFP:
+            return attr0->dfp.fl == attr1->dfp.fl;
+        case VSI_NN_KERNEL_QUANT_ASYMM:
+        case VSI_NN_KERNEL_QUANT_SYMM:
+            return attr0->asymm.scale == attr1->asymm.scale
+                && attr0->asymm.zero_point == attr1->asymm.zero_point;
+        default:
+            return FALSE;
+    }
+} /* vsi_nn_kernel_cpu_is_same_quant() */
+
+vsi_status vsi_nn_kernel_cpu_quantize
+    (
+    const vsi_nn_kernel_tensor_attr_t * attr,
+    const float * buffer,
+    size_t size,
+    void * out
+    )
+{
+    vsi_bool ret = FALSE;
+
+    if ( !attr || !buffer || !out )
+    {
+        return VSI_FAILURE;
+    }
+    if ( !vsi_nn_kernel_tensor_attr_is_quantized( attr ) )
+    {
+        ret = vsi_nn_dtype_convert_float_to_dtype( buffer, size, attr->dtype, out );
+    }
+    else if ( attr->quant == VSI_NN_KERNEL_QUANT_DFP )
+    {
+        ret = vsi_nn_dtype_convert_float_to_quantize_dfp( buffer, size,
+                attr->dtype, attr->dfp.fl, out );
+    }
+    else if ( attr->quant == VSI_NN_KERNEL_QUANT_ASYMM )
+    {
+        ret = vsi_nn_dtype_convert_float_to_quantize_asymm( buffer, size,
+                attr->dtype, attr->asymm.scale, attr->asymm.zero_point, out );
+    }
+    else if ( attr->quant == VSI_NN_KERNEL_QUANT_SYMM )
+    {
+        ret = vsi_nn_dtype_convert_float_to_quantize_symm( buffer, size,
+                attr->dtype, attr->asymm.scale, attr->asymm.zero_point, out );
+    }
+    return ret ? VSI_SUCCESS : VSI_FAILURE;
+} /* vsi_nn_kernel_cpu_quantize() */
+
+vsi_status vsi_nn_kernel_cpu_dequantize_table
+    (
+    const vsi_nn_kernel_tensor_attr_t * attr,
+    float table[256]
+    )
+{
+    uint8_t codes[256];
+    vsi_bool ret = FALSE;
+    uint32_t i = 0;
+
+    if ( !attr || !table || (attr->dtype != U8 && attr->dtype != I8) )
+    {
+        return VSI_FAILURE;
+    }
+    for ( i = 0; i < 256; i ++ )
+    {
+        codes[i] = (uint8_t)i;
+    }
+    if ( !vsi_nn_kernel_tensor_attr_is_quantized( attr ) )
+    {
+        ret = vsi_nn_dtype_convert_dtype_to_float( codes, 256, attr->dtype, table );
+    }
+    else if ( attr->quant == VSI_NN_KERNEL_QUANT_DFP )
+    {
+        ret = vsi_nn_dtype_convert_quantize_dfp_to_float( codes, 256,
+                attr->dtype, attr->dfp.fl, table );
+    }
+    else if ( attr->quant == VSI_NN_KERNEL_QUANT_ASYMM )
+    {
+        ret = vsi_nn_dtype_convert_quantize_asymm_to_float( codes, 256,
+                attr->dtype, attr->asymm.scale, attr->asymm.zero_point, table );
+    }
+    else if ( attr->quant == VSI_NN_KERNEL_QUANT_SYMM )
+    {
+        ret = vsi_nn_dtype_convert_quantize_symm_to_float( codes, 256,
+                attr->dtype, attr->asymm.scale, attr->asymm.zero_point, table );
+    }
+    return ret ? VSI_SUCCESS : VSI_FAILURE;
+} /* vsi_nn_kernel_cpu_dequantize_table() */
@@ -40,24 +40,99 @@
 #include "kernel/vsi_nn_kernel.h"
 #include "kernel/vsi_nn_kernel_lut.h"
 #include "utils/vsi_nn_dtype_util.h"
+#include "utils/vsi_nn_rwlock.h"
 
-static int32_t _comparator(const void *pa, const void *pb)
+/* Distinct activations kept per process, 8KB each. */
+#define VSI_NN_KERNEL_LUT_CACHE_SIZE  (256)
+
+typedef struct _vsi_nn_kernel_lut_cache_entry
+{
+    vsi_nn_kernel_lut_params key;
+    vsi_nn_kernel_lut_table_t * table;
+} vsi_nn_kernel_lut_cache_entry_t;
+
+typedef struct _vsi_nn_kernel_lut_object
+{
+    vx_context context;
+    const vsi_nn_kernel_lut_table_t * table;
+    vx_lut index_lut;
+    vx_lut output_lut;
+    struct _vsi_nn_kernel_lut_object * next;
+} vsi_nn_kernel_lut_object_t;
+
+static struct
 {
-    vsi_nn_kernel_lut_t a = *(vsi_nn_kernel_lut_t *)pa;
-    vsi_nn_kernel_lut_t b = *(vsi_nn_kernel_lut_t *)pb;
-    float diff = a.index - b.index;
+    vsi_nn_kernel_lut_cache_entry_t entries[VSI_NN_KERNEL_LUT_CACHE_SIZE];
+    uint32_t count;
+    uint32_t hits;
+    uint32_t misses;
+    vsi_nn_kernel_lut_object_t * objects;
+} s_lut_cache;
+
+/* Hits share the lock, misses and new lut objects take it exclusively. */
+static vsi_nn_rwlock_t s_lut_cache_lock = VSI_NN_RWLOCK_INITIALIZER;
+
+/* Hits are counted by readers sharing the lock. */
+#if defined(_MSC_VER)
+#define _LUT_CACHE_COUNT(counter) \
+    InterlockedIncrement( (volatile LONG *)&(counter) )
+#else
+#define _LUT_CACHE_COUNT(counter) \
+    __atomic_fetch_add( &(counter), 1, __ATOMIC_RELAXED )
+#endif
+
+/*
+ * Stable bottom up merge sort by index, entries with equal index keep
+ * their order like they did with the qsort this replaces. tmp holds
+ * size entries.
+ */
+static void _lut_sort
+    (
+    vsi_nn_kernel_lut_t * lut,
+    vsi_nn_kernel_lut_t * tmp,
+    uint32_t size
+    )
+{
+    vsi_nn_kernel_lut_t * src = lut;
+    vsi_nn_kernel_lut_t * dst = tmp;
+    uint32_t width = 0;
 
-    if ( diff > 0)
+    for ( width = 1; width < size; width *= 2 )
     {
-        return 1;
+        uint32_t lo = 0;
+        vsi_nn_kernel_lut_t * swap = NULL;
+
+        for ( lo = 0; lo < size; lo += 2 * width )
+        {
+            uint32_t mid = vsi_nn_min( lo + width, size );
+            uint32_t hi = vsi_nn_min( lo + 2 * width, size );
+            uint32_t i = lo;
+            uint32_t j = mid;
+            uint32_t k = lo;
+
+            while ( i < mid && j < hi )
+            {
+                dst[k++] = src[j].index < src[i].index ? src[j++] : src[i++];
+            }
+            while ( i < mid )
+            {
+                dst[k++] = src[i++];
+            }
+            while ( j < hi )
+            {
+                dst[k++] = src[j++];
+            }
+        }
+        swap = src;
+        src = dst;
+        dst = swap;
     }
-    else if ( diff < 0)
+
+    if ( src != lut )
     {
-        return -1;
+        memcpy( lut, src, sizeof(vsi_nn_kernel_lut_t) * size );
     }
-
-    return 0;
-}
+} /* _lut_sort() */
 
 static float exp_eval(float val)
 {
@@ -333,157 +408,350 @@ static float vsi_nn_kernel_lut_activation(float data, vsi_nn_kernel_lut_params *
     return result;
 }
 
-vsi_status vsi_nn_kernel_lut_positive
+/*
+ * Same as vsi_nn_kernel_lut_activation() over an array. The switch is
+ * taken once per table instead of per entry, which lets the compiler
+ * inline and vectorize the simple activations.
+ */
+static void _lut_activation_array
     (
-    vx_lut index_lut,
-    vx_lut output_lut,
-    vsi_nn_kernel_lut_params *param
+    const float * in,
+    float * out,
+    uint32_t size,
+    vsi_nn_kernel_lut_params * lut_param
     )
 {
-    vsi_status status = VSI_SUCCESS;
-    vsi_nn_kernel_lut_t *lut = NULL;
     uint32_t i = 0;
-    float clamp_min = 0;
-    float index[VSI_NN_KERNEL_LUT_MAX_SIZE] = {0};
-    float value[VSI_NN_KERNEL_LUT_MAX_SIZE] = {0};
 
-    if (index_lut == NULL || output_lut == NULL || param == NULL)
+#define _EVAL_LOOP( expr ) \
+    for ( i = 0; i < size; i++ ) \
+    { \
+        float x = in[i]; \
+        out[i] = expr; \
+    } \
+    break;
+
+    switch (lut_param->act_type)
     {
-        return VSI_FAILURE;
+    case VSI_NN_KERNEL_LUT_MISH:
+        _EVAL_LOOP( mish_eval(x) )
+    case VSI_NN_KERNEL_LUT_LOG:
+        _EVAL_LOOP( log_eval(x) )
+    case VSI_NN_KERNEL_LUT_EXP:
+        _EVAL_LOOP( exp_eval(x) )
+    case VSI_NN_KERNEL_LUT_SELU:
+        _EVAL_LOOP( selu_eval(x, lut_param) )
+    case VSI_NN_KERNEL_LUT_NEG:
+        _EVAL_LOOP( neg_eval(x) )
+    case VSI_NN_KERNEL_LUT_HSIGMOID:
+        _EVAL_LOOP( hsigmoid_eval(x, lut_param) )
+    case VSI_NN_KERNEL_LUT_SOFT_PLUS:
+        _EVAL_LOOP( soft_plus_eval(x) )
+    case VSI_NN_KERNEL_LUT_ERF:
+        _EVAL_LOOP( erf_eval(x) )
+    case VSI_NN_KERNEL_LUT_GELU:
+        _EVAL_LOOP( gelu_eval(x) )
+    case VSI_NN_KERNEL_LUT_HGELU:
+        _EVAL_LOOP( hgelu_eval(x) )
+    case VSI_NN_KERNEL_LUT_RELU_KERAS:
+        _EVAL_LOOP( relu_keras_eval(x, lut_param) )
+    case VSI_NN_KERNEL_LUT_CLIP:
+        _EVAL_LOOP( clip_eval(x, lut_param) )
+    case VSI_NN_KERNEL_LUT_SQUARE:
+        _EVAL_LOOP( square_eval(x) )
+    case VSI_NN_KERNEL_LUT_CELU:
+        _EVAL_LOOP( celu_eval(x, lut_param) )
+    case VSI_NN_KERNEL_LUT_RCP:
+        _EVAL_LOOP( rcp_eval(x) )
+    case VSI_NN_KERNEL_LUT_SOFTSIGN:
+        _EVAL_LOOP( softsign_eval(x) )
+    case VSI_NN_KERNEL_LUT_LINEAR_EXP:
+        _EVAL_LOOP( linear_exp_eval(x, lut_param) )
+    case VSI_NN_KERNEL_LUT_LINEAR_RSQRT:
+        _EVAL_LOOP( linear_rsqrt_eval(x, lut_param) )
+    case VSI_NN_KERNEL_LUT_LINEAR_SIGMOID:
+        _EVAL_LOOP( linear_sigmoid_eval(x, lut_param) )
+    case VSI_NN_KERNEL_LUT_ATAN:
+        _EVAL_LOOP( atan_eval(x) )
+    case VSI_NN_KERNEL_LUT_ATANH:
+        _EVAL_LOOP( atanh_eval(x) )
+    case VSI_NN_KERNEL_LUT_ACOSH:
+        _EVAL_LOOP( acosh_eval(x) )
+    case VSI_NN_KERNEL_LUT_INVERSE_SIGMOID:
+        _EVAL_LOOP( inverse_sigmoid_eval(x, lut_param) )
+    default:
+        for ( i = 0; i < size; i++ )
+        {
+            out[i] = vsi_nn_kernel_lut_activation(in[i], lut_param);
+        }
+        break;
     }
+#undef _EVAL_LOOP
+} /* _lut_activation_array() */
 
-    lut = (vsi_nn_kernel_lut_t *)calloc(VSI_NN_KERNEL_LUT_MAX_SIZE, sizeof(vsi_nn_kernel_lut_t));
-    CHECK_PTR_FAIL_GOTO( lut, "Create LUT buffer fail.", final );
-    memset(lut, 0, sizeof(vsi_nn_kernel_lut_t) * VSI_NN_KERNEL_LUT_MAX_SIZE);
-
-    clamp_min = param->clamp_min;
+static void _lut_index_positive
+    (
+    float * index,
+    const vsi_nn_kernel_lut_params *param
+    )
+{
+    uint32_t i = 0;
+    float clamp_min = param->clamp_min;
 
-    for ( i = 0; i < VSI_NN_KERNEL_LUT_MAX_SIZE; i++)
+    for ( i = 0; i < 992; i++)
     {
-        int16_t val = (int16_t)(i << 5);
-        float fidx = fp16_to_fp32(val);
-
-        if (val < 0)
-        {
-            continue;
-        }
+        float fidx = fp16_to_fp32((int16_t)(i << 5));
 
         if (param->pwl_sign_remove_support && fidx < clamp_min)
         {
             fidx = clamp_min;
         }
-
-        lut[i].index = fidx;
-        lut[i].val = vsi_nn_kernel_lut_activation(lut[i].index, param);
+        index[i] = fidx;
     }
 
     for (i = 992; i < VSI_NN_KERNEL_LUT_MAX_SIZE; i++)
     {
-        lut[i].index = VSI_NN_KERNEL_LUT_FP16_MAX;
-        lut[i].val = vsi_nn_kernel_lut_activation(lut[i].index, param);
+        index[i] = VSI_NN_KERNEL_LUT_FP16_MAX;
     }
+} /* _lut_index_positive() */
 
-    qsort(lut, VSI_NN_KERNEL_LUT_MAX_SIZE, sizeof(vsi_nn_kernel_lut_t), _comparator);
+static void _lut_index_all
+    (
+    float * index,
+    const vsi_nn_kernel_lut_params *param
+    )
+{
+    uint32_t i = 0;
+    float clamp_min = param->clamp_min;
 
     for ( i = 0; i < VSI_NN_KERNEL_LUT_MAX_SIZE; i++)
     {
-        index[i] = lut[i].index;
-        value[i] = lut[i].val;
-    }
+        float fidx = i < 0x10 ? 0 : fp16_to_fp32((int16_t)(i << 6));
 
-    status  = vxCopyLUT(index_lut, (void*)&index, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
-    status |= vxCopyLUT(output_lut, (void*)&value, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
-final:
-    vsi_nn_safe_free(lut);
+        if (param->pwl_sign_remove_support && fidx < clamp_min)
+        {
+            fidx = clamp_min;
+        }
 
-    return status;
-}
+        if (i >= 0x1F0 && i < 0x200)
+        {
+            fidx = VSI_NN_KERNEL_LUT_FP16_MAX;
+        }
+        else if (i >= 0x3F0)
+        {
+            fidx = param->pwl_sign_remove_support ?
+                clamp_min : VSI_NN_KERNEL_LUT_FP16_MIN;
+        }
+        index[i] = fidx;
+    }
+} /* _lut_index_all() */
 
-vsi_status vsi_nn_kernel_lut_all
+vsi_status vsi_nn_kernel_lut_generate
     (
-    vx_lut index_lut,
-    vx_lut output_lut,
-    vsi_nn_kernel_lut_params *param
+    const vsi_nn_kernel_lut_params * param,
+    vsi_nn_kernel_lut_table_t * table
     )
 {
-    vsi_status status = VSI_SUCCESS;
+    vsi_status status = VSI_FAILURE;
     vsi_nn_kernel_lut_t *lut = NULL;
+    vsi_nn_kernel_lut_params lut_param;
     uint32_t i = 0;
-    float clamp_min = 0;
-    float index[VSI_NN_KERNEL_LUT_MAX_SIZE] = {0};
-    float value[VSI_NN_KERNEL_LUT_MAX_SIZE] = {0};
 
-    if (index_lut == NULL || output_lut == NULL || param == NULL)
+    if (param == NULL || table == NULL)
     {
         return VSI_FAILURE;
     }
 
-    lut = (vsi_nn_kernel_lut_t *)calloc(VSI_NN_KERNEL_LUT_MAX_SIZE, sizeof(vsi_nn_kernel_lut_t));
+    /* The eval helpers take a mutable pointer. */
+    memcpy(&lut_param, param, sizeof(lut_param));
+
+    lut = (vsi_nn_kernel_lut_t *)calloc(2 * VSI_NN_KERNEL_LUT_MAX_SIZE, sizeof(vsi_nn_kernel_lut_t));
     CHECK_PTR_FAIL_GOTO( lut, "Create LUT buffer fail.", final );
-    memset(lut, 0, sizeof(vsi_nn_kernel_lut_t) * VSI_NN_KERNEL_LUT_MAX_SIZE);
 
-    clamp_min = param->clamp_min;
+    if (param->pwl_sign_remove_support && param->clamp_min >= 0)
+    {
+        _lut_index_positive(table->index, param);
+    }
+    else
+    {
+        _lut_index_all(table->index, param);
+    }
+
+    _lut_activation_array(table->index, table->value, VSI_NN_KERNEL_LUT_MAX_SIZE, &lut_param);
 
     for ( i = 0; i < VSI_NN_KERNEL_LUT_MAX_SIZE; i++)
     {
-        int16_t val = (int16_t)(i << 6);
-        float fidx = fp16_to_fp32(val);
-        if (param->pwl_sign_remove_support && fidx < clamp_min)
-        {
-            fidx = clamp_min;
-        }
+        lut[i].index = table->index[i];
+        lut[i].val = table->value[i];
+    }
 
-        lut[i].index = fidx;
-        lut[i].val = vsi_nn_kernel_lut_activation(lut[i].index, param);
+    _lut_sort(lut, lut + VSI_NN_KERNEL_LUT_MAX_SIZE, VSI_NN_KERNEL_LUT_MAX_SIZE);
+
+    for ( i = 0; i < VSI_NN_KERNEL_LUT_MAX_SIZE; i++)
+    {
+        table->index[i] = lut[i].index;
+        table->value[i] = lut[i].val;
     }
+    status = VSI_SUCCESS;
 
-    for (i = 0x0; i < 0x10; i++)
+final:
+    vsi_nn_safe_free(lut);
+
+    return status;
+} /* vsi_nn_kernel_lut_generate() */
+
+static void _lut_cache_key
+    (
+    const vsi_nn_kernel_lut_params * param,
+    vsi_nn_kernel_lut_params * key
+    )
+{
+    memset(key, 0, sizeof(*key));
+    key->act_type = param->act_type;
+    key->pwl_sign_remove_support = param->pwl_sign_remove_support ? TRUE : FALSE;
+    /* clamp_min is only read together with the sign flag */
+    if (key->pwl_sign_remove_support)
     {
-        float fidx = 0;
-        if (param->pwl_sign_remove_support && fidx < clamp_min)
+        key->clamp_min = param->clamp_min;
+    }
+    memcpy(key->params, param->params, sizeof(key->params));
+} /* _lut_cache_key() */
+
+/* Called with s_lut_cache_lock held, shared or exclusive. */
+static const vsi_nn_kernel_lut_table_t * _lut_cache_find
+    (
+    const vsi_nn_kernel_lut_params * key
+    )
+{
+    uint32_t i = 0;
+
+    for ( i = 0; i < s_lut_cache.count; i++ )
+    {
+        if ( 0 == memcmp(&s_lut_cache.entries[i].key, key, sizeof(*key)) )
         {
-            fidx = clamp_min;
+            return s_lut_cache.entries[i].table;
         }
+    }
+    return NULL;
+} /* _lut_cache_find() */
 
-        lut[i].index = fidx;
-        lut[i].val = vsi_nn_kernel_lut_activation(lut[i].index, param);
+/* Called with s_lut_cache_lock held exclusively. */
+static const vsi_nn_kernel_lut_table_t * _lut_cache_add
+    (
+    const vsi_nn_kernel_lut_params * key
+    )
+{
+    vsi_nn_kernel_lut_cache_entry_t * entry = NULL;
+    vsi_nn_kernel_lut_table_t * table = NULL;
+
+    s_lut_cache.misses ++;
+    if ( s_lut_cache.count >= VSI_NN_KERNEL_LUT_CACHE_SIZE )
+    {
+        return NULL;
     }
 
-    for (i = 0x1F0; i < 0x200; i++)
+    table = (vsi_nn_kernel_lut_table_t *)malloc(sizeof(vsi_nn_kernel_lut_table_t));
+    CHECK_PTR_FAIL_GOTO( table, "Create LUT table fail.", final );
+    if ( VSI_SUCCESS != vsi_nn_kernel_lut_generate(key, table) )
     {
-        lut[i].index = VSI_NN_KERNEL_LUT_FP16_MAX;
-        lut[i].val = vsi_nn_kernel_lut_activation(lut[i].index, param);
+        vsi_nn_safe_free(table);
+        goto final;
     }
 
-    for (i = 0x3F0; i < 0x400; i++)
+    entry = &s_lut_cache.entries[s_lut_cache.count ++];
+    memcpy(&entry->key, key, sizeof(*key));
+    entry->table = table;
+
+final:
+    return table;
+} /* _lut_cache_add() */
+
+/* Tables are never freed, the result stays valid without the lock. */
+static const vsi_nn_kernel_lut_table_t * _lut_cache_get
+    (
+    const vsi_nn_kernel_lut_params * param
+    )
+{
+    vsi_nn_kernel_lut_params key;
+    const vsi_nn_kernel_lut_table_t * table = NULL;
+
+    _lut_cache_key(param, &key);
+    vsi_nn_rwlock_rdlock( &s_lut_cache_lock );
+    table = _lut_cache_find(&key);
+    if ( table )
     {
-        if (param->pwl_sign_remove_support)
-        {
-            lut[i].index = clamp_min;
-        }
-        else
-        {
-            lut[i].index = VSI_NN_KERNEL_LUT_FP16_MIN;
-        }
+        _LUT_CACHE_COUNT( s_lut_cache.hits );
+    }
+    vsi_nn_rwlock_rdunlock( &s_lut_cache_lock );
+    if ( table )
+    {
+        return table;
+    }
 
-        lut[i].val = vsi_nn_kernel_lut_activation(lut[i].index, param);
+    /* Another thread may have added it in between. */
+    vsi_nn_rwlock_wrlock( &s_lut_cache_lock );
+    table = _lut_cache_find(&key);
+    if ( table )
+    {
+        s_lut_cache.hits ++;
+    }
+    else
+    {
+        table = _lut_cache_add(&key);
     }
+    vsi_nn_rwlock_wrunlock( &s_lut_cache_lock );
+    return table;
+} /* _lut_cache_get() */
 
-    qsort(lut, VSI_NN_KERNEL_LUT_MAX_SIZE, sizeof(vsi_nn_kernel_lut_t), _comparator);
+const vsi_nn_kernel_lut_table_t * vsi_nn_kernel_lut_get_table
+    (
+    const vsi_nn_kernel_lut_params * param
+    )
+{
+    if (param == NULL)
+    {
+        return NULL;
+    }
+    return _lut_cache_get(param);
+} /* vsi_nn_kernel_lut_get_table() */
 
-    for ( i = 0; i < VSI_NN_KERNEL_LUT_MAX_SIZE; i++)
+void vsi_nn_kernel_lut_cache_query
+    (
+    uint32_t * entries,
+    uint32_t * hits,
+    uint32_t * misses
+    )
+{
+    vsi_nn_rwlock_wrlock( &s_lut_cache_lock );
+    if (entries)
+    {
+        *entries = s_lut_cache.count;
+    }
+    if (hits)
+    {
+        *hits = s_lut_cache.hits;
+    }
+    if (misses)
     {
-        index[i] = lut[i].index;
-        value[i] = lut[i].val;
+        *misses = s_lut_cache.misses;
     }
+    vsi_nn_rwlock_wrunlock( &s_lut_cache_lock );
+} /* vsi_nn_kernel_lut_cache_query() */
 
-    status  = vxCopyLUT(index_lut, (void*)&index, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
-    status |= vxCopyLUT(output_lut, (void*)&value, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
-final:
-    vsi_nn_safe_free(lut);
+static vsi_status _lut_copy
+    (
+    vx_lut index_lut,
+    vx_lut output_lut,
+    const vsi_nn_kernel_lut_table_t * table
+    )
+{
+    vsi_status status = VSI_SUCCESS;
+
+    status  = vxCopyLUT(index_lut, (void*)table->index, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
+    status |= vxCopyLUT(output_lut, (void*)table->value, VX_WRITE_ONLY, VX_MEMORY_TYPE_HOST);
 
     return status;
-}
+} /* _lut_copy() */
 
 vsi_status vsi_nn_kernel_lut
     (
@@ -492,24 +760,181 @@ vsi_status vsi_nn_kernel_lut
     vsi_nn_kernel_lut_params *param
     )
 {
-    vsi_status status = VSI_SUCCESS;
-    float clamp_min = 0;
+    vsi_status status = VSI_FAILURE;
+    const vsi_nn_kernel_lut_table_t * table = NULL;
+    vsi_nn_kernel_lut_table_t * scratch = NULL;
 
-    if (param == NULL)
+    if (index_lut == NULL || output_lut == NULL || param == NULL)
     {
         return VSI_FAILURE;
     }
 
-    clamp_min = param->clamp_min;
+    table = vsi_nn_kernel_lut_get_table(param);
+    if (table == NULL)
+    {
+        scratch = (vsi_nn_kernel_lut_table_t *)malloc(sizeof(vsi_nn_kernel_lut_table_t));
+        CHECK_PTR_FAIL_GOTO( scratch, "Create LUT table fail.", final );
+        status = vsi_nn_kernel_lut_generate(param, scratch);
+        CHECK_STATUS_FAIL_GOTO( status, final );
+        table = scratch;
+    }
+
+    status = _lut_copy(index_lut, output_lut, table);
+
+final:
+    vsi_nn_safe_free(scratch);
+
+    return status;
+} /* vsi_nn_kernel_lut() */
+
+/* Called with s_lut_cache_lock held, shared or exclusive. */
+static vsi_nn_kernel_lut_object_t * _lut_object_find
+    (
+    vx_context context,
+    const vsi_nn_kernel_lut_table_t * table
+    )
+{
+    vsi_nn_kernel_lut_object_t * object = NULL;
 
-    if (param->pwl_sign_remove_support && clamp_min >= 0)
+    for ( object = s_lut_cache.objects; object != NULL; object = object->next )
     {
-        status = vsi_nn_kernel_lut_positive(index_lut, output_lut, param);
+        if (object->context == context && object->table == table)
+        {
+            break;
+        }
     }
-    else
+    return object;
+} /* _lut_object_find() */
+
+vsi_status vsi_nn_kernel_lut_create
+    (
+    vx_context context,
+    vsi_nn_kernel_lut_params * param,
+    vx_lut * index_lut,
+    vx_lut * output_lut
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    const vsi_nn_kernel_lut_table_t * table = NULL;
+    vsi_nn_kernel_lut_object_t * object = NULL;
+    vx_lut lut1 = NULL;
+    vx_lut lut2 = NULL;
+
+    if (context == NULL || param == NULL || index_lut == NULL || output_lut == NULL)
+    {
+        return VSI_FAILURE;
+    }
+    *index_lut = NULL;
+    *output_lut = NULL;
+
+    table = _lut_cache_get(param);
+    if (table == NULL)
+    {
+        /* Not cacheable, give the caller luts of its own. */
+        lut1 = vxCreateLUT( context, VX_TYPE_FLOAT32, VSI_NN_KERNEL_LUT_MAX_SIZE);
+        lut2 = vxCreateLUT( context, VX_TYPE_FLOAT32, VSI_NN_KERNEL_LUT_MAX_SIZE);
+        if (NULL == lut1 || NULL == lut2)
+        {
+            VSILOGE("create lut object fail.");
+            goto final;
+        }
+        status = vsi_nn_kernel_lut(lut1, lut2, param);
+        CHECK_STATUS_FAIL_GOTO( status, final );
+        *index_lut = lut1;
+        *output_lut = lut2;
+        return VSI_SUCCESS;
+    }
+
+    vsi_nn_rwlock_rdlock( &s_lut_cache_lock );
+    object = _lut_object_find(context, table);
+    if (object)
+    {
+        vxRetainReference( (vx_reference)object->index_lut );
+        vxRetainReference( (vx_reference)object->output_lut );
+        *index_lut = object->index_lut;
+        *output_lut = object->output_lut;
+    }
+    vsi_nn_rwlock_rdunlock( &s_lut_cache_lock );
+    if (object)
+    {
+        return VSI_SUCCESS;
+    }
+
+    vsi_nn_rwlock_wrlock( &s_lut_cache_lock );
+    object = _lut_object_find(context, table);
+    if (object == NULL)
+    {
+        lut1 = vxCreateLUT( context, VX_TYPE_FLOAT32, VSI_NN_KERNEL_LUT_MAX_SIZE);
+        lut2 = vxCreateLUT( context, VX_TYPE_FLOAT32, VSI_NN_KERNEL_LUT_MAX_SIZE);
+        if (NULL == lut1 || NULL == lut2)
+        {
+            VSILOGE("create lut object fail.");
+            vsi_nn_rwlock_wrunlock( &s_lut_cache_lock );
+            goto final;
+        }
+        status = _lut_copy(lut1, lut2, table);
+        object = (vsi_nn_kernel_lut_object_t *)malloc(sizeof(vsi_nn_kernel_lut_object_t));
+        if (VSI_SUCCESS != status || NULL == object)
+        {
+            VSILOGE("create lut object fail.");
+            vsi_nn_safe_free(object);
+            status = VSI_FAILURE;
+            vsi_nn_rwlock_wrunlock( &s_lut_cache_lock );
+            goto final;
+        }
+        object->context = context;
+        object->table = table;
+        object->index_lut = lut1;
+        object->output_lut = lut2;
+        object->next = s_lut_cache.objects;
+        s_lut_cache.objects = object;
+        lut1 = NULL;
+        lut2 = NULL;
+    }
+
+    vxRetainReference( (vx_reference)object->index_lut );
+    vxRetainReference( (vx_reference)object->output_lut );
+    *index_lut = object->index_lut;
+    *output_lut = object->output_lut;
+    status = VSI_SUCCESS;
+    vsi_nn_rwlock_wrunlock( &s_lut_cache_lock );
+
+final:
+    if (lut1)
+    {
+        vxReleaseLUT(&lut1);
+    }
+    if (lut2)
     {
-        status = vsi_nn_kernel_lut_all(index_lut, output_lut, param);
+        vxReleaseLUT(&lut2);
     }
 
     return status;
-}
+} /* vsi_nn_kernel_lut_create() */
+
+void vsi_nn_kernel_lut_release_context
+    (
+    vx_context context
+    )
+{
+    vsi_nn_kernel_lut_object_t ** link = NULL;
+
+    vsi_nn_rwlock_wrlock( &s_lut_cache_lock );
+    link = &s_lut_cache.objects;
+    while (*link != NULL)
+    {
+        vsi_nn_kernel_lut_object_t * object = *link;
+        if (object->context == context)
+        {
+            *link = object->next;
+            vxReleaseLUT(&object->index_lut);
+            vxReleaseLUT(&object->output_lut);
+            free(object);
+        }
+        else
+        {
+            link = &object->next;
+        }
+    }
+    vsi_nn_rwlock_wrunlock( &s_lut_cache_lock );
+} /* vsi_nn_kernel_lut_release_context() */
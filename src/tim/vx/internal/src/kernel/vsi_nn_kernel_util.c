@@ -24,6 +24,7 @@
 
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 #include "vsi_nn_prv.h"
 #include "vsi_nn_log.h"
@@ -343,6 +344,54 @@ vsi_status vsi_nn_kernel_tensor_write
             (void*)buffer, size );
 } /* vsi_nn_kernel_tensor_write() */
 
+vsi_status vsi_nn_kernel_tensor_write_patch
+    (
+    vsi_nn_kernel_tensor_t tensor,
+    const vsi_nn_kernel_tensor_attr_t * attr,
+    const void * buffer,
+    const vsi_size_t * start,
+    const vsi_size_t * end
+    )
+{
+    vsi_status status = VSI_FAILURE;
+    vsi_nn_kernel_tensor_attr_t patch_attr;
+    vsi_size_t view_start[VSI_NN_MAX_DIM_NUM] = { 0 };
+    vsi_size_t view_end[VSI_NN_MAX_DIM_NUM] = { 0 };
+    vsi_size_t stride[VSI_NN_MAX_DIM_NUM] = { 0 };
+    uint32_t i;
+
+    if ( NULL == tensor || NULL == attr || NULL == buffer ||
+         attr->dtype == I4 || attr->dtype == U4 )
+    {
+        VSILOGE("Invalid parameter");
+        return status;
+    }
+
+    /* The user memory is addressed with the shape of the patch */
+    memcpy( &patch_attr, attr, sizeof(vsi_nn_kernel_tensor_attr_t) );
+    patch_attr.shape = vsi_size_array_create( attr->shape->size );
+    CHECK_PTR_FAIL_GOTO( patch_attr.shape, "Create shape fail.", final );
+
+    stride[0] = (vsi_size_t)vsi_nn_kernel_dtype_get_bytes( attr->dtype );
+    for (i = 0; i < (uint32_t)attr->shape->size; i++)
+    {
+        view_start[i] = start[i];
+        view_end[i] = end[i];
+        patch_attr.shape->data[i] = end[i] - start[i];
+        if ( i > 0 )
+        {
+            stride[i] = stride[i - 1] * patch_attr.shape->data[i - 1];
+        }
+    }
+
+    status = vsi_nn_kernel_copy_tensor_veiw_patch( (vx_tensor)tensor, &patch_attr,
+            (void*)buffer, view_start, view_end, stride, VX_WRITE_ONLY, 0 );
+
+final:
+    vsi_size_array_release( &patch_attr.shape );
+    return status;
+} /* vsi_nn_kernel_tensor_write_patch() */
+
 vsi_status vsi_nn_kernel_tensor_write_from_float
     (
     vsi_nn_kernel_tensor_t tensor,
@@ -88,15 +88,7 @@ static vsi_nn_kernel_node_t _setup
         return NULL;
     }
 
-    lut1 = vxCreateLUT( graph->ctx->c, VX_TYPE_FLOAT32, VSI_NN_KERNEL_LUT_MAX_SIZE);
-    lut2 = vxCreateLUT( graph->ctx->c, VX_TYPE_FLOAT32, VSI_NN_KERNEL_LUT_MAX_SIZE);
-    if( NULL == lut1 || NULL == lut2 )
-    {
-        VSILOGE("create lut object fail.");
-        goto final;
-    }
-
-    status = vsi_nn_kernel_lut(lut1, lut2, &lut_param);
+    status = vsi_nn_kernel_lut_create(graph->ctx->c, &lut_param, &lut1, &lut2);
     CHECK_STATUS_FAIL_GOTO(status, final);
 
     node = vxTensorTableLookupLayer( graph->g, inputs[0]->t, lut1, lut2, outputs[0]->t);
@@ -0,0 +1,97 @@
+#define SDPA_MAX_HEAD_DIM (128)
+
+/*
+ * One work item per query row and flattened outer index. The softmax is
+ * accumulated online over the keys, no score matrix is written.
+ */
+#define SDPA_ROW(MASK_SCORE) \
+    int row = get_global_id(0); \
+    int z = get_global_id(1); \
+    int head_dim = get_image_width(query); \
+    int value_dim = get_image_width(value); \
+    int q_len = get_image_height(query); \
+    int kv_len = get_image_height(key); \
+    int keys = causal ? min(kv_len, row + kv_len - q_len + 1) : kv_len; \
+    float q[SDPA_MAX_HEAD_DIM]; \
+    float acc[SDPA_MAX_HEAD_DIM]; \
+    float max_score = -MAXFLOAT; \
+    float sum = 0; \
+    int4 coord = (int4)(0, row, z, 0); \
+    int j, k; \
+ \
+    for (k = 0; k < head_dim; k++) \
+    { \
+        coord.x = k; \
+        q[k] = read_imagef(query, coord).x * scale; \
+    } \
+    for (k = 0; k < value_dim; k++) \
+    { \
+        acc[k] = 0; \
+    } \
+ \
+    for (j = 0; j < keys; j++) \
+    { \
+        float score = 0; \
+        float weight; \
+        int4 coord_kv = (int4)(0, j, z, 0); \
+ \
+        for (k = 0; k < head_dim; k++) \
+        { \
+            coord_kv.x = k; \
+            score += q[k] * read_imagef(key, coord_kv).x; \
+        } \
+        MASK_SCORE \
+        if (score > max_score) \
+        { \
+            float rescale = exp(max_score - score); \
+            sum *= rescale; \
+            for (k = 0; k < value_dim; k++) \
+            { \
+                acc[k] *= rescale; \
+            } \
+            max_score = score; \
+        } \
+        weight = exp(score - max_score); \
+        sum += weight; \
+        for (k = 0; k < value_dim; k++) \
+        { \
+            coord_kv.x = k; \
+            acc[k] += weight * read_imagef(value, coord_kv).x; \
+        } \
+    } \
+ \
+    sum = sum > 0 ? 1.0f / sum : 0; \
+    for (k = 0; k < value_dim; k++) \
+    { \
+        coord.x = k; \
+        write_imagef(output, coord, (float4)(acc[k] * sum, 0, 0, 0)); \
+    }
+
+__kernel void custom_scaled_dot_product_attention
+    (
+    __read_only  image2d_array_t query,
+    __read_only  image2d_array_t key,
+    __read_only  image2d_array_t value,
+    __write_only image2d_array_t output,
+                 float           scale,
+                 int             causal
+    )
+{
+    SDPA_ROW(;)
+}
+
+__kernel void custom_scaled_dot_product_attention_mask
+    (
+    __read_only  image2d_array_t query,
+    __read_only  image2d_array_t key,
+    __read_only  image2d_array_t value,
+    __read_only  image2d_array_t mask,
+    __write_only image2d_array_t output,
+                 float           scale,
+                 int             causal,
+                 int             mask_row_step,
+                 int             mask_z_step
+    )
+{
+    SDPA_ROW(score += read_imagef(mask, (int4)(j, row * mask_row_step, z * mask_z_step, 0)).x;)
+}
@@ -0,0 +1,17 @@
+#define SLICE_UPDATE(name, read_func, write_func) \
+__kernel void custom_slice_update_##name \
+    ( \
+    __read_only  image2d_array_t input, \
+    __read_only  image2d_array_t start, \
+    __write_only image2d_array_t output \
+    ) \
+{ \
+    int4 coord = (int4)(get_global_id(0), get_global_id(1), get_global_id(2), 0); \
+    int offset = read_imagei(start, (int4)(0, 0, 0, 0)).x; \
+ \
+    coord.w = coord.y + offset; \
+    write_func(output, coord.xwzz, read_func(input, coord)); \
+}
+SLICE_UPDATE(F32, read_imagef,  write_imagef)
+SLICE_UPDATE(U32, read_imageui, write_imageui)
+SLICE_UPDATE(I32, read_imagei,  write_imagei)
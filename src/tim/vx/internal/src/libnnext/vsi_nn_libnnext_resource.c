@@ -47942,6 +47942,124 @@ __kernel void cumsum_F32toU8_axis0_2D(\n\
     }\n\
 }"; /* end of cumsum_2d_cl*/
 
+static const char custom_scaled_dot_product_attention_cl[] = "#define SDPA_MAX_HEAD_DIM (128)\n\
+\n\
+/*\n\
+ * One work item per query row and flattened outer index. The softmax is\n\
+ * accumulated online over the keys, no score matrix is written.\n\
+ */\n\
+#define SDPA_ROW(MASK_SCORE) \\\n\
+    int row = get_global_id(0); \\\n\
+    int z = get_global_id(1); \\\n\
+    int head_dim = get_image_width(query); \\\n\
+    int value_dim = get_image_width(value); \\\n\
+    int q_len = get_image_height(query); \\\n\
+    int kv_len = get_image_height(key); \\\n\
+    int keys = causal ? min(kv_len, row + kv_len - q_len + 1) : kv_len; \\\n\
+    float q[SDPA_MAX_HEAD_DIM]; \\\n\
+    float acc[SDPA_MAX_HEAD_DIM]; \\\n\
+    float max_score = -MAXFLOAT; \\\n\
+    float sum = 0; \\\n\
+    int4 coord = (int4)(0, row, z, 0); \\\n\
+    int j, k; \\\n\
+ \\\n\
+    for (k = 0; k < head_dim; k++) \\\n\
+    { \\\n\
+        coord.x = k; \\\n\
+        q[k] = read_imagef(query, coord).x * scale; \\\n\
+    } \\\n\
+    for (k = 0; k < value_dim; k++) \\\n\
+    { \\\n\
+        acc[k] = 0; \\\n\
+    } \\\n\
+ \\\n\
+    for (j = 0; j < keys; j++) \\\n\
+    { \\\n\
+        float score = 0; \\\n\
+        float weight; \\\n\
+        int4 coord_kv = (int4)(0, j, z, 0); \\\n\
+ \\\n\
+        for (k = 0; k < head_dim; k++) \\\n\
+        { \\\n\
+            coord_kv.x = k; \\\n\
+            score += q[k] * read_imagef(key, coord_kv).x; \\\n\
+        } \\\n\
+        MASK_SCORE \\\n\
+        if (score > max_score) \\\n\
+        { \\\n\
+            float rescale = exp(max_score - score); \\\n\
+            sum *= rescale; \\\n\
+            for (k = 0; k < value_dim; k++) \\\n\
+            { \\\n\
+                acc[k] *= rescale; \\\n\
+            } \\\n\
+            max_score = score; \\\n\
+        } \\\n\
+        weight = exp(score - max_score); \\\n\
+        sum += weight; \\\n\
+        for (k = 0; k < value_dim; k++) \\\n\
+        { \\\n\
+            coord_kv.x = k; \\\n\
+            acc[k] += weight * read_imagef(value, coord_kv).x; \\\n\
+        } \\\n\
+    } \\\n\
+ \\\n\
+    sum = sum > 0 ? 1.0f / sum : 0; \\\n\
+    for (k = 0; k < value_dim; k++) \\\n\
+    { \\\n\
+        coord.x = k; \\\n\
+        write_imagef(output, coord, (float4)(acc[k] * sum, 0, 0, 0)); \\\n\
+    }\n\
+\n\
+__kernel void custom_scaled_dot_product_attention\n\
+    (\n\
+    __read_only  image2d_array_t query,\n\
+    __read_only  image2d_array_t key,\n\
+    __read_only  image2d_array_t value,\n\
+    __write_only image2d_array_t output,\n\
+                 float           scale,\n\
+                 int             causal\n\
+    )\n\
+{\n\
+    SDPA_ROW(;)\n\
+}\n\
+\n\
+__kernel void custom_scaled_dot_product_attention_mask\n\
+    (\n\
+    __read_only  image2d_array_t query,\n\
+    __read_only  image2d_array_t key,\n\
+    __read_only  image2d_array_t value,\n\
+    __read_only  image2d_array_t mask,\n\
+    __write_only image2d_array_t output,\n\
+                 float           scale,\n\
+                 int             causal,\n\
+                 int             mask_row_step,\n\
+                 int             mask_z_step\n\
+    )\n\
+{\n\
+    SDPA_ROW(score += read_imagef(mask, (int4)(j, row * mask_row_step, z * mask_z_step, 0)).x;)\n\
+}\n\
+"; /* end of custom_scaled_dot_product_attention_cl*/
+
+static const char custom_slice_update_cl[] = "#define SLICE_UPDATE(name, read_func, write_func) \\\n\
+__kernel void custom_slice_update_##name \\\n\
+    ( \\\n\
+    __read_only  image2d_array_t input, \\\n\
+    __read_only  image2d_array_t start, \\\n\
+    __write_only image2d_array_t output \\\n\
+    ) \\\n\
+{ \\\n\
+    int4 coord = (int4)(get_global_id(0), get_global_id(1), get_global_id(2), 0); \\\n\
+    int offset = read_imagei(start, (int4)(0, 0, 0, 0)).x; \\\n\
+ \\\n\
+    coord.w = coord.y + offset; \\\n\
+    write_func(output, coord.xwzz, read_func(input, coord)); \\\n\
+}\n\
+SLICE_UPDATE(F32, read_imagef,  write_imagef)\n\
+SLICE_UPDATE(U32, read_imageui, write_imageui)\n\
+SLICE_UPDATE(I32, read_imagei,  write_imagei)\n\
+"; /* end of custom_slice_update_cl*/
+
 static const char depth2space_crd_cl[] = "\n\
 __kernel void depth2space_crd_F32toF32(\n\
     image2d_array_t input, image2d_array_t output, int block_size)\n\
@@ -66132,6 +66250,8 @@ static const source_map_t cl_resource[] =
     {"clip_U8_cl", clip_U8_cl},
     {"cumsum_cl", cumsum_cl},
     {"cumsum_2d_cl", cumsum_2d_cl},
+    {"custom_scaled_dot_product_attention_cl", custom_scaled_dot_product_attention_cl},
+    {"custom_slice_update_cl", custom_slice_update_cl},
     {"depth2space_crd_cl", depth2space_crd_cl},
     {"detect_post_box_cl", detect_post_box_cl},
     {"eltwise_ops_helper_cl", eltwise_ops_helper_cl},
@@ -0,0 +1,530 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "vsi_nn_types.h"
+#include "vsi_nn_log.h"
+#include "vsi_nn_error.h"
+#include "utils/vsi_nn_math.h"
+#include "utils/vsi_nn_util.h"
+#include "kernel/vsi_nn_kernel_cpu.h"
+#include "post/vsi_nn_post_detection.h"
+
+struct _vsi_nn_detection_workspace_t
+{
+    uint32_t capacity;
+    vsi_nn_detection_t * candidates;
+    /* sorted candidate boxes, struct of arrays so the IoU loop vectorizes */
+    float * x1;
+    float * y1;
+    float * x2;
+    float * y2;
+    float * area;
+    uint8_t * suppressed;
+    /* per class results waiting to be merged */
+    uint32_t merged_capacity;
+    vsi_nn_detection_t * merged;
+};
+
+typedef struct
+{
+    const float * deltas;
+    const float * anchors;
+    const float * variance;
+    float * boxes;
+} _decode_args_t;
+
+static void _release_buffers
+    (
+    vsi_nn_detection_workspace_t * ws
+    )
+{
+    vsi_nn_safe_free( ws->candidates );
+    vsi_nn_safe_free( ws->x1 );
+    vsi_nn_safe_free( ws->y1 );
+    vsi_nn_safe_free( ws->x2 );
+    vsi_nn_safe_free( ws->y2 );
+    vsi_nn_safe_free( ws->area );
+    vsi_nn_safe_free( ws->suppressed );
+    ws->capacity = 0;
+} /* _release_buffers() */
+
+static vsi_bool _reserve
+    (
+    vsi_nn_detection_workspace_t * ws,
+    uint32_t count
+    )
+{
+    if ( count <= ws->capacity )
+    {
+        return TRUE;
+    }
+    /* Contents are scratch, no need to preserve them. */
+    _release_buffers( ws );
+    ws->candidates = (vsi_nn_detection_t *)malloc( sizeof(vsi_nn_detection_t) * count );
+    ws->x1 = (float *)malloc( sizeof(float) * count );
+    ws->y1 = (float *)malloc( sizeof(float) * count );
+    ws->x2 = (float *)malloc( sizeof(float) * count );
+    ws->y2 = (float *)malloc( sizeof(float) * count );
+    ws->area = (float *)malloc( sizeof(float) * count );
+    ws->suppressed = (uint8_t *)malloc( count );
+    if ( !ws->candidates || !ws->x1 || !ws->y1 || !ws->x2 || !ws->y2
+        || !ws->area || !ws->suppressed )
+    {
+        VSILOGE("Create detection workspace for %u boxes fail.", count);
+        _release_buffers( ws );
+        return FALSE;
+    }
+    ws->capacity = count;
+    return TRUE;
+} /* _reserve() */
+
+static vsi_bool _reserve_merged
+    (
+    vsi_nn_detection_workspace_t * ws,
+    uint32_t count
+    )
+{
+    vsi_nn_detection_t * merged = NULL;
+
+    if ( count <= ws->merged_capacity )
+    {
+        return TRUE;
+    }
+    count = vsi_nn_max( count, ws->merged_capacity * 2 );
+    merged = (vsi_nn_detection_t *)realloc( ws->merged, sizeof(vsi_nn_detection_t) * count );
+    if ( !merged )
+    {
+        VSILOGE("Create detection merge buffer fail.");
+        return FALSE;
+    }
+    ws->merged = merged;
+    ws->merged_capacity = count;
+    return TRUE;
+} /* _reserve_merged() */
+
+/* Descending score, ties by index then class so results are deterministic. */
+static int _compare_detection
+    (
+    const void * a,
+    const void * b
+    )
+{
+    const vsi_nn_detection_t * da = (const vsi_nn_detection_t *)a;
+    const vsi_nn_detection_t * db = (const vsi_nn_detection_t *)b;
+
+    if ( da->score != db->score )
+    {
+        return da->score > db->score ? -1 : 1;
+    }
+    if ( da->index != db->index )
+    {
+        return da->index < db->index ? -1 : 1;
+    }
+    if ( da->class_id != db->class_id )
+    {
+        return da->class_id < db->class_id ? -1 : 1;
+    }
+    return 0;
+} /* _compare_detection() */
+
+/*
+ * Move the k best detections to the front, in no particular order.
+ */
+static void _select_top_k
+    (
+    vsi_nn_detection_t * d,
+    uint32_t count,
+    uint32_t k
+    )
+{
+    int64_t left = 0;
+    int64_t right = (int64_t)count - 1;
+    int64_t target = (int64_t)k - 1;
+
+    while ( left < right )
+    {
+        vsi_nn_detection_t pivot = d[left + (right - left) / 2];
+        int64_t i = left;
+        int64_t j = right;
+
+        while ( i <= j )
+        {
+            while ( _compare_detection( &d[i], &pivot ) < 0 )
+            {
+                i++;
+            }
+            while ( _compare_detection( &d[j], &pivot ) > 0 )
+            {
+                j--;
+            }
+            if ( i <= j )
+            {
+                vsi_nn_detection_t tmp = d[i];
+                d[i] = d[j];
+                d[j] = tmp;
+                i++;
+                j--;
+            }
+        }
+        if ( target <= j )
+        {
+            right = j;
+        }
+        else if ( target >= i )
+        {
+            left = i;
+        }
+        else
+        {
+            break;
+        }
+    }
+} /* _select_top_k() */
+
+static uint32_t _collect_candidates
+    (
+    vsi_nn_detection_workspace_t * ws,
+    const float * scores,
+    uint32_t stride,
+    uint32_t count,
+    uint32_t class_id,
+    const uint32_t * class_ids,
+    const vsi_nn_detection_nms_param_t * param
+    )
+{
+    vsi_nn_detection_t * candidates = ws->candidates;
+    uint32_t num = 0;
+    uint32_t i = 0;
+
+    for ( i = 0; i < count; i++ )
+    {
+        float score = scores[(size_t)i * stride];
+        if ( score > param->score_thresh )
+        {
+            candidates[num].index = i;
+            candidates[num].class_id = class_ids ? class_ids[i] : class_id;
+            candidates[num].score = score;
+            num++;
+        }
+    }
+    if ( param->pre_nms_top_k > 0 && num > param->pre_nms_top_k )
+    {
+        _select_top_k( candidates, num, param->pre_nms_top_k );
+        num = param->pre_nms_top_k;
+    }
+    qsort( candidates, num, sizeof(vsi_nn_detection_t), _compare_detection );
+    return num;
+} /* _collect_candidates() */
+
+/*
+ * Greedy NMS over the sorted candidates. class_span > 0 shifts every
+ * class to its own coordinate range, see vsi_nn_DetectionBatchedNms().
+ */
+static uint32_t _nms_sorted
+    (
+    vsi_nn_detection_workspace_t * ws,
+    const float * boxes,
+    uint32_t num,
+    const vsi_nn_detection_nms_param_t * param,
+    float class_span,
+    vsi_nn_detection_t * detections,
+    uint32_t capacity
+    )
+{
+    const float offset = param->pixel_inclusive ? 1.0f : 0.0f;
+    const float thresh = param->iou_thresh;
+    float * x1 = ws->x1;
+    float * y1 = ws->y1;
+    float * x2 = ws->x2;
+    float * y2 = ws->y2;
+    float * area = ws->area;
+    uint8_t * suppressed = ws->suppressed;
+    uint32_t kept = 0;
+    uint32_t i = 0;
+    uint32_t j = 0;
+
+    for ( i = 0; i < num; i++ )
+    {
+        const float * box = boxes + (size_t)ws->candidates[i].index * 4;
+        float shift = class_span * (float)ws->candidates[i].class_id;
+
+        x1[i] = box[0] + shift;
+        y1[i] = box[1] + shift;
+        x2[i] = box[2] + shift;
+        y2[i] = box[3] + shift;
+        area[i] = (box[2] - box[0] + offset) * (box[3] - box[1] + offset);
+        suppressed[i] = 0;
+    }
+
+    for ( i = 0; i < num && kept < capacity; i++ )
+    {
+        float ix1, iy1, ix2, iy2, iarea;
+
+        if ( suppressed[i] )
+        {
+            continue;
+        }
+        detections[kept++] = ws->candidates[i];
+        ix1 = x1[i];
+        iy1 = y1[i];
+        ix2 = x2[i];
+        iy2 = y2[i];
+        iarea = area[i];
+        /*
+         * Only max style selects, anything else keeps gcc from vectorizing.
+         * Like py-faster-rcnn, boxes less than the pixel inclusive offset
+         * apart still intersect.
+         */
+        for ( j = i + 1; j < num; j++ )
+        {
+            float xx1 = x1[j] > ix1 ? x1[j] : ix1;
+            float yy1 = y1[j] > iy1 ? y1[j] : iy1;
+            float xx2 = x2[j] < ix2 ? x2[j] : ix2;
+            float yy2 = y2[j] < iy2 ? y2[j] : iy2;
+            float w = xx2 - xx1 + offset;
+            float h = yy2 - yy1 + offset;
+            float inter;
+
+            w = w > 0.0f ? w : 0.0f;
+            h = h > 0.0f ? h : 0.0f;
+            inter = w * h;
+
+            /* iou > thresh without the division */
+            suppressed[j] |= (uint8_t)( inter > thresh * ( iarea + area[j] - inter ) );
+        }
+    }
+    return kept;
+} /* _nms_sorted() */
+
+static void _decode_task
+    (
+    vsi_size_t begin,
+    vsi_size_t end,
+    void * user_data
+    )
+{
+    const _decode_args_t * args = (const _decode_args_t *)user_data;
+    const float * variance = args->variance;
+    vsi_size_t i = 0;
+
+    for ( i = begin; i < end; i++ )
+    {
+        const float * d = args->deltas + i * 4;
+        const float * a = args->anchors + i * 4;
+        float * box = args->boxes + i * 4;
+        float cx = a[0] + d[0] * variance[0] * a[2];
+        float cy = a[1] + d[1] * variance[1] * a[3];
+        float half_w = 0.5f * a[2] * expf( d[2] * variance[2] );
+        float half_h = 0.5f * a[3] * expf( d[3] * variance[3] );
+
+        box[0] = cx - half_w;
+        box[1] = cy - half_h;
+        box[2] = cx + half_w;
+        box[3] = cy + half_h;
+    }
+} /* _decode_task() */
+
+vsi_nn_detection_workspace_t * vsi_nn_DetectionCreateWorkspace
+    (
+    uint32_t max_boxes
+    )
+{
+    vsi_nn_detection_workspace_t * ws = NULL;
+
+    ws = (vsi_nn_detection_workspace_t *)malloc( sizeof(vsi_nn_detection_workspace_t) );
+    CHECK_PTR_FAIL_GOTO( ws, "Create detection workspace fail.", final );
+    memset( ws, 0, sizeof(vsi_nn_detection_workspace_t) );
+    if ( max_boxes > 0 && !_reserve( ws, max_boxes ) )
+    {
+        vsi_nn_DetectionReleaseWorkspace( &ws );
+    }
+final:
+    return ws;
+} /* vsi_nn_DetectionCreateWorkspace() */
+
+void vsi_nn_DetectionReleaseWorkspace
+    (
+    vsi_nn_detection_workspace_t ** workspace
+    )
+{
+    if ( workspace && *workspace )
+    {
+        _release_buffers( *workspace );
+        vsi_nn_safe_free( (*workspace)->merged );
+        free( *workspace );
+        *workspace = NULL;
+    }
+} /* vsi_nn_DetectionReleaseWorkspace() */
+
+vsi_status vsi_nn_DetectionDecodeBoxes
+    (
+    const float * deltas,
+    const float * anchors,
+    uint32_t count,
+    const float variance[4],
+    float * boxes
+    )
+{
+    _decode_args_t args;
+
+    if ( !deltas || !anchors || !variance || !boxes )
+    {
+        return VSI_FAILURE;
+    }
+    args.deltas = deltas;
+    args.anchors = anchors;
+    args.variance = variance;
+    args.boxes = boxes;
+    vsi_nn_kernel_cpu_parallel_for( count, 4096, _decode_task, &args );
+    return VSI_SUCCESS;
+} /* vsi_nn_DetectionDecodeBoxes() */
+
+vsi_status vsi_nn_DetectionNms
+    (
+    vsi_nn_detection_workspace_t * workspace,
+    const float * boxes,
+    const float * scores,
+    uint32_t count,
+    const vsi_nn_detection_nms_param_t * param,
+    vsi_nn_detection_t * detections,
+    uint32_t capacity,
+    uint32_t * kept
+    )
+{
+    uint32_t num = 0;
+
+    if ( !kept )
+    {
+        return VSI_FAILURE;
+    }
+    *kept = 0;
+    if ( !workspace || !boxes || !scores || !param || !detections
+        || !_reserve( workspace, count ) )
+    {
+        return VSI_FAILURE;
+    }
+    num = _collect_candidates( workspace, scores, 1, count, 0, NULL, param );
+    *kept = _nms_sorted( workspace, boxes, num, param, 0.0f, detections, capacity );
+    return VSI_SUCCESS;
+} /* vsi_nn_DetectionNms() */
+
+vsi_status vsi_nn_DetectionMultiClassNms
+    (
+    vsi_nn_detection_workspace_t * workspace,
+    const float * boxes,
+    const float * scores,
+    uint32_t count,
+    uint32_t class_num,
+    uint32_t first_class,
+    const vsi_nn_detection_nms_param_t * param,
+    vsi_nn_detection_t * detections,
+    uint32_t capacity,
+    uint32_t * kept
+    )
+{
+    uint32_t merged = 0;
+    uint32_t c = 0;
+
+    if ( !kept )
+    {
+        return VSI_FAILURE;
+    }
+    *kept = 0;
+    if ( !workspace || !boxes || !scores || !param || !detections
+        || !_reserve( workspace, count ) )
+    {
+        return VSI_FAILURE;
+    }
+    for ( c = first_class; c < class_num; c++ )
+    {
+        uint32_t num = _collect_candidates( workspace, scores + c, class_num,
+            count, c, NULL, param );
+        /* A class can not contribute more than capacity results. */
+        uint32_t limit = vsi_nn_min( num, capacity );
+
+        if ( !_reserve_merged( workspace, merged + limit ) )
+        {
+            return VSI_FAILURE;
+        }
+        merged += _nms_sorted( workspace, boxes, num, param, 0.0f,
+            workspace->merged + merged, limit );
+    }
+    qsort( workspace->merged, merged, sizeof(vsi_nn_detection_t), _compare_detection );
+    merged = vsi_nn_min( merged, capacity );
+    if ( merged > 0 )
+    {
+        memcpy( detections, workspace->merged, sizeof(vsi_nn_detection_t) * merged );
+    }
+    *kept = merged;
+    return VSI_SUCCESS;
+} /* vsi_nn_DetectionMultiClassNms() */
+
+vsi_status vsi_nn_DetectionBatchedNms
+    (
+    vsi_nn_detection_workspace_t * workspace,
+    const float * boxes,
+    const float * scores,
+    const uint32_t * class_ids,
+    uint32_t count,
+    const vsi_nn_detection_nms_param_t * param,
+    vsi_nn_detection_t * detections,
+    uint32_t capacity,
+    uint32_t * kept
+    )
+{
+    float min_coord = 0.0f;
+    float max_coord = 0.0f;
+    uint32_t num = 0;
+    uint32_t i = 0;
+
+    if ( !kept )
+    {
+        return VSI_FAILURE;
+    }
+    *kept = 0;
+    if ( !workspace || !boxes || !scores || !class_ids || !param || !detections
+        || !_reserve( workspace, count ) )
+    {
+        return VSI_FAILURE;
+    }
+    num = _collect_candidates( workspace, scores, 1, count, 0, class_ids, param );
+    if ( num > 0 )
+    {
+        min_coord = boxes[(size_t)workspace->candidates[0].index * 4];
+        max_coord = min_coord;
+    }
+    for ( i = 0; i < num; i++ )
+    {
+        const float * box = boxes + (size_t)workspace->candidates[i].index * 4;
+        min_coord = vsi_nn_min( min_coord, vsi_nn_min( box[0], box[1] ) );
+        max_coord = vsi_nn_max( max_coord, vsi_nn_max( box[2], box[3] ) );
+    }
+    /* Wide enough that shifted classes never touch, even pixel inclusive. */
+    *kept = _nms_sorted( workspace, boxes, num, param,
+        max_coord - min_coord + 2.0f, detections, capacity );
+    return VSI_SUCCESS;
+} /* vsi_nn_DetectionBatchedNms() */
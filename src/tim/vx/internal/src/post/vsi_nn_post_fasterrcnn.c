@@ -37,6 +37,7 @@
 #include "utils/vsi_nn_dtype_util.h"
 #include "utils/vsi_nn_util.h"
 #include "post/vsi_nn_post_fasterrcnn.h"
+#include "post/vsi_nn_post_detection.h"
 #include "vsi_nn_error.h"
 
 /*
@@ -84,28 +85,6 @@ static vsi_status _bbox_transform_inv
     float **boxes
     );
 
-static float detection_box_iou
-    (
-    float *A,
-    float *B
-    );
-
-static void detection_box_nms
-    (
-    float *box,
-    float thresh,
-    uint32_t rois_num,
-    uint32_t *keep,
-    uint32_t *num
-    );
-
-static void detection_box_qsort
-    (
-    float *box,
-    int32_t start,
-    int32_t end
-    );
-
 static void _init_box
     (
     vsi_nn_link_list_t *node
@@ -329,154 +308,6 @@ final:
     return status;
 }
 
-static float detection_box_iou
-    (
-    float *A,
-    float *B
-    )
-{
-    float x1,y1,x2,y2,width,height,area,A_area,B_area;
-
-    if (A[0] > B[2] || A[1] > B[3] || A[2] < B[0] || A[3] < B[1])
-    {
-        return 0;
-    }
-
-    /* overlapped region (=box) */
-    x1 = vsi_nn_max(A[0], B[0]);
-    y1 = vsi_nn_max(A[1], B[1]);
-    x2 = vsi_nn_min(A[2], B[2]);
-    y2 = vsi_nn_min(A[3], B[3]);
-
-    /* intersection area */
-    width    = vsi_nn_max(0.0f, x2 - x1 + 1.0f);
-    height   = vsi_nn_max(0.0f, y2 - y1 + 1.0f);
-    area     = width * height;
-
-    /* area of A, B */
-    A_area   = (A[2] - A[0] + 1.0f) * (A[3] - A[1] + 1.0f);
-    B_area   = (B[2] - B[0] + 1.0f) * (B[3] - B[1] + 1.0f);
-
-    /* IOU */
-    return area / (A_area + B_area - area);
-}
-
-static void detection_box_nms
-    (
-    float *box,
-    float thresh,
-    uint32_t rois_num,
-    uint32_t *keep,
-    uint32_t *num
-    )
-{
-    uint32_t i,j;
-    uint32_t *is_dead = NULL;
-
-    is_dead = (uint32_t *)malloc(sizeof(uint32_t) * rois_num);
-    CHECK_PTR_FAIL_GOTO( is_dead, "Create buffer fail.", final );
-    memset(is_dead, 0, sizeof(uint32_t) * rois_num);
-
-    for(i = 0; i < rois_num; i++)
-    {
-        if(is_dead[i])
-        {
-            continue;
-        }
-
-        for(j = i + 1; j < rois_num; ++j)
-        {
-            if(!is_dead[j] && detection_box_iou(&box[i * 5], &box[j * 5]) > thresh)
-            {
-                is_dead[j] = 1;
-            }
-        }
-    }
-
-    j = 0;
-    for(i=0; i<rois_num; i++)
-    {
-        if(!is_dead[i])
-        {
-            keep[j] = i;
-            j++;
-        }
-    }
-    *num = j;
-
-final:
-    vsi_nn_safe_free(is_dead);
-}
-
-static void detection_box_qsort
-    (
-    float *box,
-    int32_t start,
-    int32_t end
-    )
-{
-    /*
-        box[x] = {x1, y1, x2, y2, score};
-    */
-    int i;
-    float pivot_score = box[start * 5 + 4];
-    int32_t left = start + 1, right = end;
-    float temp[5];
-
-    while (left <= right)
-    {
-        while(left <= end && box[left * 5 + 4] >= pivot_score)
-            ++left;
-        while (right > start && box[right * 5 + 4] <= pivot_score)
-            --right;
-
-        if (left <= right)
-        {
-            /* swap box */
-            for(i = 0; i < 5; ++i)
-            {
-                temp[i] = box[left * 5 + i];
-            }
-            for(i = 0; i < 5; ++i)
-            {
-                box[left * 5 + i] = box[right * 5 + i];
-            }
-            for(i = 0; i < 5; ++i)
-            {
-                box[right * 5 + i] = temp[i];
-            }
-
-            ++left;
-            --right;
-        }
-    }
-
-    if (right > start)
-    {
-        for(i = 0; i < 5; ++i)
-        {
-            temp[i] = box[start * 5 + i];
-        }
-        for(i = 0; i < 5; ++i)
-        {
-            box[start * 5 + i] = box[right * 5 + i];
-        }
-        for(i = 0; i < 5; ++i)
-        {
-            box[right * 5 + i] = temp[i];
-        }
-    }
-
-    if(start < right - 1)
-    {
-        detection_box_qsort(box, start, right - 1);
-    }
-    if(right + 1 < end)
-    {
-        detection_box_qsort(box, right + 1, end);
-    }
-}
-
 static void _init_box(vsi_nn_link_list_t *node)
 {
     vsi_nn_fasterrcnn_box_t *box = NULL;
@@ -496,11 +327,13 @@ static vsi_status _fasterrcnn_post_process
     vsi_status status;
     uint32_t i,j,k;
     uint32_t rois_num,classes_num;
-    float *pred_boxes = NULL,*dets = NULL;
-    float *pdets = NULL, *ppred = NULL;
+    float *pred_boxes = NULL,*boxes = NULL,*scores = NULL;
+    float *pboxes = NULL, *ppred = NULL;
     vsi_nn_fasterrcnn_box_t *box = NULL;
-    uint32_t *keep = NULL,num;
-    float score;
+    vsi_nn_detection_workspace_t *workspace = NULL;
+    vsi_nn_detection_t *keep = NULL;
+    vsi_nn_detection_nms_param_t nms_param;
+    uint32_t num;
 
     if(NULL == rois || NULL == bbox || NULL == cls || NULL == param)
     {
@@ -524,71 +357,74 @@ static vsi_status _fasterrcnn_post_process
 
     rois_num = param->rois_num;
     classes_num = param->classes_num;
-    dets = (float *)malloc(sizeof(float) * 5 * rois_num);
-    if(NULL == dets)
+    boxes = (float *)malloc(sizeof(float) * 4 * rois_num);
+    scores = (float *)malloc(sizeof(float) * rois_num);
+    keep = (vsi_nn_detection_t *)malloc(sizeof(vsi_nn_detection_t) * rois_num);
+    workspace = vsi_nn_DetectionCreateWorkspace(rois_num);
+    if(NULL == boxes || NULL == scores || NULL == keep || NULL == workspace)
     {
         status = VSI_FAILURE;
         goto final;
     }
 
-    keep = NULL;
-    keep = (uint32_t *)malloc(sizeof(uint32_t) * rois_num);
-    if(NULL == keep)
-    {
-        status = VSI_FAILURE;
-        goto final;
-    }
+    /*
+        Boxes at or below conf_thresh can only suppress boxes that are
+        dropped anyway, so filtering them before nms keeps the result.
+    */
+    memset(&nms_param, 0, sizeof(nms_param));
+    nms_param.iou_thresh = param->nms_thresh;
+    nms_param.score_thresh = param->conf_thresh;
+    nms_param.pixel_inclusive = TRUE;
 
     /* i=1, skip background */
     for(i=1; i<param->classes_num; i++)
     {
         /* pred_boxes{rois_num,84} */
-        pdets = dets;
+        pboxes = boxes;
         ppred = pred_boxes + 4 * i;
         for(j=0; j<rois_num; j++)
         {
-            pdets[0] = ppred[0];
-            pdets[1] = ppred[1];
-            pdets[2] = ppred[2];
-            pdets[3] = ppred[3];
-            pdets[4] = cls[j*classes_num + i];
+            pboxes[0] = ppred[0];
+            pboxes[1] = ppred[1];
+            pboxes[2] = ppred[2];
+            pboxes[3] = ppred[3];
+            scores[j] = cls[j*classes_num + i];
 
-            pdets += 5;
+            pboxes += 4;
             ppred += classes_num*4;
         }
 
-        detection_box_qsort(dets, 0, rois_num - 1);
-
-        num = 0;
-        memset(keep, 0, sizeof(int32_t) * rois_num);
-        detection_box_nms(dets, param->nms_thresh, rois_num, keep, &num);
+        status = vsi_nn_DetectionNms(workspace, boxes, scores, rois_num,
+            &nms_param, keep, rois_num, &num);
+        if(status != VSI_SUCCESS)
+        {
+            goto final;
+        }
 
         for(k=0; k<num; k++)
         {
-            score = dets[keep[k]*5+4];
-            if(score > param->conf_thresh)
+            if(NULL != dets_box)
             {
-                if(NULL != dets_box)
-                {
-                    box = (vsi_nn_fasterrcnn_box_t *)
-                        vsi_nn_LinkListNewNode(sizeof(vsi_nn_fasterrcnn_box_t), _init_box);
-                    box->score = dets[keep[k]*5+4];
-                    box->class_id = i;
-                    box->x1 = dets[keep[k]*5+0];
-                    box->y1 = dets[keep[k]*5+1];
-                    box->x2 = dets[keep[k]*5+2];
-                    box->y2 = dets[keep[k]*5+3];
-                    vsi_nn_LinkListPushStart(
-                        (vsi_nn_link_list_t **)dets_box,
-                        (vsi_nn_link_list_t *)box );
-                }
+                box = (vsi_nn_fasterrcnn_box_t *)
+                    vsi_nn_LinkListNewNode(sizeof(vsi_nn_fasterrcnn_box_t), _init_box);
+                box->score = keep[k].score;
+                box->class_id = i;
+                box->x1 = boxes[keep[k].index*4+0];
+                box->y1 = boxes[keep[k].index*4+1];
+                box->x2 = boxes[keep[k].index*4+2];
+                box->y2 = boxes[keep[k].index*4+3];
+                vsi_nn_LinkListPushStart(
+                    (vsi_nn_link_list_t **)dets_box,
+                    (vsi_nn_link_list_t *)box );
             }
         }
     }
 
 final:
+    vsi_nn_DetectionReleaseWorkspace(&workspace);
     if(keep)free(keep);
-    if(dets)free(dets);
+    if(scores)free(scores);
+    if(boxes)free(boxes);
     if(pred_boxes)free(pred_boxes);
     return status;
 } /* _fasterrcnn_post_process() */
@@ -28,6 +28,7 @@
 #include "vsi_nn_ops.h"
 #include "vsi_nn_client_op.h"
 #include "utils/vsi_nn_binary_tree.h"
+#include "utils/vsi_nn_rwlock.h"
 
 
 typedef struct _client_node
@@ -37,8 +38,21 @@ typedef struct _client_node
     const char*                kernel_name;
 } _client_node_t;
 
+/* Guards s_root, see vsi_nn_rwlock.h */
+static vsi_nn_rwlock_t s_lock = VSI_NN_RWLOCK_INITIALIZER;
 static vsi_nn_binary_tree_t * s_root = NULL;
 
+/* Caller holds s_lock */
+static _client_node_t * _get_client_node
+    (
+    vsi_nn_op_t op
+    )
+{
+    return (_client_node_t *)vsi_nn_BinaryTreeGetNode(
+        &s_root,
+        (vsi_nn_binary_tree_key_t)op );
+} /* _get_client_node() */
+
 static _client_node_t * _create_client_node
     (
     vsi_nn_op_t op,
@@ -85,8 +99,10 @@ vsi_bool vsi_nn_OpRegisterClient
     _client_node_t * node;
 
     ret = FALSE;
-    if( TRUE ==  vsi_nn_OpIsRegistered( op ) )
+    vsi_nn_rwlock_wrlock( &s_lock );
+    if( NULL != _get_client_node( op ) )
     {
+        vsi_nn_rwlock_wrunlock( &s_lock );
         VSILOGE( "OP %#x has been registered.", op );
         return ret;
     }
@@ -101,6 +117,7 @@ vsi_bool vsi_nn_OpRegisterClient
             );
         ret = TRUE;
     }
+    vsi_nn_rwlock_wrunlock( &s_lock );
     return ret;
 } /* vsi_nn_OpRegisterClient() */
 
@@ -113,9 +130,11 @@ vsi_nn_op_proc_t * vsi_nn_OpGetClient
     _client_node_t * node;
 
     proc = NULL;
-    node = (_client_node_t *)vsi_nn_BinaryTreeGetNode(
-        &s_root,
-        (vsi_nn_binary_tree_key_t)op );
+    /* The node stays valid until the op is removed, ops must not be removed
+     * while graphs using them are set up. */
+    vsi_nn_rwlock_rdlock( &s_lock );
+    node = _get_client_node( op );
+    vsi_nn_rwlock_rdunlock( &s_lock );
     if( NULL != node )
     {
         proc = &node->proc;
@@ -130,14 +149,14 @@ void vsi_nn_OpRemoveClient
 {
     _client_node_t * node;
 
-    node = (_client_node_t *)vsi_nn_BinaryTreeGetNode(
-        &s_root,
-        (vsi_nn_binary_tree_key_t)op );
+    vsi_nn_rwlock_wrlock( &s_lock );
+    node = _get_client_node( op );
     if( NULL != node )
     {
         _release_client_node( &node );
         vsi_nn_BinaryTreeRemoveNode( &s_root, op );
     }
+    vsi_nn_rwlock_wrunlock( &s_lock );
 } /* vsi_nn_OpRemoveClient() */
 
 vsi_bool vsi_nn_OpAddClientName
@@ -150,14 +169,14 @@ vsi_bool vsi_nn_OpAddClientName
      vsi_bool ret;
 
     ret = FALSE;
-    node = (_client_node_t *)vsi_nn_BinaryTreeGetNode(
-        &s_root,
-        (vsi_nn_binary_tree_key_t)op );
+    vsi_nn_rwlock_wrlock( &s_lock );
+    node = _get_client_node( op );
     if( NULL != node && NULL != kernel_name)
     {
         node->kernel_name = kernel_name;
         ret = TRUE;
     }
+    vsi_nn_rwlock_wrunlock( &s_lock );
     return ret;
 }/* vsi_nn_OpAddClientName() */
 
@@ -167,14 +186,13 @@ const char * vsi_nn_OpGetClientName
     )
 {
     _client_node_t * node;
+    const char * name = NULL;
 
-    node = (_client_node_t *)vsi_nn_BinaryTreeGetNode(
-        &s_root,
-        (vsi_nn_binary_tree_key_t)op );
-
+    vsi_nn_rwlock_rdlock( &s_lock );
+    node = _get_client_node( op );
     if( NULL != node ){
-        return node->kernel_name;
-    }else{
-        return NULL;
+        name = node->kernel_name;
     }
+    vsi_nn_rwlock_rdunlock( &s_lock );
+    return name;
 } /* vsi_nn_OpGetClientName() */
\ No newline at end of file
@@ -26,6 +26,7 @@
 #include "vsi_nn_test.h"
 #include "vsi_nn_context.h"
 #include "vsi_nn_platform.h"
+#include "kernel/vsi_nn_kernel_lut.h"
 
 static vsi_status query_hardware_caps
     (
@@ -198,6 +199,7 @@ void vsi_nn_ReleaseContext
         vsi_nn_context_t context = *ctx;
         if(context->c)
         {
+            vsi_nn_kernel_lut_release_context( context->c );
             vxReleaseContext( &context->c);
         }
         free(context);
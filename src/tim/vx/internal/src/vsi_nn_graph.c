@@ -32,6 +32,7 @@
 #include "vsi_nn_types.h"
 #include "vsi_nn_ops.h"
 #include "vsi_nn_prv.h"
+#include "vsi_nn_types_prv.h"
 #include "vsi_nn_rnn.h"
 #include "vsi_nn_test.h"
 #include "vsi_nn_internal_node.h"
@@ -374,7 +375,10 @@ static vsi_status compute_node
 
         /* Create vx node */
         VSILOGD("Instance node[%d] \"%s\" ...", node_id, vsi_nn_OpGetName(node->op));
+        node->attr.selected_kernel_types = 0;
+        ((vsi_nn_graph_prv_t*)graph)->compute_node = node;
         status = vsi_nn_OpCompute( node->op, node, inputs, outputs );
+        ((vsi_nn_graph_prv_t*)graph)->compute_node = NULL;
         if( VSI_SUCCESS != status )
         {
             VSILOGE( "Create node[%d] %s fail", node_id, vsi_nn_OpGetName(node->op));
@@ -567,10 +571,10 @@ vsi_nn_graph_t * vsi_nn_CreateGraph
         return graph;
     }
 
-    graph = (vsi_nn_graph_t *)malloc( sizeof( vsi_nn_graph_t ) );
+    graph = (vsi_nn_graph_t *)malloc( sizeof( vsi_nn_graph_prv_t ) );
     if( NULL != graph )
     {
-        memset( graph, 0, sizeof( vsi_nn_graph_t ) );
+        memset( graph, 0, sizeof( vsi_nn_graph_prv_t ) );
         graph->g = vxCreateGraph( ctx->c );
         if( NULL != graph->g )
         {
@@ -41,6 +41,9 @@ typedef struct _vsi_nn_graph_prv
     /** Public Ovxlib Graph(pot)*/
     vsi_nn_graph_t pog;
 
+    /** Node being computed, kernels selected meanwhile are credited to it */
+    vsi_nn_node_t* compute_node;
+
     // Add graph internal attribute here...
 } vsi_nn_graph_prv_t;
 
@@ -0,0 +1,133 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "kernel/vsi_nn_kernel_cpu.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+const vsi_size_t kRowSize = 16;
+
+struct Coverage {
+  std::vector<std::atomic<int>>* hits;
+  vsi_size_t offset;
+};
+
+void MarkRange(vsi_size_t begin, vsi_size_t end, void* user_data) {
+  auto* coverage = static_cast<Coverage*>(user_data);
+  for (vsi_size_t i = begin; i < end; ++i) {
+    (*coverage->hits)[coverage->offset + i]++;
+  }
+}
+
+// Every row index marks its own row through a nested parallel_for.
+void MarkRows(vsi_size_t begin, vsi_size_t end, void* user_data) {
+  auto* coverage = static_cast<Coverage*>(user_data);
+  for (vsi_size_t row = begin; row < end; ++row) {
+    Coverage inner = {coverage->hits, row * kRowSize};
+    vsi_nn_kernel_cpu_parallel_for(kRowSize, 1, MarkRange, &inner);
+  }
+}
+
+}  // namespace
+
+TEST(KernelCpu, parallel_for_covers_every_index_once) {
+  const vsi_size_t total = 100003;
+  std::vector<std::atomic<int>> hits(total);
+  Coverage coverage = {&hits, 0};
+
+  EXPECT_GE(vsi_nn_kernel_cpu_get_thread_num(), 1u);
+  vsi_nn_kernel_cpu_parallel_for(total, 7, MarkRange, &coverage);
+
+  for (vsi_size_t i = 0; i < total; ++i) {
+    ASSERT_EQ(1, hits[i].load()) << "index " << i;
+  }
+}
+
+TEST(KernelCpu, parallel_for_nested_and_concurrent) {
+  const vsi_size_t total = 4096;
+  const int callers = 8;
+  std::vector<std::atomic<int>> hits(total);
+  std::vector<std::thread> threads;
+
+  for (int t = 0; t < callers; ++t) {
+    threads.emplace_back([&hits]() {
+      Coverage coverage = {&hits, 0};
+      for (int round = 0; round < 50; ++round) {
+        vsi_nn_kernel_cpu_parallel_for(total, 64, MarkRange, &coverage);
+      }
+    });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+  for (vsi_size_t i = 0; i < total; ++i) {
+    ASSERT_EQ(callers * 50, hits[i].load()) << "index " << i;
+  }
+
+  // A task that calls back into the pool must not deadlock.
+  const vsi_size_t rows = 64;
+  std::vector<std::atomic<int>> nested_hits(rows * kRowSize);
+  Coverage coverage = {&nested_hits, 0};
+  vsi_nn_kernel_cpu_parallel_for(rows, 1, MarkRows, &coverage);
+  for (auto& hit : nested_hits) {
+    ASSERT_EQ(1, hit.load());
+  }
+}
+
+TEST(KernelCpu, quantized_helpers) {
+  vsi_nn_kernel_tensor_attr_t u8_attr = {};
+  u8_attr.dtype = U8;
+  u8_attr.quant = VSI_NN_KERNEL_QUANT_ASYMM;
+  u8_attr.asymm.scale = 0.5f;
+  u8_attr.asymm.zero_point = 10;
+  vsi_nn_kernel_tensor_attr_t other = u8_attr;
+
+  EXPECT_TRUE(vsi_nn_kernel_cpu_is_same_quant(&u8_attr, &other));
+  other.asymm.zero_point = 11;
+  EXPECT_FALSE(vsi_nn_kernel_cpu_is_same_quant(&u8_attr, &other));
+  other = u8_attr;
+  other.dtype = I8;
+  EXPECT_FALSE(vsi_nn_kernel_cpu_is_same_quant(&u8_attr, &other));
+
+  float table[256];
+  ASSERT_EQ(VSI_SUCCESS, vsi_nn_kernel_cpu_dequantize_table(&u8_attr, table));
+  EXPECT_FLOAT_EQ(-5.0f, table[0]);
+  EXPECT_FLOAT_EQ(0.0f, table[10]);
+  EXPECT_FLOAT_EQ(122.5f, table[255]);
+
+  uint8_t codes[256];
+  ASSERT_EQ(VSI_SUCCESS, vsi_nn_kernel_cpu_quantize(&u8_attr, table, 256, codes));
+  for (int i = 0; i < 256; ++i) {
+    EXPECT_EQ(i, codes[i]);
+  }
+
+  vsi_nn_kernel_tensor_attr_t f32_attr = {};
+  f32_attr.dtype = F32;
+  EXPECT_NE(VSI_SUCCESS, vsi_nn_kernel_cpu_dequantize_table(&f32_attr, table));
+}
@@ -0,0 +1,118 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "kernel/vsi_nn_kernel_lut.h"
+
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+vsi_nn_kernel_lut_params MakeParams(vsi_enum act_type, float alpha) {
+  vsi_nn_kernel_lut_params param;
+  memset(&param, 0, sizeof(param));
+  param.act_type = act_type;
+  param.params[0] = alpha;
+  return param;
+}
+
+}  // namespace
+
+TEST(KernelLut, cached_table_matches_generated) {
+  vsi_nn_kernel_lut_params param = MakeParams(VSI_NN_KERNEL_LUT_GELU, 0);
+  vsi_nn_kernel_lut_table_t expected;
+  ASSERT_EQ(VSI_SUCCESS, vsi_nn_kernel_lut_generate(&param, &expected));
+
+  const vsi_nn_kernel_lut_table_t* table = vsi_nn_kernel_lut_get_table(&param);
+  ASSERT_NE(nullptr, table);
+  EXPECT_EQ(0, memcmp(expected.index, table->index, sizeof(expected.index)));
+  EXPECT_EQ(0, memcmp(expected.value, table->value, sizeof(expected.value)));
+  for (uint32_t i = 1; i < VSI_NN_KERNEL_LUT_MAX_SIZE; ++i) {
+    EXPECT_LE(table->index[i - 1], table->index[i]);
+  }
+}
+
+TEST(KernelLut, same_params_share_one_table) {
+  vsi_nn_kernel_lut_params param = MakeParams(VSI_NN_KERNEL_LUT_CELU, 1.25f);
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  uint32_t hits_after = 0;
+  uint32_t misses_after = 0;
+
+  const vsi_nn_kernel_lut_table_t* first = vsi_nn_kernel_lut_get_table(&param);
+  ASSERT_NE(nullptr, first);
+  vsi_nn_kernel_lut_cache_query(nullptr, &hits, &misses);
+  EXPECT_EQ(first, vsi_nn_kernel_lut_get_table(&param));
+  vsi_nn_kernel_lut_cache_query(nullptr, &hits_after, &misses_after);
+  EXPECT_EQ(hits + 1, hits_after);
+  EXPECT_EQ(misses, misses_after);
+
+  // clamp_min means nothing without the sign flag.
+  vsi_nn_kernel_lut_params clamped = param;
+  clamped.clamp_min = -3.0f;
+  EXPECT_EQ(first, vsi_nn_kernel_lut_get_table(&clamped));
+
+  clamped.pwl_sign_remove_support = TRUE;
+  EXPECT_NE(first, vsi_nn_kernel_lut_get_table(&clamped));
+
+  vsi_nn_kernel_lut_params other = MakeParams(VSI_NN_KERNEL_LUT_CELU, 0.5f);
+  EXPECT_NE(first, vsi_nn_kernel_lut_get_table(&other));
+}
+
+TEST(KernelLut, concurrent_lookups_share_one_table) {
+  vsi_nn_kernel_lut_params param = MakeParams(VSI_NN_KERNEL_LUT_SELU, 1.75f);
+  param.params[1] = 1.05f;
+  const uint32_t kLookups = 100;
+  std::vector<const vsi_nn_kernel_lut_table_t*> tables(8, nullptr);
+  std::vector<std::thread> threads;
+  uint32_t hits = 0;
+  uint32_t misses = 0;
+  vsi_nn_kernel_lut_cache_query(nullptr, &hits, &misses);
+
+  for (size_t i = 0; i < tables.size(); ++i) {
+    threads.emplace_back([&tables, &param, i]() {
+      for (uint32_t n = 0; n < kLookups; ++n) {
+        auto table = vsi_nn_kernel_lut_get_table(&param);
+        if (n > 0 && table != tables[i]) table = nullptr;
+        tables[i] = table;
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  ASSERT_NE(nullptr, tables[0]);
+  for (auto* table : tables) {
+    EXPECT_EQ(tables[0], table);
+  }
+  // Hits counted under the shared lock are not lost
+  uint32_t hits_after = 0;
+  uint32_t misses_after = 0;
+  vsi_nn_kernel_lut_cache_query(nullptr, &hits_after, &misses_after);
+  EXPECT_EQ(misses + 1, misses_after);
+  EXPECT_EQ(hits + tables.size() * kLookups - 1, hits_after);
+}
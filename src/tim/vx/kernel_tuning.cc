@@ -0,0 +1,321 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "kernel_tuning.h"
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#include "compile_cache.h"
+#include "graph_private.h"
+#include "kernel/vsi_nn_kernel.h"
+#include "op_impl.h"
+#include "op_signature.h"
+#include "tim/vx/compile_option.h"
+#include "tim/vx/operation.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace {
+
+// Bump when the content of the tuning key changes
+constexpr uint32_t kTuningKeyVersion = 1;
+constexpr char kTuningDBHeader[] = "# tim-vx kernel tuning database";
+constexpr int kWarmupRuns = 2;
+constexpr int kMeasureRuns = 10;
+// Candidates must beat the default kernels by this factor, timing noise would
+// otherwise flip choices between runs
+constexpr float kMinSpeedup = 1.05f;
+
+bool IsTunable(const std::shared_ptr<Operation>& op) {
+  const auto& impl = op->impl();
+  if (nullptr == impl->node() || -1 == impl->kind_ ||
+      !HasOpParams(impl->kind_)) {
+    return false;
+  }
+  auto tensors = impl->InputsTensor();
+  auto outputs = impl->OutputsTensor();
+  tensors.insert(tensors.end(), outputs.begin(), outputs.end());
+  for (const auto& t : tensors) {
+    if (t->IsPlaceHolder()) continue;
+    const auto& shape = t->GetSpec().shape_;
+    if (shape.empty()) return false;
+    for (auto dim : shape) {
+      if (0 == dim) return false;
+    }
+  }
+  return true;
+}
+
+// Constant data and graph inputs/outputs do not change which kernel is
+// fastest, tensors are described by spec only
+std::string TuningKey(GraphImpl* graph, const std::shared_ptr<Operation>& op) {
+  OpSignature signature;
+  signature.Append(kTuningKeyVersion);
+  AppendTargetSignature(graph, signature);
+  signature.Append(graph->GetCompileOption().isRelaxMode());
+  if (!AppendOpParams(op, signature)) return std::string();
+
+  auto inputs = op->impl()->InputsTensor();
+  auto outputs = op->impl()->OutputsTensor();
+  signature.Append(uint32_t(inputs.size())).Append(uint32_t(outputs.size()));
+  inputs.insert(inputs.end(), outputs.begin(), outputs.end());
+  for (const auto& t : inputs) {
+    if (t->IsPlaceHolder()) {
+      signature.Append(int32_t(-1));
+      continue;
+    }
+    TensorSpec spec = t->GetSpec();
+    if (TensorAttribute::CONSTANT != spec.attr_) {
+      spec.attr_ = TensorAttribute::TRANSIENT;
+    }
+    signature.Append(spec);
+  }
+  return SignatureDigest(signature.str());
+}
+
+std::string KernelTypesName(int32_t kernel_types) {
+  if (0 == kernel_types) return "default";
+  std::string name;
+  for (int32_t type = VSI_NN_KERNEL_TYPE_CPU; type < VSI_NN_KERNEL_TYPE_NUM;
+       ++type) {
+    if (0 == (kernel_types & (1 << type))) continue;
+    if (!name.empty()) name += "|";
+    name += vsi_nn_kernel_type_str(static_cast<vsi_nn_kernel_type_e>(type));
+  }
+  return name;
+}
+
+/// Deterministic pseudo-random bytes, small enough to stay finite in any
+/// data type, so kernels with data dependent paths are timed realistically.
+void FillInput(std::vector<uint8_t>& data, uint32_t seed) {
+  for (auto& byte : data) {
+    seed = seed * 1664525u + 1013904223u;
+    byte = static_cast<uint8_t>((seed >> 24) & 0x3f);
+  }
+}
+
+/// Average run time in ms of `op` alone in a new graph with `kernel_types`
+/// preferred, negative if the graph fails or no preferred kernel is instanced.
+/// `selected` receives the kernel types instanced for the node.
+float MeasureNode(GraphImpl* graph, const std::shared_ptr<Operation>& op,
+                  int32_t kernel_types, int32_t* selected) {
+  CompileOption options;
+  options.setRelaxMode(graph->GetCompileOption().isRelaxMode());
+  auto single = graph->GetContext()->CreateGraph(options);
+
+  std::vector<std::vector<uint8_t>> const_data;
+  std::vector<std::shared_ptr<Tensor>> inputs;
+  std::vector<std::shared_ptr<Tensor>> outputs;
+  std::vector<std::shared_ptr<Tensor>> graph_inputs;
+  for (const auto& t : op->impl()->InputsTensor()) {
+    if (t->IsPlaceHolder()) {
+      inputs.push_back(single->CreateTensorPlaceHolder());
+      continue;
+    }
+    TensorSpec spec = t->GetSpec();
+    if (t->IsConstTensor()) {
+      const_data.emplace_back(spec.GetByteSize());
+      if (!t->CopyDataFromTensor(const_data.back().data())) return -1;
+      inputs.push_back(single->CreateTensor(spec, const_data.back().data()));
+    } else {
+      spec.attr_ = TensorAttribute::INPUT;
+      inputs.push_back(single->CreateTensor(spec));
+      graph_inputs.push_back(inputs.back());
+    }
+  }
+  for (const auto& t : op->impl()->OutputsTensor()) {
+    if (t->IsPlaceHolder()) {
+      outputs.push_back(single->CreateTensorPlaceHolder());
+      continue;
+    }
+    TensorSpec spec = t->GetSpec();
+    spec.attr_ = TensorAttribute::OUTPUT;
+    outputs.push_back(single->CreateTensor(spec));
+  }
+
+  auto clone = op->Clone(single);
+  auto node = clone->impl()->node();
+  if (nullptr == node) return -1;
+  node->vx_param = op->impl()->node()->vx_param;
+  (*clone).BindInputs(inputs).BindOutputs(outputs);
+  // Clone rebuilds the operation from its public parameters, only time it if
+  // it describes the same node
+  OpSignature original;
+  OpSignature cloned;
+  if (!AppendOpParams(op, original) || !AppendOpParams(clone, cloned) ||
+      original.str() != cloned.str()) {
+    VSILOGD("Op %d: clone differs from the original node.",
+            op->impl()->kind_);
+    return -1;
+  }
+
+  node->attr.preferred_kernel_types = kernel_types;
+  if (!single->Compile()) return -1;
+  *selected = node->attr.selected_kernel_types;
+  if (0 != kernel_types && 0 == (*selected & kernel_types)) return -1;
+
+  // Same data for every kernel type measured
+  for (size_t i = 0; i < graph_inputs.size(); ++i) {
+    std::vector<uint8_t> data(graph_inputs[i]->GetSpec().GetByteSize());
+    FillInput(data, static_cast<uint32_t>(i + 1));
+    if (!graph_inputs[i]->CopyDataToTensor(data.data(), data.size())) {
+      return -1;
+    }
+  }
+  for (int i = 0; i < kWarmupRuns; ++i) {
+    if (!single->Run()) return -1;
+  }
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kMeasureRuns; ++i) {
+    if (!single->Run()) return -1;
+  }
+  std::chrono::duration<float, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count() / kMeasureRuns;
+}
+
+/// Time the default kernels of `op` against preferring each kernel type.
+/// Nodes not instanced through the kernel selector keep zero times.
+KernelTuningRecord MeasureKernels(GraphImpl* graph,
+                                  const std::shared_ptr<Operation>& op) {
+  KernelTuningRecord record;
+  int32_t default_types = 0;
+  float default_ms = MeasureNode(graph, op, 0, &default_types);
+  if (default_ms <= 0 || 0 == default_types) return record;
+
+  record.default_ms = default_ms;
+  record.best_ms = default_ms;
+  for (int32_t type = VSI_NN_KERNEL_TYPE_CPU; type < VSI_NN_KERNEL_TYPE_NUM;
+       ++type) {
+    int32_t candidate = 1 << type;
+    if (candidate == default_types) continue;
+    int32_t selected = 0;
+    float ms = MeasureNode(graph, op, candidate, &selected);
+    if (ms <= 0 || selected == default_types) continue;
+    VSILOGD("Op %d: %s kernels %.3f ms, default %.3f ms.", op->impl()->kind_,
+            KernelTypesName(selected).c_str(), ms, default_ms);
+    if (ms * kMinSpeedup < default_ms && ms < record.best_ms) {
+      record.kernel_types = candidate;
+      record.best_ms = ms;
+    }
+  }
+  return record;
+}
+
+}  // namespace
+
+KernelTuningStatistics TuneKernels(GraphImpl* graph) {
+  KernelTuningStatistics statistics;
+  const auto& options = graph->GetCompileOption();
+  const std::string path = options.getKernelTuningDB();
+  const bool measure = options.isKernelTuning();
+
+  KernelTuningDB db;
+  if (!path.empty() && !LoadKernelTuningDB(path, db)) {
+    VSILOGI("Kernel tuning database %s not found.", path.c_str());
+  }
+
+  bool updated = false;
+  for (const auto& op : graph->OpVector()) {
+    if (!IsTunable(op)) continue;
+    std::string key = TuningKey(graph, op);
+    if (key.empty()) continue;
+
+    KernelTuningRecord record;
+    auto found = db.find(key);
+    if (db.end() != found) {
+      record = found->second;
+      statistics.loaded_nodes++;
+    } else if (measure) {
+      // Nodes without alternative kernels are stored too, so that they are
+      // not measured again
+      record = MeasureKernels(graph, op);
+      db[key] = record;
+      updated = true;
+      statistics.measured_nodes++;
+    } else {
+      continue;
+    }
+    if (record.default_ms <= 0) continue;
+
+    auto node = op->impl()->node();
+    node->attr.preferred_kernel_types = record.kernel_types;
+    if (0 != record.kernel_types) statistics.tuned_nodes++;
+    KernelTuningChoice choice;
+    choice.node_id = node->uid;
+    choice.kind = op->impl()->kind_;
+    choice.record = record;
+    statistics.choices.push_back(choice);
+    VSILOGI("Kernel tuning: node[%u] op %d runs %s kernels, %.3f ms -> %.3f ms.",
+            choice.node_id, choice.kind,
+            KernelTypesName(record.kernel_types).c_str(), record.default_ms,
+            record.best_ms);
+  }
+
+  if (updated && !path.empty()) {
+    // Keep records stored meanwhile by other graphs sharing the database
+    LoadKernelTuningDB(path, db);
+    if (!StoreKernelTuningDB(path, db)) {
+      VSILOGW("Store kernel tuning database to %s fail.", path.c_str());
+    }
+  }
+  return statistics;
+}
+
+bool LoadKernelTuningDB(const std::string& path, KernelTuningDB& db) {
+  std::ifstream file(path);
+  if (!file) return false;
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty() || '#' == line[0]) continue;
+    std::istringstream fields(line);
+    std::string key;
+    KernelTuningRecord record;
+    if (!(fields >> key >> record.kernel_types >> record.default_ms >>
+          record.best_ms)) {
+      VSILOGW("Skip malformed kernel tuning record: %s", line.c_str());
+      continue;
+    }
+    db.emplace(key, record);
+  }
+  return true;
+}
+
+bool StoreKernelTuningDB(const std::string& path, const KernelTuningDB& db) {
+  std::ostringstream text;
+  text << kTuningDBHeader << "\n";
+  for (const auto& entry : db) {
+    text << entry.first << " " << entry.second.kernel_types << " "
+         << entry.second.default_ms << " " << entry.second.best_ms << "\n";
+  }
+  const std::string& data = text.str();
+  return StoreCompiledGraph(path, std::vector<char>(data.begin(), data.end()));
+}
+
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,78 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_KERNEL_TUNING_H_
+#define TIM_VX_KERNEL_TUNING_H_
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace tim {
+namespace vx {
+
+class GraphImpl;
+
+struct KernelTuningRecord {
+  // Bitmask of (1 << vsi_nn_kernel_type_e) preferred by the kernel selector,
+  // 0 keeps the default priorities
+  int32_t kernel_types{0};
+  // Average run time of the node with default and with chosen kernels
+  float default_ms{0};
+  float best_ms{0};
+};
+
+/// Kernel choices keyed by the digest of operation, tensor specs and target
+using KernelTuningDB = std::map<std::string, KernelTuningRecord>;
+
+struct KernelTuningChoice {
+  uint32_t node_id{0};
+  int32_t kind{0};
+  KernelTuningRecord record;
+};
+
+struct KernelTuningStatistics {
+  // Nodes running a non-default kernel
+  uint32_t tuned_nodes{0};
+  // Choices found in the tuning database or measured by this compile
+  uint32_t loaded_nodes{0};
+  uint32_t measured_nodes{0};
+  std::vector<KernelTuningChoice> choices;
+};
+
+/// Choose the kernel backend of every builtin operation instanced through the
+/// ovxlib kernel selector. Choices come from the tuning database, missing ones
+/// are measured with single-node graphs if kernel tuning is enabled.
+KernelTuningStatistics TuneKernels(GraphImpl* graph);
+
+/// Merge records read from `path` into `db`, entries already in `db` are kept
+bool LoadKernelTuningDB(const std::string& path, KernelTuningDB& db);
+
+/// Write `db` as text, a concurrent reader never sees a partial file
+bool StoreKernelTuningDB(const std::string& path, const KernelTuningDB& db);
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_KERNEL_TUNING_H_ */
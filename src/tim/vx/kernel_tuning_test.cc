@@ -0,0 +1,103 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "kernel_tuning.h"
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/compile_option.h"
+#include "tim/vx/ops/activations.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+TEST(kernel_tuning, database_round_trip) {
+  std::string path = ::testing::TempDir() + "/kernel_tuning_round_trip.db";
+  tim::vx::KernelTuningDB db;
+  db["0123456789abcdef0123456789abcdef"] = {1 << 2, 1.5f, 0.5f};
+  db["fedcba9876543210fedcba9876543210"] = {0, 0, 0};
+  ASSERT_TRUE(tim::vx::StoreKernelTuningDB(path, db));
+  {
+    std::ofstream file(path, std::ios::app);
+    file << "malformed record\n";
+  }
+
+  tim::vx::KernelTuningDB loaded;
+  loaded["fedcba9876543210fedcba9876543210"] = {1, 2, 1};
+  ASSERT_TRUE(tim::vx::LoadKernelTuningDB(path, loaded));
+  EXPECT_EQ(loaded.size(), 2u);
+  const auto& tuned = loaded["0123456789abcdef0123456789abcdef"];
+  EXPECT_EQ(tuned.kernel_types, 1 << 2);
+  EXPECT_FLOAT_EQ(tuned.default_ms, 1.5f);
+  EXPECT_FLOAT_EQ(tuned.best_ms, 0.5f);
+  // Records already in memory win over the stored ones
+  EXPECT_EQ(loaded["fedcba9876543210fedcba9876543210"].kernel_types, 1);
+
+  EXPECT_FALSE(tim::vx::LoadKernelTuningDB(path + ".missing", loaded));
+}
+
+TEST(kernel_tuning, reuse_tuning_database) {
+  auto ctx = tim::vx::Context::Create();
+  std::string path = ::testing::TempDir() + "/kernel_tuning_reuse.db";
+  std::remove(path.c_str());
+
+  tim::vx::ShapeType shape({8, 4});
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shape,
+                                  tim::vx::TensorAttribute::OUTPUT);
+  std::vector<float> in_data(8 * 4);
+  std::vector<float> golden(in_data.size());
+  for (size_t i = 0; i < in_data.size(); ++i) {
+    in_data[i] = static_cast<float>(i) - 16;
+    golden[i] = in_data[i] > 0 ? in_data[i] : 0;
+  }
+
+  // The first compile measures the node and stores its choice, the second
+  // one only loads it
+  for (int i = 0; i < 2; ++i) {
+    tim::vx::CompileOption option;
+    option.setKernelTuning(0 == i);
+    option.setKernelTuningDB(path);
+    auto graph = ctx->CreateGraph(option);
+    auto input = graph->CreateTensor(input_spec);
+    auto output = graph->CreateTensor(output_spec);
+    auto relu = graph->CreateOperation<tim::vx::ops::Relu>();
+    (*relu).BindInput(input).BindOutput(output);
+
+    EXPECT_TRUE(graph->Compile());
+    EXPECT_TRUE(input->CopyDataToTensor(in_data.data(),
+                                        in_data.size() * sizeof(float)));
+    EXPECT_TRUE(graph->Run());
+    std::vector<float> output_data(golden.size());
+    EXPECT_TRUE(output->CopyDataFromTensor(output_data.data()));
+    EXPECT_EQ(golden, output_data);
+
+    tim::vx::KernelTuningDB db;
+    EXPECT_TRUE(tim::vx::LoadKernelTuningDB(path, db));
+    EXPECT_EQ(db.size(), 1u);
+  }
+}
@@ -0,0 +1,89 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "mapped_file.h"
+
+#if defined(_WIN32)
+#include <fstream>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+
+std::shared_ptr<const char> MapFile(const std::string& path, size_t* size) {
+#if defined(_WIN32)
+  // No mmap here, fall back to a single heap copy
+  std::ifstream file(path, std::ios::binary | std::ios::ate);
+  if (!file) {
+    VSILOGE("Failed to open %s", path.c_str());
+    return nullptr;
+  }
+  size_t length = static_cast<size_t>(file.tellg());
+  std::shared_ptr<char> buffer(new char[length], std::default_delete<char[]>());
+  file.seekg(0, std::ios::beg);
+  if (!file.read(buffer.get(), length)) {
+    VSILOGE("Failed to read %s", path.c_str());
+    return nullptr;
+  }
+#else
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    VSILOGE("Failed to open %s", path.c_str());
+    return nullptr;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+    VSILOGE("Invalid file %s", path.c_str());
+    close(fd);
+    return nullptr;
+  }
+  size_t length = static_cast<size_t>(st.st_size);
+  // Writable but private, pages a consumer writes to are copied and never
+  // reach the file. Drivers take the binary as a non-const pointer.
+  void* addr =
+      mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+  // The mapping keeps its own reference on the file
+  close(fd);
+  if (addr == MAP_FAILED) {
+    VSILOGE("Failed to map %s", path.c_str());
+    return nullptr;
+  }
+  std::shared_ptr<const char> buffer(
+      static_cast<const char*>(addr),
+      [length](const char* p) { munmap(const_cast<char*>(p), length); });
+#endif
+  if (size) {
+    *size = length;
+  }
+  return buffer;
+}
+
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,314 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "op_signature.h"
+
+#include <functional>
+#include <map>
+
+#include "op_impl.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+namespace {
+
+using ParamVisitor = std::function<void(vsi_nn_nn_param_t&, ParamArchive&)>;
+
+void NoParam(vsi_nn_nn_param_t&, ParamArchive&) {}
+
+const std::map<int32_t, ParamVisitor>& ParamVisitors() {
+  static const std::map<int32_t, ParamVisitor> visitors = {
+      {VSI_NN_OP_ADD, NoParam},
+      {VSI_NN_OP_SUBTRACT, NoParam},
+      {VSI_NN_OP_MINIMUM, NoParam},
+      {VSI_NN_OP_MAXIMUM, NoParam},
+      {VSI_NN_OP_POW, NoParam},
+      {VSI_NN_OP_FLOORDIV, NoParam},
+      {VSI_NN_OP_ADDN, NoParam},
+      {VSI_NN_OP_SELECT, NoParam},
+      {VSI_NN_OP_DATACONVERT, NoParam},
+      {VSI_NN_OP_CAST, NoParam},
+      {VSI_NN_OP_NEG, NoParam},
+      {VSI_NN_OP_ABS, NoParam},
+      {VSI_NN_OP_EXP, NoParam},
+      {VSI_NN_OP_LOG, NoParam},
+      {VSI_NN_OP_SIN, NoParam},
+      {VSI_NN_OP_COS, NoParam},
+      {VSI_NN_OP_SQRT, NoParam},
+      {VSI_NN_OP_RSQRT, NoParam},
+      {VSI_NN_OP_SQUARE, NoParam},
+      {VSI_NN_OP_RCP, NoParam},
+      {VSI_NN_OP_FLOOR, NoParam},
+      {VSI_NN_OP_CEIL, NoParam},
+      {VSI_NN_OP_ROUND, NoParam},
+      {VSI_NN_OP_ERF, NoParam},
+      {VSI_NN_OP_LOGICAL_NOT, NoParam},
+      {VSI_NN_OP_RELU, NoParam},
+      {VSI_NN_OP_RELU1, NoParam},
+      {VSI_NN_OP_RELU6, NoParam},
+      {VSI_NN_OP_SIGMOID, NoParam},
+      {VSI_NN_OP_MISH, NoParam},
+      {VSI_NN_OP_SOFTRELU, NoParam},
+      {VSI_NN_OP_SIGN, NoParam},
+      {VSI_NN_OP_SOFTSIGN, NoParam},
+      {VSI_NN_OP_MULTIPLY,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.multiply.scale); }},
+      {VSI_NN_OP_DIVIDE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.divide.scale); }},
+      {VSI_NN_OP_TANH,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.tanh.scale_a)(p.tanh.scale_b);
+       }},
+      {VSI_NN_OP_LEAKY_RELU,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.activation.leaky_ratio);
+       }},
+      {VSI_NN_OP_ELU,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.elu.alpha); }},
+      {VSI_NN_OP_SWISH,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.swish.type)(p.swish.beta);
+       }},
+      {VSI_NN_OP_PRELU,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.prelu.axis); }},
+      {VSI_NN_OP_HARD_SIGMOID,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.hard_sigmoid.alpha)(p.hard_sigmoid.beta);
+       }},
+      {VSI_NN_OP_LINEAR,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.linear.a)(p.linear.b);
+       }},
+      {VSI_NN_OP_GELU,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.gelu.approximate); }},
+#ifdef _VSI_NN_OP_SELU_H
+      {VSI_NN_OP_SELU,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.selu.alpha)(p.selu.gamma);
+       }},
+#endif
+#ifdef _VSI_NN_OP_CELU_H
+      {VSI_NN_OP_CELU,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.celu.alpha); }},
+#endif
+      {VSI_NN_OP_CLIP,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.clip.min)(p.clip.max);
+       }},
+      {VSI_NN_OP_BATCH_NORM,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.batch_norm.eps); }},
+      {VSI_NN_OP_INSTANCE_NORM,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.instancenorm.eps); }},
+      {VSI_NN_OP_LAYER_NORM,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.layernorm.eps)(p.layernorm.axis);
+       }},
+      {VSI_NN_OP_L2_NORMALIZE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.l2_normalize.axis);
+       }},
+      {VSI_NN_OP_LRN2,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.lrn.type)(p.lrn.size)(p.lrn.alpha)(p.lrn.beta)(p.lrn.bias);
+         a(p.lrn.axis);
+       }},
+      {VSI_NN_OP_SOFTMAX,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.softmax.beta)(p.softmax.axis);
+       }},
+      {VSI_NN_OP_LOG_SOFTMAX,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.log_softmax.betaValue)(p.log_softmax.axis);
+       }},
+      {VSI_NN_OP_PERMUTE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.permute.perm, p.permute.dim_num);
+       }},
+#ifdef _VSI_NN_OP_RESHAPE2_H
+      {VSI_NN_OP_RESHAPE2,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.reshape2.size, p.reshape2.dim_num);
+       }},
+#endif
+      {VSI_NN_OP_SQUEEZE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.squeeze.axis, p.squeeze.axis_num);
+       }},
+      {VSI_NN_OP_SLICE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         uint32_t dims = p.slice.dims;
+         a(p.slice.start, dims);
+         a(p.slice.length, p.slice.dims);
+       }},
+      {VSI_NN_OP_STRIDED_SLICE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         auto& ss = p.strided_slice;
+         a(ss.begin_dims, ss.begin_dims_num);
+         a(ss.end_dims, ss.end_dims_num);
+         a(ss.stride_dims, ss.stride_dims_num);
+         a(ss.begin_mask)(ss.end_mask);
+         a(ss.shrink_axis_mask)(ss.new_axis_mask);
+       }},
+      {VSI_NN_OP_PAD,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         uint8_t dim_num = p.pad.dim_num;
+         a(p.pad.front_size, dim_num);
+         a(p.pad.back_size, p.pad.dim_num);
+         a(p.pad.const_val)(p.pad.mode);
+       }},
+      {VSI_NN_OP_REDUCE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.reduce.type)(p.reduce.keep_dim);
+         a(p.reduce.axis, p.reduce.axis_num);
+       }},
+      {VSI_NN_OP_ARGMAX,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.argmax.axis)(p.argmax.keep_dims);
+       }},
+      {VSI_NN_OP_ARGMIN,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.argmin.axis)(p.argmin.keep_dims);
+       }},
+      {VSI_NN_OP_CONCAT,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.concat.axis); }},
+      {VSI_NN_OP_SPLIT,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.split.axis)(p.split.slices, p.split.slices_num);
+       }},
+      {VSI_NN_OP_STACK,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.stack.axis); }},
+      {VSI_NN_OP_UNSTACK,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.unstack.axis); }},
+      {VSI_NN_OP_TILE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.tile.multiples, p.tile.multiples_num);
+       }},
+      {VSI_NN_OP_GATHER,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.gather.axis)(p.gather.batch_dims);
+       }},
+      {VSI_NN_OP_TOPK,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) { a(p.topk.k); }},
+      {VSI_NN_OP_DEPTH2SPACE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.depth2space.block_size)(p.depth2space.mode);
+       }},
+      {VSI_NN_OP_SPACE2DEPTH,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.space2depth.block_size);
+       }},
+      {VSI_NN_OP_RESIZE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         auto& resize = p.resize;
+         a(resize.type)(resize.factor)(resize.size);
+         a(resize.align_corners)(resize.half_pixel_centers)(resize.layout);
+       }},
+      {VSI_NN_OP_RELATIONAL_OPS,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.relational_ops.op);
+       }},
+      {VSI_NN_OP_LOGICAL_OPS,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.relational_ops.op);
+       }},
+      {VSI_NN_OP_MATRIXMUL,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.matrixmul.transpose)(p.matrixmul.adjoint);
+       }},
+      {VSI_NN_OP_CONV2D,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         // No pointer inside, visit the whole structure
+         a(p.conv2d);
+       }},
+      {VSI_NN_OP_DECONVOLUTION,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         // No pointer inside, visit the whole structure
+         a(p.deconv);
+       }},
+      {VSI_NN_OP_POOL,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         auto& pool = p.pool;
+         a(pool.type)(pool.round_type);
+         a(pool.ksize)(pool.stride)(pool.pad);
+         a(pool.pad_type);
+       }},
+      {VSI_NN_OP_FCL2,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.fcl.weights)(p.fcl.axis);
+       }},
+      {VSI_NN_OP_CUSTOM_SCALED_DOT_PRODUCT_ATTENTION,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         auto& sdpa = p.custom_scaled_dot_product_attention;
+         a(sdpa.scale)(sdpa.causal)(sdpa.query_tile);
+       }},
+      {VSI_NN_OP_CUSTOM_SLICE_UPDATE,
+       [](vsi_nn_nn_param_t& p, ParamArchive& a) {
+         a(p.custom_slice_update.axis);
+       }},
+  };
+  return visitors;
+}
+
+}  // namespace
+
+OpSignature& OpSignature::Append(const TensorSpec& spec) {
+  Append(spec.datatype_).Append(spec.attr_);
+  Append(spec.shape_.data(), spec.shape_.size());
+  const auto& quant = spec.quantization_;
+  Append(quant.Type()).Append(quant.ChannelDim());
+  Append(quant.Scales().data(), quant.Scales().size());
+  Append(quant.ZeroPoints().data(), quant.ZeroPoints().size());
+  return *this;
+}
+
+std::vector<int32_t> OpParamKinds() {
+  std::vector<int32_t> kinds;
+  for (const auto& visitor : ParamVisitors()) kinds.push_back(visitor.first);
+  return kinds;
+}
+
+bool HasOpParams(int32_t kind) {
+  return ParamVisitors().end() != ParamVisitors().find(kind);
+}
+
+bool VisitOpParams(int32_t kind, vsi_nn_nn_param_t& param,
+                   ParamArchive& archive) {
+  auto visitor = ParamVisitors().find(kind);
+  if (ParamVisitors().end() == visitor) return false;
+  visitor->second(param, archive);
+  return true;
+}
+
+bool AppendOpParams(const std::shared_ptr<Operation>& op,
+                    OpSignature& signature) {
+  auto node = op->impl()->node();
+  if (nullptr == node || op->impl()->kind_ == -1) return false;
+  if (!HasOpParams(op->impl()->kind_)) return false;
+
+  signature.Append(op->impl()->kind_).Append(node->vx_param);
+  return VisitOpParams(op->impl()->kind_, node->nn_param, signature);
+}
+
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,202 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#ifndef TIM_VX_OP_SIGNATURE_H_
+#define TIM_VX_OP_SIGNATURE_H_
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tim/vx/operation.h"
+#include "tim/vx/tensor.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+
+/// Visits the value fields of an nn_param. Writers append the visited values,
+/// readers overwrite them, arrays referenced by pointer are visited by value
+class ParamArchive {
+ public:
+  virtual ~ParamArchive() {}
+
+  template <typename T>
+  ParamArchive& operator()(T& value) {
+    Visit(&value, sizeof(T));
+    return *this;
+  }
+
+  template <typename T, typename N>
+  ParamArchive& operator()(const T*& values, N& num) {
+    const void* data = values;
+    uint32_t count = static_cast<uint32_t>(num);
+    VisitArray(&data, &count, sizeof(T));
+    values = static_cast<const T*>(data);
+    num = static_cast<N>(count);
+    return *this;
+  }
+
+  template <typename T, typename N>
+  ParamArchive& operator()(T*& values, N& num) {
+    const T* data = values;
+    (*this)(data, num);
+    values = const_cast<T*>(data);
+    return *this;
+  }
+
+ protected:
+  virtual void Visit(void* data, size_t size) = 0;
+  /// `*data` may be redirected to storage owned by the archive
+  virtual void VisitArray(const void** data, uint32_t* num,
+                          size_t elem_size) = 0;
+};
+
+/// Byte string describing operations and tensors by value, parameters referenced
+/// by pointers in nn_param are appended as the pointed-to values
+class OpSignature : public ParamArchive {
+ public:
+  template <typename T>
+  OpSignature& Append(const T& value) {
+    data_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    return *this;
+  }
+
+  template <typename T>
+  OpSignature& Append(const T* values, uint32_t num) {
+    Append(num);
+    if (nullptr != values) {
+      data_.append(reinterpret_cast<const char*>(values), sizeof(T) * num);
+    }
+    return *this;
+  }
+
+  OpSignature& Append(const TensorSpec& spec);
+
+  const std::string& str() const { return data_; }
+
+ protected:
+  void Visit(void* data, size_t size) override {
+    data_.append(static_cast<const char*>(data), size);
+  }
+  void VisitArray(const void** data, uint32_t* num,
+                  size_t elem_size) override {
+    uint32_t count = nullptr != *data ? *num : 0;
+    Append(count);
+    if (0 != count) {
+      data_.append(static_cast<const char*>(*data), elem_size * count);
+    }
+  }
+
+ private:
+  std::string data_;
+};
+
+/// Reads back values appended by OpSignature. Arrays visited through
+/// ParamArchive are copied into the storage set by SetStorage.
+class ParamReader : public ParamArchive {
+ public:
+  ParamReader(const char* data, size_t size)
+      : data_(data), end_(data + size) {}
+
+  bool ok() const { return ok_; }
+
+  void SetStorage(std::vector<std::vector<char>>* storage) {
+    storage_ = storage;
+  }
+
+  template <typename T>
+  bool Read(T& value) {
+    Visit(&value, sizeof(T));
+    return ok_;
+  }
+
+  template <typename T>
+  bool Read(std::vector<T>& values) {
+    uint32_t num = 0;
+    if (!Read(num) || num > Remaining() / sizeof(T)) {
+      ok_ = false;
+      return ok_;
+    }
+    values.resize(num);
+    if (0 != num) Visit(values.data(), sizeof(T) * num);
+    return ok_;
+  }
+
+ protected:
+  void Visit(void* data, size_t size) override {
+    if (!ok_ || size > Remaining()) {
+      ok_ = false;
+      return;
+    }
+    memcpy(data, data_, size);
+    data_ += size;
+  }
+
+  void VisitArray(const void** data, uint32_t* num,
+                  size_t elem_size) override {
+    uint32_t count = 0;
+    Visit(&count, sizeof(count));
+    if (!ok_ || nullptr == storage_ || count > Remaining() / elem_size) {
+      ok_ = false;
+      count = 0;
+    }
+    *num = count;
+    *data = nullptr;
+    if (0 != count) {
+      storage_->emplace_back(data_, data_ + elem_size * count);
+      *data = storage_->back().data();
+      data_ += elem_size * count;
+    }
+  }
+
+ private:
+  size_t Remaining() const { return end_ - data_; }
+
+  const char* data_;
+  const char* end_;
+  bool ok_{true};
+  std::vector<std::vector<char>>* storage_{nullptr};
+};
+
+/// Builtin op kinds whose nn_param layout is known, in ascending order
+std::vector<int32_t> OpParamKinds();
+
+/// Whether the nn_param layout of builtin op `kind` is known
+bool HasOpParams(int32_t kind);
+
+/// Visit the nn_param fields set by builtin op `kind`. Returns false for
+/// kinds whose nn_param layout is unknown.
+bool VisitOpParams(int32_t kind, vsi_nn_nn_param_t& param,
+                   ParamArchive& archive);
+
+/// Append kind, vx_param and nn_param of `op`. Returns false for composed
+/// operations and kinds whose nn_param layout is unknown, their nn_param may
+/// hold node-private pointers which can not be compared.
+bool AppendOpParams(const std::shared_ptr<Operation>& op,
+                    OpSignature& signature);
+
+}  // namespace vx
+}  // namespace tim
+
+#endif /* TIM_VX_OP_SIGNATURE_H_ */
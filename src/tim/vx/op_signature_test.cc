@@ -0,0 +1,112 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "op_signature.h"
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <vector>
+
+namespace {
+/// Sets every visited value to pseudo-random bytes and points arrays at
+/// three such elements, so all fields of a visitor take part in the check
+class ParamFiller : public tim::vx::ParamArchive {
+ protected:
+  void Visit(void* data, size_t size) override {
+    auto bytes = static_cast<char*>(data);
+    for (size_t i = 0; i < size; ++i) bytes[i] = Next();
+  }
+
+  void VisitArray(const void** data, uint32_t* num,
+                  size_t elem_size) override {
+    storage_.emplace_back(elem_size * kArraySize);
+    for (auto& byte : storage_.back()) byte = Next();
+    *data = storage_.back().data();
+    *num = kArraySize;
+  }
+
+ private:
+  static constexpr uint32_t kArraySize = 3;
+
+  char Next() {
+    seed_ = seed_ * 1664525u + 1013904223u;
+    return static_cast<char>(seed_ >> 24);
+  }
+
+  uint32_t seed_{1};
+  std::vector<std::vector<char>> storage_;
+};
+
+std::string WriteParams(int32_t kind, vsi_nn_nn_param_t& param) {
+  tim::vx::OpSignature signature;
+  EXPECT_TRUE(tim::vx::VisitOpParams(kind, param, signature));
+  return signature.str();
+}
+}  // namespace
+
+TEST(op_signature, params_round_trip_every_kind) {
+  auto kinds = tim::vx::OpParamKinds();
+  ASSERT_FALSE(kinds.empty());
+  for (int32_t kind : kinds) {
+    ParamFiller filler;
+    vsi_nn_nn_param_t param;
+    memset(&param, 0, sizeof(param));
+    ASSERT_TRUE(tim::vx::VisitOpParams(kind, param, filler));
+    std::string written = WriteParams(kind, param);
+
+    vsi_nn_nn_param_t loaded;
+    memset(&loaded, 0, sizeof(loaded));
+    std::vector<std::vector<char>> storage;
+    tim::vx::ParamReader reader(written.data(), written.size());
+    reader.SetStorage(&storage);
+    EXPECT_TRUE(tim::vx::VisitOpParams(kind, loaded, reader));
+    EXPECT_TRUE(reader.ok()) << "kind " << kind;
+    EXPECT_EQ(written, WriteParams(kind, loaded)) << "kind " << kind;
+  }
+}
+
+TEST(op_signature, truncated_params_fail_to_read) {
+  ParamFiller filler;
+  vsi_nn_nn_param_t param;
+  memset(&param, 0, sizeof(param));
+  ASSERT_TRUE(tim::vx::VisitOpParams(VSI_NN_OP_STRIDED_SLICE, param, filler));
+  std::string written = WriteParams(VSI_NN_OP_STRIDED_SLICE, param);
+  ASSERT_FALSE(written.empty());
+
+  vsi_nn_nn_param_t loaded;
+  memset(&loaded, 0, sizeof(loaded));
+  std::vector<std::vector<char>> storage;
+  tim::vx::ParamReader reader(written.data(), written.size() - 1);
+  reader.SetStorage(&storage);
+  tim::vx::VisitOpParams(VSI_NN_OP_STRIDED_SLICE, loaded, reader);
+  EXPECT_FALSE(reader.ok());
+}
+
+TEST(op_signature, unknown_kind_has_no_params) {
+  EXPECT_FALSE(tim::vx::HasOpParams(-1));
+  vsi_nn_nn_param_t param;
+  memset(&param, 0, sizeof(param));
+  ParamFiller filler;
+  EXPECT_FALSE(tim::vx::VisitOpParams(-1, param, filler));
+}
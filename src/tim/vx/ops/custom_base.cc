@@ -23,6 +23,9 @@
 *****************************************************************************/
 #ifdef TIM_VX_ENABLE_CUSTOM_OP
 #include <map>
+#include <mutex>
+#include <string>
+#include <utility>
 #include <assert.h>
 #include "tim/vx/ops.h"
 #include "builtin_op_impl.h"
@@ -43,8 +46,46 @@ static vsi_bool op_compute(vsi_nn_node_t* self, vsi_nn_tensor_t** inputs,
 static vx_status derive_kernel_init(vx_node node, const vx_reference* param,
                                     vx_uint32 param_size);
 
+// vx node to op, filled while graphs are set up and read back when the driver
+// initializes the kernel, graphs may be compiled from several threads
+static std::mutex node_base_mutex_;
 static std::map<void*, CustomOpBase*> node_base_map_;
 
+// ovxlib registers a client kernel with its built program on the vx context and
+// looks it up by function name, so every later instance with the same name in
+// that context skips program build. Record the build option each program was
+// built with to catch instances which would silently reuse a program built for
+// other options.
+static std::mutex program_cache_mutex_;
+static std::map<std::pair<vx_context, std::string>, std::string> program_cache_;
+
+static void check_program_cache(vsi_nn_graph_t* graph, const char* func_name,
+                                const std::string& build_option) {
+  vx_context ctx = vxGetContext(reinterpret_cast<vx_reference>(graph->g));
+  std::lock_guard<std::mutex> lock(program_cache_mutex_);
+  auto key = std::make_pair(ctx, std::string(func_name));
+  auto cached = program_cache_.find(key);
+  if (program_cache_.end() == cached) {
+    program_cache_.insert(std::make_pair(key, build_option));
+  } else if (cached->second != build_option) {
+    VSILOGW("Kernel %s was built with option \"%s\", \"%s\" is ignored.",
+            func_name, cached->second.c_str(), build_option.c_str());
+  } else {
+    VSILOGD("Reuse program of kernel %s.", func_name);
+  }
+}
+
+void ReleaseCustomOpPrograms(vx_context context) {
+  std::lock_guard<std::mutex> lock(program_cache_mutex_);
+  for (auto it = program_cache_.begin(); it != program_cache_.end();) {
+    if (it->first.first == context) {
+      it = program_cache_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
 CustomOpBase::CustomOpBase(Graph* graph, uint32_t input_num,
                            uint32_t output_num, int32_t kernel_id,
                            const char* kernel_name)
@@ -58,6 +99,7 @@ CustomOpBase::CustomOpBase(Graph* graph, uint32_t input_num,
 }
 
 CustomOpBase::~CustomOpBase(){
+  std::lock_guard<std::mutex> lock(node_base_mutex_);
   auto iter = node_base_map_.find(this->vx_node_);
   if (iter != node_base_map_.end()) {
     node_base_map_.erase(this->vx_node_);
@@ -124,6 +166,7 @@ vsi_bool op_compute(vsi_nn_node_t* self, vsi_nn_tensor_t** inputs,
 
   std::string build_option;
   op_this->SetupParams(input_types, build_option);
+  check_program_cache(self->graph, op_this->func_name_, build_option);
 
   snprintf(kernel->info.name, VX_MAX_KERNEL_NAME, "%s", op_this->func_name_);
   kernel->unique_id =
@@ -202,9 +245,14 @@ vsi_bool op_compute(vsi_nn_node_t* self, vsi_nn_tensor_t** inputs,
     }
 
   }
+  // Kernel description is only needed to register and create the node
+  vsi_nn_KernelRelease(&kernel);
   self->n = (vx_node)node;
 
-  node_base_map_.insert(std::pair<void*, CustomOpBase*>(reinterpret_cast<void*>(self->n), op_this));
+  {
+    std::lock_guard<std::mutex> lock(node_base_mutex_);
+    node_base_map_.insert(std::pair<void*, CustomOpBase*>(reinterpret_cast<void*>(self->n), op_this));
+  }
   op_this->vx_node_ = reinterpret_cast<void*>(self->n);
   return status;
 }
@@ -222,9 +270,14 @@ vx_status derive_kernel_init(vx_node node, const vx_reference* param,
   std::vector<size_t> local_size(3);
   uint32_t dim = 0;
 
-  auto iter = node_base_map_.find(reinterpret_cast<void*>(node));
-  if (iter != node_base_map_.end()) {
-    iter->second->SetupEnqueue(dim, global_size, local_size);
+  CustomOpBase* op_this = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(node_base_mutex_);
+    auto iter = node_base_map_.find(reinterpret_cast<void*>(node));
+    if (iter != node_base_map_.end()) op_this = iter->second;
+  }
+  if (op_this) {
+    op_this->SetupEnqueue(dim, global_size, local_size);
   } else {
     std::cout << "Something wrong in finding gpu param setup function"
               << std::endl;
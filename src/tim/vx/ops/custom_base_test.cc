@@ -0,0 +1,50 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/ops/custom_base.h"
+
+#include "gtest/gtest.h"
+
+TEST(CustomOpBase, param_transform) {
+    std::tuple<int32_t, float, uint32_t, bool> params(-3, 0.5f, 7u, true);
+    std::vector<tim::vx::ops::Param> param_list;
+    tim::vx::ops::param_transform(params, param_list);
+
+    ASSERT_EQ(param_list.size(), 4u);
+    EXPECT_EQ(param_list[0].type, tim::vx::DataType::INT32);
+    EXPECT_EQ(param_list[0].data.i, -3);
+    EXPECT_EQ(param_list[1].type, tim::vx::DataType::FLOAT32);
+    EXPECT_EQ(param_list[1].data.f, 0.5f);
+    EXPECT_EQ(param_list[2].type, tim::vx::DataType::UINT32);
+    EXPECT_EQ(param_list[2].data.ui, 7u);
+    EXPECT_EQ(param_list[3].type, tim::vx::DataType::BOOL8);
+    EXPECT_EQ(param_list[3].data.b, true);
+}
+
+TEST(CustomOpBase, param_transform_empty) {
+    std::tuple<> params;
+    std::vector<tim::vx::ops::Param> param_list;
+    tim::vx::ops::param_transform(params, param_list);
+
+    EXPECT_TRUE(param_list.empty());
+}
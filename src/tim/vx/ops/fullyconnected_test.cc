@@ -74,3 +74,60 @@ TEST(FullyConnected, unit_2_float_axis_0) {
   EXPECT_TRUE(output_tensor->CopyDataFromTensor(output.data()));
   EXPECT_EQ(golden, output);
 }
+
+TEST(FullyConnected, unit_2_uint8_int4_weights) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+
+  tim::vx::ShapeType in_shape({2, 2});
+  tim::vx::ShapeType weight_shape({2, 3});
+  tim::vx::ShapeType bias_shape({3});
+  tim::vx::ShapeType out_shape({3, 2});
+  tim::vx::Quantization in_quant(tim::vx::QuantType::ASYMMETRIC, 0.5f, 128);
+  tim::vx::Quantization weight_quant(tim::vx::QuantType::ASYMMETRIC, 1.0f, 0);
+  tim::vx::Quantization bias_quant(tim::vx::QuantType::ASYMMETRIC, 0.5f, 0);
+  tim::vx::Quantization out_quant(tim::vx::QuantType::ASYMMETRIC, 0.5f, 0);
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8, in_shape,
+                                 tim::vx::TensorAttribute::INPUT, in_quant);
+  tim::vx::TensorSpec weight_spec(tim::vx::DataType::INT4, weight_shape,
+                                  tim::vx::TensorAttribute::CONSTANT,
+                                  weight_quant);
+  tim::vx::TensorSpec bias_spec(tim::vx::DataType::INT32, bias_shape,
+                                tim::vx::TensorAttribute::CONSTANT,
+                                bias_quant);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8, out_shape,
+                                  tim::vx::TensorAttribute::OUTPUT, out_quant);
+  // 1, 4, 2, 6
+  std::vector<uint8_t> in_data = {
+      130, 136, 132, 140,
+  };
+  // -3, 3, 2, 1, 0, 4 packed two per byte, low nibble first
+  std::vector<uint8_t> weight = {
+      0x3D, 0x12, 0x40,
+  };
+  // 0, 1, 2
+  std::vector<int32_t> bias = {
+      0, 2, 4,
+  };
+  // 9, 7, 18, 12, 11, 26
+  std::vector<uint8_t> golden = {
+      18, 14, 36, 24, 22, 52,
+  };
+  EXPECT_EQ(3, weight_spec.GetByteSize());
+
+  auto input_tensor = graph->CreateTensor(input_spec);
+  auto weight_tensor = graph->CreateTensor(weight_spec, weight.data());
+  auto bias_tensor = graph->CreateTensor(bias_spec, bias.data());
+  auto output_tensor = graph->CreateTensor(output_spec);
+
+  EXPECT_TRUE(input_tensor->CopyDataToTensor(in_data.data(), in_data.size()));
+  auto op = graph->CreateOperation<tim::vx::ops::FullyConnected>(0, 3);
+  (*op).BindInputs({input_tensor, weight_tensor, bias_tensor}).BindOutputs({output_tensor});
+
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<uint8_t> output(golden.size());
+  EXPECT_TRUE(output_tensor->CopyDataFromTensor(output.data()));
+  EXPECT_EQ(golden, output);
+}
@@ -24,6 +24,7 @@
 #include "tim/vx/ops/nbg.h"
 
 #include "builtin_op_impl.h"
+#include "mapped_file.h"
 #include "vsi_nn_pub.h"
 
 namespace tim {
@@ -36,7 +37,31 @@ NBG::NBG(Graph* graph, const char* binary, size_t input_count,
   this->impl()->node()->nn_param.nbg.type = VSI_NN_NBG_POINTER;
 }
 
+NBG::NBG(Graph* graph, const std::shared_ptr<const char>& binary,
+         size_t input_count, size_t output_count)
+    : NBG(graph, binary.get(), input_count, output_count) {
+  binary_ = binary;
+}
+
+std::shared_ptr<NBG> NBG::FromFile(Graph* graph, const std::string& path,
+                                   size_t input_count, size_t output_count) {
+  auto binary = MapFile(path);
+  if (!binary) {
+    return nullptr;
+  }
+  return graph->CreateOperation<NBG>(binary, input_count, output_count);
+}
+
+std::shared_ptr<const char> NBG::MapFile(const std::string& path,
+                                         size_t* size) {
+  return tim::vx::MapFile(path, size);
+}
+
 std::shared_ptr<Operation> NBG::Clone(std::shared_ptr<Graph>& graph) const {
+  if (binary_) {
+    return graph->CreateOperation<NBG>(binary_, this->impl_->input_cnt_,
+                                       this->impl_->output_cnt_);
+  }
   return graph->CreateOperation<NBG>(this->impl_->node()->nn_param.nbg.url,
                                      this->impl_->input_cnt_,
                                      this->impl_->output_cnt_);
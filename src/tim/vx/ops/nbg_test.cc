@@ -0,0 +1,61 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/ops/nbg.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+TEST(NBG, map_file) {
+  std::string path = ::testing::TempDir() + "nbg_map_file_test.nb";
+  const char content[] = "network binary graph";
+  {
+    std::ofstream file(path, std::ios::binary);
+    file.write(content, sizeof(content));
+  }
+
+  size_t size = 0;
+  auto binary = tim::vx::ops::NBG::MapFile(path, &size);
+  ASSERT_TRUE(binary);
+  EXPECT_EQ(sizeof(content), size);
+  EXPECT_EQ(0, memcmp(content, binary.get(), size));
+
+  // Drivers take the binary as writable, writes stay out of the file
+  const_cast<char*>(binary.get())[0] = 'N';
+  binary.reset();
+  auto remapped = tim::vx::ops::NBG::MapFile(path);
+  ASSERT_TRUE(remapped);
+  EXPECT_EQ(0, memcmp(content, remapped.get(), size));
+
+  remapped.reset();
+  std::remove(path.c_str());
+}
+
+TEST(NBG, map_missing_file) {
+  EXPECT_FALSE(tim::vx::ops::NBG::MapFile(::testing::TempDir() +
+                                          "nbg_missing_file_test.nb"));
+}
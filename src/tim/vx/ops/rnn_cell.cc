@@ -22,14 +22,86 @@
 *
 *****************************************************************************/
 #include "tim/vx/ops.h"
+#include "builtin_op_impl.h"
+#include "tensor_private.h"
 #include "vsi_nn_pub.h"
 #include "op_impl.h"
 
 #include <array>
+#include <cstring>
 namespace tim {
 namespace vx {
 namespace ops {
 
+namespace {
+// Direct mapping of ovxlib's rnncell, which places both projections on
+// NN/TP and keeps its intermediates in internal_dtype.
+class RNNCellOvxlib : public BuiltinOp {
+ public:
+  RNNCellOvxlib(Graph* graph, const Quantization& internal_quant,
+                DataType internal_type)
+      : BuiltinOp(graph, VSI_NN_OP_RNNCELL_OVXLIB),
+        internal_quant_(internal_quant),
+        internal_type_(internal_type) {
+    auto& param = this->impl()->node()->nn_param.rnncell_ovxlib;
+    // Same activation as the composite path
+    param.activation = VSI_NN_ACT_TANH;
+
+    vsi_nn_dtype_t dtype;
+    memset(&dtype, 0, sizeof(dtype));
+    if (internal_quant_.Type() != QuantType::NONE) {
+      TensorSpec spec(internal_type_, {}, TensorAttribute::TRANSIENT,
+                      internal_quant_);
+      PackTensorDtype(spec, &dtype);
+    } else {
+      dtype.vx_type = VSI_NN_TYPE_FLOAT16;
+    }
+    param.internal_dtype[RNNCELL_QUANTIZE_PARAM_I] = dtype;
+    param.internal_dtype[RNNCELL_QUANTIZE_PARAM_H] = dtype;
+  }
+
+  std::shared_ptr<Operation> Clone(
+      std::shared_ptr<Graph>& graph) const override {
+    return graph->CreateOperation<RNNCellOvxlib>(internal_quant_,
+                                                 internal_type_);
+  }
+
+ protected:
+  const Quantization internal_quant_;
+  const DataType internal_type_;
+};
+
+// Zero bias of the recurrent projection, quantized to state * weight scale
+// like the bias of any quantized fully connected layer.
+std::shared_ptr<Tensor> CreateZeroRecurrentBias(
+    Graph* graph, const std::shared_ptr<Tensor>& bias,
+    const std::shared_ptr<Tensor>& state,
+    const std::shared_ptr<Tensor>& weight) {
+  uint32_t num_units = weight->GetShape()[1];
+  auto bias_quant = bias->GetQuantization();
+  const auto& state_quant = state->GetQuantization();
+  const auto& weight_quant = weight->GetQuantization();
+  if (bias_quant.Type() != QuantType::NONE &&
+      state_quant.Type() != QuantType::NONE &&
+      weight_quant.Type() != QuantType::NONE) {
+    std::vector<float> scales(weight_quant.Scales());
+    for (auto& scale : scales) {
+      scale *= state_quant.Scales()[0];
+    }
+    if (weight_quant.Type() == QuantType::SYMMETRIC_PER_CHANNEL) {
+      bias_quant = Quantization(QuantType::SYMMETRIC_PER_CHANNEL, 0, scales,
+                                std::vector<int32_t>(scales.size(), 0));
+    } else {
+      bias_quant = Quantization(bias_quant.Type(), scales[0], 0);
+    }
+  }
+  TensorSpec spec(bias->GetDataType(), {num_units}, TensorAttribute::CONSTANT,
+                  bias_quant);
+  std::vector<uint8_t> zeros(spec.GetByteSize(), 0);
+  return graph->CreateTensor(spec, zeros.data());
+}
+}  // namespace
+
 class RNNCellImpl : public OpImpl {
  public:
   enum {
@@ -49,14 +121,10 @@ class RNNCellImpl : public OpImpl {
   };
 
   RNNCellImpl(Graph* graph, int input_cnt, int output_cnt,
+              const Quantization& internal_quant,
               DataLayout layout = DataLayout::ANY)
-      : OpImpl(graph, -1, input_cnt, output_cnt, layout) {
-    fc0_ = graph->CreateOperation<tim::vx::ops::FullyConnected>(0, 4);
-    fc1_ = graph->CreateOperation<tim::vx::ops::FullyConnected>(0, 4);
-    add_ = graph->CreateOperation<tim::vx::ops::Add>();
-    tanh_ = graph->CreateOperation<tim::vx::ops::Tanh>();
-    data_convert_ = graph->CreateOperation<tim::vx::ops::DataConvert>();
-  }
+      : OpImpl(graph, -1, input_cnt, output_cnt, layout),
+        internal_quant_(internal_quant) {}
 
   ~RNNCellImpl() {}
 
@@ -65,32 +133,12 @@ class RNNCellImpl : public OpImpl {
 
     if (this->input_tensor_index == INPUT_CNT - 1) {
       // Get all input tensor
-      tim::vx::ShapeType shape = {0, 0};
-      tim::vx::TensorSpec FC0_spec(tim::vx::DataType::FLOAT32, shape,
-                                   tim::vx::TensorAttribute::TRANSIENT);
-      tim::vx::TensorSpec FC1_spec(tim::vx::DataType::FLOAT32, shape,
-                                   tim::vx::TensorAttribute::TRANSIENT);
-      tim::vx::TensorSpec add_spec(tim::vx::DataType::FLOAT32, shape,
-                                   tim::vx::TensorAttribute::TRANSIENT);
-
-      auto FC0_tensor = graph_->CreateTensor(FC0_spec);
-      auto FC1_tensor = graph_->CreateTensor(FC1_spec);
-      auto add_tensor = graph_->CreateTensor(add_spec);
-
-      fc0_->BindInput(in_tensors_[FULLY_CONNECTED_0_IN]);
-      fc0_->BindInput(in_tensors_[FULLY_CONNECTED_0_WEIGHT]);
-      fc0_->BindInput(in_tensors_[FULLY_CONNECTED_0_BIAS]);
-      fc0_->BindOutput(FC0_tensor);
-
-      fc1_->BindInput(in_tensors_[FULLY_CONNECTED_1_WEIGHT]);
-      fc1_->BindInput(in_tensors_[FULLY_CONNECTED_1_STATE_IN]);
-      fc1_->BindOutput(FC1_tensor);
-
-      add_->BindInput(FC0_tensor);
-      add_->BindInput(FC1_tensor);
-      add_->BindOutput(add_tensor);
-
-      tanh_->BindInput(add_tensor);
+      if (in_tensors_[FULLY_CONNECTED_0_IN]->GetQuantization().Type() !=
+          QuantType::NONE) {
+        BindFusedCell();
+      } else {
+        BindComposite();
+      }
     }
     this->input_tensor_index++;
     return *this;
@@ -99,9 +147,14 @@ class RNNCellImpl : public OpImpl {
   RNNCellImpl& BindOutput(const std::shared_ptr<Tensor>& tensor) override {
     out_tensors_[output_tensor_index] = tensor;
     if (this->output_tensor_index == OUT_CNT - 1) {
-      tanh_->BindOutput(out_tensors_[OUT]);
-      data_convert_->BindInput(out_tensors_[OUT]);
-      data_convert_->BindOutput(out_tensors_[STATE_OUT]);
+      if (cell_) {
+        cell_->BindOutput(out_tensors_[STATE_OUT]);
+        cell_->BindOutput(out_tensors_[OUT]);
+      } else {
+        tanh_->BindOutput(out_tensors_[OUT]);
+        data_convert_->BindInput(out_tensors_[OUT]);
+        data_convert_->BindOutput(out_tensors_[STATE_OUT]);
+      }
     }
     this->output_tensor_index++;
     return *this;
@@ -117,23 +170,82 @@ class RNNCellImpl : public OpImpl {
   }
 
  private:
+  // Quantized cells run as one ovxlib rnncell, intermediates stay in
+  // internal_quant_ or fall back to float16.
+  void BindFusedCell() {
+    auto& input = in_tensors_[FULLY_CONNECTED_0_IN];
+    // The signature binds state_in before the recurrent weights
+    auto& state_in = in_tensors_[FULLY_CONNECTED_1_WEIGHT];
+    auto& recurrent_weight = in_tensors_[FULLY_CONNECTED_1_STATE_IN];
+    auto recurrent_bias =
+        CreateZeroRecurrentBias(graph_, in_tensors_[FULLY_CONNECTED_0_BIAS],
+                                state_in, recurrent_weight);
+
+    cell_ = graph_->CreateOperation<RNNCellOvxlib>(internal_quant_,
+                                                   input->GetDataType());
+    cell_->BindInputs({input, in_tensors_[FULLY_CONNECTED_0_WEIGHT],
+                       recurrent_weight, in_tensors_[FULLY_CONNECTED_0_BIAS],
+                       recurrent_bias, state_in});
+  }
+
+  void BindComposite() {
+    tim::vx::ShapeType shape = {0, 0};
+    tim::vx::TensorSpec FC0_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec FC1_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::TRANSIENT);
+    tim::vx::TensorSpec add_spec(tim::vx::DataType::FLOAT32, shape,
+                                 tim::vx::TensorAttribute::TRANSIENT);
+
+    auto FC0_tensor = graph_->CreateTensor(FC0_spec);
+    auto FC1_tensor = graph_->CreateTensor(FC1_spec);
+    auto add_tensor = graph_->CreateTensor(add_spec);
+
+    fc0_ = graph_->CreateOperation<tim::vx::ops::FullyConnected>(0, 4);
+    fc1_ = graph_->CreateOperation<tim::vx::ops::FullyConnected>(0, 4);
+    add_ = graph_->CreateOperation<tim::vx::ops::Add>();
+    tanh_ = graph_->CreateOperation<tim::vx::ops::Tanh>();
+    data_convert_ = graph_->CreateOperation<tim::vx::ops::DataConvert>();
+
+    fc0_->BindInput(in_tensors_[FULLY_CONNECTED_0_IN]);
+    fc0_->BindInput(in_tensors_[FULLY_CONNECTED_0_WEIGHT]);
+    fc0_->BindInput(in_tensors_[FULLY_CONNECTED_0_BIAS]);
+    fc0_->BindOutput(FC0_tensor);
+
+    fc1_->BindInput(in_tensors_[FULLY_CONNECTED_1_WEIGHT]);
+    fc1_->BindInput(in_tensors_[FULLY_CONNECTED_1_STATE_IN]);
+    fc1_->BindOutput(FC1_tensor);
+
+    add_->BindInput(FC0_tensor);
+    add_->BindInput(FC1_tensor);
+    add_->BindOutput(add_tensor);
+
+    tanh_->BindInput(add_tensor);
+  }
+
+  const Quantization internal_quant_;
+
   std::shared_ptr<tim::vx::Operation> fc0_;
   std::shared_ptr<tim::vx::Operation> fc1_;
   std::shared_ptr<tim::vx::Operation> add_;
   std::shared_ptr<tim::vx::Operation> tanh_;
   std::shared_ptr<tim::vx::Operation> data_convert_;
+  std::shared_ptr<tim::vx::Operation> cell_;
 
   std::array<std::shared_ptr<tim::vx::Tensor>, INPUT_CNT> in_tensors_;
   std::array<std::shared_ptr<tim::vx::Tensor>, OUT_CNT> out_tensors_;
 };
 
-RNNCell::RNNCell(Graph* graph, ActivationType activation)
-    : activation_(activation) {
-  impl_ = std::make_unique<RNNCellImpl>(graph, 0, 0, DataLayout::ANY);
+RNNCell::RNNCell(Graph* graph, ActivationType activation,
+                 const Quantization& internal_quant)
+    : activation_(activation), internal_quant_(internal_quant) {
+  impl_ = std::make_unique<RNNCellImpl>(graph, 0, 0, internal_quant_,
+                                        DataLayout::ANY);
 }
 
 std::shared_ptr<Operation> RNNCell::Clone(std::shared_ptr<Graph>& graph) const {
-  return graph->CreateOperation<RNNCell>(this->activation_);
+  return graph->CreateOperation<RNNCell>(this->activation_,
+                                         this->internal_quant_);
 }
 
 }  // namespace ops
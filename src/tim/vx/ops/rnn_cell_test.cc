@@ -238,4 +238,220 @@ TEST(RNNCell, seperate) {
     EXPECT_TRUE(convert_tensor->CopyDataFromTensor(state_out.data()));
     EXPECT_TRUE(ArraysMatch(output_golden, output, 1e-5f));
     EXPECT_EQ(state_out_golden, state_out);
-}
\ No newline at end of file
+}
+
+TEST(RNNCell, shape_3_2_4_uint8) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    uint32_t input_size = 3, batch_size = 2, num_units = 4;
+
+    std::vector<float> in_data = {
+        0.12609188,  0.46347019, 0.89598465,
+        0.35867718,  0.36897406, 0.73463392,
+        };
+    std::vector<float> weights_data = {
+        0.12609188,  0.46347019, 0.89598465,
+        0.35867718,  0.36897406,  0.73463392,
+        0.12609188,  0.46347019, 0.89598465,
+        0.35867718,  0.36897406,  0.73463392,
+        };
+    std::vector<float> recurrent_weights_data = {
+        -0.31930989, 0.37613347,  0.27901134,  0.36137494,
+        -1.36916667, 0.38031587,  0.21580373, 0.27072677,
+        1.01580888, 0.14943552, 1.15465137,  0.09784451,
+        -1.02702999, 1.39296314,  0.15785322,  0.21931258,
+    };
+    std::vector<float> bias_data = {
+        0.01580888, 0.14943552, 0.15465137,  0.09784451,
+    };
+    std::vector<float> state_in_data = {
+        0,0,0,0,0,0,0,0
+    };
+    std::vector<float> output_golden = {
+        0.781534, 0.771447, 0.830002, 0.749713, 0.711524, 0.74155, 0.77355, 0.717427
+    };
+
+    float in_scale = 1.0f / 255, weights_scale = 1.0f / 255;
+    float recurrent_scale = 2.8f / 255, state_scale = 1.0f / 128;
+    tim::vx::Quantization in_quant(tim::vx::QuantType::ASYMMETRIC, in_scale, 0);
+    tim::vx::Quantization weights_quant(tim::vx::QuantType::ASYMMETRIC,
+        weights_scale, 0);
+    tim::vx::Quantization recurrent_quant(tim::vx::QuantType::ASYMMETRIC,
+        recurrent_scale, 125);
+    tim::vx::Quantization bias_quant(tim::vx::QuantType::ASYMMETRIC,
+        in_scale * weights_scale, 0);
+    tim::vx::Quantization state_quant(tim::vx::QuantType::ASYMMETRIC,
+        state_scale, 128);
+    tim::vx::Quantization internal_quant(tim::vx::QuantType::ASYMMETRIC,
+        4.0f / 255, 128);
+
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8,
+        {input_size, batch_size}, tim::vx::TensorAttribute::INPUT, in_quant);
+    tim::vx::TensorSpec weights_spec(tim::vx::DataType::UINT8,
+        {input_size, num_units}, tim::vx::TensorAttribute::CONSTANT,
+        weights_quant);
+    tim::vx::TensorSpec recurrent_weights_spec(tim::vx::DataType::UINT8,
+        {num_units, num_units}, tim::vx::TensorAttribute::CONSTANT,
+        recurrent_quant);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::INT32,
+        {num_units}, tim::vx::TensorAttribute::CONSTANT, bias_quant);
+    tim::vx::TensorSpec state_in_spec(tim::vx::DataType::UINT8,
+        {num_units, batch_size}, tim::vx::TensorAttribute::INPUT, state_quant);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8,
+        {num_units, batch_size}, tim::vx::TensorAttribute::OUTPUT, state_quant);
+    tim::vx::TensorSpec state_out_spec(tim::vx::DataType::UINT8,
+        {num_units, batch_size}, tim::vx::TensorAttribute::OUTPUT, state_quant);
+
+    auto weights = Quantize<uint8_t>(weights_data, weights_scale, 0);
+    auto recurrent_weights =
+        Quantize<uint8_t>(recurrent_weights_data, recurrent_scale, 125);
+    auto bias = Quantize<int32_t>(bias_data, in_scale * weights_scale, 0);
+
+    auto input_tensor = graph->CreateTensor(input_spec);
+    auto weights_tensor = graph->CreateTensor(weights_spec, weights.data());
+    auto recurrent_weights_tensor =
+        graph->CreateTensor(recurrent_weights_spec, recurrent_weights.data());
+    auto bias_tensor = graph->CreateTensor(bias_spec, bias.data());
+    auto state_in_tensor = graph->CreateTensor(state_in_spec);
+    auto output_tensor = graph->CreateTensor(output_spec);
+    auto state_out_tensor = graph->CreateTensor(state_out_spec);
+
+    auto op = graph->CreateOperation<tim::vx::ops::RNNCell>(
+        tim::vx::ops::RNNCell::ActivationType::kTANH, internal_quant);
+    (*op).BindInputs({input_tensor, weights_tensor, bias_tensor, state_in_tensor, recurrent_weights_tensor})
+         .BindOutputs({output_tensor, state_out_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+
+    auto in = Quantize<uint8_t>(in_data, in_scale, 0);
+    auto state_in = Quantize<uint8_t>(state_in_data, state_scale, 128);
+    EXPECT_TRUE(input_tensor->CopyDataToTensor(in.data(), in.size()));
+    EXPECT_TRUE(state_in_tensor->CopyDataToTensor(state_in.data(),
+                                                  state_in.size()));
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<uint8_t> output(output_golden.size());
+    std::vector<uint8_t> state_out(output_golden.size());
+    EXPECT_TRUE(output_tensor->CopyDataFromTensor(output.data()));
+    EXPECT_TRUE(state_out_tensor->CopyDataFromTensor(state_out.data()));
+    EXPECT_TRUE(ArraysMatch(output_golden,
+                            Dequantize<uint8_t>(output, state_scale, 128),
+                            2e-2f));
+    EXPECT_EQ(output, state_out);
+}
+
+TEST(RNNCell, shape_3_2_4_uint8_per_channel_state) {
+    auto ctx = tim::vx::Context::Create();
+    auto graph = ctx->CreateGraph();
+
+    uint32_t input_size = 3, batch_size = 2, num_units = 4;
+
+    std::vector<float> in_data = {
+        0.12609188,  0.46347019, 0.89598465,
+        0.35867718,  0.36897406, 0.73463392,
+        };
+    std::vector<float> weights_data = {
+        0.12609188,  0.46347019, 0.89598465,
+        0.35867718,  0.36897406,  0.73463392,
+        0.12609188,  0.46347019, 0.89598465,
+        0.35867718,  0.36897406,  0.73463392,
+        };
+    std::vector<float> recurrent_weights_data = {
+        -0.31930989, 0.37613347,  0.27901134,  0.36137494,
+        -1.36916667, 0.38031587,  0.21580373, 0.27072677,
+        1.01580888, 0.14943552, 1.15465137,  0.09784451,
+        -1.02702999, 1.39296314,  0.15785322,  0.21931258,
+    };
+    std::vector<float> bias_data = {
+        0.01580888, 0.14943552, 0.15465137,  0.09784451,
+    };
+    // A non-zero state, so a swapped state and recurrent weight or a wrong
+    // recurrent bias scale changes the result
+    std::vector<float> state_in_data = {
+        0.5, -0.25, 0.125, -0.5,
+        -0.375, 0.75, -0.625, 0.25,
+    };
+    std::vector<float> output_golden = {
+        0.571537, 0.135011, 0.94184, 0.020617,
+        0.836099, 0.933558, 0.062976, 0.979632,
+    };
+
+    float in_scale = 1.0f / 255, weights_scale = 1.0f / 255;
+    float state_scale = 1.0f / 128;
+    std::vector<float> recurrent_scales = {0.003f, 0.011f, 0.0092f, 0.011f};
+    tim::vx::Quantization in_quant(tim::vx::QuantType::ASYMMETRIC, in_scale, 0);
+    tim::vx::Quantization weights_quant(tim::vx::QuantType::ASYMMETRIC,
+        weights_scale, 0);
+    tim::vx::Quantization recurrent_quant(
+        tim::vx::QuantType::SYMMETRIC_PER_CHANNEL, 1, recurrent_scales,
+        std::vector<int32_t>(num_units, 0));
+    tim::vx::Quantization bias_quant(tim::vx::QuantType::ASYMMETRIC,
+        in_scale * weights_scale, 0);
+    tim::vx::Quantization state_quant(tim::vx::QuantType::ASYMMETRIC,
+        state_scale, 128);
+    tim::vx::Quantization internal_quant(tim::vx::QuantType::ASYMMETRIC,
+        4.0f / 255, 128);
+
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8,
+        {input_size, batch_size}, tim::vx::TensorAttribute::INPUT, in_quant);
+    tim::vx::TensorSpec weights_spec(tim::vx::DataType::UINT8,
+        {input_size, num_units}, tim::vx::TensorAttribute::CONSTANT,
+        weights_quant);
+    tim::vx::TensorSpec recurrent_weights_spec(tim::vx::DataType::INT8,
+        {num_units, num_units}, tim::vx::TensorAttribute::CONSTANT,
+        recurrent_quant);
+    tim::vx::TensorSpec bias_spec(tim::vx::DataType::INT32,
+        {num_units}, tim::vx::TensorAttribute::CONSTANT, bias_quant);
+    tim::vx::TensorSpec state_in_spec(tim::vx::DataType::UINT8,
+        {num_units, batch_size}, tim::vx::TensorAttribute::INPUT, state_quant);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8,
+        {num_units, batch_size}, tim::vx::TensorAttribute::OUTPUT, state_quant);
+    tim::vx::TensorSpec state_out_spec(tim::vx::DataType::UINT8,
+        {num_units, batch_size}, tim::vx::TensorAttribute::OUTPUT, state_quant);
+
+    auto weights = Quantize<uint8_t>(weights_data, weights_scale, 0);
+    // Each unit's row of recurrent weights has its own scale
+    std::vector<int8_t> recurrent_weights;
+    for (uint32_t u = 0; u < num_units; u++) {
+        auto row = Quantize<int8_t>(
+            std::vector<float>(recurrent_weights_data.begin() + u * num_units,
+                recurrent_weights_data.begin() + (u + 1) * num_units),
+            recurrent_scales[u], 0);
+        recurrent_weights.insert(recurrent_weights.end(), row.begin(),
+            row.end());
+    }
+    auto bias = Quantize<int32_t>(bias_data, in_scale * weights_scale, 0);
+
+    auto input_tensor = graph->CreateTensor(input_spec);
+    auto weights_tensor = graph->CreateTensor(weights_spec, weights.data());
+    auto recurrent_weights_tensor =
+        graph->CreateTensor(recurrent_weights_spec, recurrent_weights.data());
+    auto bias_tensor = graph->CreateTensor(bias_spec, bias.data());
+    auto state_in_tensor = graph->CreateTensor(state_in_spec);
+    auto output_tensor = graph->CreateTensor(output_spec);
+    auto state_out_tensor = graph->CreateTensor(state_out_spec);
+
+    auto op = graph->CreateOperation<tim::vx::ops::RNNCell>(
+        tim::vx::ops::RNNCell::ActivationType::kTANH, internal_quant);
+    (*op).BindInputs({input_tensor, weights_tensor, bias_tensor, state_in_tensor, recurrent_weights_tensor})
+         .BindOutputs({output_tensor, state_out_tensor});
+
+    EXPECT_TRUE(graph->Compile());
+
+    auto in = Quantize<uint8_t>(in_data, in_scale, 0);
+    auto state_in = Quantize<uint8_t>(state_in_data, state_scale, 128);
+    EXPECT_TRUE(input_tensor->CopyDataToTensor(in.data(), in.size()));
+    EXPECT_TRUE(state_in_tensor->CopyDataToTensor(state_in.data(),
+                                                  state_in.size()));
+    EXPECT_TRUE(graph->Run());
+
+    std::vector<uint8_t> output(output_golden.size());
+    std::vector<uint8_t> state_out(output_golden.size());
+    EXPECT_TRUE(output_tensor->CopyDataFromTensor(output.data()));
+    EXPECT_TRUE(state_out_tensor->CopyDataFromTensor(state_out.data()));
+    EXPECT_TRUE(ArraysMatch(output_golden,
+                            Dequantize<uint8_t>(output, state_scale, 128),
+                            2e-2f));
+    EXPECT_EQ(output, state_out);
+}
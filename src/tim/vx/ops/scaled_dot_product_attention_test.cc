@@ -0,0 +1,271 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/scaled_dot_product_attention.h"
+#include "test_utils.h"
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// q [d, q_len, z], k [d, kv_len, z], v [dv, kv_len, z], mask [kv_len, q_len]
+std::vector<float> Reference(const std::vector<float>& q,
+                             const std::vector<float>& k,
+                             const std::vector<float>& v,
+                             const std::vector<float>& mask, uint32_t d,
+                             uint32_t dv, uint32_t q_len, uint32_t kv_len,
+                             uint32_t z, bool causal) {
+  std::vector<float> out(dv * q_len * z, 0.0f);
+  float scale = 1.0f / std::sqrt(static_cast<float>(d));
+  for (uint32_t b = 0; b < z; ++b) {
+    for (uint32_t i = 0; i < q_len; ++i) {
+      std::vector<float> s(kv_len, -std::numeric_limits<float>::infinity());
+      uint32_t keys = causal ? i + kv_len - q_len + 1 : kv_len;
+      for (uint32_t j = 0; j < keys; ++j) {
+        float acc = 0.0f;
+        for (uint32_t c = 0; c < d; ++c) {
+          acc += q[(b * q_len + i) * d + c] * k[(b * kv_len + j) * d + c];
+        }
+        s[j] = acc * scale + (mask.empty() ? 0.0f : mask[i * kv_len + j]);
+      }
+      float max_s = *std::max_element(s.begin(), s.end());
+      float sum = 0.0f;
+      for (auto& e : s) {
+        e = std::exp(e - max_s);
+        sum += e;
+      }
+      for (uint32_t j = 0; j < kv_len; ++j) {
+        for (uint32_t c = 0; c < dv; ++c) {
+          out[(b * q_len + i) * dv + c] +=
+              s[j] / sum * v[(b * kv_len + j) * dv + c];
+        }
+      }
+    }
+  }
+  return out;
+}
+
+std::vector<float> Ramp(size_t size, float step, float offset) {
+  std::vector<float> data(size);
+  for (size_t i = 0; i < size; ++i) {
+    data[i] = std::sin(static_cast<float>(i) * step) + offset;
+  }
+  return data;
+}
+
+}  // namespace
+
+TEST(ScaledDotProductAttention, shape_4_3_2_kv_5_float) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+  uint32_t d = 4, dv = 4, q_len = 3, kv_len = 5, z = 2;
+
+  tim::vx::TensorSpec q_spec(tim::vx::DataType::FLOAT32, {d, q_len, z},
+                             tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec k_spec(tim::vx::DataType::FLOAT32, {d, kv_len, z},
+                             tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec v_spec(tim::vx::DataType::FLOAT32, {dv, kv_len, z},
+                             tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec out_spec(tim::vx::DataType::FLOAT32, {dv, q_len, z},
+                               tim::vx::TensorAttribute::OUTPUT);
+
+  auto q_tensor = graph->CreateTensor(q_spec);
+  auto k_tensor = graph->CreateTensor(k_spec);
+  auto v_tensor = graph->CreateTensor(v_spec);
+  auto out_tensor = graph->CreateTensor(out_spec);
+
+  auto q = Ramp(d * q_len * z, 0.7f, 0.0f);
+  auto k = Ramp(d * kv_len * z, 0.3f, 0.1f);
+  auto v = Ramp(dv * kv_len * z, 0.5f, -0.2f);
+  auto golden = Reference(q, k, v, {}, d, dv, q_len, kv_len, z, false);
+
+  EXPECT_TRUE(q_tensor->CopyDataToTensor(q.data(), q.size() * sizeof(float)));
+  EXPECT_TRUE(k_tensor->CopyDataToTensor(k.data(), k.size() * sizeof(float)));
+  EXPECT_TRUE(v_tensor->CopyDataToTensor(v.data(), v.size() * sizeof(float)));
+
+  auto op = graph->CreateOperation<tim::vx::ops::ScaledDotProductAttention>();
+  (*op).BindInputs({q_tensor, k_tensor, v_tensor}).BindOutputs({out_tensor});
+
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<float> output(golden.size());
+  EXPECT_TRUE(out_tensor->CopyDataFromTensor(output.data()));
+  EXPECT_TRUE(ArraysMatch(golden, output, 1e-4f));
+}
+
+TEST(ScaledDotProductAttention, shape_4_3_1_kv_4_mask_float) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+  uint32_t d = 4, dv = 2, q_len = 3, kv_len = 4, z = 1;
+
+  tim::vx::TensorSpec q_spec(tim::vx::DataType::FLOAT32, {d, q_len, z},
+                             tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec k_spec(tim::vx::DataType::FLOAT32, {d, kv_len, z},
+                             tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec v_spec(tim::vx::DataType::FLOAT32, {dv, kv_len, z},
+                             tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec mask_spec(tim::vx::DataType::FLOAT32, {kv_len, q_len, 1},
+                                tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec out_spec(tim::vx::DataType::FLOAT32, {dv, q_len, z},
+                               tim::vx::TensorAttribute::OUTPUT);
+
+  auto q_tensor = graph->CreateTensor(q_spec);
+  auto k_tensor = graph->CreateTensor(k_spec);
+  auto v_tensor = graph->CreateTensor(v_spec);
+  auto mask_tensor = graph->CreateTensor(mask_spec);
+  auto out_tensor = graph->CreateTensor(out_spec);
+
+  auto q = Ramp(d * q_len * z, 0.9f, 0.0f);
+  auto k = Ramp(d * kv_len * z, 0.4f, 0.0f);
+  auto v = Ramp(dv * kv_len * z, 1.1f, 0.5f);
+  std::vector<float> mask = {
+      0, -1e4f, 0,     0,
+      0, 0,     -1e4f, 0,
+      0, 0,     0,     -1e4f,
+  };
+  auto golden = Reference(q, k, v, mask, d, dv, q_len, kv_len, z, false);
+
+  EXPECT_TRUE(q_tensor->CopyDataToTensor(q.data(), q.size() * sizeof(float)));
+  EXPECT_TRUE(k_tensor->CopyDataToTensor(k.data(), k.size() * sizeof(float)));
+  EXPECT_TRUE(v_tensor->CopyDataToTensor(v.data(), v.size() * sizeof(float)));
+  EXPECT_TRUE(mask_tensor->CopyDataToTensor(mask.data(),
+                                            mask.size() * sizeof(float)));
+
+  auto op = graph->CreateOperation<tim::vx::ops::ScaledDotProductAttention>();
+  (*op)
+      .BindInputs({q_tensor, k_tensor, v_tensor, mask_tensor})
+      .BindOutputs({out_tensor});
+
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<float> output(golden.size());
+  EXPECT_TRUE(out_tensor->CopyDataFromTensor(output.data()));
+  EXPECT_TRUE(ArraysMatch(golden, output, 1e-4f));
+}
+
+TEST(ScaledDotProductAttention, shape_8_4_2_kv_6_causal_float) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+  uint32_t d = 8, dv = 8, q_len = 4, kv_len = 6, z = 2;
+
+  tim::vx::TensorSpec q_spec(tim::vx::DataType::FLOAT32, {d, q_len, z},
+                             tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec k_spec(tim::vx::DataType::FLOAT32, {d, kv_len, z},
+                             tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec v_spec(tim::vx::DataType::FLOAT32, {dv, kv_len, z},
+                             tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec out_spec(tim::vx::DataType::FLOAT32, {dv, q_len, z},
+                               tim::vx::TensorAttribute::OUTPUT);
+
+  auto q_tensor = graph->CreateTensor(q_spec);
+  auto k_tensor = graph->CreateTensor(k_spec);
+  auto v_tensor = graph->CreateTensor(v_spec);
+  auto out_tensor = graph->CreateTensor(out_spec);
+
+  auto q = Ramp(d * q_len * z, 0.2f, 0.0f);
+  auto k = Ramp(d * kv_len * z, 0.6f, 0.0f);
+  auto v = Ramp(dv * kv_len * z, 0.8f, 0.0f);
+  auto golden = Reference(q, k, v, {}, d, dv, q_len, kv_len, z, true);
+
+  EXPECT_TRUE(q_tensor->CopyDataToTensor(q.data(), q.size() * sizeof(float)));
+  EXPECT_TRUE(k_tensor->CopyDataToTensor(k.data(), k.size() * sizeof(float)));
+  EXPECT_TRUE(v_tensor->CopyDataToTensor(v.data(), v.size() * sizeof(float)));
+
+  auto op = graph->CreateOperation<tim::vx::ops::ScaledDotProductAttention>(
+      0.0f, true);
+  (*op).BindInputs({q_tensor, k_tensor, v_tensor}).BindOutputs({out_tensor});
+
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<float> output(golden.size());
+  EXPECT_TRUE(out_tensor->CopyDataFromTensor(output.data()));
+  EXPECT_TRUE(ArraysMatch(golden, output, 1e-4f));
+}
+
+// Quantized tensors run the tiled decomposition, a tile of 2 query rows
+// splits the causal mask across tiles.
+TEST(ScaledDotProductAttention, shape_4_5_1_causal_tile_2_uint8) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+  uint32_t d = 4, dv = 4, q_len = 5, kv_len = 5, z = 1;
+  float scale = 2.0f / 255.0f;
+  int32_t zp = 128;
+  tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, scale, zp);
+
+  tim::vx::TensorSpec q_spec(tim::vx::DataType::UINT8, {d, q_len, z},
+                             tim::vx::TensorAttribute::INPUT, quant);
+  tim::vx::TensorSpec k_spec(tim::vx::DataType::UINT8, {d, kv_len, z},
+                             tim::vx::TensorAttribute::INPUT, quant);
+  tim::vx::TensorSpec v_spec(tim::vx::DataType::UINT8, {dv, kv_len, z},
+                             tim::vx::TensorAttribute::INPUT, quant);
+  tim::vx::TensorSpec out_spec(tim::vx::DataType::UINT8, {dv, q_len, z},
+                               tim::vx::TensorAttribute::OUTPUT, quant);
+
+  auto q_tensor = graph->CreateTensor(q_spec);
+  auto k_tensor = graph->CreateTensor(k_spec);
+  auto v_tensor = graph->CreateTensor(v_spec);
+  auto out_tensor = graph->CreateTensor(out_spec);
+
+  auto q = Ramp(d * q_len * z, 0.7f, 0.0f);
+  auto k = Ramp(d * kv_len * z, 0.3f, 0.0f);
+  auto v = Ramp(dv * kv_len * z, 0.5f, 0.0f);
+  auto golden = Reference(q, k, v, {}, d, dv, q_len, kv_len, z, true);
+
+  auto quantize = [&](const std::vector<float>& data) {
+    std::vector<uint8_t> codes(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+      codes[i] = static_cast<uint8_t>(
+          std::max(0.0f, std::min(255.0f, std::round(data[i] / scale) + zp)));
+    }
+    return codes;
+  };
+  auto q_codes = quantize(q);
+  auto k_codes = quantize(k);
+  auto v_codes = quantize(v);
+  EXPECT_TRUE(q_tensor->CopyDataToTensor(q_codes.data(), q_codes.size()));
+  EXPECT_TRUE(k_tensor->CopyDataToTensor(k_codes.data(), k_codes.size()));
+  EXPECT_TRUE(v_tensor->CopyDataToTensor(v_codes.data(), v_codes.size()));
+
+  auto op = graph->CreateOperation<tim::vx::ops::ScaledDotProductAttention>(
+      0.0f, true, 2);
+  (*op).BindInputs({q_tensor, k_tensor, v_tensor}).BindOutputs({out_tensor});
+
+  EXPECT_TRUE(graph->Compile());
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<uint8_t> codes(golden.size());
+  EXPECT_TRUE(out_tensor->CopyDataFromTensor(codes.data()));
+  std::vector<float> output(codes.size());
+  for (size_t i = 0; i < codes.size(); ++i) {
+    output[i] = (static_cast<int32_t>(codes[i]) - zp) * scale;
+  }
+  EXPECT_TRUE(ArraysMatch(golden, output, 3 * scale));
+}
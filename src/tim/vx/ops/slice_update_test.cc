@@ -0,0 +1,118 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/slice_update.h"
+#include "tim/vx/ops/elementwise.h"
+#include "test_utils.h"
+#include "gtest/gtest.h"
+
+TEST(SliceUpdate, append_rows_over_runs_float) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+  uint32_t width = 2, max_len = 4;
+
+  tim::vx::TensorSpec update_spec(tim::vx::DataType::FLOAT32, {width, 1},
+                                  tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec start_spec(tim::vx::DataType::INT32, {1},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec cache_spec(tim::vx::DataType::FLOAT32, {width, max_len},
+                                 tim::vx::TensorAttribute::VARIABLE);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32,
+                                  {width, max_len},
+                                  tim::vx::TensorAttribute::OUTPUT);
+
+  auto update_tensor = graph->CreateTensor(update_spec);
+  auto start_tensor = graph->CreateTensor(start_spec);
+  auto cache_tensor = graph->CreateTensor(cache_spec);
+  auto output_tensor = graph->CreateTensor(output_spec);
+
+  auto op = graph->CreateOperation<tim::vx::ops::SliceUpdate>(1);
+  (*op).BindInputs({update_tensor, start_tensor}).BindOutputs({cache_tensor});
+  auto copy = graph->CreateOperation<tim::vx::ops::Add>();
+  (*copy).BindInputs({cache_tensor, cache_tensor}).BindOutputs({output_tensor});
+
+  EXPECT_TRUE(graph->Compile());
+
+  std::vector<float> zeros(width * max_len, 0.0f);
+  EXPECT_TRUE(cache_tensor->CopyDataToTensor(zeros.data(),
+                                             zeros.size() * sizeof(float)));
+
+  // One row per run, the rows written by earlier runs have to survive.
+  std::vector<float> golden(zeros);
+  for (int32_t pos = 0; pos < 3; ++pos) {
+    std::vector<float> row = {pos + 1.0f, -(pos + 1.0f)};
+    EXPECT_TRUE(update_tensor->CopyDataToTensor(row.data(),
+                                                row.size() * sizeof(float)));
+    EXPECT_TRUE(start_tensor->CopyDataToTensor(&pos, sizeof(pos)));
+    EXPECT_TRUE(graph->Run());
+
+    golden[pos * width] = row[0];
+    golden[pos * width + 1] = row[1];
+    std::vector<float> cache(golden.size());
+    EXPECT_TRUE(cache_tensor->CopyDataFromTensor(cache.data()));
+    EXPECT_EQ(golden, cache);
+
+    std::vector<float> doubled(golden.size());
+    EXPECT_TRUE(output_tensor->CopyDataFromTensor(doubled.data()));
+    for (size_t i = 0; i < golden.size(); ++i) {
+      EXPECT_FLOAT_EQ(golden[i] * 2.0f, doubled[i]);
+    }
+  }
+}
+
+TEST(SliceUpdate, axis_2_uint8) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+
+  tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 0.5f, 10);
+  tim::vx::TensorSpec update_spec(tim::vx::DataType::UINT8, {2, 2, 1},
+                                  tim::vx::TensorAttribute::INPUT, quant);
+  tim::vx::TensorSpec start_spec(tim::vx::DataType::INT32, {1},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec cache_spec(tim::vx::DataType::UINT8, {2, 2, 3},
+                                 tim::vx::TensorAttribute::VARIABLE, quant);
+
+  auto update_tensor = graph->CreateTensor(update_spec);
+  auto start_tensor = graph->CreateTensor(start_spec);
+  auto cache_tensor = graph->CreateTensor(cache_spec);
+
+  auto op = graph->CreateOperation<tim::vx::ops::SliceUpdate>(2);
+  (*op).BindInputs({update_tensor, start_tensor}).BindOutputs({cache_tensor});
+
+  EXPECT_TRUE(graph->Compile());
+
+  std::vector<uint8_t> init(12, 10);
+  std::vector<uint8_t> update = {1, 2, 3, 4};
+  int32_t start = 2;
+  EXPECT_TRUE(cache_tensor->CopyDataToTensor(init.data(), init.size()));
+  EXPECT_TRUE(update_tensor->CopyDataToTensor(update.data(), update.size()));
+  EXPECT_TRUE(start_tensor->CopyDataToTensor(&start, sizeof(start)));
+  EXPECT_TRUE(graph->Run());
+
+  std::vector<uint8_t> golden = {10, 10, 10, 10, 10, 10, 10, 10, 1, 2, 3, 4};
+  std::vector<uint8_t> output(golden.size());
+  EXPECT_TRUE(cache_tensor->CopyDataFromTensor(output.data()));
+  EXPECT_EQ(golden, output);
+}
@@ -0,0 +1,306 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/platform/batch_scheduler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace tim {
+namespace vx {
+namespace platform {
+
+void LatencyHistogram::Record(std::chrono::microseconds latency) {
+  uint64_t us = latency.count() > 0 ? latency.count() : 0;
+  size_t bucket = 0;
+  while ((us >>= 1) != 0 && bucket + 1 < kBucketCount) {
+    ++bucket;
+  }
+  ++buckets_[bucket];
+  ++count_;
+  total_ += latency;
+  max_ = std::max(max_, latency);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    buckets_[i] += other.buckets_[i];
+  }
+  count_ += other.count_;
+  total_ += other.total_;
+  max_ = std::max(max_, other.max_);
+}
+
+std::chrono::microseconds LatencyHistogram::Mean() const {
+  if (0 == count_) return std::chrono::microseconds(0);
+  return std::chrono::microseconds(total_.count() /
+                                   static_cast<int64_t>(count_));
+}
+
+std::chrono::microseconds LatencyHistogram::Percentile(
+    double percentile) const {
+  if (0 == count_) return std::chrono::microseconds(0);
+  uint64_t target = static_cast<uint64_t>(
+      std::ceil(std::min(std::max(percentile, 0.0), 100.0) / 100.0 * count_));
+  target = std::max<uint64_t>(target, 1);
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets_[i];
+    if (seen >= target) {
+      return std::min(max_, std::chrono::microseconds(int64_t(2) << i));
+    }
+  }
+  return max_;
+}
+
+BatchScheduler::BatchScheduler(const BatchSchedulerOptions& options)
+    : options_(options) {}
+
+BatchScheduler::~BatchScheduler() { Shutdown(); }
+
+std::shared_ptr<BatchScheduler> BatchScheduler::Create(
+    const std::shared_ptr<IExecutor>& executor, const GraphBuilder& builder,
+    const BatchSchedulerOptions& options) {
+  std::vector<uint32_t> batch_sizes = options.batch_sizes;
+  std::sort(batch_sizes.begin(), batch_sizes.end());
+  batch_sizes.erase(std::unique(batch_sizes.begin(), batch_sizes.end()),
+                    batch_sizes.end());
+  batch_sizes.erase(std::remove(batch_sizes.begin(), batch_sizes.end(), 0u),
+                    batch_sizes.end());
+  if (batch_sizes.empty() || 0 == options.max_batch_size) {
+    std::cout << "BatchScheduler needs a non-zero batch size" << std::endl;
+    return nullptr;
+  }
+
+  std::shared_ptr<BatchScheduler> scheduler(new BatchScheduler(options));
+  for (auto batch : batch_sizes) {
+    if (!scheduler->AddVariant(executor, builder, batch)) {
+      return nullptr;
+    }
+  }
+  scheduler->max_batch_ =
+      std::min(options.max_batch_size, batch_sizes.back());
+  scheduler->worker_ = std::thread(&BatchScheduler::WorkerLoop,
+                                   scheduler.get());
+  return scheduler;
+}
+
+bool BatchScheduler::AddVariant(const std::shared_ptr<IExecutor>& executor,
+                                const GraphBuilder& builder, uint32_t batch) {
+  auto graph = builder(executor->Contex(), batch);
+  if (!graph) {
+    std::cout << "Build graph for batch " << batch << " failed" << std::endl;
+    return false;
+  }
+  auto executable = executor->Compile(graph);
+  if (!executable) {
+    std::cout << "Compile graph for batch " << batch << " failed"
+              << std::endl;
+    return false;
+  }
+
+  Variant variant{batch, executable, {}, {}};
+  // Per sample bytes of each tensor, the batch being the outermost dimension
+  auto sample_sizes =
+      [batch](const std::vector<std::shared_ptr<Tensor>>& tensors,
+              std::vector<size_t>& sizes) {
+        for (const auto& tensor : tensors) {
+          const auto& spec = tensor->GetSpec();
+          if (spec.shape_.empty() || spec.shape_.back() != batch) {
+            std::cout << "Batch must be the outermost dimension of graph "
+                         "inputs and outputs"
+                      << std::endl;
+            return false;
+          }
+          sizes.push_back(spec.GetByteSize() / batch);
+        }
+        return true;
+      };
+  std::vector<size_t> input_sizes;
+  std::vector<size_t> output_sizes;
+  if (!sample_sizes(graph->InputsTensor(), input_sizes) ||
+      !sample_sizes(graph->OutputsTensor(), output_sizes)) {
+    return false;
+  }
+  if (!variants_.empty() &&
+      (input_sizes != input_sizes_ || output_sizes != output_sizes_)) {
+    std::cout << "Graph for batch " << batch
+              << " does not match the other batch sizes" << std::endl;
+    return false;
+  }
+  input_sizes_ = input_sizes;
+  output_sizes_ = output_sizes;
+
+  for (const auto& input : graph->InputsTensor()) {
+    auto handle = executable->AllocateTensor(input->GetSpec());
+    executable->SetInput(handle);
+    variant.inputs.push_back(handle);
+  }
+  for (const auto& output : graph->OutputsTensor()) {
+    auto handle = executable->AllocateTensor(output->GetSpec());
+    executable->SetOutput(handle);
+    variant.outputs.push_back(handle);
+  }
+  if (!executable->Verify()) {
+    std::cout << "Verify executable for batch " << batch << " failed"
+              << std::endl;
+    return false;
+  }
+  variants_.push_back(std::move(variant));
+  return true;
+}
+
+std::future<BatchScheduler::Sample> BatchScheduler::Submit(Sample inputs) {
+  std::promise<Sample> result;
+  auto future = result.get_future();
+
+  bool valid = inputs.size() == input_sizes_.size();
+  for (size_t i = 0; valid && i < inputs.size(); ++i) {
+    valid = inputs[i].size() == input_sizes_[i];
+  }
+  if (!valid) {
+    result.set_exception(std::make_exception_ptr(
+        std::runtime_error("Sample does not match graph inputs")));
+    return future;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopped_) {
+      result.set_exception(std::make_exception_ptr(
+          std::runtime_error("BatchScheduler is shut down")));
+      return future;
+    }
+    queue_.push_back(Request{std::move(inputs), std::move(result),
+                             std::chrono::steady_clock::now()});
+  }
+  cv_.notify_one();
+  return future;
+}
+
+void BatchScheduler::Shutdown() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+BatchScheduler::Stats BatchScheduler::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void BatchScheduler::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+    if (queue_.empty()) return;
+
+    // Give later requests until the oldest one's deadline to fill the batch
+    auto deadline = queue_.front().enqueue_time + options_.max_latency;
+    cv_.wait_until(lock, deadline, [this] {
+      return stopped_ || queue_.size() >= max_batch_;
+    });
+
+    size_t count = std::min(queue_.size(), max_batch_);
+    std::vector<Request> batch;
+    batch.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+      batch.push_back(std::move(queue_.front()));
+      queue_.pop_front();
+    }
+    lock.unlock();
+    RunBatch(batch);
+    lock.lock();
+  }
+}
+
+void BatchScheduler::RunBatch(std::vector<Request>& batch) {
+  auto start = std::chrono::steady_clock::now();
+  const Variant* variant = &variants_.back();
+  for (const auto& candidate : variants_) {
+    if (candidate.batch >= batch.size()) {
+      variant = &candidate;
+      break;
+    }
+  }
+
+  bool ok = true;
+  std::vector<char> buffer;
+  for (size_t i = 0; ok && i < variant->inputs.size(); ++i) {
+    size_t size = input_sizes_[i];
+    buffer.assign(size * variant->batch, 0);
+    for (size_t j = 0; j < batch.size(); ++j) {
+      memcpy(buffer.data() + j * size, batch[j].inputs[i].data(), size);
+    }
+    ok = variant->inputs[i]->CopyDataToTensor(
+        buffer.data(), static_cast<uint32_t>(buffer.size()));
+  }
+  ok = ok && variant->executable->Trigger();
+
+  std::vector<Sample> results(batch.size(), Sample(output_sizes_.size()));
+  for (size_t i = 0; ok && i < variant->outputs.size(); ++i) {
+    size_t size = output_sizes_[i];
+    buffer.resize(size * variant->batch);
+    ok = variant->outputs[i]->CopyDataFromTensor(buffer.data());
+    for (size_t j = 0; ok && j < batch.size(); ++j) {
+      results[j][i].assign(buffer.data() + j * size,
+                           buffer.data() + (j + 1) * size);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.requests += batch.size();
+    ++stats_.batches;
+    ++stats_.batch_size_runs[variant->batch];
+    stats_.exec_latency.Record(
+        std::chrono::duration_cast<std::chrono::microseconds>(end - start));
+    for (const auto& request : batch) {
+      stats_.queue_latency.Record(
+          std::chrono::duration_cast<std::chrono::microseconds>(
+              start - request.enqueue_time));
+    }
+  }
+
+  for (size_t j = 0; j < batch.size(); ++j) {
+    if (ok) {
+      batch[j].result.set_value(std::move(results[j]));
+    } else {
+      batch[j].result.set_exception(std::make_exception_ptr(
+          std::runtime_error("Batched run failed")));
+    }
+  }
+}
+
+}  // namespace platform
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,113 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/platform/batch_scheduler.h"
+#include "tim/vx/platform/native.h"
+#include "tim/vx/ops/activations.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+using std::chrono::microseconds;
+
+TEST(LatencyHistogram, percentiles) {
+  tim::vx::platform::LatencyHistogram histogram;
+  EXPECT_EQ(microseconds(0), histogram.Percentile(50));
+
+  for (int i = 0; i < 90; ++i) histogram.Record(microseconds(100));
+  for (int i = 0; i < 10; ++i) histogram.Record(microseconds(5000));
+
+  EXPECT_EQ(100u, histogram.Count());
+  EXPECT_EQ(microseconds(590), histogram.Mean());
+  EXPECT_EQ(microseconds(5000), histogram.Max());
+  // 100us falls in [64, 128), 5000us in [4096, 8192)
+  EXPECT_EQ(90u, histogram.Bucket(6));
+  EXPECT_EQ(10u, histogram.Bucket(12));
+  EXPECT_EQ(microseconds(128), histogram.Percentile(50));
+  EXPECT_EQ(microseconds(128), histogram.Percentile(90));
+  EXPECT_EQ(microseconds(5000), histogram.Percentile(99));
+
+  tim::vx::platform::LatencyHistogram other;
+  other.Record(microseconds(0));
+  histogram.Merge(other);
+  EXPECT_EQ(101u, histogram.Count());
+  EXPECT_EQ(1u, histogram.Bucket(0));
+}
+
+TEST(BatchScheduler, coalesce_requests) {
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  ASSERT_FALSE(devices.empty());
+  auto executor =
+      std::make_shared<tim::vx::platform::NativeExecutor>(devices[0]);
+
+  auto builder = [](const std::shared_ptr<tim::vx::Context>& context,
+                    uint32_t batch) {
+    auto graph = context->CreateGraph();
+    tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {4, batch},
+                                   tim::vx::TensorAttribute::INPUT);
+    tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {4, batch},
+                                    tim::vx::TensorAttribute::OUTPUT);
+    auto input = graph->CreateTensor(input_spec);
+    auto output = graph->CreateTensor(output_spec);
+    (*graph->CreateOperation<tim::vx::ops::Relu>())
+        .BindInput(input)
+        .BindOutput(output);
+    return graph;
+  };
+
+  tim::vx::platform::BatchSchedulerOptions options;
+  options.batch_sizes = {1, 4};
+  options.max_latency = microseconds(100000);
+  auto scheduler =
+      tim::vx::platform::BatchScheduler::Create(executor, builder, options);
+  ASSERT_TRUE(scheduler);
+  EXPECT_EQ(std::vector<size_t>({4 * sizeof(float)}),
+            scheduler->InputSizes());
+
+  std::vector<std::future<tim::vx::platform::BatchScheduler::Sample>> results;
+  for (int i = 0; i < 4; ++i) {
+    std::vector<float> sample = {-1.0f, float(i), -2.0f, float(i + 1)};
+    std::vector<char> bytes(reinterpret_cast<char*>(sample.data()),
+                            reinterpret_cast<char*>(sample.data() + 4));
+    results.push_back(scheduler->Submit({bytes}));
+  }
+  for (int i = 0; i < 4; ++i) {
+    auto output = results[i].get();
+    ASSERT_EQ(1u, output.size());
+    std::vector<float> values(4);
+    memcpy(values.data(), output[0].data(), output[0].size());
+    EXPECT_EQ(std::vector<float>({0, float(i), 0, float(i + 1)}), values);
+  }
+
+  // Wrong sized samples are rejected without reaching the device
+  EXPECT_THROW(scheduler->Submit({std::vector<char>(3)}).get(),
+               std::runtime_error);
+
+  scheduler->Shutdown();
+  auto stats = scheduler->GetStats();
+  EXPECT_EQ(4u, stats.requests);
+  EXPECT_EQ(1u, stats.batches);
+  EXPECT_EQ(1u, stats.batch_size_runs[4]);
+  EXPECT_EQ(4u, stats.queue_latency.Count());
+}
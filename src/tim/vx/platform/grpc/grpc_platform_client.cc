@@ -57,6 +57,15 @@ namespace {
     case tim::vx::DataType::BOOL8:
       rpc_type = ::rpc::DataType::BOOL8;
       break;
+    case tim::vx::DataType::INT4:
+      rpc_type = ::rpc::DataType::INT4;
+      break;
+    case tim::vx::DataType::UINT4:
+      rpc_type = ::rpc::DataType::UINT4;
+      break;
+    case tim::vx::DataType::BFLOAT16:
+      rpc_type = ::rpc::DataType::BFLOAT16;
+      break;
     default:
       std::cout << "unknown tim vx data type" << std::endl;
       assert(false);
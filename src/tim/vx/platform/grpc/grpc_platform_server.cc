@@ -75,6 +75,15 @@ tim::vx::DataType MapDataType(::rpc::DataType type) {
     case ::rpc::DataType::BOOL8:
       vx_type = tim::vx::DataType::BOOL8;
       break;
+    case ::rpc::DataType::INT4:
+      vx_type = tim::vx::DataType::INT4;
+      break;
+    case ::rpc::DataType::UINT4:
+      vx_type = tim::vx::DataType::UINT4;
+      break;
+    case ::rpc::DataType::BFLOAT16:
+      vx_type = tim::vx::DataType::BFLOAT16;
+      break;
     default:
       std::cout << "unknown data type" << std::endl;
       assert(false);
@@ -299,10 +299,15 @@ LiteNativeTensorHandle::~LiteNativeTensorHandle() {
 bool LiteNativeTensorHandle::CopyDataToTensor(const void* data,
                                               uint32_t size_in_bytes) {
   memcpy(tensor_buffer_->cpu_logical, data, size_in_bytes);
-  return true;
+  return VIP_SUCCESS ==
+         vip_flush_videomemory(tensor_buffer_, VIP_BUFFER_OPER_TYPE_FLUSH);
 }
 
 bool LiteNativeTensorHandle::CopyDataFromTensor(void* data) {
+  if (VIP_SUCCESS != vip_flush_videomemory(tensor_buffer_,
+                                           VIP_BUFFER_OPER_TYPE_INVALIDATE)) {
+    return false;
+  }
   memcpy(data, tensor_buffer_->cpu_logical, tensor_buffer_->size);
   return true;
 }
@@ -24,6 +24,14 @@
 #include "tim/vx/platform/native.h"
 #include "native_device_private.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <mutex>
+
 namespace tim {
 namespace vx {
 namespace platform {
@@ -45,7 +53,9 @@ IDevice::device_id_t IDevice::Id() const { return device_id_; }
 
 void IDevice::RemoteReset() {}
 
-NativeDeviceImpl::NativeDeviceImpl(device_id_t id) {
+NativeDeviceImpl::NativeDeviceImpl(
+    device_id_t id, const std::shared_ptr<_vsi_nn_context_t>& context)
+    : shared_context_(context) {
   vip_device_ = std::make_unique<vip::IDevice>(id);
   device_id_ = id;
 }
@@ -76,17 +86,20 @@ bool NativeDeviceImpl::DeviceExit() { return vip_device_->ThreadExit(); }
 std::vector<std::shared_ptr<IDevice>> NativeDevice::Enumerate() {
   std::vector<std::shared_ptr<IDevice>> device_v;
   device_id_t deviceCount = 0;
-  vsi_nn_context_t context;
-  context = vsi_nn_CreateContext();
+  // Borrow the process-wide context instead of creating a throwaway one, the
+  // devices keep it alive for executors and Context::CreateShared
+  auto context = AcquireSharedContext();
+  if (!context) {
+    return device_v;
+  }
   vxQueryContext(context->c, VX_CONTEXT_DEVICE_COUNT_VIV, &deviceCount,
                  sizeof(deviceCount));
   std::cout << "Device count = " << deviceCount << std::endl;
   for (device_id_t i = 0; i < deviceCount; i++) {
-    IDevice* local_device = new NativeDeviceImpl(i);
+    IDevice* local_device = new NativeDeviceImpl(i, context);
     std::shared_ptr<IDevice> local_device_sp(local_device);
     device_v.push_back(local_device_sp);
   }
-  vsi_nn_ReleaseContext(&context);
   return device_v;
 }
 
@@ -100,22 +113,64 @@ std::shared_ptr<IExecutor> IExecutable::Executor() const {
   return executor;
 }
 
+static std::shared_ptr<const char> ShareBuffer(std::vector<char>&& buf) {
+  auto owner = std::make_shared<std::vector<char>>(std::move(buf));
+  return std::shared_ptr<const char>(owner, owner->data());
+}
+
 NativeExecutable::NativeExecutable(const std::shared_ptr<IExecutor>& executor,
-                                   const std::vector<char>& nb_buf,
+                                   std::vector<char> nb_buf,
+                                   size_t inputs, size_t outputs)
+    : NativeExecutable(executor, ShareBuffer(std::move(nb_buf)), inputs,
+                       outputs) {}
+
+NativeExecutable::NativeExecutable(const std::shared_ptr<IExecutor>& executor,
+                                   const std::shared_ptr<const char>& nb_buf,
                                    size_t inputs, size_t outputs) {
   executor_ = executor;
   context_ = executor->Contex();
   nb_graph_ = context_->CreateGraph();
-  nb_buf_ = nb_buf;
-  nb_node_ = nb_graph_->CreateOperation<tim::vx::ops::NBG>(nb_buf_.data(),
-                                                           inputs, outputs);
+  nb_node_ = nb_graph_->CreateOperation<tim::vx::ops::NBG>(nb_buf, inputs,
+                                                           outputs);
+}
+
+std::shared_ptr<Tensor> NativeExecutable::BindForeignHandle(
+    const std::shared_ptr<ITensorHandle>& th, TensorAttribute attr,
+    std::vector<HandleBinding>& copies) {
+  auto handle = std::static_pointer_cast<NativeTensorHandle>(th);
+  TensorSpec spec = th->GetTensor()->GetSpec();
+  spec.SetAttribute(attr);
+  if (handle->Buffer()) {
+    auto tensor = nb_graph_->CreateIOTensor(spec, handle->Buffer().get());
+    shared_bindings_.push_back(std::make_pair(th, tensor));
+    return tensor;
+  }
+  auto tensor = nb_graph_->CreateTensor(spec);
+  copies.push_back(std::make_pair(th, tensor));
+  return tensor;
+}
+
+static bool IsForeignHandle(const std::shared_ptr<ITensorHandle>& th,
+                            const Graph* graph) {
+  auto handle = std::dynamic_pointer_cast<NativeTensorHandle>(th);
+  return handle && handle->Owner() && handle->Owner() != graph;
 }
 
 void NativeExecutable::SetInput(const std::shared_ptr<ITensorHandle>& th) {
+  if (IsForeignHandle(th, nb_graph_.get())) {
+    nb_node_->BindInput(
+        BindForeignHandle(th, TensorAttribute::INPUT, copied_inputs_));
+    return;
+  }
   nb_node_->BindInput(th->GetTensor());
 }
 
 void NativeExecutable::SetOutput(const std::shared_ptr<ITensorHandle>& th) {
+  if (IsForeignHandle(th, nb_graph_.get())) {
+    nb_node_->BindOutput(
+        BindForeignHandle(th, TensorAttribute::OUTPUT, copied_outputs_));
+    return;
+  }
   nb_node_->BindOutput(th->GetTensor());
 }
 
@@ -132,22 +187,68 @@ bool NativeExecutable::Submit(const std::shared_ptr<IExecutable>& ref,
   return status;
 }
 
+static bool CopyThroughHost(const std::shared_ptr<Tensor>& src,
+                            const std::shared_ptr<Tensor>& dst,
+                            uint64_t* bytes) {
+  std::vector<char> staging(src->GetSpec().GetByteSize());
+  if (!src->CopyDataFromTensor(staging.data()) ||
+      !dst->CopyDataToTensor(staging.data(), staging.size())) {
+    return false;
+  }
+  *bytes += 2 * staging.size();
+  return true;
+}
+
 bool NativeExecutable::Trigger(bool async) {
   (void)async;
-  bool status = false;
+  bool status = true;
+  for (auto& binding : copied_inputs_) {
+    status = status && CopyThroughHost(binding.first->GetTensor(),
+                                       binding.second, &host_bytes_copied_);
+  }
+  // The producer may have been written by the CPU, e.g. the first stage
+  for (auto& binding : shared_bindings_) {
+    if (binding.second->GetSpec().attr_ & TensorAttribute::INPUT) {
+      binding.second->FlushCacheForHandle();
+    }
+  }
+  if (!status) {
+    return false;
+  }
   auto device = Executor()->Device();
   device->Submit(nb_graph_);
   status = device->Trigger();
   device->WaitDeviceIdle();
+  for (auto& binding : copied_outputs_) {
+    status = status && CopyThroughHost(binding.second,
+                                       binding.first->GetTensor(),
+                                       &host_bytes_copied_);
+  }
   return status;
 }
 
+/* Handle memory for the driver, see samples/lenet_lite */
+static const size_t kHandleAlignment = 64;
+
 std::shared_ptr<ITensorHandle> NativeExecutable::AllocateTensor(
     const TensorSpec& tensor_spec) {
+#if (ENABLE_TENSOR_HNDL)
+  if (tensor_spec.attr_ & (TensorAttribute::INPUT | TensorAttribute::OUTPUT)) {
+    size_t size = (tensor_spec.GetByteSize() + kHandleAlignment - 1) /
+                  kHandleAlignment * kHandleAlignment;
+    std::shared_ptr<char> buffer(
+        static_cast<char*>(aligned_alloc(kHandleAlignment, size)), free);
+    if (buffer) {
+      memset(buffer.get(), 0, size);
+      auto tensor = nb_graph_->CreateIOTensor(tensor_spec, buffer.get());
+      return std::make_shared<NativeTensorHandle>(tensor, buffer,
+                                                  nb_graph_.get());
+    }
+  }
+#endif
   auto tensor = nb_graph_->CreateTensor(tensor_spec);
-  ITensorHandle* tensor_handle = new NativeTensorHandle(tensor);
-  std::shared_ptr<ITensorHandle> tensor_handle_sp(tensor_handle);
-  return tensor_handle_sp;
+  return std::make_shared<NativeTensorHandle>(tensor, nullptr,
+                                              nb_graph_.get());
 }
 
 bool NativeExecutable::Verify() { return nb_graph_->Compile(); }
@@ -214,7 +315,11 @@ std::shared_ptr<Context> IExecutor::Contex() const { return context_; }
 
 NativeExecutor::NativeExecutor(const std::shared_ptr<IDevice>& device) {
   device_ = device;
-  context_ = Context::Create();
+  // Reuses the context pooled by NativeDevice::Enumerate
+  context_ = Context::CreateShared();
+  if (!context_) {
+    context_ = Context::Create();
+  }
 }
 
 NativeExecutor::NativeExecutor(const std::shared_ptr<IDevice>& device,
@@ -223,69 +328,254 @@ NativeExecutor::NativeExecutor(const std::shared_ptr<IDevice>& device,
   context_ = context;
 }
 
+NativeExecutor::~NativeExecutor() {
+  if (async_run_.joinable()) {
+    // The last reference may be dropped by the run itself, which only
+    // uses state it owns, so it can finish on its own
+    if (async_run_.get_id() == std::this_thread::get_id()) {
+      async_run_.detach();
+    } else {
+      async_run_.join();
+    }
+  }
+}
+
+static const size_t kNoTask = std::numeric_limits<size_t>::max();
+
+size_t NativeExecutor::FindTask(
+    const std::shared_ptr<IExecutable>& executable) const {
+  for (size_t i = 0; i < graph_.size(); i++) {
+    if (graph_[i].executable.lock() == executable) {
+      return i;
+    }
+  }
+  return kNoTask;
+}
+
+size_t NativeExecutor::AddTask(
+    const std::shared_ptr<IExecutable>& executable) {
+  size_t index = FindTask(executable);
+  if (index == kNoTask) {
+    TaskNode node;
+    node.executable = executable;
+    graph_.push_back(node);
+    index = graph_.size() - 1;
+  }
+  return index;
+}
+
+bool NativeExecutor::Reaches(size_t from, size_t to) const {
+  std::vector<bool> visited(graph_.size(), false);
+  std::vector<size_t> stack = {from};
+  while (!stack.empty()) {
+    size_t i = stack.back();
+    stack.pop_back();
+    if (i == to) {
+      return true;
+    }
+    if (visited[i]) {
+      continue;
+    }
+    visited[i] = true;
+    stack.insert(stack.end(), graph_[i].next.begin(), graph_[i].next.end());
+  }
+  return false;
+}
+
 bool NativeExecutor::Submit(const std::shared_ptr<IExecutable>& executable,
                             const std::shared_ptr<IExecutable>& ref,
                             bool after) {
-  bool success = false;
-  success = executable->Verify();
-  if (success == false) {
-    std::cout << "Executable NBG compile failed";
+  if (!executable) {
     return false;
   }
   if (executable == ref) {
-    tasks_.push_back(executable);
+    AddTask(executable);
     return true;
   }
-  for (size_t i = 0; i < tasks_.size(); i++) {
-    if (tasks_[i].lock() == ref) {
-      if (after == true) {
-        tasks_.insert(tasks_.begin() + i + 1, executable);
-        success = true;
-        break;
-      } else {
-        tasks_.insert(tasks_.begin() + i, executable);
-        success = true;
+  size_t ref_index = FindTask(ref);
+  if (ref_index == kNoTask) {
+    return false;
+  }
+  size_t index = AddTask(executable);
+  size_t from = after ? ref_index : index;
+  size_t to = after ? index : ref_index;
+  auto& next = graph_[from].next;
+  if (std::find(next.begin(), next.end(), to) != next.end()) {
+    return true;
+  }
+  if (Reaches(to, from)) {
+    std::cout << "Executable submit would create a cycle" << std::endl;
+    return false;
+  }
+  next.push_back(to);
+  graph_[to].deps++;
+  return true;
+}
+
+bool NativeExecutor::Run(const std::vector<TaskNode>& graph,
+                         const std::shared_ptr<IDevice>& device,
+                         const TaskCallback& callback) {
+  size_t count = graph.size();
+  std::vector<std::shared_ptr<IExecutable>> executables(count);
+  std::vector<std::shared_ptr<IDevice>> lanes;
+  std::vector<size_t> lane_of(count, 0);
+  std::vector<size_t> deps(count);
+  std::vector<bool> skip(count, false);
+  std::vector<std::deque<size_t>> ready;
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t remaining = count;
+  bool status = true;
+
+  for (size_t i = 0; i < count; i++) {
+    executables[i] = graph[i].executable.lock();
+    std::shared_ptr<IDevice> lane_device = device;
+    if (executables[i]) {
+      auto executor = executables[i]->Executor();
+      if (executor && executor->Device()) {
+        lane_device = executor->Device();
+      }
+    } else {
+      std::cout << "Task unable to lock weak_ptr" << std::endl;
+      skip[i] = true;
+    }
+    auto lane = std::find(lanes.begin(), lanes.end(), lane_device);
+    lane_of[i] = lane - lanes.begin();
+    if (lane == lanes.end()) {
+      lanes.push_back(lane_device);
+    }
+    deps[i] = graph[i].deps;
+  }
+  ready.resize(lanes.size());
+  for (size_t i = 0; i < count; i++) {
+    if (deps[i] == 0) {
+      ready[lane_of[i]].push_back(i);
+    }
+  }
+
+  auto lane_loop = [&](size_t lane) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+      cv.wait(lock, [&]() { return remaining == 0 || !ready[lane].empty(); });
+      if (ready[lane].empty()) {
         break;
       }
+      size_t i = ready[lane].front();
+      ready[lane].pop_front();
+      bool run = !skip[i];
+      lock.unlock();
+
+      bool success = false;
+      if (run) {
+        success = executables[i]->Verify();
+        if (success) {
+          success = executables[i]->Trigger();
+        } else {
+          std::cout << "Executable NBG compile failed" << std::endl;
+        }
+      }
+      if (callback) {
+        callback(executables[i], success);
+      }
+
+      lock.lock();
+      status = status && success;
+      for (size_t next : graph[i].next) {
+        skip[next] = skip[next] || !success;
+        if (--deps[next] == 0) {
+          ready[lane_of[next]].push_back(next);
+        }
+      }
+      remaining--;
+      cv.notify_all();
     }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t lane = 1; lane < lanes.size(); lane++) {
+    threads.emplace_back(lane_loop, lane);
+  }
+  if (!lanes.empty()) {
+    lane_loop(0);
+  }
+  for (auto& thread : threads) {
+    thread.join();
   }
-  return success;
+  for (auto& lane_device : lanes) {
+    if (lane_device) {
+      lane_device->WaitDeviceIdle();
+    }
+  }
+  return status;
 }
 
 bool NativeExecutor::Trigger(bool async) {
-  (void)async;
-  while (!tasks_.empty()) {
-    auto task = tasks_.front();
-    tasks_.erase(tasks_.begin());
-    auto task_ = task.lock();
-    if (!task_) {
-      std::cout << "Task unable to lock weak_ptr";
-    }
-    task_->Trigger();
+  Wait();
+  std::vector<TaskNode> graph;
+  graph.swap(graph_);
+  TaskCallback callback;
+  {
+    std::lock_guard<std::mutex> lock(callback_mutex_);
+    callback = task_callback_;
+  }
+  if (!async) {
+    return Run(graph, device_, callback);
   }
-  device_->WaitDeviceIdle();
+  // The run only holds copies, the executor may be gone before it ends
+  auto status = std::make_shared<bool>(true);
+  async_status_ = status;
+  async_run_ = std::thread([graph, device = device_, callback, status]() {
+    *status = Run(graph, device, callback);
+  });
   return true;
 }
 
+bool NativeExecutor::Wait() {
+  if (async_run_.joinable()) {
+    async_run_.join();
+  }
+  bool status = async_status_ ? *async_status_ : true;
+  async_status_.reset();
+  return status;
+}
+
+void NativeExecutor::SetTaskCallback(const TaskCallback& callback) {
+  std::lock_guard<std::mutex> lock(callback_mutex_);
+  task_callback_ = callback;
+}
+
 std::shared_ptr<IExecutable> NativeExecutor::Compile(
     const std::shared_ptr<Graph>& graph) {
+  auto nb_buf = CompileToBinary(graph);
+  if (!nb_buf) {
+    return nullptr;
+  }
+  size_t inputs = graph->InputsTensor().size();
+  size_t outputs = graph->OutputsTensor().size();
+  std::shared_ptr<IExecutor> this_sp = shared_from_this();
+  IExecutable* executable =
+      new NativeExecutable(this_sp, nb_buf, inputs, outputs);
+  std::shared_ptr<IExecutable> executable_sp(executable);
+  return executable_sp;
+}
+
+std::shared_ptr<const char> NativeExecutor::CompileToBinary(
+    const std::shared_ptr<Graph>& graph) {
   GraphImpl* graphimp =
       dynamic_cast<GraphImpl*>(graph.get());  // hack to downcast
   IDevice::device_id_t id = device_->Id();
   vxSetGraphAttribute(graphimp->graph()->g, VX_GRAPH_DEVICE_INDEX_VIV,
                       (void*)(&id), sizeof(id));
   size_t bin_size = -1;
-  graph->CompileToBinary(nullptr, &bin_size);
+  if (!graph->CompileToBinary(nullptr, &bin_size)) {
+    return nullptr;
+  }
   std::vector<char> nb_buf;
   nb_buf.resize(bin_size);
-  size_t inputs = graph->InputsTensor().size();
-  size_t outputs = graph->OutputsTensor().size();
-  graph->CompileToBinary(nb_buf.data(), &bin_size);
-  std::shared_ptr<IExecutor> this_sp = shared_from_this();
-  IExecutable* executable =
-      new NativeExecutable(this_sp, nb_buf, inputs, outputs);
-  std::shared_ptr<IExecutable> executable_sp(executable);
-  return executable_sp;
+  if (!graph->CompileToBinary(nb_buf.data(), &bin_size)) {
+    return nullptr;
+  }
+  return ShareBuffer(std::move(nb_buf));
 }
 
 std::shared_ptr<IDevice> IExecutor::Device() const { return device_; }
@@ -296,6 +586,13 @@ NativeTensorHandle::NativeTensorHandle(const std::shared_ptr<Tensor>& tensor) {
   tensor_ = tensor;
 }
 
+NativeTensorHandle::NativeTensorHandle(const std::shared_ptr<Tensor>& tensor,
+                                       const std::shared_ptr<char>& buffer,
+                                       const Graph* graph)
+    : buffer_(buffer), graph_(graph) {
+  tensor_ = tensor;
+}
+
 bool NativeTensorHandle::CopyDataToTensor(const void* data,
                                           uint32_t size_in_bytes) {
   return tensor_->CopyDataToTensor(data, size_in_bytes);
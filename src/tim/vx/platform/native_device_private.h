@@ -37,7 +37,8 @@ namespace platform {
 
 class NativeDeviceImpl : public NativeDevice {
  public:
-  NativeDeviceImpl(device_id_t id);
+  NativeDeviceImpl(device_id_t id,
+                   const std::shared_ptr<_vsi_nn_context_t>& context = nullptr);
   ~NativeDeviceImpl(){};
 
   bool Submit(const std::shared_ptr<tim::vx::Graph>& graph) override;
@@ -48,6 +49,9 @@ class NativeDeviceImpl : public NativeDevice {
  protected:
   std::unique_ptr<vip::IDevice> vip_device_;
   std::vector<vsi_nn_graph_t*> vsi_graph_v_;
+  // Pooled context used to enumerate the device, kept alive so that shared
+  // contexts created while the device is in use reuse it
+  std::shared_ptr<_vsi_nn_context_t> shared_context_;
 
 };
 
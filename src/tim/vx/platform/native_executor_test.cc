@@ -0,0 +1,326 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/platform/native.h"
+#include "tim/vx/ops/simple_operations.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using tim::vx::platform::IDevice;
+using tim::vx::platform::IExecutable;
+using tim::vx::platform::IExecutor;
+using tim::vx::platform::ITensorHandle;
+using tim::vx::platform::NativeExecutor;
+
+class FakeDevice : public IDevice {
+ public:
+  explicit FakeDevice(device_id_t id) { device_id_ = id; }
+  bool Submit(const std::shared_ptr<tim::vx::Graph>& graph) override {
+    (void)graph;
+    return true;
+  }
+  bool Trigger(bool async = false, async_callback cb = NULL) override {
+    (void)async;
+    (void)cb;
+    return true;
+  }
+  void WaitDeviceIdle() override {}
+  bool DeviceExit() override { return true; }
+};
+
+struct RunLog {
+  std::mutex mutex;
+  std::vector<std::string> order;
+  std::map<std::string, std::chrono::steady_clock::time_point> start;
+  std::map<std::string, std::chrono::steady_clock::time_point> end;
+
+  size_t Position(const std::string& name) {
+    return std::find(order.begin(), order.end(), name) - order.begin();
+  }
+};
+
+class FakeExecutable : public IExecutable {
+ public:
+  FakeExecutable(const std::shared_ptr<IExecutor>& executor,
+                 const std::string& name, RunLog* log,
+                 std::chrono::milliseconds duration =
+                     std::chrono::milliseconds(0),
+                 bool success = true)
+      : name_(name), log_(log), duration_(duration), success_(success) {
+    executor_ = executor;
+  }
+  void SetInput(const std::shared_ptr<ITensorHandle>& th) override {
+    (void)th;
+  }
+  void SetOutput(const std::shared_ptr<ITensorHandle>& th) override {
+    (void)th;
+  }
+  void GetOutput(
+      const std::vector<std::shared_ptr<ITensorHandle>>& th) override {
+    (void)th;
+  }
+  bool Submit(const std::shared_ptr<IExecutable>& ref,
+              bool after = true) override {
+    return Executor()->Submit(shared_from_this(), ref, after);
+  }
+  bool Trigger(bool async = false) override {
+    (void)async;
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration_);
+    std::lock_guard<std::mutex> lock(log_->mutex);
+    log_->order.push_back(name_);
+    log_->start[name_] = start;
+    log_->end[name_] = std::chrono::steady_clock::now();
+    return success_;
+  }
+  bool Verify() override {
+    verify_count_++;
+    return true;
+  }
+  std::shared_ptr<ITensorHandle> AllocateTensor(
+      const tim::vx::TensorSpec& tensor_spec) override {
+    (void)tensor_spec;
+    return nullptr;
+  }
+
+  int verify_count_{0};
+
+ private:
+  std::string name_;
+  RunLog* log_;
+  std::chrono::milliseconds duration_;
+  bool success_;
+};
+
+std::shared_ptr<NativeExecutor> MakeExecutor(IDevice::device_id_t id) {
+  return std::make_shared<NativeExecutor>(std::make_shared<FakeDevice>(id),
+                                          nullptr);
+}
+
+}  // namespace
+
+TEST(NativeExecutor, diamond_runs_in_dependency_order) {
+  auto executor = MakeExecutor(0);
+  RunLog log;
+  std::vector<std::shared_ptr<FakeExecutable>> g;
+  for (int i = 0; i < 6; ++i) {
+    g.push_back(std::make_shared<FakeExecutable>(
+        executor, "g" + std::to_string(i), &log));
+  }
+  //         -->g1--g2-->
+  //    g0-->|           |-->g5
+  //         -->g3--g4-->
+  ASSERT_TRUE(g[0]->Submit(g[0]));
+  ASSERT_TRUE(g[1]->Submit(g[0]));
+  ASSERT_TRUE(g[2]->Submit(g[1]));
+  ASSERT_TRUE(g[3]->Submit(g[0]));
+  ASSERT_TRUE(g[4]->Submit(g[3]));
+  ASSERT_TRUE(g[5]->Submit(g[2]));
+  ASSERT_TRUE(g[5]->Submit(g[4]));
+  // Verification waits for Trigger()
+  EXPECT_EQ(0, g[0]->verify_count_);
+
+  int callbacks = 0;
+  executor->SetTaskCallback(
+      [&callbacks](const std::shared_ptr<IExecutable>& executable,
+                   bool success) {
+        EXPECT_TRUE(executable);
+        EXPECT_TRUE(success);
+        callbacks++;
+      });
+  EXPECT_TRUE(executor->Trigger());
+
+  ASSERT_EQ(6u, log.order.size());
+  EXPECT_EQ(6, callbacks);
+  for (auto& executable : g) {
+    EXPECT_EQ(1, executable->verify_count_);
+  }
+  EXPECT_LT(log.Position("g0"), log.Position("g1"));
+  EXPECT_LT(log.Position("g1"), log.Position("g2"));
+  EXPECT_LT(log.Position("g0"), log.Position("g3"));
+  EXPECT_LT(log.Position("g3"), log.Position("g4"));
+  EXPECT_LT(log.Position("g2"), log.Position("g5"));
+  EXPECT_LT(log.Position("g4"), log.Position("g5"));
+
+  // The submissions were consumed
+  EXPECT_TRUE(executor->Trigger());
+  EXPECT_EQ(6u, log.order.size());
+}
+
+TEST(NativeExecutor, submit_before_ref) {
+  auto executor = MakeExecutor(0);
+  RunLog log;
+  auto a = std::make_shared<FakeExecutable>(executor, "a", &log);
+  auto b = std::make_shared<FakeExecutable>(executor, "b", &log);
+  ASSERT_TRUE(a->Submit(a));
+  ASSERT_TRUE(b->Submit(a, false));
+  EXPECT_TRUE(executor->Trigger());
+  EXPECT_EQ(std::vector<std::string>({"b", "a"}), log.order);
+}
+
+TEST(NativeExecutor, rejects_unknown_ref_and_cycles) {
+  auto executor = MakeExecutor(0);
+  RunLog log;
+  auto a = std::make_shared<FakeExecutable>(executor, "a", &log);
+  auto b = std::make_shared<FakeExecutable>(executor, "b", &log);
+  auto c = std::make_shared<FakeExecutable>(executor, "c", &log);
+  EXPECT_FALSE(b->Submit(a));
+  ASSERT_TRUE(a->Submit(a));
+  ASSERT_TRUE(b->Submit(a));
+  ASSERT_TRUE(c->Submit(b));
+  // a -> b -> c, so a can not run after c
+  EXPECT_FALSE(a->Submit(c));
+  EXPECT_TRUE(executor->Trigger());
+  EXPECT_EQ(std::vector<std::string>({"a", "b", "c"}), log.order);
+}
+
+TEST(NativeExecutor, failure_skips_dependents) {
+  auto executor = MakeExecutor(0);
+  RunLog log;
+  auto a = std::make_shared<FakeExecutable>(
+      executor, "a", &log, std::chrono::milliseconds(0), false);
+  auto b = std::make_shared<FakeExecutable>(executor, "b", &log);
+  auto c = std::make_shared<FakeExecutable>(executor, "c", &log);
+  ASSERT_TRUE(a->Submit(a));
+  ASSERT_TRUE(b->Submit(a));
+  ASSERT_TRUE(c->Submit(c));
+
+  int failures = 0;
+  executor->SetTaskCallback(
+      [&failures](const std::shared_ptr<IExecutable>& executable,
+                  bool success) {
+        (void)executable;
+        failures += success ? 0 : 1;
+      });
+  EXPECT_FALSE(executor->Trigger());
+  EXPECT_EQ(std::vector<std::string>({"a", "c"}), log.order);
+  EXPECT_EQ(2, failures);
+}
+
+TEST(NativeExecutor, devices_run_concurrently) {
+  auto executor0 = MakeExecutor(0);
+  auto executor1 = MakeExecutor(1);
+  RunLog log;
+  const std::chrono::milliseconds duration(100);
+  auto root = std::make_shared<FakeExecutable>(executor0, "root", &log);
+  auto a = std::make_shared<FakeExecutable>(executor0, "a", &log, duration);
+  auto b = std::make_shared<FakeExecutable>(executor1, "b", &log, duration);
+  ASSERT_TRUE(executor0->Submit(root, root));
+  ASSERT_TRUE(executor0->Submit(a, root));
+  ASSERT_TRUE(executor0->Submit(b, root));
+
+  EXPECT_TRUE(executor0->Trigger(true));
+  EXPECT_TRUE(executor0->Wait());
+  ASSERT_EQ(3u, log.order.size());
+  EXPECT_EQ("root", log.order[0]);
+  EXPECT_LT(log.start["a"], log.end["b"]);
+  EXPECT_LT(log.start["b"], log.end["a"]);
+}
+
+TEST(NativeExecutor, callback_drops_last_reference) {
+  auto executor = MakeExecutor(0);
+  std::weak_ptr<NativeExecutor> weak = executor;
+  RunLog log;
+  auto a = std::make_shared<FakeExecutable>(executor, "a", &log);
+  ASSERT_TRUE(a->Submit(a));
+
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool triggered = false;
+  executor->SetTaskCallback(
+      [&](const std::shared_ptr<IExecutable>& executable, bool success) {
+        (void)executable;
+        EXPECT_TRUE(success);
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait(lock, [&triggered]() { return triggered; });
+        // The run still holds `a`, which holds the executor, so the
+        // executor is destroyed on the run's thread once it returns
+        executor.reset();
+        a.reset();
+      });
+  EXPECT_TRUE(executor->Trigger(true));
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    triggered = true;
+  }
+  cv.notify_all();
+
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (!weak.expired() && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_TRUE(weak.expired());
+  EXPECT_EQ(std::vector<std::string>({"a"}), log.order);
+}
+
+TEST(NativeExecutable, chained_handles_share_buffer) {
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  ASSERT_FALSE(devices.empty());
+  auto executor = std::make_shared<NativeExecutor>(devices[0]);
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {4},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {4},
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto compile_neg = [&]() {
+    auto graph = executor->Contex()->CreateGraph();
+    auto input = graph->CreateTensor(input_spec);
+    auto output = graph->CreateTensor(output_spec);
+    (*graph->CreateOperation<tim::vx::ops::Neg>())
+        .BindInput(input)
+        .BindOutput(output);
+    return executor->Compile(graph);
+  };
+
+  auto first = compile_neg();
+  auto second = compile_neg();
+  auto input = first->AllocateTensor(input_spec);
+  auto middle = first->AllocateTensor(output_spec);
+  auto output = second->AllocateTensor(output_spec);
+  first->SetInput(input);
+  first->SetOutput(middle);
+  second->SetInput(middle);
+  second->SetOutput(output);
+
+  std::vector<float> data = {1, -2, 3, -4};
+  ASSERT_TRUE(input->CopyDataToTensor(data.data(), data.size() * 4));
+  ASSERT_TRUE(first->Submit(first));
+  ASSERT_TRUE(second->Submit(first));
+  ASSERT_TRUE(executor->Trigger());
+
+  std::vector<float> result(4);
+  ASSERT_TRUE(output->CopyDataFromTensor(result.data()));
+  EXPECT_EQ(data, result);
+  EXPECT_EQ(0u, std::dynamic_pointer_cast<tim::vx::platform::NativeExecutable>(
+                    second)->HostBytesCopied());
+}
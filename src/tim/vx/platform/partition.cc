@@ -0,0 +1,629 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/platform/partition.h"
+
+#include <algorithm>
+#include <map>
+#include <set>
+
+#include "native_device_private.h"
+#include "op_impl.h"
+
+namespace tim {
+namespace vx {
+namespace platform {
+
+constexpr size_t CostGraph::kNoProducer;
+
+double PartitionPlan::BottleneckUs() const {
+  double bottleneck = 0;
+  for (double cost : stage_cost_us) {
+    bottleneck = std::max(bottleneck, cost);
+  }
+  return bottleneck;
+}
+
+double PartitionPlan::PredictedSpeedup() const {
+  double bottleneck = BottleneckUs();
+  return bottleneck > 0 ? total_cost_us / bottleneck : 1.0;
+}
+
+namespace {
+
+struct Choice {
+  double bottleneck{std::numeric_limits<double>::infinity()};
+  uint64_t cut_bytes{0};
+  double stage_cost{0};
+  size_t start{0};
+};
+
+/* Slowest stage first, equal ones (up to rounding) by cut bytes */
+bool IsBetter(const Choice& a, const Choice& b) {
+  const double kTolerance = 1e-9;
+  if (a.bottleneck < b.bottleneck * (1 - kTolerance)) {
+    return true;
+  }
+  return a.bottleneck <= b.bottleneck * (1 + kTolerance) &&
+         a.cut_bytes < b.cut_bytes;
+}
+
+double DeviceSpeed(const PartitionPolicy& policy, size_t device) {
+  if (device < policy.device_speed.size() && policy.device_speed[device] > 0) {
+    return policy.device_speed[device];
+  }
+  return 1.0;
+}
+
+double TransferUs(const PartitionPolicy& policy, uint64_t bytes) {
+  return policy.transfer_bytes_per_us > 0
+             ? bytes / policy.transfer_bytes_per_us
+             : 0.0;
+}
+
+}  // namespace
+
+PartitionPlan PlanPartition(const CostGraph& graph, size_t devices,
+                            const PartitionPolicy& policy) {
+  PartitionPlan plan;
+  size_t count = graph.ops.size();
+  size_t max_stages = std::min(devices, count);
+  std::vector<double> prefix(count + 1, 0);
+  for (size_t i = 0; i < count; i++) {
+    prefix[i + 1] = prefix[i] + graph.ops[i].cost_us;
+  }
+  plan.total_cost_us = prefix[count] / DeviceSpeed(policy, 0);
+  if (max_stages == 0) {
+    return plan;
+  }
+
+  // best[j][i] splits ops [0, i) into j + 1 stages, stage [p, i) reads the
+  // tensors produced before p from the earlier stages
+  std::vector<std::vector<Choice>> best(max_stages,
+                                        std::vector<Choice>(count + 1));
+  std::vector<size_t> counted(graph.tensors.size(), CostGraph::kNoProducer);
+  for (size_t p = 0; p < count; p++) {
+    uint64_t in_bytes = 0;
+    for (size_t i = p + 1; i <= count; i++) {
+      for (size_t t : graph.ops[i - 1].inputs) {
+        const auto& edge = graph.tensors[t];
+        if (edge.producer != CostGraph::kNoProducer && edge.producer < p &&
+            counted[t] != p) {
+          counted[t] = p;
+          in_bytes += edge.bytes;
+        }
+      }
+      double compute = prefix[i] - prefix[p];
+      for (size_t j = 0; j < max_stages; j++) {
+        Choice choice;
+        choice.stage_cost =
+            compute / DeviceSpeed(policy, j) + TransferUs(policy, in_bytes);
+        choice.start = p;
+        if (j == 0) {
+          if (p != 0) {
+            continue;
+          }
+          choice.bottleneck = choice.stage_cost;
+        } else {
+          const Choice& prev = best[j - 1][p];
+          if (prev.bottleneck == std::numeric_limits<double>::infinity()) {
+            continue;
+          }
+          choice.bottleneck = std::max(prev.bottleneck, choice.stage_cost);
+          choice.cut_bytes = prev.cut_bytes + in_bytes;
+        }
+        if (IsBetter(choice, best[j][i])) {
+          best[j][i] = choice;
+        }
+      }
+    }
+  }
+
+  size_t stages = 0;
+  for (size_t j = 1; j < max_stages; j++) {
+    if (IsBetter(best[j][count], best[stages][count])) {
+      stages = j;
+    }
+  }
+  plan.cut_bytes = best[stages][count].cut_bytes;
+  plan.op_stage.resize(count);
+  plan.stage_cost_us.resize(stages + 1);
+  for (size_t i = count, j = stages + 1; j-- > 0;) {
+    const Choice& choice = best[j][i];
+    plan.stage_cost_us[j] = choice.stage_cost;
+    std::fill(plan.op_stage.begin() + choice.start, plan.op_stage.begin() + i,
+              static_cast<uint32_t>(j));
+    i = choice.start;
+  }
+  return plan;
+}
+
+namespace {
+
+/* Ops of a graph in topological order and the tensors they exchange */
+struct GraphView {
+  std::vector<std::shared_ptr<Operation>> order;
+  std::vector<std::shared_ptr<Tensor>> tensors;
+  std::map<const Tensor*, size_t> index;
+  /// Spec of each exchanged tensor with its inferred shape, the tensors of
+  /// the viewed graph are never modified
+  std::vector<TensorSpec> specs;
+};
+
+bool IsExchanged(const std::shared_ptr<Tensor>& tensor) {
+  return !tensor->IsPlaceHolder() && !tensor->IsConstTensor();
+}
+
+const TensorSpec& SpecOf(const GraphView& view,
+                         const std::shared_ptr<Tensor>& tensor) {
+  auto it = view.index.find(tensor.get());
+  return it != view.index.end() ? view.specs[it->second] : tensor->GetSpec();
+}
+
+std::shared_ptr<Tensor> CloneConstant(const std::shared_ptr<Tensor>& tensor,
+                                      const std::shared_ptr<Graph>& graph) {
+  auto data = std::shared_ptr<char>(
+      new char[tensor->GetSpec().GetByteSize()], std::default_delete<char[]>());
+  if (!tensor->CopyDataFromTensor(data.get())) {
+    return nullptr;
+  }
+  dynamic_cast<GraphImpl*>(graph.get())->RetainBuffer(data);
+  return graph->CreateTensor(tensor->GetSpec(), data.get());
+}
+
+/* Ready ops are taken in creation order, which keeps the branches users
+ * build one after the other in one piece */
+bool ViewGraph(const std::shared_ptr<Graph>& graph, GraphView* view) {
+  auto graph_impl = dynamic_cast<GraphImpl*>(graph.get());
+  if (!graph_impl) {
+    return false;
+  }
+  const auto& ops = graph_impl->OpVector();
+  std::map<const Tensor*, size_t> producer;
+  for (size_t i = 0; i < ops.size(); i++) {
+    for (const auto& tensor : ops[i]->impl()->OutputsTensor()) {
+      producer[tensor.get()] = i;
+    }
+  }
+  std::vector<size_t> deps(ops.size(), 0);
+  std::vector<std::vector<size_t>> next(ops.size());
+  for (size_t i = 0; i < ops.size(); i++) {
+    std::set<size_t> producers;
+    for (const auto& tensor : ops[i]->impl()->InputsTensor()) {
+      auto it = producer.find(tensor.get());
+      if (it != producer.end() && producers.insert(it->second).second) {
+        next[it->second].push_back(i);
+        deps[i]++;
+      }
+    }
+  }
+  std::set<size_t> ready;
+  for (size_t i = 0; i < ops.size(); i++) {
+    if (deps[i] == 0) {
+      ready.insert(i);
+    }
+  }
+  while (!ready.empty()) {
+    size_t i = *ready.begin();
+    ready.erase(ready.begin());
+    view->order.push_back(ops[i]);
+    for (size_t n : next[i]) {
+      if (--deps[n] == 0) {
+        ready.insert(n);
+      }
+    }
+  }
+  if (view->order.size() != ops.size()) {
+    VSILOGE("Graph has a cycle, unable to partition");
+    return false;
+  }
+  for (const auto& op : view->order) {
+    for (const auto* tensors :
+         {&op->impl()->inputs_tensor_, &op->impl()->outputs_tensor_}) {
+      for (const auto& tensor : *tensors) {
+        if (IsExchanged(tensor) && !view->index.count(tensor.get())) {
+          view->index[tensor.get()] = view->tensors.size();
+          view->tensors.push_back(tensor);
+          view->specs.push_back(tensor->GetSpec());
+        }
+      }
+    }
+  }
+  return true;
+}
+
+/* Transient tensors may leave their shape to be inferred by the graph. The
+ * viewed ops are cloned into a private graph which is compiled instead, so
+ * the caller's graph keeps its ops and shapes. */
+bool ResolveShapes(const std::shared_ptr<Graph>& graph, GraphView* view) {
+  bool inferred = false;
+  for (const auto& spec : view->specs) {
+    inferred = inferred || spec.shape_.empty();
+  }
+  if (!inferred) {
+    return true;
+  }
+  // Every cloned tensor has to survive compilation to be read back
+  CompileOption options;
+  options.setDeadNodeElimination(false);
+  options.setCommonSubexpressionElimination(false);
+  auto probe =
+      dynamic_cast<GraphImpl*>(graph.get())->GetContext()->CreateGraph(options);
+  std::map<const Tensor*, std::shared_ptr<Tensor>> mapped;
+  for (const auto& op : view->order) {
+    std::vector<std::shared_ptr<Tensor>> inputs;
+    for (const auto& tensor : op->impl()->InputsTensor()) {
+      auto& input = mapped[tensor.get()];
+      if (!input) {
+        if (tensor->IsPlaceHolder()) {
+          input = probe->CreateTensorPlaceHolder();
+        } else if (tensor->IsConstTensor()) {
+          input = CloneConstant(tensor, probe);
+        } else {
+          input = probe->CreateTensor(tensor->GetSpec());
+        }
+      }
+      if (!input) {
+        return false;
+      }
+      inputs.push_back(input);
+    }
+    std::vector<std::shared_ptr<Tensor>> outputs;
+    for (const auto& tensor : op->impl()->OutputsTensor()) {
+      auto output = probe->CreateTensor(tensor->GetSpec());
+      mapped[tensor.get()] = output;
+      outputs.push_back(output);
+    }
+    auto clone = op->Clone(probe);
+    for (const auto& input : inputs) {
+      clone->BindInput(input);
+    }
+    clone->BindOutputs(outputs);
+  }
+  if (!probe->Compile()) {
+    return false;
+  }
+
+  auto probe_impl = dynamic_cast<GraphImpl*>(probe.get());
+  for (size_t t = 0; t < view->specs.size(); t++) {
+    if (!view->specs[t].shape_.empty()) {
+      continue;
+    }
+    vsi_nn_tensor_t* vsi_tensor =
+        vsi_nn_GetTensor(probe_impl->graph(),
+                         mapped.at(view->tensors[t].get())->GetId());
+    if (!vsi_tensor) {
+      return false;
+    }
+    ShapeType shape(vsi_tensor->attr.size,
+                    vsi_tensor->attr.size + vsi_tensor->attr.dim_num);
+    view->specs[t].SetShape(shape);
+  }
+  return true;
+}
+
+/* Multiply-accumulates of ops with weights, one op per output element for
+ * everything else */
+double EstimateMacs(const GraphView& view,
+                    const std::shared_ptr<Operation>& op) {
+  const auto& impl = op->impl();
+  double out_elements = 0;
+  for (const auto& tensor : impl->outputs_tensor_) {
+    out_elements += SpecOf(view, tensor).GetElementNum();
+  }
+  switch (impl->kind_) {
+    case VSI_NN_OP_CONV1D:
+    case VSI_NN_OP_CONV2D:
+    case VSI_NN_OP_CONV3D:
+    case VSI_NN_OP_GROUPED_CONV2D:
+    case VSI_NN_OP_DECONVOLUTION:
+    case VSI_NN_OP_FCL2: {
+      // Weights keep the output channels in the last dimension
+      if (impl->inputs_tensor_.size() > 1) {
+        const auto& shape = impl->inputs_tensor_[1]->GetShape();
+        if (!shape.empty() && shape.back() > 0) {
+          return out_elements *
+                 (impl->inputs_tensor_[1]->GetSpec().GetElementNum() /
+                  shape.back());
+        }
+      }
+      break;
+    }
+    case VSI_NN_OP_MATRIXMUL: {
+      if (!impl->inputs_tensor_.empty()) {
+        const auto& shape = SpecOf(view, impl->inputs_tensor_[0]).shape_;
+        if (!shape.empty()) {
+          return out_elements * shape[0];
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  return out_elements;
+}
+
+CostGraph BuildCostGraph(const GraphView& view,
+                         const PartitionPolicy& policy) {
+  CostGraph costs;
+  costs.tensors.resize(view.tensors.size());
+  for (size_t t = 0; t < view.tensors.size(); t++) {
+    costs.tensors[t].bytes = view.specs[t].GetByteSize();
+  }
+  costs.ops.resize(view.order.size());
+  for (size_t i = 0; i < view.order.size(); i++) {
+    const auto& op = view.order[i];
+    uint64_t bytes = 0;
+    for (const auto& tensor : op->impl()->inputs_tensor_) {
+      if (tensor->IsPlaceHolder()) {
+        continue;
+      }
+      bytes += SpecOf(view, tensor).GetByteSize();
+      if (IsExchanged(tensor)) {
+        costs.ops[i].inputs.push_back(view.index.at(tensor.get()));
+      }
+    }
+    for (const auto& tensor : op->impl()->outputs_tensor_) {
+      bytes += SpecOf(view, tensor).GetByteSize();
+      costs.tensors[view.index.at(tensor.get())].producer = i;
+    }
+    double cost = EstimateMacs(view, op) / policy.macs_per_us +
+                  bytes / policy.bytes_per_us;
+    if (policy.calibrate) {
+      cost = policy.calibrate(op, cost);
+    }
+    costs.ops[i].cost_us = cost;
+  }
+  return costs;
+}
+
+}  // namespace
+
+CostGraph BuildCostGraph(const std::shared_ptr<Graph>& graph,
+                         const PartitionPolicy& policy,
+                         std::vector<std::shared_ptr<Operation>>* order) {
+  GraphView view;
+  if (!ViewGraph(graph, &view) || !ResolveShapes(graph, &view)) {
+    return CostGraph();
+  }
+  if (order) {
+    *order = view.order;
+  }
+  return BuildCostGraph(view, policy);
+}
+
+namespace {
+
+/* Subgraph of one stage, cut tensors become its inputs and outputs */
+struct StageGraph {
+  std::shared_ptr<Graph> graph;
+  /// Tensors of the original graph bound to the subgraph inputs / outputs
+  std::vector<const Tensor*> inputs;
+  std::vector<const Tensor*> outputs;
+  std::set<size_t> deps;
+};
+
+bool BuildStage(const GraphView& view, const PartitionPlan& plan,
+                uint32_t stage, const std::vector<uint32_t>& tensor_stage,
+                const std::vector<uint32_t>& last_use, StageGraph* sub) {
+  std::map<const Tensor*, std::shared_ptr<Tensor>> mapped;
+  for (size_t i = 0; i < view.order.size(); i++) {
+    if (plan.op_stage[i] != stage) {
+      continue;
+    }
+    const auto& op = view.order[i];
+    std::vector<std::shared_ptr<Tensor>> inputs;
+    for (const auto& tensor : op->impl()->InputsTensor()) {
+      auto it = mapped.find(tensor.get());
+      if (it != mapped.end()) {
+        inputs.push_back(it->second);
+        continue;
+      }
+      std::shared_ptr<Tensor> input;
+      if (tensor->IsPlaceHolder()) {
+        input = sub->graph->CreateTensorPlaceHolder();
+      } else if (tensor->IsConstTensor()) {
+        input = CloneConstant(tensor, sub->graph);
+      } else {
+        TensorSpec spec = SpecOf(view, tensor);
+        spec.SetAttribute(TensorAttribute::INPUT);
+        input = sub->graph->CreateTensor(spec);
+        sub->inputs.push_back(tensor.get());
+        uint32_t producer = tensor_stage[view.index.at(tensor.get())];
+        if (producer < stage) {
+          sub->deps.insert(producer);
+        }
+      }
+      if (!input) {
+        return false;
+      }
+      mapped[tensor.get()] = input;
+      inputs.push_back(input);
+    }
+    std::vector<std::shared_ptr<Tensor>> outputs;
+    for (const auto& tensor : op->impl()->OutputsTensor()) {
+      TensorSpec spec = SpecOf(view, tensor);
+      if ((spec.attr_ & TensorAttribute::OUTPUT) ||
+          last_use[view.index.at(tensor.get())] > stage) {
+        spec.SetAttribute(TensorAttribute::OUTPUT);
+        sub->outputs.push_back(tensor.get());
+      }
+      auto output = sub->graph->CreateTensor(spec);
+      mapped[tensor.get()] = output;
+      outputs.push_back(output);
+    }
+    auto cloned = op->Clone(sub->graph);
+    for (const auto& input : inputs) {
+      cloned->BindInput(input);
+    }
+    cloned->BindOutputs(outputs);
+  }
+  return true;
+}
+
+}  // namespace
+
+std::shared_ptr<PartitionedGraph> Partition(
+    const std::shared_ptr<Graph>& graph,
+    const std::vector<std::shared_ptr<IDevice>>& devices,
+    const PartitionPolicy& policy) {
+  GraphView view;
+  if (!graph || devices.empty() || !ViewGraph(graph, &view) ||
+      view.order.empty() || !ResolveShapes(graph, &view)) {
+    return nullptr;
+  }
+  std::shared_ptr<PartitionedGraph> partitioned(new PartitionedGraph());
+  auto& plan = partitioned->plan_;
+  plan = PlanPartition(BuildCostGraph(view, policy), devices.size(), policy);
+  size_t stages = plan.StageCount();
+
+  // Stage producing each tensor, none for graph inputs, and the last stage
+  // reading it
+  std::vector<uint32_t> tensor_stage(view.tensors.size(),
+                                     std::numeric_limits<uint32_t>::max());
+  std::vector<uint32_t> last_use(view.tensors.size(), 0);
+  for (size_t i = 0; i < view.order.size(); i++) {
+    for (const auto& tensor : view.order[i]->impl()->OutputsTensor()) {
+      tensor_stage[view.index.at(tensor.get())] = plan.op_stage[i];
+    }
+    for (const auto& tensor : view.order[i]->impl()->InputsTensor()) {
+      if (IsExchanged(tensor)) {
+        auto& last = last_use[view.index.at(tensor.get())];
+        last = std::max(last, plan.op_stage[i]);
+      }
+    }
+  }
+
+  size_t slots = policy.pipelined ? stages : 1;
+  std::vector<StageGraph> subs(stages);
+  partitioned->stages_.resize(stages);
+  for (size_t s = 0; s < stages; s++) {
+    auto executor = std::make_shared<NativeExecutor>(devices[s]);
+    partitioned->executors_.push_back(executor);
+    subs[s].graph = executor->Contex()->CreateGraph();
+    if (!BuildStage(view, plan, static_cast<uint32_t>(s), tensor_stage,
+                    last_use, &subs[s])) {
+      VSILOGE("Failed to build stage %zu", s);
+      return nullptr;
+    }
+    auto nb_buf = executor->CompileToBinary(subs[s].graph);
+    if (!nb_buf) {
+      VSILOGE("Failed to compile stage %zu", s);
+      return nullptr;
+    }
+    for (size_t slot = 0; slot < slots; slot++) {
+      partitioned->stages_[s].push_back(std::make_shared<NativeExecutable>(
+          executor, nb_buf, subs[s].inputs.size(), subs[s].outputs.size()));
+    }
+    partitioned->stage_graphs_.push_back(subs[s].graph);
+    partitioned->stage_deps_.emplace_back(subs[s].deps.begin(),
+                                          subs[s].deps.end());
+  }
+
+  // The first stage reading a graph input and the stage producing a cut
+  // tensor own its handle, the others bind it and share its buffer
+  for (size_t slot = 0; slot < slots; slot++) {
+    std::map<const Tensor*, std::shared_ptr<ITensorHandle>> handles;
+    for (size_t s = 0; s < stages; s++) {
+      auto& executable = partitioned->stages_[s][slot];
+      auto sub_inputs = subs[s].graph->InputsTensor();
+      for (size_t i = 0; i < subs[s].inputs.size(); i++) {
+        auto& handle = handles[subs[s].inputs[i]];
+        if (!handle) {
+          handle = executable->AllocateTensor(sub_inputs[i]->GetSpec());
+        }
+        executable->SetInput(handle);
+      }
+      auto sub_outputs = subs[s].graph->OutputsTensor();
+      for (size_t i = 0; i < subs[s].outputs.size(); i++) {
+        auto handle = executable->AllocateTensor(sub_outputs[i]->GetSpec());
+        handles[subs[s].outputs[i]] = handle;
+        executable->SetOutput(handle);
+      }
+    }
+    std::vector<std::shared_ptr<ITensorHandle>> inputs, outputs;
+    for (const auto& tensor : graph->InputsTensor()) {
+      inputs.push_back(handles[tensor.get()]);
+    }
+    for (const auto& tensor : graph->OutputsTensor()) {
+      outputs.push_back(handles[tensor.get()]);
+    }
+    partitioned->inputs_.push_back(inputs);
+    partitioned->outputs_.push_back(outputs);
+  }
+  return partitioned;
+}
+
+bool PartitionedGraph::Run() {
+  auto& scheduler = executors_[0];
+  for (size_t s = 0; s < stages_.size(); s++) {
+    const auto& executable = stages_[s][0];
+    scheduler->Submit(executable, executable);
+    for (size_t dep : stage_deps_[s]) {
+      scheduler->Submit(executable, stages_[dep][0]);
+    }
+  }
+  return scheduler->Trigger();
+}
+
+bool PartitionedGraph::RunPipelined(size_t frames, const FrameCallback& feed,
+                                    const FrameCallback& fetch) {
+  size_t stages = stages_.size();
+  if (Slots() < stages) {
+    for (size_t frame = 0; frame < frames; frame++) {
+      if (!feed(frame, inputs_[0]) || !Run() || !fetch(frame, outputs_[0])) {
+        return false;
+      }
+    }
+    return true;
+  }
+  // Frame n lives in slot n % stages, so a stage never writes a buffer a
+  // later stage has yet to read
+  auto& scheduler = executors_[0];
+  for (size_t tick = 0; tick + 1 < frames + stages; tick++) {
+    if (tick < frames && !feed(tick, inputs_[tick % stages])) {
+      return false;
+    }
+    for (size_t s = 0; s < stages; s++) {
+      if (tick >= s && tick - s < frames) {
+        const auto& executable = stages_[s][(tick - s) % stages];
+        scheduler->Submit(executable, executable);
+      }
+    }
+    if (!scheduler->Trigger()) {
+      return false;
+    }
+    if (tick + 1 >= stages) {
+      size_t frame = tick + 1 - stages;
+      if (!fetch(frame, outputs_[frame % stages])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace platform
+}  // namespace vx
+}  // namespace tim
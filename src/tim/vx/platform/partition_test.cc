@@ -0,0 +1,243 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/platform/partition.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/simple_operations.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+namespace {
+
+using tim::vx::platform::CostGraph;
+using tim::vx::platform::PartitionPlan;
+using tim::vx::platform::PartitionPolicy;
+using tim::vx::platform::PlanPartition;
+
+/* ops[i] reads inputs[i], tensor t is produced by producers[t] */
+CostGraph MakeCostGraph(const std::vector<double>& costs,
+                        const std::vector<std::vector<size_t>>& inputs,
+                        const std::vector<size_t>& producers,
+                        const std::vector<uint64_t>& bytes) {
+  CostGraph graph;
+  for (size_t i = 0; i < costs.size(); i++) {
+    CostGraph::Node node;
+    node.cost_us = costs[i];
+    node.inputs = inputs[i];
+    graph.ops.push_back(node);
+  }
+  for (size_t t = 0; t < producers.size(); t++) {
+    CostGraph::Edge edge;
+    edge.producer = producers[t];
+    edge.bytes = bytes[t];
+    graph.tensors.push_back(edge);
+  }
+  return graph;
+}
+
+/* A chain of ops, op i + 1 reads the output of op i */
+CostGraph MakeChain(const std::vector<double>& costs, uint64_t bytes) {
+  std::vector<std::vector<size_t>> inputs(costs.size());
+  std::vector<size_t> producers;
+  for (size_t i = 1; i < costs.size(); i++) {
+    inputs[i] = {i - 1};
+    producers.push_back(i - 1);
+  }
+  return MakeCostGraph(costs, inputs, producers,
+                       std::vector<uint64_t>(producers.size(), bytes));
+}
+
+PartitionPolicy FreeTransfers() {
+  PartitionPolicy policy;
+  policy.transfer_bytes_per_us = 0;
+  return policy;
+}
+
+}  // namespace
+
+TEST(PlanPartition, balances_chain) {
+  auto plan = PlanPartition(MakeChain(std::vector<double>(8, 1.0), 16), 4,
+                            FreeTransfers());
+  ASSERT_EQ(4u, plan.StageCount());
+  EXPECT_EQ(std::vector<uint32_t>({0, 0, 1, 1, 2, 2, 3, 3}), plan.op_stage);
+  EXPECT_DOUBLE_EQ(2.0, plan.BottleneckUs());
+  EXPECT_DOUBLE_EQ(4.0, plan.PredictedSpeedup());
+  EXPECT_EQ(48u, plan.cut_bytes);
+}
+
+TEST(PlanPartition, prefers_smaller_cut) {
+  // Both splits take 1us per stage, the second one moves fewer bytes
+  auto graph = MakeCostGraph({1, 0, 1}, {{}, {0}, {1}}, {0, 1}, {100, 10});
+  auto plan = PlanPartition(graph, 2, FreeTransfers());
+  EXPECT_EQ(std::vector<uint32_t>({0, 0, 1}), plan.op_stage);
+  EXPECT_EQ(10u, plan.cut_bytes);
+}
+
+TEST(PlanPartition, counts_skip_connections) {
+  // op 3 reads the output of op 0 and op 2
+  auto graph = MakeCostGraph({1, 1, 1, 1}, {{}, {0}, {1}, {2, 0}},
+                             {0, 1, 2}, {7, 11, 13});
+  auto plan = PlanPartition(graph, 2, FreeTransfers());
+  EXPECT_EQ(std::vector<uint32_t>({0, 0, 1, 1}), plan.op_stage);
+  EXPECT_EQ(18u, plan.cut_bytes);
+}
+
+TEST(PlanPartition, keeps_one_stage_if_transfer_dominates) {
+  PartitionPolicy policy;
+  policy.transfer_bytes_per_us = 1000;
+  auto plan = PlanPartition(MakeChain({1, 1}, 1000000), 2, policy);
+  EXPECT_EQ(1u, plan.StageCount());
+  EXPECT_EQ(0u, plan.cut_bytes);
+  EXPECT_DOUBLE_EQ(1.0, plan.PredictedSpeedup());
+}
+
+TEST(PlanPartition, weights_device_speed) {
+  PartitionPolicy policy = FreeTransfers();
+  policy.device_speed = {2.0, 1.0};
+  auto plan = PlanPartition(MakeChain({1, 1, 1}, 4), 2, policy);
+  EXPECT_EQ(std::vector<uint32_t>({0, 0, 1}), plan.op_stage);
+  EXPECT_DOUBLE_EQ(1.0, plan.BottleneckUs());
+}
+
+TEST(PlanPartition, more_devices_than_ops) {
+  auto plan = PlanPartition(MakeChain({3, 5}, 4), 4, FreeTransfers());
+  EXPECT_EQ(2u, plan.StageCount());
+  EXPECT_DOUBLE_EQ(5.0, plan.BottleneckUs());
+  EXPECT_TRUE(PlanPartition(CostGraph(), 4).op_stage.empty());
+}
+
+TEST(Partition, matches_unpartitioned_graph) {
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  ASSERT_FALSE(devices.empty());
+  // Stand in for missing devices, the stages then share one
+  while (devices.size() < 2) {
+    devices.push_back(devices[0]);
+  }
+  auto context = tim::vx::Context::Create();
+  auto graph = context->CreateGraph();
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {4},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {4},
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {4},
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto tensor = graph->CreateTensor(input_spec);
+  for (int i = 0; i < 4; i++) {
+    auto next = graph->CreateTensor(i == 3 ? output_spec : transient_spec);
+    (*graph->CreateOperation<tim::vx::ops::Neg>())
+        .BindInput(tensor)
+        .BindOutput(next);
+    if (i == 1) {
+      // Also a graph output, read by the second stage as well
+      auto relu = graph->CreateTensor(output_spec);
+      (*graph->CreateOperation<tim::vx::ops::Relu>())
+          .BindInput(next)
+          .BindOutput(relu);
+    }
+    tensor = next;
+  }
+
+  PartitionPolicy policy = FreeTransfers();
+  auto partitioned = tim::vx::platform::Partition(graph, devices, policy);
+  ASSERT_TRUE(partitioned);
+  EXPECT_EQ(2u, partitioned->Plan().StageCount());
+  ASSERT_EQ(1u, partitioned->Inputs().size());
+  ASSERT_EQ(2u, partitioned->Outputs().size());
+
+  std::vector<float> data = {1, -2, 3, -4};
+  ASSERT_TRUE(partitioned->Inputs()[0]->CopyDataToTensor(data.data(),
+                                                          data.size() * 4));
+  ASSERT_TRUE(partitioned->Run());
+  std::vector<float> relu(4), result(4);
+  ASSERT_TRUE(partitioned->Outputs()[0]->CopyDataFromTensor(relu.data()));
+  ASSERT_TRUE(partitioned->Outputs()[1]->CopyDataFromTensor(result.data()));
+  EXPECT_EQ(std::vector<float>({1, 0, 3, 0}), relu);
+  EXPECT_EQ(data, result);
+
+  std::vector<std::vector<float>> fetched;
+  ASSERT_TRUE(partitioned->RunPipelined(
+      3,
+      [&](size_t frame,
+          const std::vector<std::shared_ptr<tim::vx::platform::ITensorHandle>>&
+              th) {
+        std::vector<float> frame_data(4, static_cast<float>(frame));
+        return th[0]->CopyDataToTensor(frame_data.data(), 16);
+      },
+      [&](size_t frame,
+          const std::vector<std::shared_ptr<tim::vx::platform::ITensorHandle>>&
+              th) {
+        std::vector<float> frame_result(4);
+        EXPECT_EQ(fetched.size(), frame);
+        fetched.push_back(frame_result);
+        return th[1]->CopyDataFromTensor(fetched.back().data());
+      }));
+  ASSERT_EQ(3u, fetched.size());
+  for (size_t frame = 0; frame < 3; frame++) {
+    EXPECT_EQ(std::vector<float>(4, static_cast<float>(frame)),
+              fetched[frame]);
+  }
+}
+
+TEST(Partition, inferred_shapes_leave_graph_untouched) {
+  auto devices = tim::vx::platform::NativeDevice::Enumerate();
+  ASSERT_FALSE(devices.empty());
+  while (devices.size() < 2) {
+    devices.push_back(devices[0]);
+  }
+  auto context = tim::vx::Context::Create();
+  auto graph = context->CreateGraph();
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, {4},
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec transient_spec(tim::vx::DataType::FLOAT32, {},
+                                     tim::vx::TensorAttribute::TRANSIENT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, {4},
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto input = graph->CreateTensor(input_spec);
+  auto transient = graph->CreateTensor(transient_spec);
+  auto output = graph->CreateTensor(output_spec);
+  (*graph->CreateOperation<tim::vx::ops::Neg>())
+      .BindInput(input)
+      .BindOutput(transient);
+  (*graph->CreateOperation<tim::vx::ops::Neg>())
+      .BindInput(transient)
+      .BindOutput(output);
+
+  auto partitioned =
+      tim::vx::platform::Partition(graph, devices, FreeTransfers());
+  ASSERT_TRUE(partitioned);
+  // Shapes were inferred on a copy, the caller's graph is still uncompiled
+  EXPECT_TRUE(transient->GetShape().empty());
+
+  std::vector<float> data = {1, -2, 3, -4};
+  ASSERT_TRUE(partitioned->Inputs()[0]->CopyDataToTensor(data.data(),
+                                                          data.size() * 4));
+  ASSERT_TRUE(partitioned->Run());
+  std::vector<float> result(4);
+  ASSERT_TRUE(partitioned->Outputs()[0]->CopyDataFromTensor(result.data()));
+  EXPECT_EQ(data, result);
+
+  // Its ops are all still there to be compiled on their own
+  EXPECT_TRUE(graph->Compile());
+}
@@ -0,0 +1,327 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/shape_family.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/tensor.h"
+#include "vsi_nn_pub.h"
+
+namespace tim {
+namespace vx {
+
+namespace {
+size_t ElementNum(const ShapeType& shape) {
+  size_t num = 1;
+  for (auto dim : shape) num *= dim;
+  return num;
+}
+
+// Copy the leading corner common to both shapes, dimension 0 is innermost
+void CopyRegion(const char* src, const ShapeType& src_shape, char* dst,
+                const ShapeType& dst_shape, size_t element_size) {
+  size_t rank = src_shape.size();
+  if (0 == rank) {
+    memcpy(dst, src, element_size);
+    return;
+  }
+  ShapeType region(rank);
+  std::vector<size_t> src_strides(rank);
+  std::vector<size_t> dst_strides(rank);
+  size_t src_stride = element_size;
+  size_t dst_stride = element_size;
+  for (size_t d = 0; d < rank; ++d) {
+    region[d] = std::min(src_shape[d], dst_shape[d]);
+    if (0 == region[d]) return;
+    src_strides[d] = src_stride;
+    dst_strides[d] = dst_stride;
+    src_stride *= src_shape[d];
+    dst_stride *= dst_shape[d];
+  }
+
+  size_t row_bytes = region[0] * element_size;
+  std::vector<uint32_t> index(rank, 0);
+  while (true) {
+    size_t src_offset = 0;
+    size_t dst_offset = 0;
+    for (size_t d = 1; d < rank; ++d) {
+      src_offset += index[d] * src_strides[d];
+      dst_offset += index[d] * dst_strides[d];
+    }
+    memcpy(dst + dst_offset, src + src_offset, row_bytes);
+
+    size_t d = 1;
+    for (; d < rank; ++d) {
+      if (++index[d] < region[d]) break;
+      index[d] = 0;
+    }
+    if (d >= rank) break;
+  }
+}
+
+// Fill `buffer` with the encoding of the real value 0 for elements of `spec`
+void FillZero(std::vector<char>& buffer, const TensorSpec& spec) {
+  const auto& quant = spec.quantization_;
+  int32_t zero_point = 0;
+  if (QuantType::ASYMMETRIC == quant.Type() && !quant.ZeroPoints().empty()) {
+    zero_point = quant.ZeroPoints()[0];
+  }
+  size_t element_size = spec.GetElementByteSize();
+  if (0 == zero_point || element_size > sizeof(zero_point)) {
+    std::fill(buffer.begin(), buffer.end(), 0);
+    return;
+  }
+
+  char element[sizeof(zero_point)];
+  if (1 == element_size) {
+    int8_t value = static_cast<int8_t>(zero_point);
+    memcpy(element, &value, element_size);
+  } else if (2 == element_size) {
+    int16_t value = static_cast<int16_t>(zero_point);
+    memcpy(element, &value, element_size);
+  } else {
+    memcpy(element, &zero_point, element_size);
+  }
+  for (size_t offset = 0; offset + element_size <= buffer.size();
+       offset += element_size) {
+    memcpy(buffer.data() + offset, element, element_size);
+  }
+}
+}  // namespace
+
+void ShapeFamily::LatencySample::Add(std::chrono::microseconds latency,
+                                     uint32_t* seed) {
+  ++seen;
+  if (values.size() < ShapeFamilyStats::kLatencySamples) {
+    values.push_back(latency);
+    return;
+  }
+  *seed = *seed * 1664525u + 1013904223u;
+  uint64_t slot = *seed % seen;
+  if (slot < values.size()) values[slot] = latency;
+}
+
+std::chrono::microseconds ShapeFamily::LatencySample::Percentile(
+    uint32_t percent) const {
+  if (values.empty()) return std::chrono::microseconds(0);
+  auto sorted = values;
+  size_t rank = (sorted.size() - 1) * percent / 100;
+  std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+  return sorted[rank];
+}
+
+ShapeFamily::ShapeFamily(const Builder& builder,
+                         const ShapeFamilyOptions& options,
+                         const OutputShapeFunc& output_shape,
+                         const std::shared_ptr<Context>& context)
+    : builder_(builder),
+      options_(options),
+      output_shape_(output_shape),
+      context_(context ? context : Context::CreateShared()) {}
+
+ShapeFamily::Key ShapeFamily::BucketShapes(
+    const std::vector<Input>& inputs) const {
+  Key key;
+  for (const auto& input : inputs) {
+    ShapeType shape = input.shape;
+    for (size_t d = 0; d < shape.size(); ++d) {
+      uint32_t granularity = d < options_.bucket_granularity.size()
+                                 ? options_.bucket_granularity[d]
+                                 : 0;
+      if (granularity > 1) {
+        shape[d] = (shape[d] + granularity - 1) / granularity * granularity;
+      }
+    }
+    key.push_back(shape);
+  }
+  return key;
+}
+
+std::shared_ptr<ShapeFamily::Specialization> ShapeFamily::Lookup(
+    const Key& key, bool* hit) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (index_.end() != it) {
+    lru_.splice(lru_.begin(), lru_, it->second);
+    auto specialization = it->second->specialization;
+    // Another caller is building this shape, wait for it instead of building
+    // the same graph twice
+    built_.wait(lock, [&] { return !specialization->building; });
+    *hit = true;
+    return specialization->graph ? specialization : nullptr;
+  }
+
+  *hit = false;
+  auto specialization = std::make_shared<Specialization>();
+  lru_.push_front(Entry{key, specialization});
+  index_[key] = lru_.begin();
+  while (lru_.size() > std::max<size_t>(options_.capacity, 1)) {
+    index_.erase(lru_.back().key);
+    lru_.pop_back();
+    ++stats_.evictions;
+  }
+  lock.unlock();
+
+  auto graph = builder_(context_, key);
+  bool built = graph && graph->Compile();
+  if (!built) VSILOGE("Failed to build graph for new input shapes");
+
+  lock.lock();
+  specialization->graph = built ? graph : nullptr;
+  specialization->building = false;
+  it = index_.find(key);
+  if (!built && index_.end() != it &&
+      it->second->specialization == specialization) {
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  built_.notify_all();
+  return built ? specialization : nullptr;
+}
+
+bool ShapeFamily::Run(const std::vector<Input>& inputs,
+                      std::vector<Output>& outputs) {
+  auto start = std::chrono::steady_clock::now();
+  Key key = BucketShapes(inputs);
+  bool hit = false;
+  auto specialization = Lookup(key, &hit);
+  if (!specialization) return false;
+
+  {
+    std::lock_guard<std::mutex> run_lock(specialization->run_mutex);
+    if (!RunSpecialization(specialization->graph.get(), key, inputs,
+                           outputs)) {
+      return false;
+    }
+  }
+
+  Record(hit, std::chrono::duration_cast<std::chrono::microseconds>(
+                  std::chrono::steady_clock::now() - start));
+  return true;
+}
+
+bool ShapeFamily::RunSpecialization(Graph* graph, const Key& key,
+                                    const std::vector<Input>& inputs,
+                                    std::vector<Output>& outputs) {
+  auto graph_inputs = graph->InputsTensor();
+  if (graph_inputs.size() != inputs.size()) {
+    VSILOGE("Graph has %zu inputs, %zu given", graph_inputs.size(),
+            inputs.size());
+    return false;
+  }
+  std::vector<char> buffer;
+  std::vector<ShapeType> input_shapes;
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    const auto& spec = graph_inputs[i]->GetSpec();
+    if (spec.shape_ != key[i]) {
+      VSILOGE("Input %zu of the built graph does not have the requested shape",
+              i);
+      return false;
+    }
+    input_shapes.push_back(inputs[i].shape);
+    bool copied = false;
+    if (inputs[i].shape == key[i]) {
+      copied = graph_inputs[i]->CopyDataToTensor(inputs[i].data,
+                                                 spec.GetByteSize());
+    } else {
+      buffer.resize(spec.GetByteSize());
+      FillZero(buffer, spec);
+      CopyRegion(static_cast<const char*>(inputs[i].data), inputs[i].shape,
+                 buffer.data(), key[i], spec.GetElementByteSize());
+      copied = graph_inputs[i]->CopyDataToTensor(buffer.data(), buffer.size());
+    }
+    if (!copied) return false;
+  }
+
+  if (!graph->Run()) return false;
+
+  auto graph_outputs = graph->OutputsTensor();
+  outputs.resize(graph_outputs.size());
+  for (size_t i = 0; i < graph_outputs.size(); ++i) {
+    const auto& spec = graph_outputs[i]->GetSpec();
+    ShapeType shape = spec.shape_;
+    if (output_shape_ && input_shapes != key) {
+      shape = output_shape_(i, input_shapes);
+      if (shape.size() != spec.shape_.size() ||
+          !std::equal(shape.begin(), shape.end(), spec.shape_.begin(),
+                      [](uint32_t a, uint32_t b) { return a <= b; })) {
+        VSILOGE("Output %zu can not be cropped to a larger shape", i);
+        return false;
+      }
+    }
+
+    outputs[i].shape = shape;
+    if (shape == spec.shape_) {
+      outputs[i].data.resize(spec.GetByteSize());
+      if (!graph_outputs[i]->CopyDataFromTensor(outputs[i].data.data())) {
+        return false;
+      }
+    } else {
+      buffer.resize(spec.GetByteSize());
+      if (!graph_outputs[i]->CopyDataFromTensor(buffer.data())) return false;
+      outputs[i].data.resize(ElementNum(shape) * spec.GetElementByteSize());
+      CopyRegion(buffer.data(), spec.shape_, outputs[i].data.data(), shape,
+                 spec.GetElementByteSize());
+    }
+  }
+  return true;
+}
+
+void ShapeFamily::Record(bool hit, std::chrono::microseconds latency) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (hit) {
+    ++stats_.hits;
+    stats_.hit_latency_total += latency;
+    stats_.hit_latency_max = std::max(stats_.hit_latency_max, latency);
+    hit_latency_.Add(latency, &sample_seed_);
+  } else {
+    ++stats_.misses;
+    stats_.miss_latency_total += latency;
+    stats_.miss_latency_max = std::max(stats_.miss_latency_max, latency);
+    miss_latency_.Add(latency, &sample_seed_);
+  }
+}
+
+ShapeFamilyStats ShapeFamily::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ShapeFamilyStats stats = stats_;
+  stats.hit_latency_p50 = hit_latency_.Percentile(50);
+  stats.hit_latency_p90 = hit_latency_.Percentile(90);
+  stats.hit_latency_p99 = hit_latency_.Percentile(99);
+  stats.miss_latency_p50 = miss_latency_.Percentile(50);
+  stats.miss_latency_p90 = miss_latency_.Percentile(90);
+  stats.miss_latency_p99 = miss_latency_.Percentile(99);
+  return stats;
+}
+
+size_t ShapeFamily::Size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return lru_.size();
+}
+
+}  // namespace vx
+}  // namespace tim
@@ -0,0 +1,178 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/shape_family.h"
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/ops/activations.h"
+#include "tim/vx/ops/reduce.h"
+
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+namespace {
+std::shared_ptr<tim::vx::Graph> BuildRelu(
+    const std::shared_ptr<tim::vx::Context>& ctx,
+    const std::vector<tim::vx::ShapeType>& shapes) {
+  auto graph = ctx->CreateGraph();
+  tim::vx::TensorSpec input_spec(tim::vx::DataType::FLOAT32, shapes[0],
+                                 tim::vx::TensorAttribute::INPUT);
+  tim::vx::TensorSpec output_spec(tim::vx::DataType::FLOAT32, shapes[0],
+                                  tim::vx::TensorAttribute::OUTPUT);
+  auto input = graph->CreateTensor(input_spec);
+  auto output = graph->CreateTensor(output_spec);
+  (*graph->CreateOperation<tim::vx::ops::Relu>())
+      .BindInput(input)
+      .BindOutput(output);
+  return graph;
+}
+
+std::vector<float> RunRelu(tim::vx::ShapeFamily& family,
+                           const tim::vx::ShapeType& shape,
+                           tim::vx::ShapeType* output_shape) {
+  size_t num = 1;
+  for (auto dim : shape) num *= dim;
+  std::vector<float> input(num);
+  for (size_t i = 0; i < num; ++i) {
+    input[i] = (i % 2 ? 1.0f : -1.0f) * float(i);
+  }
+  std::vector<tim::vx::ShapeFamily::Output> outputs;
+  EXPECT_TRUE(family.Run({{shape, input.data()}}, outputs));
+  EXPECT_EQ(1u, outputs.size());
+  *output_shape = outputs[0].shape;
+  std::vector<float> result(outputs[0].data.size() / sizeof(float));
+  memcpy(result.data(), outputs[0].data.data(), outputs[0].data.size());
+  return result;
+}
+}  // namespace
+
+TEST(ShapeFamily, lru_of_exact_shapes) {
+  tim::vx::ShapeFamilyOptions options;
+  options.capacity = 2;
+  tim::vx::ShapeFamily family(BuildRelu, options);
+
+  tim::vx::ShapeType output_shape;
+  RunRelu(family, {4, 2}, &output_shape);
+  EXPECT_EQ(tim::vx::ShapeType({4, 2}), output_shape);
+  RunRelu(family, {4, 2}, &output_shape);
+  RunRelu(family, {6, 2}, &output_shape);
+  RunRelu(family, {8, 2}, &output_shape);
+  // {4, 2} was evicted by {8, 2}
+  RunRelu(family, {4, 2}, &output_shape);
+
+  auto stats = family.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(4u, stats.misses);
+  EXPECT_EQ(2u, stats.evictions);
+  EXPECT_EQ(2u, family.Size());
+  EXPECT_LE(stats.miss_latency_p50, stats.miss_latency_p90);
+  EXPECT_LE(stats.miss_latency_p90, stats.miss_latency_p99);
+  EXPECT_LE(stats.miss_latency_p99, stats.miss_latency_max);
+  EXPECT_LE(stats.hit_latency_p99, stats.hit_latency_max);
+}
+
+TEST(ShapeFamily, bucketed_shapes_are_padded_and_cropped) {
+  tim::vx::ShapeFamilyOptions options;
+  options.bucket_granularity = {8, 0};
+  tim::vx::ShapeFamily family(
+      BuildRelu, options,
+      [](size_t, const std::vector<tim::vx::ShapeType>& shapes) {
+        return shapes[0];
+      });
+
+  tim::vx::ShapeType output_shape;
+  auto result = RunRelu(family, {3, 2}, &output_shape);
+  EXPECT_EQ(tim::vx::ShapeType({3, 2}), output_shape);
+  EXPECT_EQ(std::vector<float>({0, 1, 0, 3, 0, 5}), result);
+
+  result = RunRelu(family, {5, 1}, &output_shape);
+  EXPECT_EQ(tim::vx::ShapeType({5, 1}), output_shape);
+  EXPECT_EQ(std::vector<float>({0, 1, 0, 3, 0}), result);
+  // {3, 2} and {5, 1} round up to {8, 2} and {8, 1}
+  RunRelu(family, {7, 2}, &output_shape);
+
+  auto stats = family.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(2u, stats.misses);
+}
+
+TEST(ShapeFamily, concurrent_callers_build_a_shape_once) {
+  std::atomic<int> builds(0);
+  tim::vx::ShapeFamily family(
+      [&builds](const std::shared_ptr<tim::vx::Context>& ctx,
+                const std::vector<tim::vx::ShapeType>& shapes) {
+        ++builds;
+        return BuildRelu(ctx, shapes);
+      });
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([&family] {
+      tim::vx::ShapeType output_shape;
+      auto result = RunRelu(family, {4, 2}, &output_shape);
+      EXPECT_EQ(std::vector<float>({0, 1, 0, 3, 0, 5, 0, 7}), result);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  auto stats = family.GetStats();
+  EXPECT_EQ(1, builds.load());
+  EXPECT_EQ(1u, stats.misses);
+  EXPECT_EQ(3u, stats.hits);
+}
+
+TEST(ShapeFamily, quantized_inputs_are_padded_with_zero_point) {
+  tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 1.0f, 100);
+  tim::vx::ShapeFamilyOptions options;
+  options.bucket_granularity = {8};
+  tim::vx::ShapeFamily family(
+      [&quant](const std::shared_ptr<tim::vx::Context>& ctx,
+               const std::vector<tim::vx::ShapeType>& shapes) {
+        auto graph = ctx->CreateGraph();
+        tim::vx::TensorSpec input_spec(tim::vx::DataType::UINT8, shapes[0],
+                                       tim::vx::TensorAttribute::INPUT, quant);
+        tim::vx::TensorSpec output_spec(tim::vx::DataType::UINT8, {1},
+                                        tim::vx::TensorAttribute::OUTPUT,
+                                        quant);
+        auto input = graph->CreateTensor(input_spec);
+        auto output = graph->CreateTensor(output_spec);
+        (*graph->CreateOperation<tim::vx::ops::ReduceSum>(
+             std::vector<int32_t>({0}), true))
+            .BindInput(input)
+            .BindOutput(output);
+        return graph;
+      },
+      options);
+
+  // Real values 1..5, padded elements have to add real zeros to the sum
+  std::vector<uint8_t> input = {102, 101, 105, 103, 104};
+  std::vector<tim::vx::ShapeFamily::Output> outputs;
+  EXPECT_TRUE(family.Run({{{5}, input.data()}}, outputs));
+  ASSERT_EQ(1u, outputs.size());
+  ASSERT_EQ(1u, outputs[0].data.size());
+  EXPECT_EQ(115, static_cast<uint8_t>(outputs[0].data[0]));
+}
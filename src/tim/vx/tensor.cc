@@ -35,9 +35,10 @@
 #define ENABLE_TENSOR_HNDL 1
 #endif
 
-namespace {
+namespace tim {
+namespace vx {
 
-void PackTensorDtype(tim::vx::TensorSpec& spec, vsi_nn_dtype_t* dtype) {
+void PackTensorDtype(TensorSpec& spec, vsi_nn_dtype_t* dtype) {
   dtype->vx_type = TranslateDataType(spec.datatype_);
   dtype->qnt_type = TranslateQuantType(spec.quantization_.Type());
   switch (spec.quantization_.Type()) {
@@ -79,10 +80,6 @@ void PackTensorDtype(tim::vx::TensorSpec& spec, vsi_nn_dtype_t* dtype) {
   }
 }
 
-}  // namespace
-namespace tim {
-namespace vx {
-
 TensorImpl::TensorImpl(Graph* graph, const TensorSpec& spec, const void* data)
     : graph_(reinterpret_cast<GraphImpl*>(graph)),
       id_(VSI_NN_TENSOR_ID_NA),
@@ -155,16 +152,24 @@ bool TensorImpl::CopyDataToTensor(const void* data, uint32_t size_in_bytes) {
           VSILOGE("GetTensorHandle fail");
         }
       }
+      else if (spec_.GetElementBitSize() == 4) {
+        // ovxlib packs 4-bit data itself and expects one value per byte
+        std::vector<uint8_t> unpacked(spec_.GetElementNum());
+        utils::Unpack4Bit(static_cast<const uint8_t*>(data), unpacked.data(),
+                          spec_.shape_,
+                          spec_.datatype_ == DataType::INT4);
+        retn = (VSI_SUCCESS == vsi_nn_CopyDataToTensor(graph_->graph(), tensor,
+                                                      unpacked.data()));
+      }
       else {
         /*
-        argument `data` of vsi_nn_CopyDataToTensor is non-const
-        convert it from const data to non-const, will be fixed in ovxlib
+        argument `data` of vsi_nn_CopyDataToTensor is non-const but only
+        read from, pass it through instead of copying, so that constant data
+        may live in read-only memory such as a file mapping
         */
-        const uint8_t* end = static_cast<const uint8_t*>(data) + tensor_bytes;
-        std::vector<uint8_t> data_copy(static_cast<const uint8_t*>(data), end);
-
         retn = (VSI_SUCCESS ==
-             vsi_nn_CopyDataToTensor(graph_->graph(), tensor, data_copy.data()));
+             vsi_nn_CopyDataToTensor(graph_->graph(), tensor,
+                                     const_cast<void*>(data)));
       }
     }
   }
@@ -422,27 +427,47 @@ int64_t TensorSpec::GetElementNum() const {
   return count;
 }
 
-int64_t TensorSpec::GetElementByteSize() const {
+int64_t TensorSpec::GetElementBitSize() const {
   switch (datatype_) {
+    case DataType::INT4:
+    case DataType::UINT4:
+      return 4;
     case DataType::INT8:
     case DataType::UINT8:
     case DataType::BOOL8:
-      return 1;
+      return 8;
     case DataType::INT16:
     case DataType::UINT16:
     case DataType::FLOAT16:
-      return 2;
+    case DataType::BFLOAT16:
+      return 16;
     case DataType::INT32:
     case DataType::UINT32:
     case DataType::FLOAT32:
-      return 4;
+      return 32;
+    case DataType::INT64:
+      return 64;
     default:
-      return 1;
+      return 8;
   }
 }
 
+int64_t TensorSpec::GetElementByteSize() const {
+  return (GetElementBitSize() + 7) / 8;
+}
+
 int64_t TensorSpec::GetByteSize() const {
-  return GetElementNum() * GetElementByteSize();
+  int64_t bits = GetElementBitSize();
+  if (bits >= 8) {
+    return GetElementNum() * (bits / 8);
+  }
+  // sub-byte rows are padded to a whole byte, same as ovxlib, a scalar is a
+  // row of one element
+  if (shape_.empty()) {
+    return (bits + 7) / 8;
+  }
+  int64_t row_bytes = (shape_[0] * bits + 7) / 8;
+  return row_bytes * (GetElementNum() / std::max<int64_t>(shape_[0], 1));
 }
 
 bool Quantization::operator ==  (const Quantization& other_quant) const {
@@ -461,16 +486,23 @@ namespace utils{
 bool Float32ToDtype(std::shared_ptr<tim::vx::Tensor> tensor, std::vector<float> fval, uint8_t* tensorData){
 bool retn = true;
 vsi_nn_tensor_attr_t attr;
-uint32_t sz = tensor->GetSpec().GetElementNum();
-uint32_t stride = tensor->GetSpec().GetElementByteSize();
-PackTensorDtype(tensor->GetSpec(),  &attr.dtype);
+TensorSpec spec = tensor->GetSpec();
+uint32_t sz = spec.GetElementNum();
+uint32_t stride = spec.GetElementByteSize();
+bool sub_byte = spec.GetElementBitSize() < 8;
+std::vector<uint8_t> unpacked(sub_byte ? sz : 0);
+uint8_t* out = sub_byte ? unpacked.data() : tensorData;
+PackTensorDtype(spec,  &attr.dtype);
 for (uint32_t i = 0; i < sz; i++){
-  retn = (VSI_SUCCESS == vsi_nn_Float32ToDtype(fval[i], &tensorData[i * stride], &attr.dtype));
+  retn = (VSI_SUCCESS == vsi_nn_Float32ToDtype(fval[i], &out[i * stride], &attr.dtype));
   if (!retn) {
     VSILOGE("Convert data fail");
     return retn;
   }
 }
+if (sub_byte) {
+  Pack4Bit(unpacked.data(), tensorData, spec.shape_);
+}
 return retn;
 }
 
@@ -482,6 +514,41 @@ bool DtypeToFloat32(std::shared_ptr<tim::vx::Tensor> tensor, uint8_t* tensorData
   retn = (VSI_SUCCESS == vsi_nn_DtypeToFloat32(tensorData, data, &attr.dtype));
   return retn;
 }
+
+void Pack4Bit(const uint8_t* src, uint8_t* dst, const ShapeType& shape) {
+  if (shape.empty()) return;
+  size_t row = shape[0];
+  size_t rows = 1;
+  for (size_t i = 1; i < shape.size(); ++i) rows *= shape[i];
+  size_t row_bytes = (row + 1) / 2;
+  for (size_t r = 0; r < rows; ++r) {
+    const uint8_t* in = src + r * row;
+    uint8_t* out = dst + r * row_bytes;
+    for (size_t i = 0; i < row_bytes; ++i) {
+      uint8_t lo = in[2 * i] & 0x0F;
+      uint8_t hi = (2 * i + 1 < row) ? (in[2 * i + 1] & 0x0F) : 0;
+      out[i] = static_cast<uint8_t>(lo | (hi << 4));
+    }
+  }
+}
+
+void Unpack4Bit(const uint8_t* src, uint8_t* dst, const ShapeType& shape,
+                bool is_signed) {
+  if (shape.empty()) return;
+  size_t row = shape[0];
+  size_t rows = 1;
+  for (size_t i = 1; i < shape.size(); ++i) rows *= shape[i];
+  size_t row_bytes = (row + 1) / 2;
+  for (size_t r = 0; r < rows; ++r) {
+    const uint8_t* in = src + r * row_bytes;
+    uint8_t* out = dst + r * row;
+    for (size_t i = 0; i < row; ++i) {
+      uint8_t v = (i % 2 == 0) ? (in[i / 2] & 0x0F) : (in[i / 2] >> 4);
+      if (is_signed && (v & 0x08)) v |= 0xF0;
+      out[i] = v;
+    }
+  }
+}
 }  //namespace utils
 }  // namespace vx
 }  // namespace tim
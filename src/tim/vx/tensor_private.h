@@ -30,6 +30,10 @@
 namespace tim {
 namespace vx {
 
+/// Fill low-level dtype description from `spec`, quantization buffers are
+/// referenced but not copied
+void PackTensorDtype(TensorSpec& spec, vsi_nn_dtype_t* dtype);
+
 class TensorImpl : public Tensor {
  public:
   TensorImpl(Graph* graph, const TensorSpec& spec, const void* data = nullptr);
@@ -0,0 +1,89 @@
+/****************************************************************************
+*
+*    Copyright (c) 2020-2023 Vivante Corporation
+*
+*    Permission is hereby granted, free of charge, to any person obtaining a
+*    copy of this software and associated documentation files (the "Software"),
+*    to deal in the Software without restriction, including without limitation
+*    the rights to use, copy, modify, merge, publish, distribute, sublicense,
+*    and/or sell copies of the Software, and to permit persons to whom the
+*    Software is furnished to do so, subject to the following conditions:
+*
+*    The above copyright notice and this permission notice shall be included in
+*    all copies or substantial portions of the Software.
+*
+*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+*    IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+*    FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+*    AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+*    LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+*    DEALINGS IN THE SOFTWARE.
+*
+*****************************************************************************/
+#include "tim/vx/context.h"
+#include "tim/vx/graph.h"
+#include "tim/vx/tensor.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+TEST(TensorSpec, byte_size) {
+  auto size = [](tim::vx::DataType type, const tim::vx::ShapeType& shape) {
+    return tim::vx::TensorSpec(type, shape, tim::vx::TensorAttribute::INPUT)
+        .GetByteSize();
+  };
+  EXPECT_EQ(24, size(tim::vx::DataType::FLOAT32, {2, 3}));
+  EXPECT_EQ(12, size(tim::vx::DataType::BFLOAT16, {2, 3}));
+  EXPECT_EQ(48, size(tim::vx::DataType::INT64, {2, 3}));
+  EXPECT_EQ(3, size(tim::vx::DataType::INT4, {2, 3}));
+  // rows of an odd length are padded to a whole byte
+  EXPECT_EQ(6, size(tim::vx::DataType::UINT4, {3, 3}));
+  EXPECT_EQ(1, size(tim::vx::DataType::INT4, {1}));
+  // scalars hold one element
+  EXPECT_EQ(4, size(tim::vx::DataType::FLOAT32, {}));
+  EXPECT_EQ(1, size(tim::vx::DataType::INT4, {}));
+  EXPECT_EQ(1, size(tim::vx::DataType::UINT4, {}));
+}
+
+TEST(TensorSpec, element_size) {
+  auto spec = [](tim::vx::DataType type) {
+    return tim::vx::TensorSpec(type, {1}, tim::vx::TensorAttribute::INPUT);
+  };
+  EXPECT_EQ(4, spec(tim::vx::DataType::INT4).GetElementBitSize());
+  EXPECT_EQ(1, spec(tim::vx::DataType::INT4).GetElementByteSize());
+  EXPECT_EQ(16, spec(tim::vx::DataType::BFLOAT16).GetElementBitSize());
+  EXPECT_EQ(2, spec(tim::vx::DataType::BFLOAT16).GetElementByteSize());
+  EXPECT_EQ(8, spec(tim::vx::DataType::INT64).GetElementByteSize());
+}
+
+TEST(TensorUtils, pack_4bit) {
+  tim::vx::ShapeType shape({3, 2});
+  std::vector<uint8_t> values = {0x1, 0xF, 0x7, 0x8, 0x0, 0x9};
+  std::vector<uint8_t> packed(4);
+  tim::vx::utils::Pack4Bit(values.data(), packed.data(), shape);
+  EXPECT_EQ(std::vector<uint8_t>({0xF1, 0x07, 0x08, 0x09}), packed);
+
+  std::vector<uint8_t> unpacked(6);
+  tim::vx::utils::Unpack4Bit(packed.data(), unpacked.data(), shape, false);
+  EXPECT_EQ(values, unpacked);
+  tim::vx::utils::Unpack4Bit(packed.data(), unpacked.data(), shape, true);
+  EXPECT_EQ(std::vector<uint8_t>({0x01, 0xFF, 0x07, 0xF8, 0x00, 0xF9}),
+            unpacked);
+}
+
+TEST(Tensor, int4_constant_round_trip) {
+  auto ctx = tim::vx::Context::Create();
+  auto graph = ctx->CreateGraph();
+
+  tim::vx::Quantization quant(tim::vx::QuantType::ASYMMETRIC, 1.0f, 0);
+  tim::vx::TensorSpec spec(tim::vx::DataType::INT4, {3, 2},
+                           tim::vx::TensorAttribute::CONSTANT, quant);
+  std::vector<uint8_t> data = {0xF1, 0x07, 0x08, 0x09};
+  auto tensor = graph->CreateTensor(spec, data.data());
+
+  std::vector<uint8_t> read(spec.GetByteSize());
+  EXPECT_TRUE(tensor->CopyDataFromTensor(read.data()));
+  EXPECT_EQ(data, read);
+}
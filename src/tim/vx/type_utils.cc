@@ -47,6 +47,12 @@ vsi_nn_type_e TranslateDataType(DataType dtype) {
       return VSI_NN_TYPE_FLOAT32;
     case DataType::BOOL8:
       return VSI_NN_TYPE_BOOL8;
+    case DataType::INT4:
+      return VSI_NN_TYPE_INT4;
+    case DataType::UINT4:
+      return VSI_NN_TYPE_UINT4;
+    case DataType::BFLOAT16:
+      return VSI_NN_TYPE_BFLOAT16;
     default:
       break;
   }